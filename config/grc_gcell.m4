@@ -1,4 +1,4 @@
-dnl Copyright 2001,2002,2003,2004,2005,2006,2008 Free Software Foundation, Inc.
+dnl Copyright 2001,2002,2003,2004,2005,2006,2008,2010 Free Software Foundation, Inc.
 dnl 
 dnl This file is part of GNU Radio
 dnl 
@@ -28,26 +28,32 @@ AC_DEFUN([GRC_GCELL],[
     dnl   with : if the --with code didn't error out
     dnl   yes  : if the --enable code passed muster and all dependencies are met
     dnl   no   : otherwise
+    dnl Without a Cell (or without spu-gcc) we still build gcell, but
+    dnl only with the host job manager.
+    gcell_spe=no
     if test $passed = yes; then
-	dnl Don't build gcell if host_cpu isn't powerpc
 	AC_MSG_CHECKING([whether host_cpu is powerpc*])
 	case "$host_cpu" in
 	    powerpc*)
 		AC_MSG_RESULT(yes)
+		gcell_spe=yes
 	        ;;
             *)
-	        passed=no
 		AC_MSG_RESULT(no)
 		;;
 	esac
 
-        dnl Don't build gcell if we can't find spu-gcc.
 	AC_CHECK_PROG([SPU_GCC_PROG],[spu-gcc],[yes],[no])
 	if test $SPU_GCC_PROG = no; then
-            passed=no
+            gcell_spe=no
         fi
     fi
 
+    if test $gcell_spe = yes; then
+	AC_DEFINE([GC_HAVE_SPE], [1], [Define if gcell can run jobs on the SPEs])
+    fi
+    AM_CONDITIONAL([GCELL_SPE], [test $gcell_spe = yes])
+
     if test $passed != with; then
 	dnl how and where to find INCLUDES and LA
 	gcell_INCLUDES="-I\${abs_top_srcdir}/gcell/include"
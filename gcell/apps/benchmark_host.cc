@@ -0,0 +1,198 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Throughput (jobs/sec, with many jobs outstanding) and round trip
+ * latency (one job at a time) of the host job manager, for 1 .. N
+ * worker threads.  Like benchmark_nop, each job busy waits for -u usecs.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config.h>
+#endif
+#include <gcell/gc_job_manager.h>
+#include <gnuradio/omni_time.h>
+#include <getopt.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+
+static void
+benchmark_udelay(const gc_job_direct_args_t *input,
+		 gc_job_direct_args_t *output,
+		 const gc_job_ea_args_t *eaa)
+{
+  unsigned int usecs = input->arg[0].u32;
+  if (usecs == 0)
+    return;
+
+  omni_time t_end = omni_time::time() + omni_time(usecs * 1e-6);
+  while (omni_time::time() < t_end)
+    ;
+}
+
+GC_DECLARE_HOST_PROC(benchmark_udelay, "benchmark_udelay");
+
+static void
+init_jd(gc_job_desc *jd, gc_proc_id_t proc_id, unsigned int usecs)
+{
+  jd->proc_id = proc_id;
+  jd->input.nargs = 1;
+  jd->input.arg[0].u32 = usecs;
+  jd->output.nargs = 0;
+  jd->eaa.nargs = 0;
+}
+
+static gc_job_manager_sptr
+make_mgr(unsigned int nthreads)
+{
+  gc_jm_options opts;
+  opts.use_host = true;
+  opts.nspes = nthreads;
+  return gc_make_job_manager(&opts);
+}
+
+// keep NJDS jobs in flight until njobs have completed
+static void
+run_throughput(unsigned int nthreads, unsigned int usecs, int njobs)
+{
+  static const int NJDS = 64;
+  int nsubmitted = 0;
+  int ncompleted = 0;
+  gc_job_desc *jds[NJDS];
+  bool done[NJDS];
+
+  gc_job_manager_sptr mgr = make_mgr(nthreads);
+  gc_proc_id_t proc_id = mgr->lookup_proc("benchmark_udelay");
+
+  for (int i = 0; i < NJDS; i++){
+    jds[i] = mgr->alloc_job_desc();
+    init_jd(jds[i], proc_id, usecs);
+  }
+
+  omni_time t_start = omni_time::time();
+
+  for (int i = 0; i < NJDS && nsubmitted < njobs; i++)
+    if (mgr->submit_job(jds[i]))
+      nsubmitted++;
+
+  int nactive = nsubmitted;
+  while (ncompleted < njobs){
+    int n = mgr->wait_jobs(nactive, jds, done, GC_WAIT_ANY);
+    if (n < 0){
+      fprintf(stderr, "mgr->wait_jobs failed\n");
+      break;
+    }
+
+    // resubmit the finished ones, keeping the active ones at the front
+    int j = 0;
+    for (int i = 0; i < nactive; i++){
+      if (!done[i]){
+	std::swap(jds[i], jds[j++]);
+	continue;
+      }
+      ncompleted++;
+      if (nsubmitted < njobs && mgr->submit_job(jds[i])){
+	nsubmitted++;
+	std::swap(jds[i], jds[j++]);
+      }
+    }
+    nactive = j;
+  }
+
+  double delta = (omni_time::time() - t_start).double_time();
+  printf("threads: %2d  udelay: %4d  jobs/sec: %10.0f  speedup: %6.3f\n",
+	 mgr->nspes(), usecs, njobs / delta,
+	 njobs * usecs * 1e-6 / delta);
+
+  for (int i = 0; i < NJDS; i++)
+    mgr->free_job_desc(jds[i]);
+}
+
+// submit a single job and wait for it, njobs times
+static void
+run_latency(unsigned int nthreads, unsigned int usecs, int njobs)
+{
+  gc_job_manager_sptr mgr = make_mgr(nthreads);
+  gc_proc_id_t proc_id = mgr->lookup_proc("benchmark_udelay");
+  gc_job_desc *jd = mgr->alloc_job_desc();
+  init_jd(jd, proc_id, usecs);
+
+  double min_t = 1e9, max_t = 0, total = 0;
+  for (int i = 0; i < njobs; i++){
+    omni_time t0 = omni_time::time();
+    if (!mgr->submit_job(jd) || !mgr->wait_job(jd)){
+      fprintf(stderr, "job failed, status = %d\n", jd->status);
+      break;
+    }
+    double t = (omni_time::time() - t0).double_time() - usecs * 1e-6;
+    min_t = std::min(min_t, t);
+    max_t = std::max(max_t, t);
+    total += t;
+  }
+
+  printf("threads: %2d  round trip latency (usecs): min %7.2f  avg %7.2f  max %8.2f\n",
+	 mgr->nspes(), min_t * 1e6, total / njobs * 1e6, max_t * 1e6);
+
+  mgr->free_job_desc(jd);
+}
+
+int
+main(int argc, char **argv)
+{
+  unsigned int max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned int usecs = 0;
+  int njobs = 200000;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "n:u:N:")) != EOF){
+    switch(ch){
+    case 'n':
+      max_threads = strtol(optarg, 0, 0);
+      break;
+
+    case 'u':
+      usecs = strtol(optarg, 0, 0);
+      break;
+
+    case 'N':
+      njobs = strtol(optarg, 0, 0);
+      break;
+
+    case '?':
+    default:
+      fprintf(stderr, "usage: benchmark_host [-n <max_threads>] [-u <udelay>] [-N <njobs>]\n");
+      return 1;
+    }
+  }
+
+  if (max_threads < 1)
+    max_threads = 1;
+
+  for (unsigned int n = 1; n <= max_threads; n++)
+    run_throughput(n, usecs, njobs);
+
+  for (unsigned int n = 1; n <= max_threads; n++)
+    run_latency(n, usecs, njobs / 10);
+
+  return 0;
+}
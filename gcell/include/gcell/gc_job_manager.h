@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,9 +27,11 @@
 #include <vector>
 #include <string>
 #include <stdexcept>
-#include <libspe2.h>
 #include "gc_job_desc.h"
 
+// from <libspe2.h>; declared here so that host-only builds don't need it
+typedef struct spe_program_handle spe_program_handle_t;
+
 class gc_job_manager;
 typedef boost::shared_ptr<gc_job_manager> gc_job_manager_sptr;
 typedef boost::shared_ptr<spe_program_handle_t> spe_program_handle_sptr;
@@ -74,6 +76,12 @@ gc_job_status_string(gc_job_status_t status);
 /*
  * \brief Options that configure the job_manager.
  * The default values are reasonable.
+ *
+ * With use_host, jobs run on a pool of nspes host threads instead of
+ * on the SPEs, using the procedures registered with
+ * gc_register_host_proc.  program_handle and the SPE specific options
+ * are ignored.  This is the only kind of job manager available when
+ * gcell is built for something other than the Cell.
  */
 struct gc_jm_options {
   unsigned int max_jobs;	    // max # of job descriptors in system
@@ -84,11 +92,13 @@ struct gc_jm_options {
   bool enable_logging;		    // shall we log SPE events?
   uint32_t log2_nlog_entries;    	   // log2 of number of log entries (default is 12 == 4k)
   spe_program_handle_sptr program_handle;  // program to load into SPEs
+  bool use_host;		    // run jobs on host threads, not SPEs
 
   gc_jm_options() :
     max_jobs(0), max_client_threads(0), nspes(0),
     gang_schedule(false), use_affinity(false),
-    enable_logging(false), log2_nlog_entries(12)
+    enable_logging(false), log2_nlog_entries(12),
+    use_host(false)
   {
   }
 
@@ -97,7 +107,7 @@ struct gc_jm_options {
     max_jobs(0), max_client_threads(0), nspes(nspes_),
     gang_schedule(false), use_affinity(false),
     enable_logging(false), log2_nlog_entries(12),
-    program_handle(program_handle_)
+    program_handle(program_handle_), use_host(false)
   {
   }
 };
@@ -146,6 +156,33 @@ public:
 gc_job_manager_sptr
 gc_make_job_manager(const gc_jm_options *options = 0);
 
+/*!
+ * \brief Register a host implementation of the procedure \p name.
+ *
+ * Host job managers created after this call can look it up by name.
+ * A host procedure has the same signature as the SPU one, but reads
+ * and writes its EA arguments in place, at ea_to_ptr(eaa->arg[i].ea_addr).
+ *
+ * \sa GC_DECLARE_HOST_PROC
+ */
+void
+gc_register_host_proc(const std::string &name, gc_spu_proc_t proc);
+
+//! Registers a host procedure at static initialization time
+struct gc_host_proc_registrar {
+  gc_host_proc_registrar(gc_spu_proc_t proc, const char *name)
+  {
+    gc_register_host_proc(name, proc);
+  }
+};
+
+/*!
+ * \brief Tell gcell about a host procedure; the host counterpart of
+ * GC_DECLARE_PROC.
+ */
+#define GC_DECLARE_HOST_PROC(_proc_, _name_) \
+static gc_host_proc_registrar _GCHPD_ ## _proc_(_proc_, _name_)
+
 
 /*!
  * \brief Abstract class that manages SPE jobs.
@@ -168,7 +205,8 @@ public:
   virtual bool shutdown() = 0;
 
   /*!
-   * \brief Return number of SPE's currently allocated to job manager.
+   * \brief Return number of SPE's (or host threads) currently
+   * allocated to job manager.
    */
   virtual int nspes() const = 0;
 
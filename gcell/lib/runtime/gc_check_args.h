@@ -0,0 +1,41 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef INCLUDED_GC_CHECK_ARGS_H
+#define INCLUDED_GC_CHECK_ARGS_H
+
+#include <gcell/gc_job_desc.h>
+
+/*
+ * Argument checks done at submit time by all job managers.
+ * On failure they set jd->status and return false.
+ */
+
+bool
+gc_check_direct_args(gc_job_desc *jd, gc_job_direct_args *args);
+
+/*!
+ * Also fills in jd->sys.direction_union.  If \p same_eah, all args
+ * must share the high 32 address bits (an SPE DMA restriction).
+ */
+bool
+gc_check_ea_args(gc_job_desc *jd, gc_job_ea_args *p, bool same_eah = true);
+
+#endif /* INCLUDED_GC_CHECK_ARGS_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -23,7 +23,11 @@
 #include <config.h>
 #endif
 #include <gcell/gc_job_manager.h>
+#include "gc_job_manager_host.h"
+#include "gc_check_args.h"
+#ifdef GC_HAVE_SPE
 #include "gc_job_manager_impl.h"
+#endif
 #include <boost/weak_ptr.hpp>
 #include <stdio.h>
 
@@ -47,7 +51,11 @@ public:
 gc_job_manager_sptr
 gc_make_job_manager(const gc_jm_options *options)
 {
-  return gc_job_manager_sptr(new gc_job_manager_impl(options));
+#ifdef GC_HAVE_SPE
+  if (options == 0 || !options->use_host)
+    return gc_job_manager_sptr(new gc_job_manager_impl(options));
+#endif
+  return gc_job_manager_sptr(new gc_job_manager_host(options));
 }
 
 gc_job_manager::gc_job_manager(const gc_jm_options *options)
@@ -99,6 +107,7 @@ gc_job_manager::alloc_job_desc(gc_job_manager_sptr mgr)
 
 // ------------------------------------------------------------------------
 
+#ifdef GC_HAVE_SPE
 
 // custom deleter
 class spe_program_handle_deleter {
@@ -134,6 +143,74 @@ gc_program_handle_from_address(spe_program_handle_t *handle)
   return spe_program_handle_sptr(handle, nop_spe_program_handle_deleter());
 }
 
+#else
+
+// There are no SPE programs on a host-only build
+
+spe_program_handle_sptr 
+gc_program_handle_from_filename(const std::string &filename)
+{
+  return spe_program_handle_sptr();
+}
+
+spe_program_handle_sptr 
+gc_program_handle_from_address(spe_program_handle_t *handle)
+{
+  return spe_program_handle_sptr();
+}
+
+#endif /* GC_HAVE_SPE */
+
+// ------------------------------------------------------------------------
+
+bool
+gc_check_direct_args(gc_job_desc *jd, gc_job_direct_args *args)
+{
+  if (args->nargs > MAX_ARGS_DIRECT){
+    jd->status = JS_BAD_N_DIRECT;
+    return false;
+  }
+
+  return true;
+}
+
+bool
+gc_check_ea_args(gc_job_desc *jd, gc_job_ea_args *p, bool same_eah)
+{
+  if (p->nargs > MAX_ARGS_EA){
+    jd->status = JS_BAD_N_EA;
+    return false;
+  }
+
+  uint32_t dir_union = 0;
+
+  for (unsigned int i = 0; i < p->nargs; i++){
+    dir_union |= p->arg[i].direction;
+    switch(p->arg[i].direction){
+    case GCJD_DMA_GET:
+    case GCJD_DMA_PUT:
+      break;
+
+    default:
+      jd->status = JS_BAD_DIRECTION;
+      return false;
+    }
+  }
+
+  if (same_eah && p->nargs > 1){
+    unsigned int common_eah = (p->arg[0].ea_addr) >> 32;
+    for (unsigned int i = 1; i < p->nargs; i++){
+      if ((p->arg[i].ea_addr >> 32) != common_eah){
+	jd->status = JS_BAD_EAH;
+	return false;
+      }
+    }
+  }
+
+  jd->sys.direction_union = dir_union;
+  return true;
+}
+
 const std::string
 gc_job_status_string(gc_job_status_t status)
 {
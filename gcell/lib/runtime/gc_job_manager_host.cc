@@ -0,0 +1,519 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include "gc_job_manager_host.h"
+#include "gc_check_args.h"
+#include <gcell/gc_aligned_alloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <stdexcept>
+#include <algorithm>
+
+static const size_t CACHE_LINE_SIZE = 128;
+
+static const unsigned int DEFAULT_MAX_JOBS = 128;
+static const unsigned int DEFAULT_MAX_CLIENT_THREADS = 64;
+
+// Same as the SPE runtime (GC_SPU_BUFSIZE_BASE), so that callers
+// sizing their jobs with ea_args_maxsize() behave the same on both.
+static const int EA_ARGS_MAXSIZE = 40 * 1024;
+
+////////////////////////////////////////////////////////////////////////
+//
+// the registry of host procedures, filled in at static init time
+
+struct host_proc_def {
+  std::string	 name;
+  gc_spu_proc_t	 proc;
+};
+
+static omni_mutex &
+registry_mutex()
+{
+  static omni_mutex m;
+  return m;
+}
+
+static std::vector<host_proc_def> &
+registry()
+{
+  static std::vector<host_proc_def> r;
+  return r;
+}
+
+void
+gc_register_host_proc(const std::string &name, gc_spu_proc_t proc)
+{
+  omni_mutex_lock	l(registry_mutex());
+  std::vector<host_proc_def> &r = registry();
+
+  for (unsigned int i = 0; i < r.size(); i++){
+    if (r[i].name == name){	// last one wins
+      r[i].proc = proc;
+      return;
+    }
+  }
+
+  host_proc_def d;
+  d.name = name;
+  d.proc = proc;
+  r.push_back(d);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void
+client_key_destructor(void *p)
+{
+  ((gc_client_thread_info *) p)->d_free = 1;
+}
+
+static void *
+start_worker(void *arg)
+{
+  ((gc_job_manager_host *) arg)->worker_loop();
+  return 0;
+}
+
+static inline void
+bv_zero(unsigned long *bv, int bvlen)
+{
+  memset(bv, 0, sizeof(unsigned long) * bvlen);
+}
+
+static inline void
+bv_clr(unsigned long *bv, unsigned int bitno)
+{
+  unsigned int wi = bitno / (sizeof (unsigned long) * 8);
+  unsigned int bi = bitno & ((sizeof (unsigned long) * 8) - 1);
+  bv[wi] &= ~(1UL << bi);
+}
+
+static inline void
+bv_set(unsigned long *bv, unsigned int bitno)
+{
+  unsigned int wi = bitno / (sizeof (unsigned long) * 8);
+  unsigned int bi = bitno & ((sizeof (unsigned long) * 8) - 1);
+  bv[wi] |= (1UL << bi);
+}
+
+static inline bool
+bv_isset(unsigned long *bv, unsigned int bitno)
+{
+  unsigned int wi = bitno / (sizeof (unsigned long) * 8);
+  unsigned int bi = bitno & ((sizeof (unsigned long) * 8) - 1);
+  return (bv[wi] & (1UL << bi)) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+gc_job_manager_host::gc_job_manager_host(const gc_jm_options *options)
+  : d_debug(0), d_jd(0), d_bvlen(0), d_queue_cond(&d_mutex),
+    d_free_list(0), d_queue_head(0), d_queue_tail(0),
+    d_shutdown_requested(false), d_nworkers(0)
+{
+  if (options != 0)
+    d_options = *options;
+
+  // provide the real default for those indicated with a zero
+  if (d_options.max_jobs == 0)
+    d_options.max_jobs = DEFAULT_MAX_JOBS;
+  if (d_options.max_client_threads == 0)
+    d_options.max_client_threads = DEFAULT_MAX_CLIENT_THREADS;
+
+  if (d_options.nspes == 0){	// use all the cpus
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    d_options.nspes = ncpus > 0 ? ncpus : 1;
+  }
+  d_options.nspes = std::min(d_options.nspes, (unsigned int) MAX_THREADS);
+
+  {
+    omni_mutex_lock	l(registry_mutex());
+    const std::vector<host_proc_def> &r = registry();
+    for (unsigned int i = 0; i < r.size(); i++){
+      proc_entry e;
+      e.name = r[i].name;
+      e.proc = r[i].proc;
+      d_procs.push_back(e);
+    }
+  }
+
+  // ----------------------------------------------------------------
+  // the job descriptors and their free list
+
+  _d_jd_boost = gc_aligned_alloc_sptr(sizeof(d_jd[0]) * d_options.max_jobs,
+				      CACHE_LINE_SIZE);
+  d_jd = (gc_job_desc_t *) _d_jd_boost.get();
+
+  for (int i = d_options.max_jobs - 1; i >= 0; i--){
+    d_jd[i].sys.job_id = i;
+    free_job_desc(&d_jd[i]);
+  }
+
+  // ----------------------------------------------------------------
+  // client thread info and their bitvectors
+
+  d_client_thread.reset(new gc_client_thread_info[d_options.max_client_threads]);
+  for (unsigned int i = 0; i < d_options.max_client_threads; i++)
+    d_client_thread[i].d_client_id = i;
+
+  int bits_per_long = sizeof(unsigned long) * 8;
+  d_bvlen = (d_options.max_jobs + bits_per_long - 1) / bits_per_long;
+
+  size_t nlongs = d_bvlen * d_options.max_client_threads;
+  _d_all_bitvectors = gc_aligned_alloc_sptr(nlongs * sizeof(unsigned long),
+					    CACHE_LINE_SIZE);
+  unsigned long *v = (unsigned long *) _d_all_bitvectors.get();
+  for (unsigned int i = 0; i < d_options.max_client_threads; i++, v += d_bvlen)
+    d_client_thread[i].d_jobs_done = v;
+
+  int r = pthread_key_create(&d_client_key, client_key_destructor);
+  if (r != 0)
+    throw std::runtime_error("pthread_key_create");
+
+  // ----------------------------------------------------------------
+  // start the workers
+
+  for (unsigned int i = 0; i < d_options.nspes; i++){
+    r = pthread_create(&d_worker[i], 0, start_worker, this);
+    if (r != 0){
+      fprintf(stderr, "gc_job_manager_host: pthread_create failed (return = %d)\n", r);
+      shutdown();
+      pthread_key_delete(d_client_key);
+      throw std::runtime_error("pthread_create");
+    }
+    d_nworkers++;
+  }
+}
+
+gc_job_manager_host::~gc_job_manager_host()
+{
+  shutdown();
+  pthread_key_delete(d_client_key);
+}
+
+bool
+gc_job_manager_host::shutdown()
+{
+  {
+    omni_mutex_lock	l(d_mutex);
+    d_shutdown_requested = true;
+    d_queue_cond.broadcast();
+  }
+
+  // the workers drain the queue before they exit
+  for (unsigned int i = 0; i < d_nworkers; i++)
+    pthread_join(d_worker[i], 0);
+  d_nworkers = 0;
+
+  return true;
+}
+
+int
+gc_job_manager_host::nspes() const
+{
+  return d_options.nspes;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+gc_job_desc *
+gc_job_manager_host::alloc_job_desc()
+{
+  omni_mutex_lock	l(d_mutex);
+
+  gc_job_desc *jd = d_free_list;
+  if (jd == 0)
+    throw gc_bad_alloc("alloc_job_desc: none available");
+
+  d_free_list = ea_to_jdp(jd->sys.next);
+  return jd;
+}
+
+void
+gc_job_manager_host::free_job_desc(gc_job_desc *jd)
+{
+  if (jd == 0)
+    return;
+
+  omni_mutex_lock	l(d_mutex);
+  jd->sys.next = jdp_to_ea(d_free_list);
+  d_free_list = jd;
+}
+
+gc_client_thread_info *
+gc_job_manager_host::alloc_cti()
+{
+  omni_mutex_lock	l(d_mutex);
+
+  for (unsigned int i = 0; i < d_options.max_client_threads; i++){
+    gc_client_thread_info *cti = &d_client_thread[i];
+    if (cti->d_free){
+      cti->d_free = 0;
+      cti->d_state = CT_NOT_WAITING;
+      bv_zero(cti->d_jobs_done, d_bvlen);
+      cti->d_njobs_waiting_for = 0;
+      cti->d_jobs_waiting_for = 0;
+      return cti;
+    }
+  }
+  return 0;
+}
+
+bool
+gc_job_manager_host::submit_job(gc_job_desc *jd)
+{
+  // Ensure it's one of our job descriptors
+
+  if (jd < d_jd || jd >= &d_jd[d_options.max_jobs]){
+    jd->status = JS_BAD_JOB_DESC;
+    return false;
+  }
+
+  // Ensure we've got a client_thread_info assigned to this thread.
+
+  gc_client_thread_info *cti =
+    (gc_client_thread_info *) pthread_getspecific(d_client_key);
+  if (unlikely(cti == 0)){
+    if ((cti = alloc_cti()) == 0){
+      fprintf(stderr, "gc_job_manager_host::submit_job: Too many client threads.\n");
+      jd->status = JS_TOO_MANY_CLIENTS;
+      return false;
+    }
+    int r = pthread_setspecific(d_client_key, cti);
+    if (r != 0){
+      jd->status = JS_BAD_JUJU;
+      fprintf(stderr, "pthread_setspecific failed (return = %d)\n", r);
+      return false;
+    }
+  }
+
+  if (jd->proc_id == GCP_UNKNOWN_PROC){
+    jd->status = JS_UNKNOWN_PROC;
+    return false;
+  }
+
+  if (!gc_check_direct_args(jd, &jd->input))
+    return false;
+
+  if (!gc_check_direct_args(jd, &jd->output))
+    return false;
+
+  // no DMA here, so the args needn't share the high address bits
+  if (!gc_check_ea_args(jd, &jd->eaa, false))
+    return false;
+
+  jd->status = JS_OK;
+  jd->sys.client_id = cti->d_client_id;
+  jd->sys.next = 0;
+
+  omni_mutex_lock	l(d_mutex);
+
+  if (d_shutdown_requested){
+    jd->status = JS_SHUTTING_DOWN;
+    return false;
+  }
+
+  if (d_queue_tail)
+    d_queue_tail->sys.next = jdp_to_ea(jd);
+  else
+    d_queue_head = jd;
+  d_queue_tail = jd;
+
+  d_queue_cond.signal();
+  return true;
+}
+
+bool
+gc_job_manager_host::wait_job(gc_job_desc *jd)
+{
+  bool done;
+  return wait_jobs(1, &jd, &done, GC_WAIT_ANY) == 1 && jd->status == JS_OK;
+}
+
+int
+gc_job_manager_host::wait_jobs(unsigned int njobs,
+			       gc_job_desc *jd[],
+			       bool done[],
+			       gc_wait_mode mode)
+{
+  unsigned int i;
+
+  gc_client_thread_info *cti =
+    (gc_client_thread_info *) pthread_getspecific(d_client_key);
+  if (unlikely(cti == 0))
+    return -1;
+
+  for (i = 0; i < njobs; i++){
+    done[i] = false;
+    if (unlikely(jd[i]->sys.client_id != cti->d_client_id)){
+      fprintf(stderr, "gc_job_manager_host::wait_jobs: can't wait for a job you didn't submit\n");
+      return -1;
+    }
+  }
+
+  omni_mutex_lock	l(cti->d_mutex);
+
+  cti->d_state = (mode == GC_WAIT_ANY) ? CT_WAIT_ANY : CT_WAIT_ALL;
+  cti->d_njobs_waiting_for = njobs;
+  cti->d_jobs_waiting_for = jd;
+
+  unsigned int ndone = 0;
+
+  while (1){
+    ndone = 0;
+    for (i = 0; i < njobs; i++){
+      if (done[i])
+	ndone++;
+      else if (bv_isset(cti->d_jobs_done, jd[i]->sys.job_id)){
+	bv_clr(cti->d_jobs_done, jd[i]->sys.job_id);
+	done[i] = true;
+	ndone++;
+      }
+    }
+
+    if (mode == GC_WAIT_ANY && ndone > 0)
+      break;
+
+    if (mode == GC_WAIT_ALL && ndone == njobs)
+      break;
+
+    cti->d_cond.wait();		// wait for a worker to wake us up
+  }
+
+  cti->d_state = CT_NOT_WAITING;
+  cti->d_njobs_waiting_for = 0;
+  cti->d_jobs_waiting_for = 0;
+  return ndone;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+gc_job_manager_host::worker_loop()
+{
+  while (1){
+    gc_job_desc *jd;
+    {
+      omni_mutex_lock	l(d_mutex);
+
+      while (d_queue_head == 0 && !d_shutdown_requested)
+	d_queue_cond.wait();
+
+      if (d_queue_head == 0)	// shutting down and nothing left to do
+	return;
+
+      jd = d_queue_head;
+      d_queue_head = ea_to_jdp(jd->sys.next);
+      if (d_queue_head == 0)
+	d_queue_tail = 0;
+    }
+
+    run_job(jd);
+    notify_client_job_is_done(jd);
+  }
+}
+
+void
+gc_job_manager_host::run_job(gc_job_desc *jd)
+{
+  if (jd->proc_id >= d_procs.size()){
+    jd->status = JS_UNKNOWN_PROC;
+    return;
+  }
+
+  // the same limits the SPE runtime enforces
+  uint32_t total_get = 0;
+  uint32_t total_put = 0;
+  for (unsigned int i = 0; i < jd->eaa.nargs; i++){
+    if (jd->eaa.arg[i].direction == GCJD_DMA_GET)
+      total_get += jd->eaa.arg[i].get_size;
+    else
+      total_put += jd->eaa.arg[i].put_size;
+  }
+  if (total_get > (uint32_t) EA_ARGS_MAXSIZE
+      || total_put > (uint32_t) EA_ARGS_MAXSIZE){
+    jd->status = JS_ARGS_TOO_LONG;
+    return;
+  }
+
+  if (d_debug)
+    printf("gc_job_manager_host: running %s (job %d)\n",
+	   d_procs[jd->proc_id].name.c_str(), jd->sys.job_id);
+
+  (*d_procs[jd->proc_id].proc)(&jd->input, &jd->output, &jd->eaa);
+}
+
+void
+gc_job_manager_host::notify_client_job_is_done(gc_job_desc *jd)
+{
+  gc_client_thread_info *cti = &d_client_thread[jd->sys.client_id];
+
+  omni_mutex_lock	l(cti->d_mutex);
+  bv_set(cti->d_jobs_done, jd->sys.job_id);
+  if (cti->d_state != CT_NOT_WAITING)
+    cti->d_cond.signal();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int
+gc_job_manager_host::ea_args_maxsize()
+{
+  return EA_ARGS_MAXSIZE;
+}
+
+gc_proc_id_t
+gc_job_manager_host::lookup_proc(const std::string &proc_name)
+{
+  for (unsigned int i = 0; i < d_procs.size(); i++)
+    if (proc_name == d_procs[i].name)
+      return i;
+
+  throw gc_unknown_proc(proc_name);
+}
+
+std::vector<std::string>
+gc_job_manager_host::proc_names()
+{
+  std::vector<std::string> r;
+  for (unsigned int i = 0; i < d_procs.size(); i++)
+    r.push_back(d_procs[i].name);
+
+  return r;
+}
+
+void
+gc_job_manager_host::set_debug(int debug)
+{
+  d_debug = debug;
+}
+
+int
+gc_job_manager_host::debug()
+{
+  return d_debug;
+}
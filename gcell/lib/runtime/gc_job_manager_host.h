@@ -0,0 +1,108 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INCLUDED_GC_JOB_MANAGER_HOST_H
+#define INCLUDED_GC_JOB_MANAGER_HOST_H
+
+#include <gcell/gc_job_manager.h>
+#include "gc_client_thread_info.h"
+#include <gnuradio/omnithread.h>
+#include <pthread.h>
+#include <vector>
+#include <string>
+#include <boost/scoped_array.hpp>
+
+/*!
+ * \brief Job manager that runs jobs on a pool of host threads.
+ *
+ * Jobs are run by the procedures registered with gc_register_host_proc,
+ * in place on the caller's buffers.  The free list and the job queue
+ * are intrusive lists threaded through jd->sys.next and guarded by a
+ * mutex; the lock free gc_jd_stack and gc_jd_queue are PowerPC only.
+ *
+ * Completion is reported to the client threads exactly as the SPE job
+ * manager does it: a bit per job in each client's d_jobs_done vector.
+ */
+class gc_job_manager_host : public gc_job_manager
+{
+  enum { MAX_THREADS = 64 };
+
+  struct proc_entry {
+    std::string		name;
+    gc_spu_proc_t	proc;
+  };
+
+  int			 d_debug;
+  gc_jm_options		 d_options;
+  std::vector<proc_entry> d_procs;		// snapshot of registered procs
+
+  // All of the job descriptors, in a single cache aligned chunk.
+  gc_job_desc_t		*d_jd;			// [options.max_jobs]
+  boost::shared_ptr<void> _d_jd_boost;		// hack for automatic storage mgmt
+
+  boost::scoped_array<gc_client_thread_info> d_client_thread;
+  pthread_key_t		 d_client_key;		// -> our gc_client_thread_info
+
+  int			 d_bvlen;		// bit vector length in longs
+  boost::shared_ptr<void> _d_all_bitvectors;	// hack for automatic storage mgmt
+
+  // d_mutex guards everything below
+  omni_mutex		 d_mutex;
+  omni_condition	 d_queue_cond;		// workers wait here for jobs
+  gc_job_desc		*d_free_list;
+  gc_job_desc		*d_queue_head;
+  gc_job_desc		*d_queue_tail;
+  bool			 d_shutdown_requested;
+
+  pthread_t		 d_worker[MAX_THREADS];
+  unsigned int		 d_nworkers;
+
+  gc_client_thread_info *alloc_cti();
+  void run_job(gc_job_desc *jd);
+  void notify_client_job_is_done(gc_job_desc *jd);
+
+public:
+  void worker_loop();		// really private
+
+private:
+  friend gc_job_manager_sptr gc_make_job_manager(const gc_jm_options *options);
+
+  gc_job_manager_host(const gc_jm_options *options = 0);
+
+public:
+  virtual ~gc_job_manager_host();
+
+  virtual bool shutdown();
+  virtual int nspes() const;
+  virtual gc_job_desc *alloc_job_desc();
+  virtual void free_job_desc(gc_job_desc *jd);
+  virtual bool submit_job(gc_job_desc *jd);
+  virtual bool wait_job(gc_job_desc *jd);
+  virtual int wait_jobs(unsigned int njobs,
+			gc_job_desc *jd[], bool done[], gc_wait_mode mode);
+  virtual int ea_args_maxsize();
+  virtual gc_proc_id_t lookup_proc(const std::string &name);
+  virtual std::vector<std::string> proc_names();
+  virtual void set_debug(int debug);
+  virtual int debug();
+};
+
+#endif /* INCLUDED_GC_JOB_MANAGER_HOST_H */
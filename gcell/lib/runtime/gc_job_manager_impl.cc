@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -23,6 +23,7 @@
 #include <config.h>
 #endif
 #include "gc_job_manager_impl.h"
+#include "gc_check_args.h"
 #include <gcell/gc_mbox.h>
 #include <gcell/gc_aligned_alloc.h>
 #include <gcell/memory_barrier.h>
@@ -478,58 +479,6 @@ gc_job_manager_impl::decr_njobs_active(int n)
 }
 
 
-/*
- * We check as much as we can here on the PPE side, so that the SPE
- * doesn't have to.
- */
-static bool
-check_direct_args(gc_job_desc *jd, gc_job_direct_args *args)
-{
-  if (args->nargs > MAX_ARGS_DIRECT){
-    jd->status = JS_BAD_N_DIRECT;
-    return false;
-  }
-
-  return true;
-}
-
-static bool
-check_ea_args(gc_job_desc *jd, gc_job_ea_args *p)
-{
-  if (p->nargs > MAX_ARGS_EA){
-    jd->status = JS_BAD_N_EA;
-    return false;
-  }
-
-  uint32_t dir_union = 0;
-
-  for (unsigned int i = 0; i < p->nargs; i++){
-    dir_union |= p->arg[i].direction;
-    switch(p->arg[i].direction){
-    case GCJD_DMA_GET:
-    case GCJD_DMA_PUT:
-      break;
-
-    default:
-      jd->status = JS_BAD_DIRECTION;
-      return false;
-    }
-  }
-
-  if (p->nargs > 1){
-    unsigned int common_eah = (p->arg[0].ea_addr) >> 32;
-    for (unsigned int i = 1; i < p->nargs; i++){
-      if ((p->arg[i].ea_addr >> 32) != common_eah){
-	jd->status = JS_BAD_EAH;
-	return false;
-      }
-    }
-  }
-
-  jd->sys.direction_union = dir_union;
-  return true;
-}
-
 bool
 gc_job_manager_impl::submit_job(gc_job_desc *jd)
 {
@@ -563,13 +512,16 @@ gc_job_manager_impl::submit_job(gc_job_desc *jd)
     return false;
   }
 
-  if (!check_direct_args(jd, &jd->input))
+  // We check as much as we can here on the PPE side, so that the SPE
+  // doesn't have to.
+
+  if (!gc_check_direct_args(jd, &jd->input))
     return false;
 
-  if (!check_direct_args(jd, &jd->output))
+  if (!gc_check_direct_args(jd, &jd->output))
     return false;
 
-  if (!check_ea_args(jd, &jd->eaa))
+  if (!gc_check_ea_args(jd, &jd->eaa))
     return false;
 
   jd->status = JS_OK;
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,9 @@
  * add them here.
  */
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
 #include <qa_gcell_runtime.h>
 #include <qa_jd_stack.h>
 #include <qa_jd_queue.h>
@@ -35,8 +38,11 @@ qa_gcell_runtime::suite()
 {
   CppUnit::TestSuite	*s = new CppUnit::TestSuite("runtime");
 
+#ifdef GC_HAVE_SPE
+  // the lock free stack and queue are PowerPC only
   s->addTest(qa_jd_stack::suite());
   s->addTest(qa_jd_queue::suite());
+#endif
   s->addTest(qa_job_manager::suite());
 
   return s;
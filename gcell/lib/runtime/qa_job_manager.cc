@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -30,8 +30,90 @@
 
 #include <malloc.h>
 
+#ifdef GC_HAVE_SPE
 // handle to embedded SPU executable w/ QA routines
 extern spe_program_handle_t gcell_runtime_qa_spx;
+#endif
+
+/*
+ * Host versions of the QA routines in spu/gcell_runtime_qa.c.
+ * They work on the EA args in place.
+ */
+static void
+qa_nop(const gc_job_direct_args_t *input,
+       gc_job_direct_args_t *output,
+       const gc_job_ea_args_t *eaa)
+{
+}
+
+GC_DECLARE_HOST_PROC(qa_nop, "qa_nop");
+
+static void
+qa_sum_shorts(const gc_job_direct_args_t *input,
+	      gc_job_direct_args_t *output,
+	      const gc_job_ea_args_t *eaa)
+{
+  for (unsigned int i = 0; i < eaa->nargs; i++){
+    const short *p = (const short *) ea_to_ptr(eaa->arg[i].ea_addr);
+    int n = eaa->arg[i].get_size / sizeof(short);
+    int total = 0;
+    for (int j = 0; j < n; j++)
+      total += p[j];
+    output->arg[i].s32 = total;
+  }
+}
+
+GC_DECLARE_HOST_PROC(qa_sum_shorts, "qa_sum_shorts");
+
+static void
+qa_put_seq(const gc_job_direct_args_t *input,
+	   gc_job_direct_args_t *output,
+	   const gc_job_ea_args_t *eaa)
+{
+  int counter = input->arg[0].s32;
+
+  for (unsigned int i = 0; i < eaa->nargs; i++){
+    unsigned char *p = (unsigned char *) ea_to_ptr(eaa->arg[i].ea_addr);
+    int n = eaa->arg[i].put_size;
+    for (int j = 0; j < n; j++)
+      p[j] = counter++;
+  }
+}
+
+GC_DECLARE_HOST_PROC(qa_put_seq, "qa_put_seq");
+
+static void
+qa_copy(const gc_job_direct_args_t *input,
+	gc_job_direct_args_t *output,
+	const gc_job_ea_args_t *eaa)
+{
+  if (eaa->nargs != 2
+      || eaa->arg[0].direction != GCJD_DMA_PUT
+      || eaa->arg[1].direction != GCJD_DMA_GET){
+    output->arg[0].s32 = -1;
+    return;
+  }
+
+  output->arg[0].s32 = 0;
+  unsigned n = eaa->arg[0].put_size;
+  if (eaa->arg[1].get_size < n)
+    n = eaa->arg[1].get_size;
+
+  memcpy(ea_to_ptr(eaa->arg[0].ea_addr), ea_to_ptr(eaa->arg[1].ea_addr), n);
+}
+
+GC_DECLARE_HOST_PROC(qa_copy, "qa_copy");
+
+// Run the tests on the SPEs if we've got them, else on the host
+static void
+init_options(gc_jm_options &opts)
+{
+#ifdef GC_HAVE_SPE
+  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+#else
+  opts.use_host = true;
+#endif
+}
 
 #if 0
 static void
@@ -177,7 +259,7 @@ qa_job_manager::t1_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   mgr = gc_make_job_manager(&opts);
 }
 
@@ -186,7 +268,7 @@ qa_job_manager::t2_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 100;
   opts.gang_schedule = false;
   mgr = gc_make_job_manager(&opts);
@@ -202,7 +284,7 @@ qa_job_manager::t3_body()
 #if 0
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 100;
   opts.gang_schedule = true;
   CPPUNIT_ASSERT_THROW(mgr = gc_make_job_manager(&opts), std::out_of_range);
@@ -223,7 +305,7 @@ qa_job_manager::t4_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
   //mgr->set_debug(-1);
@@ -262,7 +344,7 @@ qa_job_manager::t5_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 0;	// use them all
   mgr = gc_make_job_manager(&opts);
   //mgr->set_debug(-1);
@@ -297,7 +379,7 @@ qa_job_manager::t6_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;	
   mgr = gc_make_job_manager(&opts);
   gc_proc_id_t gcp_qa_nop = mgr->lookup_proc("qa_nop");
@@ -375,7 +457,7 @@ qa_job_manager::t7_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
 
@@ -404,7 +486,7 @@ qa_job_manager::t8_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
   gc_job_desc *jd = mgr->alloc_job_desc();
@@ -437,7 +519,7 @@ qa_job_manager::t9_body()
   static const int M = 201;
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
   gc_job_desc *jd = mgr->alloc_job_desc();
@@ -548,7 +630,7 @@ qa_job_manager::t10_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
 
@@ -576,7 +658,7 @@ qa_job_manager::t11_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
   gc_job_desc *jd = mgr->alloc_job_desc();
@@ -611,7 +693,7 @@ qa_job_manager::t12_body()
   static const int M = 201;
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
   gc_job_desc *jd = mgr->alloc_job_desc();
@@ -659,7 +741,7 @@ qa_job_manager::t13_body()
 {
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
 
@@ -729,7 +811,7 @@ qa_job_manager::t14_body()
 
   gc_job_manager_sptr mgr;
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   mgr = gc_make_job_manager(&opts);
 
@@ -778,7 +860,7 @@ void
 qa_job_manager::t15_body()
 {
   gc_jm_options opts;
-  opts.program_handle = gc_program_handle_from_address(&gcell_runtime_qa_spx);
+  init_options(opts);
   opts.nspes = 1;
   gc_job_manager_sptr mgr = gc_make_job_manager(&opts);
 
@@ -0,0 +1,144 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Host versions of the "fwd_fft_1d_r2" and "inv_fft_1d_r2" procs in
+ * spu/gcs_fft_1d_r2.c, for use with the host job manager.  The EA
+ * args are as set up by gcp_fft_1d_r2_submit:
+ *
+ *   arg[0] out, arg[1] in, arg[2] twiddle (fft_length/4 of them),
+ *   arg[3] window (get_size is zero if there isn't one)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <gcell/gc_job_manager.h>
+#include <complex>
+#include <algorithm>
+#include <string.h>
+
+typedef std::complex<float> gr_complex_t;
+
+// swap the two halves of x in place
+static void
+fftshift(gr_complex_t *x, unsigned int n)
+{
+  std::swap_ranges(x, x + n/2, x + n/2);
+}
+
+/*
+ * In place radix-2 decimation in time FFT of x.
+ *
+ * W[k] = exp(-2*pi*j*k/n) is only given for k < n/4; the rest of the
+ * first half is W[k + n/4] = -j * W[k].  For the inverse transform the
+ * twiddles are conjugated.
+ */
+static void
+fft_1d_r2(gr_complex_t *x, const gr_complex_t *W,
+	  unsigned int log2_n, bool inverse)
+{
+  unsigned int n = 1 << log2_n;
+  unsigned int q = n / 4;
+
+  // bit reverse
+  for (unsigned int i = 1, j = 0; i < n; i++){
+    unsigned int bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j |= bit;
+    if (i < j)
+      std::swap(x[i], x[j]);
+  }
+
+  for (unsigned int m = 1; m < n; m <<= 1){
+    unsigned int stride = n / (2 * m);
+    for (unsigned int k = 0; k < m; k++){
+      unsigned int t = k * stride;
+      gr_complex_t w;
+      if (t == 0)		// W may be empty when n < 4
+	w = 1;
+      else if (t < q)
+	w = W[t];
+      else
+	w = gr_complex_t(W[t - q].imag(), -W[t - q].real());
+      if (inverse)
+	w = std::conj(w);
+
+      for (unsigned int i = k; i < n; i += 2 * m){
+	gr_complex_t a = x[i];
+	gr_complex_t b = x[i + m] * w;
+	x[i] = a + b;
+	x[i + m] = a - b;
+      }
+    }
+  }
+}
+
+static void
+fft_1d_r2_proc(const gc_job_direct_args_t *input,
+	       const gc_job_ea_args_t *eaa, bool inverse)
+{
+  gr_complex_t *out = (gr_complex_t *) ea_to_ptr(eaa->arg[0].ea_addr);
+  const gr_complex_t *in = (const gr_complex_t *) ea_to_ptr(eaa->arg[1].ea_addr);
+  const gr_complex_t *twiddle = (const gr_complex_t *) ea_to_ptr(eaa->arg[2].ea_addr);
+  const float *window = (const float *) ea_to_ptr(eaa->arg[3].ea_addr);
+
+  unsigned int log2_fft_length = input->arg[0].u32;
+  bool shift = input->arg[1].u32 != 0;
+  unsigned int n = 1 << log2_fft_length;
+
+  // unlike the SPE, we mustn't scribble on the caller's input
+  if (out != in)
+    memcpy(out, in, n * sizeof(gr_complex_t));
+
+  if (eaa->arg[3].get_size)
+    for (unsigned int i = 0; i < n; i++)
+      out[i] *= window[i];
+
+  if (shift && inverse)
+    fftshift(out, n);
+
+  fft_1d_r2(out, twiddle, log2_fft_length, inverse);
+
+  if (shift && !inverse)
+    fftshift(out, n);
+}
+
+static void
+gch_fwd_fft_1d_r2(const gc_job_direct_args_t *input,
+		  gc_job_direct_args_t *output,
+		  const gc_job_ea_args_t *eaa)
+{
+  fft_1d_r2_proc(input, eaa, false);
+}
+
+GC_DECLARE_HOST_PROC(gch_fwd_fft_1d_r2, "fwd_fft_1d_r2");
+
+static void
+gch_inv_fft_1d_r2(const gc_job_direct_args_t *input,
+		  gc_job_direct_args_t *output,
+		  const gc_job_ea_args_t *eaa)
+{
+  fft_1d_r2_proc(input, eaa, true);
+}
+
+GC_DECLARE_HOST_PROC(gch_inv_fft_1d_r2, "inv_fft_1d_r2");
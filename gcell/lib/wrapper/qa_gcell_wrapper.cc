@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,9 @@
  * add them here.
  */
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
 #include <qa_gcell_wrapper.h>
 #include <qa_gcell_general.h>
 //#include <qa_gcp_fft_1d_r2.h>
@@ -34,7 +37,9 @@ qa_gcell_wrapper::suite()
 {
   CppUnit::TestSuite	*s = new CppUnit::TestSuite("wrapper");
 
+#ifdef GC_HAVE_SPE
   s->addTest(qa_gcell_general::suite());
+#endif
   //s->addTest(qa_gcp_fft_1d_r2::suite());
 
   return s;
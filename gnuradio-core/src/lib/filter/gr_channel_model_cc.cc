@@ -0,0 +1,197 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gr_channel_model_cc.h>
+#include <gr_io_signature.h>
+#include <gri_mmse_fir_interpolator_cc.h>
+#include <gr_fir_ccc.h>
+#include <gr_fir_util.h>
+#include <gr_expj.h>
+#include <algorithm>
+#include <stdexcept>
+#include <math.h>
+
+gr_channel_model_cc_sptr
+gr_make_channel_model_cc (double noise_voltage, double frequency_offset,
+			  double epsilon, const std::vector<gr_complex> &taps,
+			  long noise_seed)
+{
+  return gr_channel_model_cc_sptr (new gr_channel_model_cc (noise_voltage,
+							    frequency_offset,
+							    epsilon, taps,
+							    noise_seed));
+}
+
+gr_channel_model_cc::gr_channel_model_cc (double noise_voltage,
+					  double frequency_offset,
+					  double epsilon,
+					  const std::vector<gr_complex> &taps,
+					  long noise_seed)
+  : gr_block ("channel_model_cc",
+	      gr_make_io_signature (1, 1, sizeof (gr_complex)),
+	      gr_make_io_signature (1, 1, sizeof (gr_complex))),
+    d_mu (0), d_mu_inc (epsilon), d_interp (new gri_mmse_fir_interpolator_cc ()),
+    d_fir (0), d_updated (false), d_phase (0),
+    d_noise_voltage (noise_voltage), d_rng (noise_seed),
+    d_noise (2 * CHUNK)
+{
+  if (epsilon <= 0)
+    throw std::out_of_range ("timing offset (epsilon) must be > 0");
+  if (taps.empty ())
+    throw std::invalid_argument ("gr_channel_model_cc: taps must not be empty");
+
+  d_fir = gr_fir_util::create_gr_fir_ccc (taps);
+  d_buf.resize (d_fir->ntaps () - 1 + CHUNK);
+
+  set_frequency_offset (frequency_offset);
+  set_relative_rate (1.0 / epsilon);
+}
+
+gr_channel_model_cc::~gr_channel_model_cc ()
+{
+  delete d_fir;
+  delete d_interp;
+}
+
+void
+gr_channel_model_cc::set_frequency_offset (double frequency_offset)
+{
+  d_frequency_offset = frequency_offset;
+  d_phase_inc = 2 * M_PI * frequency_offset;
+  d_rotator.set_phase_incr (gr_expj (d_phase_inc));
+}
+
+void
+gr_channel_model_cc::set_taps (const std::vector<gr_complex> &taps)
+{
+  if (taps.empty ())
+    throw std::invalid_argument ("gr_channel_model_cc: taps must not be empty");
+
+  d_new_taps = taps;
+  d_updated = true;
+}
+
+void
+gr_channel_model_cc::set_timing_offset (double epsilon)
+{
+  if (epsilon <= 0)
+    throw std::out_of_range ("timing offset (epsilon) must be > 0");
+
+  d_mu_inc = epsilon;
+  set_relative_rate (1.0 / epsilon);
+}
+
+/*
+ * Install the new taps, keeping as much of the multipath filter's
+ * history as the new length needs so the output doesn't glitch.
+ */
+void
+gr_channel_model_cc::update_taps ()
+{
+  int old_nhist = d_fir->ntaps () - 1;
+  d_fir->set_taps (d_new_taps);
+  int nhist = d_fir->ntaps () - 1;
+
+  std::vector<gr_complex> buf (nhist + CHUNK);
+  int keep = std::min (old_nhist, nhist);
+  std::copy (d_buf.begin () + old_nhist - keep, d_buf.begin () + old_nhist,
+	     buf.begin () + nhist - keep);
+  d_buf.swap (buf);
+
+  d_updated = false;
+}
+
+void
+gr_channel_model_cc::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+{
+  ninput_items_required[0] =
+    (int) ceil ((noutput_items * d_mu_inc) + d_interp->ntaps ());
+}
+
+int
+gr_channel_model_cc::general_work (int noutput_items,
+				   gr_vector_int &ninput_items,
+				   gr_vector_const_void_star &input_items,
+				   gr_vector_void_star &output_items)
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  if (d_updated)
+    update_taps ();
+
+  int nhist = d_fir->ntaps () - 1;
+  int ii = 0;				// input index
+
+  for (int oo = 0; oo < noutput_items; ){
+    int n = std::min (noutput_items - oo, (int) CHUNK);
+    gr_complex *buf = &d_buf[nhist];
+
+    // timing offset, into d_buf behind the filter history
+    if (d_mu == 0 && d_mu_inc == 1){
+      // no offset; the mu = 0 taps are a unit impulse at ntaps/2 - 1
+      std::copy (&in[ii + d_interp->ntaps () / 2 - 1],
+		 &in[ii + d_interp->ntaps () / 2 - 1 + n], buf);
+      ii += n;
+    }
+    else {
+      for (int k = 0; k < n; k++){
+	buf[k] = d_interp->interpolate (&in[ii], d_mu);
+
+	double s = d_mu + d_mu_inc;
+	double f = floor (s);
+	d_mu = s - f;
+	ii += (int) f;
+      }
+    }
+
+    // multipath, then slide the history along for the next chunk
+    d_fir->filterN (&out[oo], &d_buf[0], n);
+    std::copy (d_buf.begin () + n, d_buf.begin () + n + nhist, d_buf.begin ());
+
+    // frequency offset and noise.  The rotator's phase is restarted
+    // from d_phase each chunk so rounding in the increment can't add up
+    d_rotator.set_phase (gr_expj (d_phase));
+    d_phase = fmod (d_phase + n * d_phase_inc, 2 * M_PI);
+
+    if (d_noise_voltage != 0){
+      float v = d_noise_voltage;
+      d_rng.gaussian (&d_noise[0], 2 * n);
+      for (int k = 0; k < n; k++)
+	out[oo + k] = d_rotator.rotate (out[oo + k])
+	  + gr_complex (v * d_noise[2 * k], v * d_noise[2 * k + 1]);
+    }
+    else {
+      for (int k = 0; k < n; k++)
+	out[oo + k] = d_rotator.rotate (out[oo + k]);
+    }
+
+    oo += n;
+  }
+
+  consume_each (ii);
+  return noutput_items;
+}
@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_CHANNEL_MODEL_CC_H
+#define INCLUDED_GR_CHANNEL_MODEL_CC_H
+
+#include <gr_block.h>
+#include <gr_rotator.h>
+#include <gri_fast_random.h>
+#include <vector>
+
+class gri_mmse_fir_interpolator_cc;
+class gr_fir_ccc;
+
+class gr_channel_model_cc;
+typedef boost::shared_ptr<gr_channel_model_cc> gr_channel_model_cc_sptr;
+
+gr_channel_model_cc_sptr
+gr_make_channel_model_cc (double noise_voltage = 0.0,
+			  double frequency_offset = 0.0,
+			  double epsilon = 1.0,
+			  const std::vector<gr_complex> &taps = std::vector<gr_complex>(1, 1),
+			  long noise_seed = 3021);
+
+/*!
+ * \brief channel simulator in a single block
+ * \ingroup misc_blk
+ *
+ * Does what gr_fractional_interpolator_cc, gr_fir_filter_ccc,
+ * multiplying by a gr_sig_source_c and adding a gr_noise_source_c do,
+ * in that order, but a buffer at a time without going through the
+ * scheduler between each step:
+ *
+ *   timing offset:	resample by \p epsilon with the MMSE interpolator
+ *   multipath:		filter with \p taps
+ *   frequency offset:	rotate by \p frequency_offset cycles per sample
+ *   AWGN:		add \p noise_voltage * (N(0,1) + j N(0,1))
+ *
+ * The noise comes from gri_fast_random, so a given \p noise_seed gives
+ * the same output however the scheduler chops up the stream.
+ */
+class gr_channel_model_cc : public gr_block
+{
+  friend gr_channel_model_cc_sptr
+  gr_make_channel_model_cc (double noise_voltage, double frequency_offset,
+			    double epsilon, const std::vector<gr_complex> &taps,
+			    long noise_seed);
+
+  static const int CHUNK = 1024;	// samples per pass, so it all stays in cache
+
+  float				d_mu;
+  float				d_mu_inc;
+  gri_mmse_fir_interpolator_cc	*d_interp;
+
+  gr_fir_ccc			*d_fir;
+  std::vector<gr_complex>	d_new_taps;
+  bool				d_updated;
+
+  gr_rotator			d_rotator;
+  double			d_frequency_offset;
+  double			d_phase;	// at the start of the next chunk
+  double			d_phase_inc;
+
+  float				d_noise_voltage;
+  gri_fast_random		d_rng;
+
+  // the last ntaps - 1 interpolated samples, then the current chunk
+  std::vector<gr_complex>	d_buf;
+  std::vector<float>		d_noise;
+
+  gr_channel_model_cc (double noise_voltage, double frequency_offset,
+		       double epsilon, const std::vector<gr_complex> &taps,
+		       long noise_seed);
+
+  void update_taps ();
+
+ public:
+  ~gr_channel_model_cc ();
+
+  void set_noise_voltage (double noise_voltage) { d_noise_voltage = noise_voltage; }
+  void set_frequency_offset (double frequency_offset);
+  void set_taps (const std::vector<gr_complex> &taps);
+  void set_timing_offset (double epsilon);
+
+  double noise_voltage () const { return d_noise_voltage; }
+  double frequency_offset () const { return d_frequency_offset; }
+  double timing_offset () const { return d_mu_inc; }
+
+  void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+  int general_work (int noutput_items,
+		    gr_vector_int &ninput_items,
+		    gr_vector_const_void_star &input_items,
+		    gr_vector_void_star &output_items);
+};
+
+#endif /* INCLUDED_GR_CHANNEL_MODEL_CC_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,6 +29,9 @@
 #include <assert.h>
 #include <cmath>
 #include "interpolator_taps.h"
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 gri_mmse_fir_interpolator_cc::gri_mmse_fir_interpolator_cc ()
 {
@@ -38,6 +41,12 @@ gri_mmse_fir_interpolator_cc::gri_mmse_fir_interpolator_cc ()
     std::vector<float> t (&taps[i][0], &taps[i][NTAPS]);
     filters[i] = gr_fir_util::create_gr_fir_ccf (t);
   }
+
+  // reversed, as the gr_fir_ccf's store them, and doubled up for re and im
+  d_ctaps.resize ((NSTEPS + 1) * 2 * NTAPS);
+  for (int i = 0; i < NSTEPS + 1; i++)
+    for (int j = 0; j < NTAPS; j++)
+      d_ctaps[2 * (i * NTAPS + j)] = d_ctaps[2 * (i * NTAPS + j) + 1] = taps[i][NTAPS - 1 - j];
 }
 
 gri_mmse_fir_interpolator_cc::~gri_mmse_fir_interpolator_cc ()
@@ -69,3 +78,37 @@ gri_mmse_fir_interpolator_cc::interpolate (const gr_complex input[], float mu)
   gr_complex r = filters[imu]->filter (input);
   return r;
 }
+
+void
+gri_mmse_fir_interpolator_cc::interpolate_n (gr_complex output[],
+					     const gr_complex input[],
+					     const int offset[],
+					     const float mu[], int n)
+{
+  for (int k = 0; k < n; k++){
+    int	imu = (int) rint (mu[k] * NSTEPS);
+
+    assert (imu >= 0);
+    assert (imu <= NSTEPS);
+
+    const float *x = (const float *) &input[offset[k]];
+    const float *t = &d_ctaps[imu * 2 * NTAPS];
+
+#ifdef __SSE__
+    // two complex samples per register; re and im sums end up in
+    // alternate lanes
+    __m128 acc = _mm_mul_ps (_mm_loadu_ps (x), _mm_loadu_ps (t));
+    for (int j = 4; j < 2 * NTAPS; j += 4)
+      acc = _mm_add_ps (acc, _mm_mul_ps (_mm_loadu_ps (x + j), _mm_loadu_ps (t + j)));
+    acc = _mm_add_ps (acc, _mm_movehl_ps (acc, acc));
+    _mm_storel_pi ((__m64 *) &output[k], acc);
+#else
+    float re = 0, im = 0;
+    for (int j = 0; j < 2 * NTAPS; j += 2){
+      re += x[j] * t[j];
+      im += x[j + 1] * t[j + 1];
+    }
+    output[k] = gr_complex (re, im);
+#endif
+  }
+}
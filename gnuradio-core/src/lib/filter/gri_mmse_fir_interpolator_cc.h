@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002,2007 Free Software Foundation, Inc.
+ * Copyright 2002,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -61,8 +61,19 @@ public:
    */
   gr_complex interpolate (const gr_complex input[], float mu);
 
+  /*!
+   * \brief compute n interpolated output values at once.
+   *
+   * output[k] = interpolate (&input[offset[k]], mu[k]) for k in [0, n),
+   * without the per-output virtual call, using SSE where available.
+   * Results may differ from interpolate() in the last bit.
+   */
+  void interpolate_n (gr_complex output[], const gr_complex input[],
+		      const int offset[], const float mu[], int n);
+
 protected:
   std::vector<gr_fir_ccf *>	filters;
+  std::vector<float>		d_ctaps;	// each tap twice, for complex input
 };
 
 
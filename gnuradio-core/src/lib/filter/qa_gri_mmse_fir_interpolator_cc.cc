@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002,2007 Free Software Foundation, Inc.
+ * Copyright 2002,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -116,3 +116,34 @@ qa_gri_mmse_fir_interpolator_cc::t2()
 {
   CPPUNIT_ASSERT_THROW(t2_body(), std::invalid_argument);
 }
+
+/*
+ * interpolate_n gives the same answers as interpolate
+ */
+void
+qa_gri_mmse_fir_interpolator_cc::t3()
+{
+  static const unsigned	N = 100;
+  gr_complex input[N + 10] __attribute__ ((aligned (8)));
+
+  for (unsigned i = 0; i < NELEM(input); i++)
+    input[i] = test_fcn ((double) i);
+
+  gri_mmse_fir_interpolator_cc	intr;
+  float inv_nsteps = 1.0 / intr.nsteps ();
+
+  int offset[N];
+  float mu[N];
+  gr_complex actual[N];
+  for (unsigned k = 0; k < N; k++){
+    offset[k] = (k * 7) % N;
+    mu[k] = ((k * 37) % (intr.nsteps () + 1)) * inv_nsteps;
+  }
+
+  intr.interpolate_n (actual, input, offset, mu, N);
+
+  for (unsigned k = 0; k < N; k++){
+    gr_complex expected = intr.interpolate (&input[offset[k]], mu[k]);
+    CPPUNIT_ASSERT_COMPLEXES_EQUAL (expected, actual[k], 1e-5);
+  }
+}
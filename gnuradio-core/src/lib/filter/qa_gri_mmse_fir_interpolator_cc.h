@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002,2007 Free Software Foundation, Inc.
+ * Copyright 2002,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -30,12 +30,14 @@ class qa_gri_mmse_fir_interpolator_cc : public CppUnit::TestCase {
   CPPUNIT_TEST_SUITE(qa_gri_mmse_fir_interpolator_cc);
   CPPUNIT_TEST(t1);
   // CPPUNIT_TEST(t2);
+  CPPUNIT_TEST(t3);
   CPPUNIT_TEST_SUITE_END();
 
  private:
   void t1();
   void t2();
   void t2_body();
+  void t3();
 
 };
 
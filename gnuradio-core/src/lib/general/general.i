@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2005,2006,2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2004,2005,2006,2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -63,12 +63,14 @@
 #include <gr_agc_cc.h>
 #include <gr_agc2_ff.h>
 #include <gr_agc2_cc.h>
+#include <gr_agc_squelch_vcc.h>
 #include <gr_rms_cf.h>
 #include <gr_rms_ff.h>
 #include <gr_nlog10_ff.h>
 #include <gr_fake_channel_coder_pp.h>
 #include <gr_throttle.h>
 #include <gr_mpsk_receiver_cc.h>
+#include <gr_mpsk_sync_cc.h>
 #include <gr_stream_mux.h>
 #include <gr_stream_to_streams.h>
 #include <gr_streams_to_stream.h>
@@ -110,12 +112,14 @@
 #include <gr_test.h>
 #include <gr_unpack_k_bits_bb.h>
 #include <gr_correlate_access_code_bb.h>
+#include <gr_correlate_access_code_packed_bb.h>
 #include <gr_diff_phasor_cc.h>
 #include <gr_constellation_decoder_cb.h>
 #include <gr_binary_slicer_fb.h>
 #include <gr_diff_encoder_bb.h>
 #include <gr_diff_decoder_bb.h>
 #include <gr_framer_sink_1.h>
+#include <gr_framer_sink_packed.h>
 #include <gr_map_bb.h>
 #include <gr_feval.h>
 #include <gr_pwr_squelch_cc.h>
@@ -185,12 +189,14 @@
 %include "gr_agc_cc.i"
 %include "gr_agc2_ff.i"
 %include "gr_agc2_cc.i"
+%include "gr_agc_squelch_vcc.i"
 %include "gr_rms_cf.i"
 %include "gr_rms_ff.i"
 %include "gr_nlog10_ff.i"
 %include "gr_fake_channel_coder_pp.i"
 %include "gr_throttle.i"
 %include "gr_mpsk_receiver_cc.i"
+%include "gr_mpsk_sync_cc.i"
 %include "gr_stream_mux.i"
 %include "gr_stream_to_streams.i"
 %include "gr_streams_to_stream.i"
@@ -232,12 +238,14 @@
 %include "gr_test.i"
 %include "gr_unpack_k_bits_bb.i"
 %include "gr_correlate_access_code_bb.i"
+%include "gr_correlate_access_code_packed_bb.i"
 %include "gr_diff_phasor_cc.i"
 %include "gr_constellation_decoder_cb.i"
 %include "gr_binary_slicer_fb.i"
 %include "gr_diff_encoder_bb.i"
 %include "gr_diff_decoder_bb.i"
 %include "gr_framer_sink_1.i"
+%include "gr_framer_sink_packed.i"
 %include "gr_map_bb.i"
 %include "gr_feval.i"
 %include "gr_pwr_squelch_cc.i"
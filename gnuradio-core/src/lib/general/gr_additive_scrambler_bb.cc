@@ -51,10 +51,18 @@ gr_additive_scrambler_bb::work(int noutput_items,
   const unsigned char *in = (const unsigned char *) input_items[0];
   unsigned char *out = (unsigned char *) output_items[0];
 
-  for (int i = 0; i < noutput_items; i++) {
-    out[i] = in[i]^d_lfsr.next_bit();
+  for (int i = 0; i < noutput_items; ) {
+    int n = noutput_items - i;
+    if (d_count > 0 && n > d_count - d_bits)
+      n = d_count - d_bits;		// up to the next reset
+
+    d_lfsr.next_bits(&out[i], n);
+    for (int k = i; k < i + n; k++)
+      out[k] ^= in[k];
+    i += n;
+
     if (d_count > 0) {
-      if (++d_bits == d_count) {
+      if ((d_bits += n) == d_count) {
 	d_lfsr.reset();
 	d_bits = 0;
       }
@@ -0,0 +1,213 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gr_agc_squelch_vcc.h>
+#include <gr_io_signature.h>
+#include <stdexcept>
+#include <algorithm>
+#include <math.h>
+#include <float.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+gr_agc_squelch_vcc_sptr
+gr_make_agc_squelch_vcc (int nchans, double db, double alpha,
+			 float attack_rate, float decay_rate,
+			 float reference, float gain, float max_gain)
+{
+  return gr_agc_squelch_vcc_sptr (new gr_agc_squelch_vcc (nchans, db, alpha,
+							  attack_rate, decay_rate,
+							  reference, gain, max_gain));
+}
+
+gr_agc_squelch_vcc::gr_agc_squelch_vcc (int nchans, double db, double alpha,
+					float attack_rate, float decay_rate,
+					float reference, float gain, float max_gain)
+  : gr_sync_block ("agc_squelch_vcc",
+		   gr_make_io_signature (1, 1, nchans * sizeof (gr_complex)),
+		   gr_make_io_signature (1, 1, nchans * sizeof (gr_complex))),
+    d_nchans (nchans),
+    d_attack_rate (attack_rate), d_decay_rate (decay_rate),
+    d_reference (reference), d_max_gain (max_gain),
+    d_pwr (nchans, 0), d_gain (nchans, gain)
+{
+  if (nchans < 1)
+    throw std::invalid_argument ("gr_agc_squelch_vcc: nchans must be >= 1");
+
+  set_threshold (db);
+  set_alpha (alpha);
+}
+
+double
+gr_agc_squelch_vcc::threshold () const
+{
+  return 10 * log10 (d_threshold);
+}
+
+void
+gr_agc_squelch_vcc::set_threshold (double db)
+{
+  d_threshold = pow (10.0, db / 10);
+}
+
+void
+gr_agc_squelch_vcc::set_alpha (double alpha)
+{
+  if (alpha < 0 || alpha > 1)
+    throw std::out_of_range ("gr_agc_squelch_vcc: alpha must be in [0, 1]");
+
+  d_alpha = alpha;
+  d_one_minus_alpha = 1.0 - alpha;
+}
+
+void
+gr_agc_squelch_vcc::set_gain (float gain)
+{
+  std::fill (d_gain.begin (), d_gain.end (), gain);
+}
+
+/*
+ * One channel: gr_pwr_squelch_cc::update_state and mute, then
+ * gri_agc2_cc::scale.  The channel's samples are nchans apart.
+ */
+void
+gr_agc_squelch_vcc::work_channel (gr_complex *out, const gr_complex *in, int n, int chan)
+{
+  float pwr = d_pwr[chan];
+  float gain = d_gain[chan];
+  float max_gain = d_max_gain > 0.0 ? d_max_gain : FLT_MAX;
+
+  for (int k = 0; k < n; k++){
+    float re = in[k * d_nchans + chan].real ();
+    float im = in[k * d_nchans + chan].imag ();
+    float p = re * re + im * im;
+
+    pwr = d_alpha * p + d_one_minus_alpha * pwr;
+    if (pwr < d_threshold)
+      re = im = p = 0;
+
+    out[k * d_nchans + chan] = gr_complex (re * gain, im * gain);
+
+    float tmp = fabsf (gain) * sqrtf (p) - d_reference;
+    float rate = tmp > gain ? d_attack_rate : d_decay_rate;
+    gain -= tmp * rate;
+    if (gain < 0.0)
+      gain = 10e-5;
+    gain = std::min (gain, max_gain);
+  }
+
+  d_pwr[chan] = pwr;
+  d_gain[chan] = gain;
+}
+
+#ifdef __SSE__
+/*
+ * The same for channels chan to chan + 3, one in each lane.  Each item
+ * has their four samples next to each other; split them into a vector
+ * of real parts and one of imaginary parts, and put them back together
+ * on the way out.  The branches above become masks.
+ */
+void
+gr_agc_squelch_vcc::work_4_channels (gr_complex *out, const gr_complex *in, int n, int chan)
+{
+  static const union { unsigned int i[4]; __m128 v; } abs_mask =
+    {{ 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff }};
+
+  const __m128 alpha = _mm_set1_ps (d_alpha);
+  const __m128 one_minus_alpha = _mm_set1_ps (d_one_minus_alpha);
+  const __m128 threshold = _mm_set1_ps (d_threshold);
+  const __m128 reference = _mm_set1_ps (d_reference);
+  const __m128 attack_rate = _mm_set1_ps (d_attack_rate);
+  const __m128 decay_rate = _mm_set1_ps (d_decay_rate);
+  const __m128 min_gain = _mm_set1_ps (10e-5);
+  const __m128 max_gain = _mm_set1_ps (d_max_gain > 0.0 ? d_max_gain : FLT_MAX);
+  const __m128 zero = _mm_setzero_ps ();
+
+  __m128 pwr = _mm_loadu_ps (&d_pwr[chan]);
+  __m128 gain = _mm_loadu_ps (&d_gain[chan]);
+
+  const float *ip = (const float *) (in + chan);
+  float *op = (float *) (out + chan);
+
+  for (int k = 0; k < n; k++){
+    __m128 a = _mm_loadu_ps (ip);
+    __m128 b = _mm_loadu_ps (ip + 4);
+    __m128 re = _mm_shuffle_ps (a, b, _MM_SHUFFLE (2,0,2,0));
+    __m128 im = _mm_shuffle_ps (a, b, _MM_SHUFFLE (3,1,3,1));
+    __m128 p = _mm_add_ps (_mm_mul_ps (re, re), _mm_mul_ps (im, im));
+
+    pwr = _mm_add_ps (_mm_mul_ps (alpha, p), _mm_mul_ps (one_minus_alpha, pwr));
+    __m128 open = _mm_cmpnlt_ps (pwr, threshold);
+    re = _mm_and_ps (open, re);
+    im = _mm_and_ps (open, im);
+    p = _mm_and_ps (open, p);
+
+    __m128 ore = _mm_mul_ps (re, gain);
+    __m128 oim = _mm_mul_ps (im, gain);
+    _mm_storeu_ps (op, _mm_unpacklo_ps (ore, oim));
+    _mm_storeu_ps (op + 4, _mm_unpackhi_ps (ore, oim));
+
+    __m128 tmp = _mm_sub_ps (_mm_mul_ps (_mm_and_ps (gain, abs_mask.v), _mm_sqrt_ps (p)),
+			     reference);
+    __m128 attack = _mm_cmpgt_ps (tmp, gain);
+    __m128 rate = _mm_or_ps (_mm_and_ps (attack, attack_rate),
+			     _mm_andnot_ps (attack, decay_rate));
+    gain = _mm_sub_ps (gain, _mm_mul_ps (tmp, rate));
+    __m128 negative = _mm_cmplt_ps (gain, zero);
+    gain = _mm_or_ps (_mm_and_ps (negative, min_gain), _mm_andnot_ps (negative, gain));
+    gain = _mm_min_ps (gain, max_gain);
+
+    ip += 2 * d_nchans;
+    op += 2 * d_nchans;
+  }
+
+  _mm_storeu_ps (&d_pwr[chan], pwr);
+  _mm_storeu_ps (&d_gain[chan], gain);
+}
+#endif
+
+int
+gr_agc_squelch_vcc::work (int noutput_items,
+			  gr_vector_const_void_star &input_items,
+			  gr_vector_void_star &output_items)
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  // A channel at a time down all the items, so its state stays in
+  // registers.
+  int chan = 0;
+#ifdef __SSE__
+  for (; chan + 4 <= d_nchans; chan += 4)
+    work_4_channels (out, in, noutput_items, chan);
+#endif
+  for (; chan < d_nchans; chan++)
+    work_channel (out, in, noutput_items, chan);
+
+  return noutput_items;
+}
@@ -0,0 +1,108 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_AGC_SQUELCH_VCC_H
+#define INCLUDED_GR_AGC_SQUELCH_VCC_H
+
+#include <gr_sync_block.h>
+#include <vector>
+
+class gr_agc_squelch_vcc;
+typedef boost::shared_ptr<gr_agc_squelch_vcc> gr_agc_squelch_vcc_sptr;
+
+gr_agc_squelch_vcc_sptr
+gr_make_agc_squelch_vcc (int nchans, double db, double alpha = 0.0001,
+			 float attack_rate = 1e-1, float decay_rate = 1e-2,
+			 float reference = 1.0, float gain = 1.0, float max_gain = 0.0);
+
+/*!
+ * \brief Power squelch and AGC on every channel of a channelizer's output
+ * \ingroup level_blk
+ *
+ * Each item is a vector of \p nchans samples, one per channel, the way
+ * gr_pfb_channelizer_ccf puts them out.  Every channel gets what
+ * gr_pwr_squelch_cc (db, alpha) followed by gr_agc2_cc (attack_rate,
+ * decay_rate, reference, gain, max_gain) would do to it on its own:
+ * while the channel's average power is below \p db its output is
+ * zero, and its AGC sees the zeros.  There is no ramp and no gating,
+ * since each output vector has to have every channel in it.
+ *
+ * The channels are run four at a time with SSE, one to a lane, so the
+ * sqrt and the gain update for four channels cost what they do for
+ * one.  The average power is kept in single precision rather than
+ * gr_pwr_squelch_cc's double.
+ */
+class gr_agc_squelch_vcc : public gr_sync_block
+{
+  friend gr_agc_squelch_vcc_sptr
+  gr_make_agc_squelch_vcc (int nchans, double db, double alpha,
+			   float attack_rate, float decay_rate,
+			   float reference, float gain, float max_gain);
+
+  int			d_nchans;
+  float			d_threshold;	// power, not dB
+  float			d_alpha;
+  float			d_one_minus_alpha;
+  float			d_attack_rate;
+  float			d_decay_rate;
+  float			d_reference;
+  float			d_max_gain;
+  std::vector<float>	d_pwr;		// per channel
+  std::vector<float>	d_gain;		// per channel
+
+  gr_agc_squelch_vcc (int nchans, double db, double alpha,
+		      float attack_rate, float decay_rate,
+		      float reference, float gain, float max_gain);
+
+  void work_channel (gr_complex *out, const gr_complex *in, int n, int chan);
+  void work_4_channels (gr_complex *out, const gr_complex *in, int n, int chan);
+
+ public:
+  int nchans () const { return d_nchans; }
+
+  double threshold () const;
+  void set_threshold (double db);
+  void set_alpha (double alpha);
+
+  float attack_rate () const { return d_attack_rate; }
+  float decay_rate () const { return d_decay_rate; }
+  float reference () const { return d_reference; }
+  float max_gain () const { return d_max_gain; }
+
+  void set_attack_rate (float rate) { d_attack_rate = rate; }
+  void set_decay_rate (float rate) { d_decay_rate = rate; }
+  void set_reference (float reference) { d_reference = reference; }
+  void set_max_gain (float max_gain) { d_max_gain = max_gain; }
+
+  //! the current gain of channel \p chan
+  float gain (int chan) const { return d_gain[chan]; }
+  //! set the gain of every channel
+  void set_gain (float gain);
+  //! true if channel \p chan is being passed through
+  bool unmuted (int chan) const { return !(d_pwr[chan] < d_threshold); }
+
+  int work (int noutput_items,
+	    gr_vector_const_void_star &input_items,
+	    gr_vector_void_star &output_items);
+};
+
+#endif /* INCLUDED_GR_AGC_SQUELCH_VCC_H */
@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+GR_SWIG_BLOCK_MAGIC(gr,agc_squelch_vcc);
+
+gr_agc_squelch_vcc_sptr
+gr_make_agc_squelch_vcc (int nchans, double db, double alpha = 0.0001,
+			 float attack_rate = 1e-1, float decay_rate = 1e-2,
+			 float reference = 1.0, float gain = 1.0, float max_gain = 0.0);
+
+class gr_agc_squelch_vcc : public gr_sync_block
+{
+  gr_agc_squelch_vcc (int nchans, double db, double alpha,
+		      float attack_rate, float decay_rate,
+		      float reference, float gain, float max_gain);
+
+ public:
+  int nchans () const;
+
+  double threshold () const;
+  void set_threshold (double db);
+  void set_alpha (double alpha);
+
+  float attack_rate () const;
+  float decay_rate () const;
+  float reference () const;
+  float max_gain () const;
+
+  void set_attack_rate (float rate);
+  void set_decay_rate (float rate);
+  void set_reference (float reference);
+  void set_max_gain (float max_gain);
+
+  float gain (int chan) const;
+  void set_gain (float gain);
+  bool unmuted (int chan) const;
+};
@@ -0,0 +1,96 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gr_correlate_access_code_packed_bb.h>
+#include <gr_io_signature.h>
+#include <string.h>
+
+gr_correlate_access_code_packed_bb_sptr
+gr_make_correlate_access_code_packed_bb (const std::string &access_code, int threshold)
+{
+  return gr_correlate_access_code_packed_bb_sptr (new gr_correlate_access_code_packed_bb (access_code, threshold));
+}
+
+
+gr_correlate_access_code_packed_bb::gr_correlate_access_code_packed_bb (
+  const std::string &access_code, int threshold)
+  : gr_sync_block ("correlate_access_code_packed_bb",
+		   gr_make_io_signature (1, 1, sizeof(char)),
+		   gr_make_io_signature (2, 2, sizeof(char))),
+    d_correlator(access_code, threshold), d_carry(0)
+{
+}
+
+gr_correlate_access_code_packed_bb::~gr_correlate_access_code_packed_bb ()
+{
+}
+
+bool
+gr_correlate_access_code_packed_bb::set_access_code(
+  const std::string &access_code)
+{
+  return d_correlator.set_access_code(access_code);
+}
+
+int
+gr_correlate_access_code_packed_bb::work (int noutput_items,
+					  gr_vector_const_void_star &input_items,
+					  gr_vector_void_star &output_items)
+{
+  const unsigned char *in = (const unsigned char *) input_items[0];
+  unsigned char *out = (unsigned char *) output_items[0];
+  unsigned char *flags = (unsigned char *) output_items[1];
+  int i = 0;
+
+  memcpy (out, in, noutput_items);
+
+  // A hit at bit j flags bit j + 1, so the flags are the hits shifted
+  // right one, with the last bit's hit carried into the next chunk.
+
+  for (; i + 8 <= noutput_items; i += 8){
+    uint64_t word = 0;
+    for (int k = 0; k < 8; k++)
+      word = (word << 8) | in[i + k];
+
+    uint64_t hits = d_correlator.hits64(word);
+    d_correlator.shift64(word);
+
+    uint64_t f = (hits >> 1) | ((uint64_t) d_carry << 63);
+    d_carry = hits & 1;
+    for (int k = 7; k >= 0; k--, f >>= 8)
+      flags[i + k] = f & 0xff;
+  }
+
+  for (; i < noutput_items; i++){
+    unsigned int hits = d_correlator.hits8(in[i]);
+    d_correlator.shift8(in[i]);
+
+    flags[i] = (hits >> 1) | (d_carry << 7);
+    d_carry = hits & 1;
+  }
+
+  return noutput_items;
+}
@@ -0,0 +1,58 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+GR_SWIG_BLOCK_MAGIC(gr,correlate_access_code_packed_bb);
+
+/*!
+ * \param access_code is represented with 1 byte per bit, e.g., "010101010111000100"
+ * \param threshold maximum number of bits that may be wrong
+ */
+gr_correlate_access_code_packed_bb_sptr 
+gr_make_correlate_access_code_packed_bb (const std::string &access_code, int threshold) 
+  throw(std::out_of_range);
+
+/*!
+ * \brief Examine packed input for specified access code, up to 64 bits at a time.
+ * \ingroup block
+ *
+ * input:  stream of bits, 8 bits per input byte, MSB first
+ * output 0: the input, unchanged
+ * output 1: flags, 8 per byte, MSB first, lined up with output 0
+ *
+ * A flag bit is 1 if the corresponding data bit is the first data bit
+ * following the access code.
+ */
+class gr_correlate_access_code_packed_bb : public gr_sync_block
+{
+  friend gr_correlate_access_code_packed_bb_sptr 
+  gr_make_correlate_access_code_packed_bb (const std::string &access_code, int threshold);
+ protected:
+  gr_correlate_access_code_packed_bb(const std::string &access_code, int threshold);
+
+ public:
+  ~gr_correlate_access_code_packed_bb();
+
+  /*!
+   * \param access_code is represented with 1 byte per bit, e.g., "010101010111000100"
+   */
+  bool set_access_code (const std::string &access_code);
+};
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2003 Free Software Foundation, Inc.
+ * Copyright 2003,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -75,11 +75,15 @@ gr_count_bits32 (unsigned int x)
 unsigned int
 gr_count_bits32 (unsigned int x)
 {
+#ifdef __POPCNT__
+  return __builtin_popcount (x);
+#else
   unsigned res = (x & 0x55555555) + ((x >> 1) & 0x55555555);
   res = (res & 0x33333333) + ((res >> 2) & 0x33333333);
   res = (res & 0x0F0F0F0F) + ((res >> 4) & 0x0F0F0F0F);
   res = (res & 0x00FF00FF) + ((res >> 8) & 0x00FF00FF);
   return (res & 0x0000FFFF) + ((res >> 16) & 0x0000FFFF);
+#endif
 }
 
 #endif
@@ -89,5 +93,12 @@ gr_count_bits32 (unsigned int x)
 unsigned int
 gr_count_bits64 (unsigned long long x)
 {
-  return gr_count_bits32((x >> 32) & 0xffffffff) + gr_count_bits32(x & 0xffffffff);
+#ifdef __POPCNT__
+  return __builtin_popcountll (x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (x * 0x0101010101010101ULL) >> 56;
+#endif
 }
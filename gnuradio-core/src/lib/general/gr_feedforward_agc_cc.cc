@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,6 +27,7 @@
 #include <gr_feedforward_agc_cc.h>
 #include <gr_io_signature.h>
 #include <stdexcept>
+#include <algorithm>
 
 gr_feedforward_agc_cc_sptr
 gr_make_feedforward_agc_cc(int nsamples, float reference)
@@ -69,6 +70,15 @@ envelope(gr_complex x)
     return i_abs + 0.4 * r_abs;
 }
 
+/*
+ * Each output needs the largest envelope in the window of nsamples
+ * inputs starting at it.  Rather than look at the whole window for
+ * every output, split the input into pieces nsamples long and keep
+ * the running max from the left and from the right of each piece (van
+ * Herk / Gil-Werman).  A window covers the end of one piece and the
+ * start of the next, so its max is the larger of those two running
+ * maxes, whatever nsamples is.
+ */
 int
 gr_feedforward_agc_cc::work(int noutput_items,
 			    gr_vector_const_void_star &input_items,
@@ -77,14 +87,30 @@ gr_feedforward_agc_cc::work(int noutput_items,
   const gr_complex *in = (const gr_complex *) input_items[0];
   gr_complex *out = (gr_complex *) output_items[0];
   int	nsamples = d_nsamples;
-  float gain;
-  
+  int	ninput = noutput_items + nsamples - 1;
+
+  d_env.resize(ninput);
+  d_right.resize(ninput);
+  float *left = &d_env[0];
+  float *right = &d_right[0];
+
+  for (int j = 0; j < ninput; j++)
+    left[j] = envelope(in[j]);
+
+  for (int start = 0; start < ninput; start += nsamples){
+    int end = std::min(start + nsamples, ninput) - 1;
+    right[end] = left[end];
+    for (int j = end - 1; j >= start; j--)
+      right[j] = std::max(right[j + 1], left[j]);
+    for (int j = start + 1; j <= end; j++)
+      left[j] = std::max(left[j - 1], left[j]);
+  }
+
   for (int i = 0; i < noutput_items; i++){
     //float max_env = 1e-12;	// avoid divide by zero
     float max_env = 1e-4;	// avoid divide by zero, indirectly set max gain
-    for (int j = 0; j < nsamples; j++)
-      max_env = std::max(max_env, envelope(in[i+j]));
-    gain = d_reference / max_env;
+    max_env = std::max(max_env, std::max(right[i], left[i + nsamples - 1]));
+    float gain = d_reference / max_env;
     out[i] = gain * in[i];
   }
   return noutput_items;
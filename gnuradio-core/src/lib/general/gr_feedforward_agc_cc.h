@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,7 @@
 #define INCLUDED_GR_FEEDFORWARD_AGC_CC_H
 
 #include <gr_sync_block.h>
+#include <vector>
 
 class gr_feedforward_agc_cc;
 typedef boost::shared_ptr<gr_feedforward_agc_cc> gr_feedforward_agc_cc_sptr;
@@ -42,6 +43,8 @@ class gr_feedforward_agc_cc : public gr_sync_block
   
   int		d_nsamples;
   float		d_reference;
+  std::vector<float> d_env;	// envelopes, then the running max from the left
+  std::vector<float> d_right;	// running max from the right
 
   gr_feedforward_agc_cc(int nsamples, float reference);
 
@@ -54,7 +54,7 @@ protected:
  public:
   ~gr_fft_vcc ();
 
-  bool set_window(const std::vector<float> &window);
+  virtual bool set_window(const std::vector<float> &window);
 };
 
 #endif /* INCLUDED_GR_FFT_VCC_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2007,2008 Free Software Foundation, Inc.
+ * Copyright 2004,2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,6 +29,14 @@
 #include <gri_fft.h>
 #include <math.h>
 #include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+// Vectors are transformed d_batch at a time, up to about this many points
+static const int BATCH_POINTS = 16384;
 
 gr_fft_vcc_sptr
 gr_make_fft_vcc_fftw (int fft_size, bool forward, const std::vector<float> &window, bool shift)
@@ -38,14 +46,148 @@ gr_make_fft_vcc_fftw (int fft_size, bool forward, const std::vector<float> &wind
 
 gr_fft_vcc_fftw::gr_fft_vcc_fftw (int fft_size, bool forward,
 				  const std::vector<float> &window, bool shift)
-  : gr_fft_vcc("fft_vcc_fftw", fft_size, forward, window, shift)
+  : gr_fft_vcc("fft_vcc_fftw", fft_size, forward, window, shift),
+    d_fft_many(0), d_fft_many_ip(0)
 {
+  d_batch = std::max(1, BATCH_POINTS / fft_size);
+
   d_fft = new gri_fft_complex (d_fft_size, forward);
+  d_fft_ip = new gri_fft_complex (d_fft_size, forward, 1, true);
+  if (d_batch > 1){
+    d_fft_many = new gri_fft_complex (d_fft_size, forward, d_batch);
+    d_fft_many_ip = new gri_fft_complex (d_fft_size, forward, d_batch, true);
+  }
+
+  compute_weights ();
 }
 
 gr_fft_vcc_fftw::~gr_fft_vcc_fftw ()
 {
   delete d_fft;
+  delete d_fft_ip;
+  delete d_fft_many;
+  delete d_fft_many_ip;
+}
+
+bool
+gr_fft_vcc_fftw::set_window (const std::vector<float> &window)
+{
+  if (!gr_fft_vcc::set_window (window))
+    return false;
+  compute_weights ();
+  return true;
+}
+
+/*
+ * Fold the window and any shift into a single pass over the input.
+ *
+ * A forward fftshift is a rotation of the output by ceil(N/2), which is
+ * the same as modulating the input by exp(-j*2*pi*n*ceil(N/2)/N); for
+ * even N that's just (-1)^n.  An inverse (input) ifftshift is done by
+ * reading the input starting at floor(N/2).
+ */
+void
+gr_fft_vcc_fftw::compute_weights ()
+{
+  unsigned int N = d_fft_size;
+  bool window = d_window.size () != 0;
+
+  d_weights.clear ();
+  d_complex_weights = false;
+  // N.B., as always, the ifftshift isn't done when there's a window
+  d_in_rotate = (!d_forward && d_shift && !window) ? N / 2 : 0;
+
+  if (d_forward && d_shift){
+    unsigned int len = (N + 1) / 2;
+    d_weights.resize (2 * N);
+    d_complex_weights = (N % 2) != 0;
+    for (unsigned int i = 0; i < N; i++){
+      float w = window ? d_window[i] : 1.0;
+      if (d_complex_weights){
+	double arg = -2 * M_PI * (double) ((uint64_t) i * len % N) / N;
+	d_weights[2*i]   = w * cos (arg);
+	d_weights[2*i+1] = w * sin (arg);
+      }
+      else {
+	d_weights[2*i] = d_weights[2*i+1] = (i & 1) ? -w : w;
+      }
+    }
+  }
+  else if (window){
+    d_weights.resize (2 * N);
+    for (unsigned int i = 0; i < N; i++)
+      d_weights[2*i] = d_weights[2*i+1] = d_window[i];
+  }
+
+  d_prepass = !d_weights.empty () || d_in_rotate != 0;
+}
+
+// out[i] = in[i] * w[i], n floats
+static void
+multiply_real (float *out, const float *in, const float *w, unsigned int n)
+{
+  unsigned int i = 0;
+#ifdef __SSE__
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps (&out[i], _mm_mul_ps (_mm_loadu_ps (&in[i]), _mm_loadu_ps (&w[i])));
+#endif
+  for (; i < n; i++)
+    out[i] = in[i] * w[i];
+}
+
+// out[i] = in[i] * w[i], n complex values stored as float pairs
+static void
+multiply_complex (float *out, const float *in, const float *w, unsigned int n)
+{
+  unsigned int i = 0;
+#ifdef __SSE__
+  __m128 x0, x1, x2, t0, t1, m;
+  m = _mm_set_ps (-1, 1, -1, 1);
+  for (; i + 2 <= n; i += 2){
+    x0 = _mm_loadu_ps (&in[2*i]);
+    t0 = _mm_loadu_ps (&w[2*i]);
+
+    t1 = _mm_shuffle_ps (t0, t0, _MM_SHUFFLE (3, 3, 1, 1));
+    t0 = _mm_shuffle_ps (t0, t0, _MM_SHUFFLE (2, 2, 0, 0));
+    t1 = _mm_mul_ps (t1, m);
+
+    x1 = _mm_mul_ps (x0, t0);
+    x2 = _mm_mul_ps (x0, t1);
+
+    x2 = _mm_shuffle_ps (x2, x2, _MM_SHUFFLE (2, 3, 0, 1));
+    _mm_storeu_ps (&out[2*i], _mm_add_ps (x1, x2));
+  }
+#endif
+  for (; i < n; i++){
+    float re = in[2*i] * w[2*i] - in[2*i+1] * w[2*i+1];
+    float im = in[2*i] * w[2*i+1] + in[2*i+1] * w[2*i];
+    out[2*i] = re;
+    out[2*i+1] = im;
+  }
+}
+
+static void
+weigh (gr_complex *out, const gr_complex *in, const float *w, bool complex_w, unsigned int n)
+{
+  if (w == 0)
+    memcpy (out, in, n * sizeof (gr_complex));
+  else if (complex_w)
+    multiply_complex ((float *) out, (const float *) in, w, n);
+  else
+    multiply_real ((float *) out, (const float *) in, w, 2 * n);
+}
+
+// Copy one vector from in to out, applying the window and shift
+void
+gr_fft_vcc_fftw::prepass (const gr_complex *in, gr_complex *out)
+{
+  unsigned int N = d_fft_size;
+  unsigned int r = d_in_rotate;
+  const float *w = d_weights.empty () ? 0 : &d_weights[0];
+
+  weigh (out, &in[r], w ? &w[2*r] : 0, d_complex_weights, N - r);
+  if (r != 0)
+    weigh (&out[N - r], in, w, d_complex_weights, r);
 }
 
 int
@@ -56,49 +198,36 @@ gr_fft_vcc_fftw::work (int noutput_items,
   const gr_complex *in = (const gr_complex *) input_items[0];
   gr_complex *out = (gr_complex *) output_items[0];
 
-  unsigned int input_data_size = input_signature()->sizeof_stream_item (0);
-  unsigned int output_data_size = output_signature()->sizeof_stream_item (0);
-
   int count = 0;
 
-  while (count++ < noutput_items){
-    
-    // copy input into optimally aligned buffer
-    
-    if (d_window.size()){
-      gr_complex *dst = d_fft->get_inbuf();
-      for (unsigned int i = 0; i < d_fft_size; i++)		// apply window
-	dst[i] = in[i] * d_window[i];
-    }
-    else {
-      if(!d_forward && d_shift) {  // apply an ifft shift on the data
-	gr_complex *dst = d_fft->get_inbuf();
-	unsigned int len = (unsigned int)(floor(d_fft_size/2.0)); // half length of complex array
-	memcpy(&dst[0], &in[len], sizeof(gr_complex)*(d_fft_size - len));
-	memcpy(&dst[d_fft_size - len], &in[0], sizeof(gr_complex)*len);
-      }
-      else {
-	memcpy (d_fft->get_inbuf(), in, input_data_size);
-      }
+  while (count < noutput_items){
+
+    if (!gri_fft_complex::is_aligned (in) || !gri_fft_complex::is_aligned (out)){
+      // go through fftw's own, optimally aligned, buffers
+      prepass (in, d_fft->get_inbuf ());
+      d_fft->execute ();
+      memcpy (out, d_fft->get_outbuf (), d_fft_size * sizeof (gr_complex));
+      in  += d_fft_size;
+      out += d_fft_size;
+      count++;
+      continue;
     }
-    
-    // compute the fft
-    d_fft->execute ();
-    
-    // copy result to our output
-    if(d_forward && d_shift) {  // apply a fft shift on the data
-      unsigned int len = (unsigned int)(ceil(d_fft_size/2.0));
-      memcpy(&out[0], &d_fft->get_outbuf()[len], sizeof(gr_complex)*(d_fft_size - len));
-      memcpy(&out[d_fft_size - len], &d_fft->get_outbuf()[0], sizeof(gr_complex)*len);
+
+    int n = (noutput_items - count >= d_batch) ? d_batch : 1;
+
+    if (d_prepass){		// window/shift into the output, transform in place
+      for (int i = 0; i < n; i++)
+	prepass (&in[i * d_fft_size], &out[i * d_fft_size]);
+      (n > 1 ? d_fft_many_ip : d_fft_ip)->execute (out, out);
     }
-    else {
-      memcpy (out, d_fft->get_outbuf (), output_data_size);
+    else {			// straight from input to output
+      (n > 1 ? d_fft_many : d_fft)->execute (in, out);
     }
-    
-    in  += d_fft_size;
-    out += d_fft_size;
+
+    in  += n * d_fft_size;
+    out += n * d_fft_size;
+    count += n;
   }
   
   return noutput_items;
 }
-
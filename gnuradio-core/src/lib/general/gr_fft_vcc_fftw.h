@@ -24,6 +24,7 @@
 #define INCLUDED_GR_FFT_VCC_FFTW_H
 
 #include <gr_fft_vcc.h>
+#include <vector>
 
 class gri_fft_complex;
 
@@ -41,13 +42,28 @@ class gr_fft_vcc_fftw : public gr_fft_vcc
   friend gr_fft_vcc_sptr
   gr_make_fft_vcc_fftw (int fft_size, bool forward, const std::vector<float> &window, bool shift);
 
-  gri_fft_complex *d_fft;
+  gri_fft_complex *d_fft;		// one vector, out of place
+  gri_fft_complex *d_fft_ip;		// one vector, in place
+  gri_fft_complex *d_fft_many;		// d_batch vectors, out of place (0 if d_batch == 1)
+  gri_fft_complex *d_fft_many_ip;	// d_batch vectors, in place (0 if d_batch == 1)
+  int		   d_batch;
+
+  // Applied to each input vector on its way to the output buffer
+  std::vector<float> d_weights;		// window, and fftshift as a phase ramp
+  bool		   d_complex_weights;	// d_weights holds complex, else real pairs
+  unsigned int	   d_in_rotate;		// ifftshift: index of first input used
+  bool		   d_prepass;		// any of the above
 
   gr_fft_vcc_fftw (int fft_size, bool forward, const std::vector<float> &window, bool shift);
 
+  void compute_weights ();
+  void prepass (const gr_complex *in, gr_complex *out);
+
  public:
   ~gr_fft_vcc_fftw ();
 
+  bool set_window (const std::vector<float> &window);
+
   int work (int noutput_items,
 	    gr_vector_const_void_star &input_items,
 	    gr_vector_void_star &output_items);
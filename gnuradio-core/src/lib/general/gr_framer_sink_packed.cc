@@ -0,0 +1,235 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gr_framer_sink_packed.h>
+#include <gr_io_signature.h>
+#include <cstdio>
+#include <algorithm>
+#include <string.h>
+
+#define VERBOSE 0
+
+inline void
+gr_framer_sink_packed::enter_search()
+{
+  if (VERBOSE)
+    fprintf(stderr, "@ enter_search\n");
+
+  d_state = STATE_SYNC_SEARCH;
+}
+    
+inline void
+gr_framer_sink_packed::enter_have_sync()
+{
+  if (VERBOSE)
+    fprintf(stderr, "@ enter_have_sync\n");
+
+  d_state = STATE_HAVE_SYNC;
+  d_header = 0;
+  d_headerbitlen_cnt = 0;
+}
+
+inline void
+gr_framer_sink_packed::enter_have_header(int payload_len, int whitener_offset)
+{
+  if (VERBOSE)
+    fprintf(stderr, "@ enter_have_header (payload_len = %d) (offset = %d)\n", payload_len, whitener_offset);
+
+  d_state = STATE_HAVE_HEADER;
+  d_packetlen = payload_len;
+  d_packet_whitener_offset = whitener_offset;
+  d_packetlen_cnt = 0;
+  d_packet_byte = 0;
+  d_packet_byte_index = 0;
+}
+
+void
+gr_framer_sink_packed::send_packet()
+{
+  // NOTE: passing header field as arg1 is not scalable
+  gr_message_sptr msg =
+    gr_make_message(0, d_packet_whitener_offset, 0, d_packetlen_cnt);
+  memcpy(msg->msg(), d_packet, d_packetlen_cnt);
+
+  d_target_queue->insert_tail(msg);		// send it
+  msg.reset();  				// free it up
+
+  enter_search();
+}
+
+gr_framer_sink_packed_sptr
+gr_make_framer_sink_packed(const std::string &access_code, int threshold,
+			   gr_msg_queue_sptr target_queue)
+{
+  return gr_framer_sink_packed_sptr(new gr_framer_sink_packed(access_code, threshold,
+							      target_queue));
+}
+
+
+gr_framer_sink_packed::gr_framer_sink_packed(const std::string &access_code,
+					     int threshold,
+					     gr_msg_queue_sptr target_queue)
+  : gr_sync_block ("framer_sink_packed",
+		   gr_make_io_signature (1, 1, sizeof(unsigned char)),
+		   gr_make_io_signature (0, 0, 0)),
+    d_correlator(access_code, threshold), d_carry(0),
+    d_target_queue(target_queue)
+{
+  enter_search();
+}
+
+gr_framer_sink_packed::~gr_framer_sink_packed ()
+{
+}
+
+bool
+gr_framer_sink_packed::set_access_code(const std::string &access_code)
+{
+  return d_correlator.set_access_code(access_code);
+}
+
+/*
+ * Feed the bits of byte from bit start (0 is the MSB) into the header
+ * or the packet, stopping early if that finishes it.  Returns where
+ * the next unused bit is.
+ */
+int
+gr_framer_sink_packed::take_bits(unsigned char byte, int start)
+{
+  int avail = 8 - start;
+
+  if (d_state == STATE_HAVE_SYNC){
+    int k = std::min(avail, HEADERBITLEN - d_headerbitlen_cnt);
+    d_header = (d_header << k) | ((byte >> (avail - k)) & ((1 << k) - 1));
+    d_headerbitlen_cnt += k;
+
+    if (d_headerbitlen_cnt == HEADERBITLEN){
+      if (VERBOSE)
+	fprintf(stderr, "got header: 0x%08x\n", d_header);
+
+      // we have a full header, check to see if it has been received properly
+      if (header_ok()){
+	int payload_len;
+	int whitener_offset;
+	header_payload(&payload_len, &whitener_offset);
+	enter_have_header(payload_len, whitener_offset);
+
+	if (d_packetlen == 0)		// zero-length payload
+	  send_packet();
+      }
+      else
+	enter_search();			// bad header
+    }
+    return start + k;
+  }
+
+  // STATE_HAVE_HEADER
+  int k = std::min(avail, 8 - d_packet_byte_index);
+  d_packet_byte = (d_packet_byte << k) | ((byte >> (avail - k)) & ((1 << k) - 1));
+  d_packet_byte_index += k;
+
+  if (d_packet_byte_index == 8){	// byte is full so move to next byte
+    d_packet[d_packetlen_cnt++] = d_packet_byte;
+    d_packet_byte = 0;
+    d_packet_byte_index = 0;
+
+    if (d_packetlen_cnt == d_packetlen)	// packet is filled
+      send_packet();
+  }
+  return start + k;
+}
+
+int
+gr_framer_sink_packed::work (int noutput_items,
+			     gr_vector_const_void_star &input_items,
+			     gr_vector_void_star &output_items)
+{
+  const unsigned char *in = (const unsigned char *) input_items[0];
+  int i = 0;
+
+  // As in gr_correlate_access_code_packed_bb, a hit on bit j means the
+  // packet starts at bit j + 1, and d_carry holds a hit on the last bit
+  // of the previous byte.
+
+  while (i < noutput_items){
+
+    if (d_state == STATE_SYNC_SEARCH && i + 8 <= noutput_items){
+      uint64_t word = 0;
+      for (int k = 0; k < 8; k++)
+	word = (word << 8) | in[i + k];
+
+      uint64_t hits = d_correlator.hits64(word);
+      uint64_t starts = (hits >> 1) | ((uint64_t) d_carry << 63);
+
+      if (starts == 0){			// nothing in the next 64 bits
+	d_correlator.shift64(word);
+	d_carry = hits & 1;
+	i += 8;
+	continue;
+      }
+
+      // skip the bytes in front of the first start
+      for (int k = 7; (starts >> 56) == 0; k--){
+	d_correlator.shift8(in[i++]);
+	d_carry = (hits >> (8 * k)) & 1;
+	starts <<= 8;
+      }
+    }
+
+    unsigned char byte = in[i];
+    int hits = -1;			// not computed yet
+    int start = 0;
+
+    while (start < 8){
+      if (d_state != STATE_SYNC_SEARCH){
+	start = take_bits(byte, start);
+	continue;
+      }
+
+      if (hits < 0)
+	hits = d_correlator.hits8(byte);
+
+      unsigned int starts = ((hits >> 1) | (d_carry << 7)) & (0xff >> start);
+      if (starts == 0)
+	break;
+
+      while ((starts & (0x80 >> start)) == 0)
+	start++;
+      enter_have_sync();
+    }
+
+    if (d_state == STATE_SYNC_SEARCH){
+      if (hits < 0)
+	hits = d_correlator.hits8(byte);
+      d_carry = hits & 1;
+    }
+
+    d_correlator.shift8(byte);
+    i++;
+  }
+
+  return noutput_items;
+}
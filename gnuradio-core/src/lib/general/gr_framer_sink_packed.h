@@ -0,0 +1,122 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_FRAMER_SINK_PACKED_H
+#define INCLUDED_GR_FRAMER_SINK_PACKED_H
+
+#include <gr_sync_block.h>
+#include <gr_msg_queue.h>
+#include <gri_correlate_access_code.h>
+#include <string>
+
+class gr_framer_sink_packed;
+typedef boost::shared_ptr<gr_framer_sink_packed> gr_framer_sink_packed_sptr;
+
+/*!
+ * \param access_code is represented with 1 byte per bit, e.g., "010101010111000100"
+ * \param threshold maximum number of bits that may be wrong
+ * \param target_queue where to send the packets
+ */
+gr_framer_sink_packed_sptr 
+gr_make_framer_sink_packed (const std::string &access_code, int threshold,
+			    gr_msg_queue_sptr target_queue);
+
+/*!
+ * \brief Find the access code in packed bits and assemble the packets after it.
+ * \ingroup sink_blk
+ *
+ * input: stream of bits, 8 bits per input byte, MSB first
+ * output: none.  Pushes assembled packet into target queue
+ *
+ * gr_correlate_access_code_bb followed by gr_framer_sink_1, without
+ * unpacking the bits.  The packets and header are the same as
+ * gr_framer_sink_1's: two identical 16-bit shorts holding the payload
+ * length and whitener offset, then the payload.
+ *
+ * While searching, 64 bits at a time that don't contain the end of an
+ * access code are skipped with a single call to the correlator.
+ * Header and payload bits are taken up to a byte at a time.
+ */
+class gr_framer_sink_packed : public gr_sync_block
+{
+  friend gr_framer_sink_packed_sptr 
+  gr_make_framer_sink_packed (const std::string &access_code, int threshold,
+			      gr_msg_queue_sptr target_queue);
+
+ private:
+  enum state_t {STATE_SYNC_SEARCH, STATE_HAVE_SYNC, STATE_HAVE_HEADER};
+
+  static const int MAX_PKT_LEN    = 4096;
+  static const int HEADERBITLEN   = 32;
+
+  gri_correlate_access_code d_correlator;
+  unsigned int	     d_carry;			// access code ended on the last bit
+
+  gr_msg_queue_sptr  d_target_queue;		// where to send the packet when received
+  state_t            d_state;
+  unsigned int       d_header;			// header bits
+  int		     d_headerbitlen_cnt;	// how many so far
+
+  unsigned char      d_packet[MAX_PKT_LEN];	// assembled payload
+  unsigned char	     d_packet_byte;		// byte being assembled
+  int		     d_packet_byte_index;	// how many bits of d_packet_byte we have
+  int 		     d_packetlen;		// length of packet
+  int                d_packet_whitener_offset;  // offset into whitener string to use
+  int		     d_packetlen_cnt;		// how many so far
+
+ protected:
+  gr_framer_sink_packed(const std::string &access_code, int threshold,
+			gr_msg_queue_sptr target_queue);
+
+  void enter_search();
+  void enter_have_sync();
+  void enter_have_header(int payload_len, int whitener_offset);
+  void send_packet();
+
+  int take_bits(unsigned char byte, int start);
+  
+  bool header_ok()
+  {
+    // confirm that two copies of header info are identical
+    return ((d_header >> 16) ^ (d_header & 0xffff)) == 0;
+  }
+
+  void header_payload(int *len, int *offset)
+  {
+    // header consists of two 16-bit shorts in network byte order
+    // payload length is lower 12 bits
+    // whitener offset is upper 4 bits
+    *len = (d_header >> 16) & 0x0fff;
+    *offset = (d_header >> 28) & 0x000f;
+  }
+
+ public:
+  ~gr_framer_sink_packed();
+
+  bool set_access_code (const std::string &access_code);
+
+  int work(int noutput_items,
+	   gr_vector_const_void_star &input_items,
+	   gr_vector_void_star &output_items);
+};
+
+#endif /* INCLUDED_GR_FRAMER_SINK_PACKED_H */
@@ -0,0 +1,40 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+GR_SWIG_BLOCK_MAGIC(gr,framer_sink_packed);
+
+gr_framer_sink_packed_sptr 
+gr_make_framer_sink_packed(const std::string &access_code, int threshold,
+			   gr_msg_queue_sptr target_queue)
+  throw(std::out_of_range);
+
+class gr_framer_sink_packed : public gr_sync_block
+{
+ protected:
+  gr_framer_sink_packed(const std::string &access_code, int threshold,
+			gr_msg_queue_sptr target_queue);
+
+ public:
+  ~gr_framer_sink_packed();
+
+  bool set_access_code (const std::string &access_code);
+};
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -66,9 +66,10 @@ gr_glfsr_source_b::work(int noutput_items,
   if ((d_index > d_length) && d_repeat == false)
     return -1; /* once through the sequence */
 
+  d_glfsr->next_bits((unsigned char *) out, noutput_items);
+
   int i;
   for (i = 0; i < noutput_items; i++) {
-    out[i] = d_glfsr->next_bit();
     d_index++;
     if (d_index > d_length && d_repeat == false)
       break;
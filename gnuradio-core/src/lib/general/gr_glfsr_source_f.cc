@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,6 +29,7 @@
 #include <gri_glfsr.h>
 #include <gr_io_signature.h>
 #include <stdexcept>
+#include <algorithm>
 
 gr_glfsr_source_f_sptr 
 gr_make_glfsr_source_f(int degree, bool repeat, int mask, int seed)
@@ -66,11 +67,21 @@ gr_glfsr_source_f::work(int noutput_items,
   if ((d_index > d_length) && d_repeat == false)
     return -1; /* once through the sequence */
 
-  int i;
-  for (i = 0; i < noutput_items; i++) {
-    out[i] = (float)d_glfsr->next_bit()*2.0-1.0;
-    d_index++;
-    if (d_index > d_length && d_repeat == false)
+  unsigned char bits[1024];
+  int i = 0;
+  while (i < noutput_items) {
+    int n = std::min(noutput_items - i, (int) sizeof(bits));
+    d_glfsr->next_bits(bits, n);
+
+    int k;
+    for (k = 0; k < n; k++) {
+      out[i + k] = (float)bits[k]*2.0-1.0;
+      d_index++;
+      if (d_index > d_length && d_repeat == false)
+	break;
+    }
+    i += k;
+    if (k < n)
       break;
   }
 
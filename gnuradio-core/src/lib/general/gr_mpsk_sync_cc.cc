@@ -0,0 +1,315 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gr_mpsk_sync_cc.h>
+#include <gr_io_signature.h>
+#include <gr_math.h>
+#include <gr_expj.h>
+#include <gr_fxpt.h>
+#include <gri_mmse_fir_interpolator_cc.h>
+#include <algorithm>
+#include <stdexcept>
+#include <math.h>
+
+#define M_TWOPI (2*M_PI)
+
+// gr_expj from the gr_fxpt table.  Goes through 64 bits so angles
+// outside +-pi wrap instead of saturating.
+static inline gr_complex
+fxpt_expj (float phase)
+{
+  gr_int32 angle = (gr_int32) (long long) (phase * (float) (2147483648.0 / M_PI));
+  return gr_complex (gr_fxpt::cos (angle), gr_fxpt::sin (angle));
+}
+
+gr_mpsk_sync_cc_sptr
+gr_make_mpsk_sync_cc (unsigned int M, float theta,
+		      float alpha, float beta,
+		      float fmin, float fmax,
+		      float mu, float gain_mu,
+		      float omega, float gain_omega, float omega_rel,
+		      int block_size)
+{
+  return gr_mpsk_sync_cc_sptr (new gr_mpsk_sync_cc (M, theta,
+						    alpha, beta,
+						    fmin, fmax,
+						    mu, gain_mu,
+						    omega, gain_omega, omega_rel,
+						    block_size));
+}
+
+gr_mpsk_sync_cc::gr_mpsk_sync_cc (unsigned int M, float theta,
+				  float alpha, float beta,
+				  float fmin, float fmax,
+				  float mu, float gain_mu,
+				  float omega, float gain_omega, float omega_rel,
+				  int block_size)
+  : gr_block ("mpsk_sync_cc",
+	      gr_make_io_signature (1, 1, sizeof (gr_complex)),
+	      gr_make_io_signature (1, 1, sizeof (gr_complex))),
+    d_M (M), d_theta (theta),
+    d_alpha (alpha), d_beta (beta), d_freq (0), d_max_freq (fmax), d_min_freq (fmin),
+    d_phase (0), d_step (0),
+    d_mu (mu), d_gain_mu (gain_mu), d_gain_omega (gain_omega), d_omega_rel (omega_rel),
+    d_p_1T (0), d_p_0T (0), d_c_1T (0), d_c_0T (0),
+    d_current_const_point (0),
+    d_interp (new gri_mmse_fir_interpolator_cc ()), d_last (0)
+{
+  if (omega <= 0.0)
+    throw std::out_of_range ("clock rate must be > 0");
+  if (gain_mu < 0 || gain_omega < 0)
+    throw std::out_of_range ("Gains must be non-negative");
+
+  set_omega (omega);
+  set_block_size (block_size);
+  set_relative_rate (1.0 / omega);
+
+  make_constellation ();
+}
+
+gr_mpsk_sync_cc::~gr_mpsk_sync_cc ()
+{
+  delete d_interp;
+}
+
+void
+gr_mpsk_sync_cc::set_block_size (int block_size)
+{
+  if (block_size < 1)
+    throw std::out_of_range ("gr_mpsk_sync_cc: block_size must be >= 1");
+
+  d_block_size = block_size;
+  d_offset.resize (block_size);
+  d_frac.resize (block_size);
+}
+
+void
+gr_mpsk_sync_cc::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+{
+  ninput_items_required[0] =
+    (int) ceil ((noutput_items * d_omega) + d_interp->ntaps ());
+}
+
+void
+gr_mpsk_sync_cc::make_constellation ()
+{
+  for (unsigned int m = 0; m < d_M; m++)
+    d_constellation.push_back (gr_expj ((M_TWOPI / d_M) * m));
+}
+
+// The detectors and decisions are gr_mpsk_receiver_cc's.  The QPSK
+// ones are written without branches, since which way they go is as
+// random as the data.
+
+inline float
+gr_mpsk_sync_cc::phase_error_detector_qpsk (gr_complex sample) const
+{
+  float re = sample.real ();
+  float im = sample.imag ();
+  float sign_re = 2.0f * (re > 0) - 1.0f;
+  float sign_im = 2.0f * (im > 0) - 1.0f;
+  float in_phase = fabsf (re) > fabsf (im);
+
+  return in_phase * (-im * sign_re) + (1.0f - in_phase) * (re * sign_im);
+}
+
+inline float
+gr_mpsk_sync_cc::phase_error_detector_bpsk (gr_complex sample) const
+{
+  return -(sample.real () * sample.imag ());
+}
+
+float
+gr_mpsk_sync_cc::phase_error_detector_generic (gr_complex sample) const
+{
+  return -arg (sample * conj (d_constellation[d_current_const_point]));
+}
+
+inline unsigned int
+gr_mpsk_sync_cc::decision_bpsk (gr_complex sample) const
+{
+  return gr_branchless_binary_slicer (sample.real ()) ^ 1;
+}
+
+inline unsigned int
+gr_mpsk_sync_cc::decision_qpsk (gr_complex sample) const
+{
+  return gr_branchless_quad_0deg_slicer (sample);
+}
+
+unsigned int
+gr_mpsk_sync_cc::decision_generic (gr_complex sample) const
+{
+  unsigned int min_m = 0;
+  float min_s = 65535;
+
+  for (unsigned int m = 0; m < d_M; m++){
+    float s = norm (d_constellation[m] - sample);
+    if (s < min_s){
+      min_s = s;
+      min_m = m;
+    }
+  }
+  return min_m;
+}
+
+/*
+ * Rotate the n interpolated symbols in sym[] by the NCO and run both
+ * loops over them, a symbol at a time.  The loops are
+ * gr_mpsk_receiver_cc's mm_error_tracking and phase_error_tracking.
+ * Their state is kept in locals for the length of the block, since
+ * each store to sym[] would otherwise make the compiler reload it.
+ *
+ * Returns how much further along the timing loop has moved the next
+ * symbol than \p omega per symbol would have put it.
+ */
+float
+gr_mpsk_sync_cc::track (gr_complex sym[], const int offset[], int n, float omega)
+{
+  const float two_pi = M_TWOPI;
+  float phase = d_phase;
+  float freq = d_freq;
+  float step = d_step;
+  float w = d_omega;
+  gr_complex p_1T = d_p_1T, p_0T = d_p_0T;
+  gr_complex c_1T = d_c_1T, c_0T = d_c_0T;
+  int last = d_last;
+  float adjust = 0;
+
+  for (int k = 0; k < n; k++){
+    // the NCO advances freq per input sample between symbols
+    phase += freq * (offset[k] - last);
+    last = offset[k];
+
+    // gr_mpsk_receiver_cc rotates samples as they go into its delay
+    // line, so the middle of the interpolator has not yet seen the
+    // last symbol's correction.  Do the same, or for a given alpha
+    // the loop is wider than it is there.
+    gr_complex sample = sym[k] * fxpt_expj (phase - step + d_theta);
+    sym[k] = sample;
+
+    // symbol timing
+    gr_complex p_2T = p_1T;
+    p_1T = p_0T;
+    p_0T = sample;
+    gr_complex c_2T = c_1T;
+    c_1T = c_0T;
+
+    d_current_const_point = decision (sample);
+    c_0T = d_constellation[d_current_const_point];
+
+    gr_complex x = (c_0T - c_2T) * conj (p_1T);
+    gr_complex y = (p_0T - p_2T) * conj (c_1T);
+    float mm_error = gr_branchless_clip ((y - x).real (), 1.0);
+
+    w = w + d_gain_omega * mm_error;
+    w = d_omega_mid + gr_branchless_clip (w - d_omega_mid, d_omega_rel);
+    adjust += (w - omega) + d_gain_mu * mm_error;
+
+    // carrier phase and frequency
+    float phase_error = phase_error_detector (sample);
+
+    freq += d_beta * phase_error;
+    step = freq + d_alpha * phase_error;
+    phase += step;
+
+    while (phase > two_pi)
+      phase -= two_pi;
+    while (phase < -two_pi)
+      phase += two_pi;
+
+    freq = gr_branchless_clip (freq, d_max_freq);
+  }
+
+  d_phase = phase;
+  d_freq = freq;
+  d_step = step;
+  d_omega = w;
+  d_p_1T = p_1T;
+  d_p_0T = p_0T;
+  d_c_1T = c_1T;
+  d_c_0T = c_0T;
+  d_last = last;
+
+  return adjust;
+}
+
+int
+gr_mpsk_sync_cc::general_work (int noutput_items,
+			       gr_vector_int &ninput_items,
+			       gr_vector_const_void_star &input_items,
+			       gr_vector_void_star &output_items)
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  int ni = ninput_items[0] - d_interp->ntaps ();	// last usable offset
+  int ii = 0;						// input index
+  int o = 0;
+
+  while (o < noutput_items){
+
+    // where the symbols in this block would be if the loops didn't move
+    int n = std::min (d_block_size, noutput_items - o);
+    float omega = d_omega;
+    float p = d_mu;
+    int k;
+    for (k = 0; k < n; k++){
+      int f = (int) floorf (p);
+      if (ii + f > ni)
+	break;
+      d_offset[k] = ii + f;
+      d_frac[k] = p - f;
+      p += omega;
+    }
+    n = k;
+    if (n == 0)
+      break;
+
+    d_interp->interpolate_n (&out[o], in, &d_offset[0], &d_frac[0], n);
+
+    float adjust = track (&out[o], &d_offset[0], n, omega);
+    o += n;
+
+    // start the next block where the corrected loop says it goes
+    p += adjust;
+    int f = (int) floorf (p);
+    ii += f;
+    d_mu = p - f;
+    if (ii < 0)
+      ii = 0;
+  }
+
+  // if the next symbol is past the end of the input, keep the excess in mu
+  if (ii > ninput_items[0]){
+    d_mu += ii - ninput_items[0];
+    ii = ninput_items[0];
+  }
+  d_last -= ii;
+
+  consume_each (ii);
+  return o;
+}
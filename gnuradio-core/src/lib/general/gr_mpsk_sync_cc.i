@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+GR_SWIG_BLOCK_MAGIC(gr,mpsk_sync_cc);
+
+gr_mpsk_sync_cc_sptr gr_make_mpsk_sync_cc (unsigned int M, float theta,
+					   float alpha, float beta,
+					   float fmin, float fmax,
+					   float mu, float gain_mu,
+					   float omega, float gain_omega, float omega_rel,
+					   int block_size = 4);
+
+class gr_mpsk_sync_cc : public gr_block
+{
+ private:
+  gr_mpsk_sync_cc (unsigned int M, float theta,
+		   float alpha, float beta,
+		   float fmin, float fmax,
+		   float mu, float gain_mu,
+		   float omega, float gain_omega, float omega_rel,
+		   int block_size);
+ public:
+  float mu () const;
+  float omega () const;
+  float gain_mu () const;
+  float gain_omega () const;
+  int block_size () const;
+  void set_mu (float mu);
+  void set_omega (float omega);
+  void set_gain_mu (float gain_mu);
+  void set_gain_omega (float gain_omega);
+  void set_block_size (int block_size);
+  float alpha () const;
+  float beta () const;
+  float freq () const;
+  float phase () const;
+  void set_alpha (float alpha);
+  void set_beta (float beta);
+  void set_freq (float freq);
+  void set_phase (float phase);
+};
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2008 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,7 +28,9 @@
 #include <gr_io_signature.h>
 #include <gr_expj.h>
 #include <gr_math.h>
+#include <gri_vector_arith.h>
 #include <cstdio>
+#include <algorithm>
 
 #define VERBOSE 0
 #define M_TWOPI (2*M_PI)
@@ -70,10 +72,12 @@ gr_ofdm_frame_acquisition::gr_ofdm_frame_acquisition (unsigned occupied_carriers
     d_known_phase_diff[i] = norm(d_known_symbol[i] - d_known_symbol[i+2]);
   }
   
+  // every offset correlate() can pick, for every symbol count, so the
+  // per-symbol phase correction is a table lookup
   d_phase_lut = new gr_complex[(2*d_freq_shift_len+1) * MAX_NUM_SYMBOLS];
   for(i = 0; i <= 2*d_freq_shift_len; i++) {
     for(j = 0; j < MAX_NUM_SYMBOLS; j++) {
-      d_phase_lut[j + i*MAX_NUM_SYMBOLS] =  gr_expj(-M_TWOPI*d_cplen/d_fft_length*(i-d_freq_shift_len)*j);
+      d_phase_lut[j + i*MAX_NUM_SYMBOLS] = calc_freq_comp((int)i - (int)d_freq_shift_len, j);
     }
   }
 }
@@ -92,14 +96,19 @@ gr_ofdm_frame_acquisition::forecast (int noutput_items, gr_vector_int &ninput_it
 }
 
 gr_complex
-gr_ofdm_frame_acquisition::coarse_freq_comp(int freq_delta, int symbol_count)
+gr_ofdm_frame_acquisition::calc_freq_comp(int freq_delta, int symbol_count)
 {
-  //  return gr_complex(cos(-M_TWOPI*freq_delta*d_cplen/d_fft_length*symbol_count),
-  //	    sin(-M_TWOPI*freq_delta*d_cplen/d_fft_length*symbol_count));
-
   return gr_expj(-M_TWOPI*freq_delta*d_cplen/d_fft_length*symbol_count);
+}
+
+gr_complex
+gr_ofdm_frame_acquisition::coarse_freq_comp(int freq_delta, int symbol_count)
+{
+  int row = freq_delta + (int)d_freq_shift_len;
+  if(row < 0 || row > 2*(int)d_freq_shift_len || symbol_count < 0 || symbol_count >= MAX_NUM_SYMBOLS)
+    return calc_freq_comp(freq_delta, symbol_count);
 
-  //return d_phase_lut[MAX_NUM_SYMBOLS * (d_freq_shift_len + freq_delta) + symbol_count];
+  return d_phase_lut[MAX_NUM_SYMBOLS * row + symbol_count];
 }
 
 void
@@ -183,26 +192,34 @@ gr_ofdm_frame_acquisition::general_work(int noutput_items,
   int unoccupied_carriers = d_fft_length - d_occupied_carriers;
   int zeros_on_left = (int)ceil(unoccupied_carriers/2.0);
 
-  if(signal_in[0]) {
-    d_phase_count = 1;
-    correlate(symbol, zeros_on_left);
-    calculate_equalizer(symbol, zeros_on_left);
-    signal_out[0] = 1;
-  }
-  else {
-    signal_out[0] = 0;
-  } 
+  int nsymbols = std::min(noutput_items, std::min(ninput_items[0], ninput_items[1]));
 
-  for(unsigned int i = 0; i < d_occupied_carriers; i++) {
-    out[i] = d_hestimate[i]*coarse_freq_comp(d_coarse_freq,d_phase_count)
-      *symbol[i+zeros_on_left+d_coarse_freq];
-  }
+  for(int k = 0; k < nsymbols; k++) {
+    if(signal_in[0]) {
+      d_phase_count = 1;
+      correlate(symbol, zeros_on_left);
+      calculate_equalizer(symbol, zeros_on_left);
+      signal_out[k] = 1;
+    }
+    else {
+      signal_out[k] = 0;
+    } 
+
+    // out = (hestimate * phase correction) * symbol, a vector at a time
+    gri_multiply_const(out, &d_hestimate[0], d_occupied_carriers,
+		       coarse_freq_comp(d_coarse_freq,d_phase_count));
+    gri_multiply(out, out, &symbol[zeros_on_left+d_coarse_freq], d_occupied_carriers);
   
-  d_phase_count++;
-  if(d_phase_count == MAX_NUM_SYMBOLS) {
-    d_phase_count = 1;
+    d_phase_count++;
+    if(d_phase_count == MAX_NUM_SYMBOLS) {
+      d_phase_count = 1;
+    }
+
+    symbol += d_fft_length;
+    signal_in += d_fft_length;
+    out += d_occupied_carriers;
   }
 
-  consume_each(1);
-  return 1;
+  consume_each(nsymbols);
+  return nsymbols;
 }
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006, 2007 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -52,6 +52,12 @@ gr_make_ofdm_frame_acquisition (unsigned int occupied_carriers, unsigned int fft
  * symbols to estimate the channel response over all subcarriers and does a simple 
  * 1-tap equalization on all subcarriers. This corrects for the phase and amplitude
  * distortion caused by the channel.
+ *
+ * It works on as many symbols per call as it is given.  The coarse
+ * frequency correction for each symbol comes from a table built once
+ * for every bin offset and symbol count, and the correction and
+ * equalizer are applied to a whole symbol with the gri_vector_arith
+ * kernels.
  */
 
 class gr_ofdm_frame_acquisition : public gr_block
@@ -81,6 +87,7 @@ protected:
   unsigned char slicer(gr_complex x);
   void correlate(const gr_complex *symbol, int zeros_on_left);
   void calculate_equalizer(const gr_complex *symbol, int zeros_on_left);
+  gr_complex calc_freq_comp(int freq_delta, int count);
   gr_complex coarse_freq_comp(int freq_delta, int count);
   
   unsigned int d_occupied_carriers;  // !< \brief number of subcarriers with data
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,11 +28,15 @@
 #include <gr_io_signature.h>
 #include <gr_expj.h>
 #include <gr_math.h>
+#include <gri_vector_arith.h>
 #include <math.h>
 #include <cstdio>
 #include <stdexcept>
 #include <iostream>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define VERBOSE 0
 
@@ -102,17 +106,94 @@ unsigned char gr_ofdm_frame_sink::slicer(const gr_complex x)
   return d_sym_value_out[min_index];
 }
 
+/*
+ * slicer() on all n points of d_sigrot at once, into d_slice.  The
+ * constellation is the outer loop so the inner one runs down the
+ * carriers, four at a time; ties go to the first point, as in slicer().
+ */
+void gr_ofdm_frame_sink::slice_symbol(unsigned int n)
+{
+  unsigned int table_size = d_sym_value_out.size();
+  float *re = &d_sig_re[0];
+  float *im = &d_sig_im[0];
+  float *min_dist = &d_min_dist[0];
+  int *min_index = &d_min_index[0];
+  unsigned int i, j;
+
+  for(i = 0; i < n; i++) {
+    re[i] = d_sigrot[i].real();
+    im[i] = d_sigrot[i].imag();
+  }
+
+  for(i = 0; i < n; i++) {
+    float dr = re[i] - d_sym_position[0].real();
+    float di = im[i] - d_sym_position[0].imag();
+    min_dist[i] = dr*dr + di*di;
+    min_index[i] = 0;
+  }
+
+  for(j = 1; j < table_size; j++) {
+    float pr = d_sym_position[j].real();
+    float pi = d_sym_position[j].imag();
+    i = 0;
+
+#ifdef __SSE2__
+    __m128 pr4 = _mm_set1_ps(pr);
+    __m128 pi4 = _mm_set1_ps(pi);
+    __m128 j4 = _mm_castsi128_ps(_mm_set1_epi32(j));
+    for(; i + 4 <= n; i += 4) {
+      __m128 dr = _mm_sub_ps(_mm_loadu_ps(&re[i]), pr4);
+      __m128 di = _mm_sub_ps(_mm_loadu_ps(&im[i]), pi4);
+      __m128 dist = _mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(di, di));
+      __m128 md = _mm_loadu_ps(&min_dist[i]);
+      __m128 mi = _mm_loadu_ps((float *) &min_index[i]);
+      __m128 lt = _mm_cmplt_ps(dist, md);
+      _mm_storeu_ps(&min_dist[i], _mm_or_ps(_mm_and_ps(lt, dist), _mm_andnot_ps(lt, md)));
+      _mm_storeu_ps((float *) &min_index[i], _mm_or_ps(_mm_and_ps(lt, j4), _mm_andnot_ps(lt, mi)));
+    }
+#endif
+
+    for(; i < n; i++) {
+      float dr = re[i] - pr;
+      float di = im[i] - pi;
+      float dist = dr*dr + di*di;
+      if(dist < min_dist[i]) {
+	min_dist[i] = dist;
+	min_index[i] = j;
+      }
+    }
+  }
+
+  for(i = 0; i < n; i++)
+    d_slice[i] = d_sym_value_out[min_index[i]];
+}
+
 unsigned int gr_ofdm_frame_sink::demapper(const gr_complex *in,
 					  unsigned char *out)
 {
   unsigned int i=0, bytes_produced=0;
+  unsigned int ncarriers = d_subcarrier_map.size();
   gr_complex carrier;
 
   carrier=gr_expj(d_phase);
 
+  // derotate and equalize the whole symbol, then slice it
+  for(i = 0; i < ncarriers; i++)
+    d_sigrot[i] = in[d_subcarrier_map[i]];
+  gri_multiply_const(&d_sigrot[0], &d_sigrot[0], ncarriers, carrier);
+  gri_multiply(&d_sigrot[0], &d_sigrot[0], &d_dfe[0], ncarriers);
+
+  if(d_derotated_output != NULL)
+    memcpy(d_derotated_output, &d_sigrot[0], ncarriers*sizeof(gr_complex));
+
+  slice_symbol(ncarriers);
+
+  // the phase error, equalizer update and bit packing depend on the
+  // order of the carriers, so they're done one at a time
+  i = 0;
   gr_complex accum_error = 0.0;
   //while(i < d_occupied_carriers) {
-  while(i < d_subcarrier_map.size()) {
+  while(i < ncarriers) {
     if(d_nresid > 0) {
       d_partial_byte |= d_resid;
       d_byte_offset += d_nresid;
@@ -121,15 +202,9 @@ unsigned int gr_ofdm_frame_sink::demapper(const gr_complex *in,
     }
     
     //while((d_byte_offset < 8) && (i < d_occupied_carriers)) {
-    while((d_byte_offset < 8) && (i < d_subcarrier_map.size())) {
-      //gr_complex sigrot = in[i]*carrier*d_dfe[i];
-      gr_complex sigrot = in[d_subcarrier_map[i]]*carrier*d_dfe[i];
-      
-      if(d_derotated_output != NULL){
-	d_derotated_output[i] = sigrot;
-      }
-      
-      unsigned char bits = slicer(sigrot);
+    while((d_byte_offset < 8) && (i < ncarriers)) {
+      gr_complex sigrot = d_sigrot[i];
+      unsigned char bits = d_slice[i];
 
       gr_complex closest_sym = d_sym_position[bits];
       
@@ -241,9 +316,9 @@ gr_ofdm_frame_sink::gr_ofdm_frame_sink(const std::vector<gr_complex> &sym_positi
   // for any offset from the 0th carrier introduced
   unsigned int i,j,k;
   for(i = 0; i < (d_occupied_carriers/4)+diff_left; i++) {
-    char c = carriers[i];
+    char c[2] = {carriers[i], 0};
     for(j = 0; j < 4; j++) {
-      k = (strtol(&c, NULL, 16) >> (3-j)) & 0x1;
+      k = (strtol(c, NULL, 16) >> (3-j)) & 0x1;
       if(k) {
 	d_subcarrier_map.push_back(4*i + j - diff_left);
       }
@@ -259,6 +334,13 @@ gr_ofdm_frame_sink::gr_ofdm_frame_sink(const std::vector<gr_complex> &sym_positi
   d_dfe.resize(occupied_carriers);
   fill(d_dfe.begin(), d_dfe.end(), gr_complex(1.0,0.0));
 
+  d_sigrot.resize(d_subcarrier_map.size());
+  d_sig_re.resize(d_subcarrier_map.size());
+  d_sig_im.resize(d_subcarrier_map.size());
+  d_min_dist.resize(d_subcarrier_map.size());
+  d_min_index.resize(d_subcarrier_map.size());
+  d_slice.resize(d_subcarrier_map.size());
+
   set_sym_value_out(sym_position, sym_value_out);
   
   enter_search();
@@ -287,22 +369,12 @@ gr_ofdm_frame_sink::set_sym_value_out(const std::vector<gr_complex> &sym_positio
 }
 
 
-int
-gr_ofdm_frame_sink::work (int noutput_items,
-			  gr_vector_const_void_star &input_items,
-			  gr_vector_void_star &output_items)
+void
+gr_ofdm_frame_sink::work_symbol (const gr_complex *in, char sig)
 {
-  const gr_complex *in = (const gr_complex *) input_items[0];
-  const char *sig = (const char *) input_items[1];
   unsigned int j = 0;
   unsigned int bytes=0;
 
-  // If the output is connected, send it the derotated symbols
-  if(output_items.size() >= 1)
-    d_derotated_output = (gr_complex *)output_items[0];
-  else
-    d_derotated_output = NULL;
-  
   if (VERBOSE)
     fprintf(stderr,">>> Entering state machine\n");
 
@@ -310,9 +382,9 @@ gr_ofdm_frame_sink::work (int noutput_items,
       
   case STATE_SYNC_SEARCH:    // Look for flag indicating beginning of pkt
     if (VERBOSE)
-      fprintf(stderr,"SYNC Search, noutput=%d\n", noutput_items);
+      fprintf(stderr,"SYNC Search\n");
     
-    if (sig[0]) {  // Found it, set up for header decode
+    if (sig) {  // Found it, set up for header decode
       enter_have_sync();
     }
     break;
@@ -323,7 +395,7 @@ gr_ofdm_frame_sink::work (int noutput_items,
     bytes = demapper(&in[0], d_bytes_out);
     
     if (VERBOSE) {
-      if(sig[0])
+      if(sig)
 	printf("ERROR -- Found SYNC in HAVE_SYNC\n");
       fprintf(stderr,"Header Search bitcnt=%d, header=0x%08x\n",
 	      d_headerbytelen_cnt, d_header);
@@ -371,7 +443,7 @@ gr_ofdm_frame_sink::work (int noutput_items,
     bytes = demapper(&in[0], d_bytes_out);
 
     if (VERBOSE) {
-      if(sig[0])
+      if(sig)
 	printf("ERROR -- Found SYNC in HAVE_HEADER at %d, length of %d\n", d_packetlen_cnt, d_packetlen);
       fprintf(stderr,"Packet Build\n");
     }
@@ -400,6 +472,25 @@ gr_ofdm_frame_sink::work (int noutput_items,
     assert(0);
     
   } // switch
+}
+
+int
+gr_ofdm_frame_sink::work (int noutput_items,
+			  gr_vector_const_void_star &input_items,
+			  gr_vector_void_star &output_items)
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  const char *sig = (const char *) input_items[1];
+  gr_complex *out = NULL;
+
+  // If the output is connected, send it the derotated symbols
+  if(output_items.size() >= 1)
+    out = (gr_complex *)output_items[0];
+
+  for(int k = 0; k < noutput_items; k++) {
+    d_derotated_output = out ? &out[k*d_occupied_carriers] : NULL;
+    work_symbol(&in[k*d_occupied_carriers], sig[k]);
+  }
 
-  return 1;
+  return noutput_items;
 }
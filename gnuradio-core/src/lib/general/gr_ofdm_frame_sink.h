@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -44,6 +44,11 @@ gr_make_ofdm_frame_sink (const std::vector<gr_complex> &sym_position,
  * NOTE: The mod input parameter simply chooses a pre-defined demapper/slicer. Eventually,
  * we want to be able to pass in a reference to an object to do the demapping and slicing
  * for a given modulation type.
+ *
+ * Each call works through all the symbols it is given.  A symbol is
+ * derotated and equalized with the gri_vector_arith kernels and sliced
+ * a whole symbol at a time; only the phase and equalizer updates, which
+ * depend on carrier order, are done one carrier at a time.
  */
 class gr_ofdm_frame_sink : public gr_sync_block
 {
@@ -92,6 +97,14 @@ class gr_ofdm_frame_sink : public gr_sync_block
 
   std::vector<int> d_subcarrier_map;
 
+  // one symbol's worth of scratch for demapper()
+  std::vector<gr_complex>    d_sigrot;	// derotated and equalized
+  std::vector<float>         d_sig_re;
+  std::vector<float>         d_sig_im;
+  std::vector<float>         d_min_dist;
+  std::vector<int>           d_min_index;
+  std::vector<unsigned char> d_slice;	// slicer() of each d_sigrot
+
  protected:
   gr_ofdm_frame_sink(const std::vector<gr_complex> &sym_position, 
 		     const std::vector<unsigned char> &sym_value_out,
@@ -109,9 +122,12 @@ class gr_ofdm_frame_sink : public gr_sync_block
   }
   
   unsigned char slicer(const gr_complex x);
+  void slice_symbol(unsigned int n);
   unsigned int demapper(const gr_complex *in,
 			unsigned char *out);
 
+  void work_symbol(const gr_complex *in, char sig);
+
   bool set_sym_value_out(const std::vector<gr_complex> &sym_position, 
 			 const std::vector<unsigned char> &sym_value_out);
 
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2008 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -99,9 +99,9 @@ gr_ofdm_mapper_bcv::gr_ofdm_mapper_bcv (const std::vector<gr_complex> &constella
 
   unsigned int i,j,k;
   for(i = 0; i < carriers.length(); i++) {
-    char c = carriers[i];                            // get the current hex character from the string
+    char c[2] = {carriers[i], 0};                    // get the current hex character from the string
     for(j = 0; j < 4; j++) {                         // walk through all four bits
-      k = (strtol(&c, NULL, 16) >> (3-j)) & 0x1;     // convert to int and extract next bit
+      k = (strtol(c, NULL, 16) >> (3-j)) & 0x1;      // convert to int and extract next bit
       if(k) {                                        // if bit is a 1, 
 	d_subcarrier_map.push_back(4*(i+diff) + j);  // use this subcarrier
       }
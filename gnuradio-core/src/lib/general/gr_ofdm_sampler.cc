@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,6 +28,8 @@
 #include <gr_io_signature.h>
 #include <gr_expj.h>
 #include <cstdio>
+#include <algorithm>
+#include <string.h>
 
 gr_ofdm_sampler_sptr
 gr_make_ofdm_sampler (unsigned int fft_length, 
@@ -50,9 +52,7 @@ gr_ofdm_sampler::gr_ofdm_sampler (unsigned int fft_length,
 void
 gr_ofdm_sampler::forecast (int noutput_items, gr_vector_int &ninput_items_required)
 {
-  // FIXME do we need more
-  //int nreqd  = (noutput_items-1) * d_symbol_length + d_fft_length;
-  int nreqd  = d_symbol_length + d_fft_length;
+  int nreqd  = noutput_items * d_symbol_length + d_fft_length;
   unsigned ninputs = ninput_items_required.size ();
   for (unsigned i = 0; i < ninputs; i++)
     ninput_items_required[i] = nreqd;
@@ -71,62 +71,71 @@ gr_ofdm_sampler::general_work (int noutput_items,
   gr_complex *optr = (gr_complex *) output_items[0];
   char *outsig = (char *) output_items[1];
 
-  //FIXME: we only process a single OFDM symbol at a time; after the preamble, we can 
-  // process a few at a time as long as we always look out for the next preamble.
-
-  unsigned int index=d_fft_length;  // start one fft length into the input so we can always look back this far
-
-  outsig[0] = 0; // set output to no signal by default
-
-  // Search for a preamble trigger signal during the next symbol length
-  while((d_state != STATE_PREAMBLE) && (index <= (d_symbol_length+d_fft_length))) {
-    if(trigger[index]) {
-      outsig[0] = 1; // tell the next block there is a preamble coming
-      d_state = STATE_PREAMBLE;
+  // Each pass through the loop is one step of the state machine starting
+  // base samples in: a symbol out in PREAMBLE and FRAME, or one symbol
+  // length of searching in NO_SIG.  Keep going while there is enough
+  // input for a step, so the preamble search happens before every symbol.
+  unsigned int ninput = std::min(ninput_items[0], ninput_items[1]);
+  unsigned int base = 0;
+  int nout = 0;
+
+  while((nout < noutput_items) && (base + d_symbol_length + d_fft_length <= ninput)) {
+    const gr_complex *in = &iptr[base];
+    const char *trig = &trigger[base];
+
+    unsigned int index=d_fft_length;  // start one fft length into the input so we can always look back this far
+
+    memset(outsig, 0, d_fft_length); // set output to no signal by default
+
+    // Search for a preamble trigger signal during the next symbol length,
+    // as far as we have input.  In STATE_FRAME the last index is looked
+    // at again by the next step; in STATE_NO_SIG we only move up to it.
+    while((d_state != STATE_PREAMBLE) && (index <= (d_symbol_length+d_fft_length))
+	  && (base + index < ninput)) {
+      if(trig[index]) {
+	outsig[0] = 1; // tell the next block there is a preamble coming
+	d_state = STATE_PREAMBLE;
+      }
+      else
+	index++;
     }
-    else
-      index++;
-  }
   
-  unsigned int i, pos, ret;
-  switch(d_state) {
-  case(STATE_PREAMBLE):
-    // When we found a preamble trigger, get it and set the symbol boundary here
-    for(i = (index - d_fft_length + 1); i <= index; i++) {
-      *optr++ = iptr[i];
-    }
+    switch(d_state) {
+    case(STATE_PREAMBLE):
+      // When we found a preamble trigger, get it and set the symbol boundary here
+      memcpy(optr, &in[index - d_fft_length + 1], d_fft_length*sizeof(gr_complex));
     
-    d_timeout = d_timeout_max; // tell the system to expect at least this many symbols for a frame
-    d_state = STATE_FRAME;
-    consume_each(index - d_fft_length + 1); // consume up to one fft_length away to keep the history
-    ret = 1;
-    break;
+      d_timeout = d_timeout_max; // tell the system to expect at least this many symbols for a frame
+      d_state = STATE_FRAME;
+      base += index - d_fft_length + 1; // consume up to one fft length away to keep the history
+      break;
     
-  case(STATE_FRAME):
-    // use this state when we have processed a preamble and are getting the rest of the frames
-    //FIXME: we could also have a power squelch system here to enter STATE_NO_SIG if no power is received
-
-    // skip over fft length history and cyclic prefix
-    pos = d_symbol_length;         // keeps track of where we are in the input buffer
-    while(pos < d_symbol_length + d_fft_length) {
-      *optr++ = iptr[pos++];
-    }
+    case(STATE_FRAME):
+      // use this state when we have processed a preamble and are getting the rest of the frames
+      //FIXME: we could also have a power squelch system here to enter STATE_NO_SIG if no power is received
 
-    if(d_timeout-- == 0) {
-      printf("TIMEOUT\n");
-      d_state = STATE_NO_SIG;
-    }
+      // skip over fft length history and cyclic prefix
+      memcpy(optr, &in[d_symbol_length], d_fft_length*sizeof(gr_complex));
+
+      if(d_timeout-- == 0) {
+	printf("TIMEOUT\n");
+	d_state = STATE_NO_SIG;
+      }
 
-    consume_each(d_symbol_length); // jump up by 1 fft length and the cyclic prefix length
-    ret = 1;
-    break;
+      base += d_symbol_length; // jump up by 1 fft length and the cyclic prefix length
+      break;
+
+    case(STATE_NO_SIG):
+    default:
+      base += index-d_fft_length; // skip everything we've gone through so far leaving the fft length history
+      continue;
+    }
 
-  case(STATE_NO_SIG):
-  default:
-    consume_each(index-d_fft_length); // consume everything we've gone through so far leaving the fft length history
-    ret = 0;
-    break;
+    optr += d_fft_length;
+    outsig += d_fft_length;
+    nout++;
   }
 
-  return ret;
+  consume_each(base);
+  return nout;
 }
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -35,6 +35,11 @@ gr_ofdm_sampler_sptr gr_make_ofdm_sampler (unsigned int fft_length,
 /*!
  * \brief does the rest of the OFDM stuff
  * \ingroup ofdm_blk
+ *
+ * Cuts fft_length samples out of the stream for every symbol, lining
+ * the first one up with the preamble trigger.  It turns out as many
+ * symbols per call as the input allows, still checking for a new
+ * trigger before each one.
  */
 class gr_ofdm_sampler : public gr_block
 {
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2006 Free Software Foundation, Inc.
+ * Copyright 2004,2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,8 @@
 #endif
 
 #include <gr_pwr_squelch_cc.h>
+#include <gri_vector_arith.h>
+#include <algorithm>
 
 gr_pwr_squelch_cc_sptr
 gr_make_pwr_squelch_cc(double threshold, double alpha, int ramp, bool gate)
@@ -53,3 +55,20 @@ void gr_pwr_squelch_cc::update_state(const gr_complex &in)
 {
   d_pwr = d_iir.filter(in.real()*in.real()+in.imag()*in.imag());
 }
+
+int gr_pwr_squelch_cc::update_state_n(const gr_complex in[], int n, bool muted)
+{
+  const int chunk = 256;
+  float pwr[chunk];
+
+  for (int i = 0; i < n; i += chunk) {
+    int m = std::min(n - i, chunk);
+    gri_magnitude_squared(pwr, &in[i], m);
+    for (int k = 0; k < m; k++) {
+      d_pwr = d_iir.filter(pwr[k]);
+      if ((d_pwr < d_threshold) != muted)
+	return i + k + 1;
+    }
+  }
+  return n;
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -50,6 +50,7 @@ private:
 protected:
   virtual void update_state(const gr_complex &in);
   virtual bool mute() const { return d_pwr < d_threshold; }
+  virtual int update_state_n(const gr_complex in[], int n, bool muted);
   
 public:
   std::vector<float> squelch_range() const;
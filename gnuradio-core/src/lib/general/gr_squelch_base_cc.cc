@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2006 Free Software Foundation, Inc.
+ * Copyright 2004,2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,6 +26,7 @@
 
 #include <gr_squelch_base_cc.h>
 #include <gr_io_signature.h>
+#include <algorithm>
 
 gr_squelch_base_cc::gr_squelch_base_cc(const char *name, int ramp, bool gate) : 
 	gr_block(name,
@@ -39,6 +40,17 @@ gr_squelch_base_cc::gr_squelch_base_cc(const char *name, int ramp, bool gate) :
   d_ramped = 0;
 }
 
+int gr_squelch_base_cc::update_state_n(const gr_complex in[], int n, bool muted)
+{
+  int i = 0;
+  while (i < n) {
+    update_state(in[i++]);
+    if (mute() != muted)
+      break;
+  }
+  return i;
+}
+
 int gr_squelch_base_cc::general_work(int noutput_items,
 				     gr_vector_int &ninput_items,
 				     gr_vector_const_void_star &input_items,
@@ -47,10 +59,38 @@ int gr_squelch_base_cc::general_work(int noutput_items,
   const gr_complex *in = (const gr_complex *) input_items[0];
   gr_complex *out = (gr_complex *) output_items[0];
 
+  int i = 0;
   int j = 0;
 
-  for (int i = 0; i < noutput_items; i++) {
-    update_state(in[i]);
+  while (i < noutput_items) {
+    if (d_state == ST_MUTED || d_state == ST_UNMUTED) {
+      // Nothing changes until mute() does, so find where that is and
+      // pass everything before it through in one go
+      bool muted = (d_state == ST_MUTED);
+      int n = update_state_n(&in[i], noutput_items - i, muted);
+      if (mute() != muted)
+	n--;				// in[i+n] changed it; finish it below
+
+      if (!muted) {
+	if (d_envelope == 1.0)
+	  std::copy(&in[i], &in[i+n], &out[j]);
+	else
+	  for (int k = 0; k < n; k++)
+	    out[j+k] = in[i+k]*gr_complex(d_envelope, 0.0);
+	j += n;
+      }
+      else if (!d_gate) {
+	std::fill(&out[j], &out[j+n], gr_complex(0.0));
+	j += n;
+      }
+
+      i += n;
+      if (i == noutput_items)
+	break;
+      // update_state has already seen in[i]
+    }
+    else
+      update_state(in[i]);
 
     // Adjust envelope based on current state
     switch(d_state) {
@@ -86,6 +126,7 @@ int gr_squelch_base_cc::general_work(int noutput_items,
     else
       if (!d_gate)
           out[j++] = 0.0;
+    i++;
   }
 
   consume_each(noutput_items);  // Use all the inputs
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -38,6 +38,14 @@ protected:
   virtual void update_state(const gr_complex &sample) {};
   virtual bool mute() const { return false; };
 
+  /*!
+   * Calls update_state on in[0], in[1], ... until mute() stops
+   * returning \p muted, or all \p n have been seen, and returns how
+   * many were seen.  Override it to do the same without a virtual
+   * call or two per sample.
+   */
+  virtual int update_state_n(const gr_complex in[], int n, bool muted);
+
 public:
   gr_squelch_base_cc(const char *name, int ramp, bool gate);
 
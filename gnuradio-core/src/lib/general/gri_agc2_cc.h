@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,7 @@
 #define _GRI_AGC2_CC_H_
 
 #include <math.h>
+#include <gri_vector_arith.h>
 
 /*!
  * \brief high performance Automatic Gain Control class
@@ -74,9 +75,29 @@ class gri_agc2_cc {
     return output;
   }
 
+  /*
+   * The same as scale() on each sample, with the magnitudes found a
+   * chunk at a time first, as gri_agc_cc::scaleN does.
+   */
   void scaleN (gr_complex output[], const gr_complex input[], unsigned n){
-    for (unsigned i = 0; i < n; i++)
-      output[i] = scale (input[i]);
+    const unsigned chunk = 256;
+    float mag[chunk], gain[chunk];
+
+    for (unsigned i = 0; i < n; i += chunk){
+      unsigned m = n - i < chunk ? n - i : chunk;
+      gri_magnitude (mag, &input[i], m);
+      for (unsigned j = 0; j < m; j++){
+	gain[j] = _gain;
+	float tmp = -_reference + fabsf(_gain) * mag[j];
+	float rate = tmp > _gain ? _attack_rate : _decay_rate;
+	_gain -= tmp*rate;
+	if (_gain < 0.0)
+	  _gain = 10e-5;
+	if (_max_gain > 0.0 && _gain > _max_gain)
+	  _gain = _max_gain;
+      }
+      gri_multiply (&output[i], &input[i], gain, m);
+    }
   }
   
  protected:
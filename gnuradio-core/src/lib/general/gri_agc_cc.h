@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,7 @@
 #define INCLUDED_GRI_AGC_CC_H
 
 #include <math.h>
+#include <gri_vector_arith.h>
 
 /*!
  * \brief high performance Automatic Gain Control class
@@ -59,9 +60,27 @@ class gri_agc_cc {
     return output;
   }
 
+  /*
+   * The same as scale() on each sample.  |input * gain| is |input| *
+   * |gain|, so the magnitudes are found first, a chunk at a time, and
+   * the sqrt is out of the loop that carries the gain from sample to
+   * sample.  Then the chunk is scaled by the gains that loop left.
+   */
   void scaleN (gr_complex output[], const gr_complex input[], unsigned n){
-    for (unsigned i = 0; i < n; i++)
-      output[i] = scale (input[i]);
+    const unsigned chunk = 256;
+    float mag[chunk], gain[chunk];
+
+    for (unsigned i = 0; i < n; i += chunk){
+      unsigned m = n - i < chunk ? n - i : chunk;
+      gri_magnitude (mag, &input[i], m);
+      for (unsigned j = 0; j < m; j++){
+	gain[j] = _gain;
+	_gain += _rate * (_reference - fabsf(_gain) * mag[j]);
+	if (_max_gain > 0.0 && _gain > _max_gain)
+	  _gain = _max_gain;
+      }
+      gri_multiply (&output[i], &input[i], gain, m);
+    }
   }
   
  protected:
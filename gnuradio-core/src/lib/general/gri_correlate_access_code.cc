@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_correlate_access_code.h>
+#include <stdexcept>
+
+gri_correlate_access_code::gri_correlate_access_code (const std::string &access_code,
+						      int threshold)
+  : d_access_code (0), d_mask (0), d_threshold (threshold), d_data_reg (0)
+{
+  if (!set_access_code (access_code))
+    throw std::out_of_range ("access_code must be 1 to 64 bits");
+}
+
+bool
+gri_correlate_access_code::set_access_code (const std::string &access_code)
+{
+  unsigned len = access_code.length ();	// # of bytes in string
+  if (len == 0 || len > 64)
+    return false;
+
+  d_mask = (~0ULL) >> (64 - len);	// low len bits
+  d_access_code = 0;
+  for (unsigned i = 0; i < len; i++)
+    d_access_code = (d_access_code << 1) | (access_code[i] & 1);	// LSB only
+
+  return true;
+}
+
+unsigned int
+gri_correlate_access_code::code_length () const
+{
+  return popcount (d_mask);
+}
+
+/*
+ * For all 64 positions at once, count the errors in the last
+ * FILTER_BITS bits of the code in a bit-sliced counter: bit (63 - j)
+ * of c0, c1 and c2 is the count for the code ending at bit j, and of
+ * over is set once it passes 7.  Most positions in random data are
+ * ruled out here, and only the rest get compared against the whole
+ * code.
+ */
+uint64_t
+gri_correlate_access_code::hits64 (uint64_t word) const
+{
+  static const unsigned int FILTER_BITS = 16;
+  unsigned int len = code_length ();
+  unsigned int nfilter = len < FILTER_BITS ? len : FILTER_BITS;
+
+  uint64_t candidates = ~0ULL;
+
+  if (d_threshold < 7){
+    uint64_t c0 = 0, c1 = 0, c2 = 0, over = 0;
+
+    for (unsigned int d = 0; d < nfilter; d++){
+      // the bit d before each position, and whether it is wrong
+      uint64_t bits = d == 0 ? word : (word >> d) | (d_data_reg << (64 - d));
+      uint64_t wrong = (d_access_code >> d) & 1 ? ~bits : bits;
+
+      uint64_t carry = c0 & wrong;
+      c0 ^= wrong;
+      wrong = c1 & carry;
+      c1 ^= carry;
+      over |= c2 & wrong;
+      c2 ^= wrong;
+    }
+
+    // keep the positions with count <= d_threshold
+    uint64_t gt = over, eq = ~over;
+    uint64_t c[3] = { c0, c1, c2 };
+    for (int i = 2; i >= 0; i--){
+      if ((d_threshold >> i) & 1)
+	eq &= c[i];
+      else {
+	gt |= eq & c[i];
+	eq &= ~c[i];
+      }
+    }
+    candidates = ~gt;
+  }
+
+  uint64_t hits = 0;
+  for (int j = 0; candidates != 0; j += 8, candidates <<= 8){
+    if ((candidates >> 56) == 0)
+      continue;
+    for (int k = j; k < j + 8; k++)
+      if (match (((d_data_reg << k) << 1) | (word >> (63 - k))))
+	hits |= 1ULL << (63 - k);
+  }
+  return hits;
+}
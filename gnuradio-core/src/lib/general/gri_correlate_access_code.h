@@ -0,0 +1,103 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_CORRELATE_ACCESS_CODE_H
+#define INCLUDED_GRI_CORRELATE_ACCESS_CODE_H
+
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Find an access code in a packed bit stream, many offsets at a time
+ * \ingroup misc
+ *
+ * The bits are packed 8 to a byte, MSB first, as gr_packed_to_unpacked_bb
+ * with GR_MSB_FIRST would unpack them.  Bit j of a chunk of input means
+ * the j'th bit in time, counting from the MSB of its first byte.
+ *
+ * hits8 and hits64 compare the access code against every position that
+ * ends in the next 8 or 64 bits, using word-wide shifts and a popcount
+ * per position instead of shifting in one bit at a time.  hits64 first
+ * counts the errors in the last few bits of the code for all 64
+ * positions at once, bit-sliced, and only does the popcount for the
+ * positions that could still match.  They return
+ * a mask with the bit for j set (0x80 >> j or 1ULL << (63 - j)) when
+ * the code, with at most threshold bits wrong, ends at bit j.  Neither
+ * changes the state; call shift8 or shift64 to move past the bits.
+ *
+ * Like gr_correlate_access_code_bb, the history starts out all zeros.
+ */
+class gri_correlate_access_code {
+  uint64_t	d_access_code;	// right justified
+  uint64_t	d_mask;		// low len bits set
+  unsigned int	d_threshold;	// how many bits may be wrong
+  uint64_t	d_data_reg;	// last 64 bits seen, newest in the LSB
+
+  static unsigned int popcount (uint64_t x)
+  {
+#ifdef __POPCNT__
+    return __builtin_popcountll (x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+#endif
+  }
+
+  bool match (uint64_t window) const
+  {
+    return popcount ((window ^ d_access_code) & d_mask) <= d_threshold;
+  }
+
+public:
+  /*!
+   * \param access_code is represented with 1 byte per bit, e.g., "010101010111000100"
+   * \param threshold maximum number of bits that may be wrong
+   * \throws std::out_of_range if access_code is empty or longer than 64 bits
+   */
+  gri_correlate_access_code (const std::string &access_code, int threshold);
+
+  //! returns false, and changes nothing, if access_code is empty or > 64 bits
+  bool set_access_code (const std::string &access_code);
+  void set_threshold (int threshold) { d_threshold = threshold; }
+
+  unsigned int code_length () const;
+
+  //! the code ending at each of the 8 bits of \p byte
+  unsigned int hits8 (unsigned char byte) const
+  {
+    unsigned int hits = 0;
+    for (int j = 0; j < 8; j++)
+      if (match (((d_data_reg << j) << 1) | (byte >> (7 - j))))
+	hits |= 0x80 >> j;
+    return hits;
+  }
+
+  //! the code ending at each of the 64 bits of \p word (first bit in the MSB)
+  uint64_t hits64 (uint64_t word) const;
+
+  void shift8 (unsigned char byte) { d_data_reg = (d_data_reg << 8) | byte; }
+  void shift64 (uint64_t word) { d_data_reg = word; }
+};
+
+#endif /* INCLUDED_GRI_CORRELATE_ACCESS_CODE_H */
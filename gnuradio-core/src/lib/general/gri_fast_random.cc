@@ -0,0 +1,268 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_fast_random.h>
+#include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Ziggurat tables, after J. A. Doornik, "An Improved Ziggurat Method
+ * to Generate Normal Random Samples", 2005.  x[i] is the right edge
+ * of layer i (x[0] is the width the base layer would need to have the
+ * same area as the others), r[i] = x[i+1] / x[i].
+ */
+static const int    ZIG_LAYERS = 128;
+static const double ZIG_R = 3.442619855899;		// start of the tail
+static const double ZIG_V = 9.91256303526217e-3;	// area of each layer
+
+struct zig_tables {
+  float	x[ZIG_LAYERS + 1];
+  float	r[ZIG_LAYERS];
+
+  zig_tables ()
+  {
+    double xd[ZIG_LAYERS + 1];
+    double f = exp (-0.5 * ZIG_R * ZIG_R);
+
+    xd[0] = ZIG_V / f;
+    xd[1] = ZIG_R;
+    xd[ZIG_LAYERS] = 0;
+    for (int i = 2; i < ZIG_LAYERS; i++){
+      xd[i] = sqrt (-2 * log (ZIG_V / xd[i - 1] + f));
+      f = exp (-0.5 * xd[i] * xd[i]);
+    }
+
+    for (int i = 0; i <= ZIG_LAYERS; i++)
+      x[i] = xd[i];
+    for (int i = 0; i < ZIG_LAYERS; i++)
+      r[i] = xd[i + 1] / xd[i];
+  }
+};
+
+static const zig_tables &
+zig ()
+{
+  static zig_tables t;
+  return t;
+}
+
+// top 7 bits pick the layer, the other 25 make a signed u in [-1, 1)
+static inline int
+zig_layer (uint32_t w)
+{
+  return w >> 25;
+}
+
+static inline float
+zig_u (uint32_t w)
+{
+  return (int32_t) (w << 7) * (1.0f / 2147483648.0f);
+}
+
+static uint64_t
+splitmix64 (uint64_t &x)
+{
+  uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+gri_fast_random::gri_fast_random (long seed, unsigned int stream)
+{
+  zig ();			// build the tables now, not in a work method
+  reseed (seed, stream);
+}
+
+void
+gri_fast_random::reseed (long seed, unsigned int stream)
+{
+  uint64_t x = (uint64_t) seed ^ ((uint64_t) stream * 0xD1B54A32D192ED03ULL);
+
+  for (int lane = 0; lane < NLANES; lane++){
+    uint64_t a = splitmix64 (x);
+    uint64_t b = splitmix64 (x);
+    d_s[0][lane] = a;
+    d_s[1][lane] = a >> 32;
+    d_s[2][lane] = b;
+    d_s[3][lane] = b >> 32;
+    if ((d_s[0][lane] | d_s[1][lane] | d_s[2][lane] | d_s[3][lane]) == 0)
+      d_s[0][lane] = 1;		// all zeros is a fixed point
+  }
+
+  d_idx = BUFSIZE;
+}
+
+/*
+ * Step all four xoshiro128+ lanes BUFSIZE / NLANES times.  Word k of
+ * the buffer comes from lane k % NLANES.
+ */
+void
+gri_fast_random::refill ()
+{
+#ifdef __SSE2__
+  __m128i s0 = _mm_loadu_si128 ((__m128i *) d_s[0]);
+  __m128i s1 = _mm_loadu_si128 ((__m128i *) d_s[1]);
+  __m128i s2 = _mm_loadu_si128 ((__m128i *) d_s[2]);
+  __m128i s3 = _mm_loadu_si128 ((__m128i *) d_s[3]);
+
+  for (int k = 0; k < BUFSIZE; k += NLANES){
+    _mm_storeu_si128 ((__m128i *) &d_buf[k], _mm_add_epi32 (s0, s3));
+
+    __m128i t = _mm_slli_epi32 (s1, 9);
+    s2 = _mm_xor_si128 (s2, s0);
+    s3 = _mm_xor_si128 (s3, s1);
+    s1 = _mm_xor_si128 (s1, s2);
+    s0 = _mm_xor_si128 (s0, s3);
+    s2 = _mm_xor_si128 (s2, t);
+    s3 = _mm_or_si128 (_mm_slli_epi32 (s3, 11), _mm_srli_epi32 (s3, 21));
+  }
+
+  _mm_storeu_si128 ((__m128i *) d_s[0], s0);
+  _mm_storeu_si128 ((__m128i *) d_s[1], s1);
+  _mm_storeu_si128 ((__m128i *) d_s[2], s2);
+  _mm_storeu_si128 ((__m128i *) d_s[3], s3);
+#else
+  for (int lane = 0; lane < NLANES; lane++){
+    uint32_t s0 = d_s[0][lane], s1 = d_s[1][lane];
+    uint32_t s2 = d_s[2][lane], s3 = d_s[3][lane];
+
+    for (int k = lane; k < BUFSIZE; k += NLANES){
+      d_buf[k] = s0 + s3;
+
+      uint32_t t = s1 << 9;
+      s2 ^= s0;
+      s3 ^= s1;
+      s1 ^= s2;
+      s0 ^= s3;
+      s2 ^= t;
+      s3 = (s3 << 11) | (s3 >> 21);
+    }
+
+    d_s[0][lane] = s0; d_s[1][lane] = s1;
+    d_s[2][lane] = s2; d_s[3][lane] = s3;
+  }
+#endif
+
+  d_idx = 0;
+}
+
+void
+gri_fast_random::uniform (float *out, int n)
+{
+  while (n > 0){
+    if (d_idx == BUFSIZE)
+      refill ();
+
+    int m = BUFSIZE - d_idx;
+    if (m > n)
+      m = n;
+
+    const uint32_t *w = &d_buf[d_idx];
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 scale = _mm_set1_ps (1.0f / 16777216.0f);
+    for (; i + 4 <= m; i += 4){
+      __m128i v = _mm_srli_epi32 (_mm_loadu_si128 ((const __m128i *) &w[i]), 8);
+      _mm_storeu_ps (&out[i], _mm_mul_ps (_mm_cvtepi32_ps (v), scale));
+    }
+#endif
+    for (; i < m; i++)
+      out[i] = (w[i] >> 8) * (1.0f / 16777216.0f);
+
+    d_idx += m;
+    out += m;
+    n -= m;
+  }
+}
+
+/*
+ * The ~1.5% of words that don't land inside a layer's rectangle.
+ * Either it's in the wedge under the curve, the tail (layer 0), or
+ * we start over with a fresh word.
+ */
+float
+gri_fast_random::gaussian_slow (uint32_t w)
+{
+  const zig_tables &t = zig ();
+
+  for (;;){
+    int i = zig_layer (w);
+    float u = zig_u (w);
+
+    if (fabsf (u) < t.r[i])
+      return u * t.x[i];
+
+    if (i == 0){			// Marsaglia's tail algorithm
+      double a, b;
+      do {
+	a = -log (1.0 - uniform ()) / ZIG_R;	// 1 - uniform () is in (0, 1]
+	b = -log (1.0 - uniform ());
+      } while (b + b < a * a);
+      return u < 0 ? -(ZIG_R + a) : ZIG_R + a;
+    }
+
+    float x = u * t.x[i];
+    float f0 = expf (-0.5f * (t.x[i] * t.x[i] - x * x));
+    float f1 = expf (-0.5f * (t.x[i + 1] * t.x[i + 1] - x * x));
+    if (f1 + uniform () * (f0 - f1) < 1.0f)
+      return x;
+
+    w = next_u32 ();
+  }
+}
+
+float
+gri_fast_random::gaussian ()
+{
+  const zig_tables &t = zig ();
+  uint32_t w = next_u32 ();
+  int i = zig_layer (w);
+  float u = zig_u (w);
+
+  if (fabsf (u) < t.r[i])
+    return u * t.x[i];
+  return gaussian_slow (w);
+}
+
+void
+gri_fast_random::gaussian (float *out, int n)
+{
+  const zig_tables &t = zig ();
+
+  for (int k = 0; k < n; k++){
+    uint32_t w = next_u32 ();
+    int i = zig_layer (w);
+    float u = zig_u (w);
+
+    if (fabsf (u) < t.r[i])
+      out[k] = u * t.x[i];
+    else
+      out[k] = gaussian_slow (w);
+  }
+}
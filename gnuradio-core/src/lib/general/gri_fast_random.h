@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_FAST_RANDOM_H
+#define INCLUDED_GRI_FAST_RANDOM_H
+
+#include <stdint.h>
+
+/*!
+ * \brief Fast pseudo random number generator for noise sources
+ *
+ * Four interleaved xoshiro128+ generators, stepped together with SSE2
+ * when it's available.  The scalar code produces exactly the same
+ * sequence, so a given (seed, stream) gives the same numbers on every
+ * machine, however the output is split up between calls.
+ *
+ * Gaussian deviates use a 128 layer ziggurat.  Each one normally costs
+ * a single 32-bit word and a table lookup.
+ *
+ * Different \p stream numbers with the same seed give independent
+ * sequences, e.g. for the I and Q channels or several noise sources
+ * in one simulation.
+ */
+class gri_fast_random {
+  static const int NLANES = 4;
+  static const int BUFSIZE = 256;	// words, multiple of NLANES
+
+  uint32_t	d_s[4][NLANES];		// state word x lane
+  uint32_t	d_buf[BUFSIZE];
+  int		d_idx;			// next unused word in d_buf
+
+  void refill ();
+  float gaussian_slow (uint32_t u);
+
+public:
+  gri_fast_random (long seed = 3021, unsigned int stream = 0);
+
+  void reseed (long seed, unsigned int stream = 0);
+
+  //! next 32 random bits
+  uint32_t next_u32 ()
+  {
+    if (d_idx == BUFSIZE)
+      refill ();
+    return d_buf[d_idx++];
+  }
+
+  //! uniform random deviate in the range [0.0, 1.0)
+  float uniform () { return (next_u32 () >> 8) * (1.0f / 16777216.0f); }
+
+  //! normally distributed deviate with zero mean and variance 1
+  float gaussian ();
+
+  //! fill \p out with \p n uniform deviates in [0.0, 1.0)
+  void uniform (float *out, int n);
+
+  //! fill \p out with \p n normal deviates, zero mean and variance 1
+  void gaussian (float *out, int n);
+};
+
+#endif /* INCLUDED_GRI_FAST_RANDOM_H */
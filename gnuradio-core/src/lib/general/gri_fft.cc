@@ -87,7 +87,7 @@ gri_fftw_export_wisdom ()
 
 // ----------------------------------------------------------------
 
-gri_fft_complex::gri_fft_complex (int fft_size, bool forward)
+gri_fft_complex::gri_fft_complex (int fft_size, bool forward, int batch, bool in_place)
 {
   // Hold global mutex during plan construction and destruction.
   gri_fft_planner::scoped_lock	lock(gri_fft_planner::mutex());
@@ -96,28 +96,38 @@ gri_fft_complex::gri_fft_complex (int fft_size, bool forward)
   
   if (fft_size <= 0)
     throw std::out_of_range ("gri_fftw: invalid fft_size");
+  if (batch <= 0)
+    throw std::out_of_range ("gri_fftw: invalid batch");
   
   d_fft_size = fft_size;
+  d_batch = batch;
+  d_in_place = in_place;
   d_inbuf = (gr_complex *) fftwf_malloc (sizeof (gr_complex) * inbuf_length ());
   if (d_inbuf == 0)
     throw std::runtime_error ("fftwf_malloc");
   
-  d_outbuf = (gr_complex *) fftwf_malloc (sizeof (gr_complex) * outbuf_length ());
-  if (d_outbuf == 0){
-    fftwf_free (d_inbuf);
-    throw std::runtime_error ("fftwf_malloc");
+  if (in_place)
+    d_outbuf = d_inbuf;
+  else {
+    d_outbuf = (gr_complex *) fftwf_malloc (sizeof (gr_complex) * outbuf_length ());
+    if (d_outbuf == 0){
+      fftwf_free (d_inbuf);
+      throw std::runtime_error ("fftwf_malloc");
+    }
   }
 
   gri_fftw_import_wisdom ();	// load prior wisdom from disk
-  d_plan = fftwf_plan_dft_1d (fft_size,
-			      reinterpret_cast<fftwf_complex *>(d_inbuf), 
-			      reinterpret_cast<fftwf_complex *>(d_outbuf),
-			      forward ? FFTW_FORWARD : FFTW_BACKWARD,
-			      FFTW_MEASURE);
+  d_plan = fftwf_plan_many_dft (1, &fft_size, batch,
+				reinterpret_cast<fftwf_complex *>(d_inbuf),
+				0, 1, fft_size,
+				reinterpret_cast<fftwf_complex *>(d_outbuf),
+				0, 1, fft_size,
+				forward ? FFTW_FORWARD : FFTW_BACKWARD,
+				FFTW_MEASURE);
 
   if (d_plan == NULL) {
     fprintf(stderr, "gri_fft_complex: error creating plan\n");
-    throw std::runtime_error ("fftwf_plan_dft_1d failed");
+    throw std::runtime_error ("fftwf_plan_many_dft failed");
   }
   gri_fftw_export_wisdom ();	// store new wisdom to disk
 }
@@ -129,7 +139,8 @@ gri_fft_complex::~gri_fft_complex ()
 
   fftwf_destroy_plan ((fftwf_plan) d_plan);
   fftwf_free (d_inbuf);
-  fftwf_free (d_outbuf);
+  if (!d_in_place)
+    fftwf_free (d_outbuf);
 }
 
 void
@@ -138,6 +149,18 @@ gri_fft_complex::execute ()
   fftwf_execute ((fftwf_plan) d_plan);
 }
 
+void
+gri_fft_complex::execute (const gr_complex *in, gr_complex *out)
+{
+  assert (is_aligned (in) && is_aligned (out));
+  assert ((in == out) == d_in_place);
+
+  // out-of-place complex transforms don't modify their input
+  fftwf_execute_dft ((fftwf_plan) d_plan,
+		     reinterpret_cast<fftwf_complex *>(const_cast<gr_complex *>(in)),
+		     reinterpret_cast<fftwf_complex *>(out));
+}
+
 // ----------------------------------------------------------------
 
 gri_fft_real_fwd::gri_fft_real_fwd (int fft_size)
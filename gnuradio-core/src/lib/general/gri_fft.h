@@ -45,15 +45,21 @@ public:
 /*!
  * \brief FFT: complex in, complex out
  * \ingroup misc
+ *
+ * Computes \p batch transforms of \p fft_size points at a time, from
+ * vectors laid out back to back.  If \p in_place is true, the output
+ * overwrites the input, and get_inbuf() == get_outbuf().
  */
 class gri_fft_complex {
   int	      d_fft_size;
+  int	      d_batch;
+  bool	      d_in_place;
   gr_complex *d_inbuf;
   gr_complex *d_outbuf;
   void	     *d_plan;
   
 public:
-  gri_fft_complex (int fft_size, bool forward = true);
+  gri_fft_complex (int fft_size, bool forward = true, int batch = 1, bool in_place = false);
   virtual ~gri_fft_complex ();
 
   /*
@@ -64,13 +70,26 @@ public:
   gr_complex *get_inbuf ()  const { return d_inbuf; }
   gr_complex *get_outbuf () const { return d_outbuf; }
 
-  int inbuf_length ()  const { return d_fft_size; }
-  int outbuf_length () const { return d_fft_size; }
+  int inbuf_length ()  const { return d_fft_size * d_batch; }
+  int outbuf_length () const { return d_fft_size * d_batch; }
+
+  int batch () const { return d_batch; }
+  bool in_place () const { return d_in_place; }
 
   /*!
    * compute FFT.  The input comes from inbuf, the output is placed in outbuf.
    */
   void execute ();
+
+  /*!
+   * \brief compute FFT from \p in to \p out, instead of inbuf to outbuf.
+   *
+   * Both must satisfy is_aligned(), and in == out iff in_place().
+   */
+  void execute (const gr_complex *in, gr_complex *out);
+
+  //! True if \p p is aligned well enough to be passed to execute(in, out)
+  static bool is_aligned (const void *p) { return ((size_t) p & 15) == 0; }
 };
 
 /*!
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -21,6 +21,7 @@
  */
 
 #include <gri_glfsr.h>
+#include <gri_pack_bits.h>
 #include <stdexcept>
 
 static int s_polynomial_masks[] = {
@@ -65,3 +66,32 @@ int gri_glfsr::glfsr_mask(int degree)
     throw std::runtime_error("gri_glfsr::glfsr_mask(): degree must be between 1 and 32 inclusive");
   return s_polynomial_masks[degree];
 }
+
+void
+gri_glfsr::next_bits(unsigned char *out, int n)
+{
+  int i = 0;
+
+  if (n >= 32){
+    if (!d_jump.built()){
+      uint64_t image[64] = { 0 };
+      for (int b = 0; b < 32; b++){
+	gri_glfsr g(d_mask, (int) (1U << b));
+	uint64_t bits = 0;
+	for (int j = 0; j < 32; j++)
+	  bits |= (uint64_t) g.next_bit() << j;
+	image[b] = (uint32_t) g.d_shift_register | (bits << 32);
+      }
+      d_jump.build(image, false);
+    }
+
+    for (; i + 32 <= n; i += 32){
+      uint64_t r = d_jump.step32((uint32_t) d_shift_register);
+      d_shift_register = (int) (uint32_t) r;
+      gri_unpack_lsbs_32(r >> 32, &out[i]);
+    }
+  }
+
+  for (; i < n; i++)
+    out[i] = next_bit();
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -23,6 +23,8 @@
 #ifndef INCLUDED_GRI_GLFSR_H
 #define INCLUDED_GRI_GLFSR_H
 
+#include <gri_lfsr_jump.h>
+
 /*!
  * \brief Galois Linear Feedback Shift Register using specified polynomial mask
  * \ingroup misc
@@ -35,6 +37,7 @@ class gri_glfsr
  private:
   int d_shift_register;
   int d_mask;
+  gri_lfsr_jump d_jump;		// built the first time next_bits is called
 
  public:
 
@@ -49,6 +52,9 @@ class gri_glfsr
     return bit;
   }
 
+  //! out[i] = next_bit(), for i = 0 .. n - 1, 32 steps at a time
+  void next_bits(unsigned char *out, int n);
+
   int mask() const { return d_mask; }
 };
 
@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_lfsr.h>
+#include <gri_pack_bits.h>
+
+/*
+ * Run 32 single steps from each unit register and input.  Register
+ * bits above reg_len never get used by the jump, so leave them out.
+ */
+void
+gri_lfsr::build_jump(mode_t mode)
+{
+  uint32_t saved = d_shift_register;
+  bool has_input = mode != PLAIN;
+  uint64_t image[64];
+
+  for (int b = 0; b < 64; b++){
+    image[b] = 0;
+    if ((b < 32 && (uint32_t) b > d_shift_register_length) || (b >= 32 && !has_input))
+      continue;
+
+    d_shift_register = b < 32 ? 1U << b : 0;
+    uint64_t out = 0;
+    for (int j = 0; j < 32; j++)
+      out |= (uint64_t) step(mode, j == b - 32) << j;
+    image[b] = d_shift_register | (out << 32);
+  }
+
+  d_shift_register = saved;
+  d_jump[mode].build(image, has_input);
+}
+
+void
+gri_lfsr::next_bits(mode_t mode, unsigned char *out, const unsigned char *in, int n)
+{
+  int i = 0;
+
+  // a seed with bits above reg_len isn't linear until they're shifted out
+  for (; i < n && (d_shift_register >> d_shift_register_length) > 1; i++)
+    out[i] = step(mode, in ? in[i] : 0);
+
+  if (n - i >= 32){
+    if (!d_jump[mode].built())
+      build_jump(mode);
+    const gri_lfsr_jump &jump = d_jump[mode];
+
+    for (; i + 32 <= n; i += 32){
+      uint64_t r = jump.step32(d_shift_register, in ? gri_pack_lsbs_32(&in[i]) : 0);
+      d_shift_register = (uint32_t) r;
+      gri_unpack_lsbs_32(r >> 32, &out[i]);
+    }
+  }
+
+  for (; i < n; i++)
+    out[i] = step(mode, in ? in[i] : 0);
+}
@@ -23,6 +23,7 @@
 #ifndef INCLUDED_GRI_LFSR_H
 #define INCLUDED_GRI_LFSR_H
 
+#include <gri_lfsr_jump.h>
 #include <stdexcept>
 #include <stdint.h>
 
@@ -79,6 +80,12 @@
  * See http://en.wikipedia.org/wiki/Scrambler for operation of these
  * last two functions (see multiplicative scrambler.)
  *
+ *  next_bits(), next_bits_scramble(), next_bits_descramble()
+ *
+ *      The same, for n bits at a time, one bit per byte.  These take
+ *      32 steps at a time with gri_lfsr_jump, whose tables are built
+ *      the first time each is called.
+ *
  */
 
 class gri_lfsr
@@ -89,6 +96,9 @@ class gri_lfsr
   uint32_t d_seed;
   uint32_t d_shift_register_length;	// less than 32
 
+  enum mode_t { PLAIN, SCRAMBLE, DESCRAMBLE };
+  gri_lfsr_jump d_jump[3];		// indexed by mode_t
+
   static uint32_t
   popCount(uint32_t x)
   {
@@ -145,7 +155,29 @@ class gri_lfsr
     }
   }
 
+  void next_bits(unsigned char *out, int n) { next_bits(PLAIN, out, 0, n); }
+
+  void next_bits_scramble(unsigned char *out, const unsigned char *in, int n) {
+    next_bits(SCRAMBLE, out, in, n);
+  }
+
+  void next_bits_descramble(unsigned char *out, const unsigned char *in, int n) {
+    next_bits(DESCRAMBLE, out, in, n);
+  }
+
   int mask() const { return d_mask; }
+
+ private:
+  unsigned char step(mode_t mode, unsigned char input) {
+    switch (mode){
+    case SCRAMBLE:	return next_bit_scramble(input);
+    case DESCRAMBLE:	return next_bit_descramble(input);
+    default:		return next_bit();
+    }
+  }
+
+  void build_jump(mode_t mode);
+  void next_bits(mode_t mode, unsigned char *out, const unsigned char *in, int n);
 };
 
 #endif /* INCLUDED_GRI_LFSR_H */
@@ -0,0 +1,47 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_lfsr_jump.h>
+
+void
+gri_lfsr_jump::build(const uint64_t *image, bool has_input)
+{
+  int nchunks = has_input ? 8 : 4;
+
+  d_has_input = has_input;
+  d_table.assign(8 * 256, 0);
+
+  // entry v of chunk c is the xor of the images of the bits set in v
+  for (int c = 0; c < nchunks; c++){
+    uint64_t *t = &d_table[c * 256];
+    for (int v = 1; v < 256; v++){
+      int b = 0;
+      while (((v >> b) & 1) == 0)
+	b++;
+      t[v] = t[v & (v - 1)] ^ image[8 * c + b];
+    }
+  }
+}
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_LFSR_JUMP_H
+#define INCLUDED_GRI_LFSR_JUMP_H
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Take 32 steps of a linear shift register at once
+ * \ingroup misc
+ *
+ * Works for any register of up to 32 bits whose single step is linear
+ * over GF(2) in the register and an input bit: the Fibonacci and Galois
+ * LFSRs and the multiplicative scrambler and descrambler all are.
+ * Then 32 steps are a linear map from (register, 32 input bits) to
+ * (register, 32 output bits), which is applied as the xor of eight
+ * byte-indexed table lookups.
+ *
+ * The caller supplies the map by running its own single step 32 times
+ * from each of the 64 unit vectors, so the result is bit for bit what
+ * the single step would give.
+ */
+class gri_lfsr_jump
+{
+  std::vector<uint64_t> d_table;	// [8][256]; 0-3 register, 4-7 input
+  bool			d_has_input;
+
+ public:
+  gri_lfsr_jump() : d_has_input(false) {}
+
+  /*!
+   * \param image image[b] is the new register in the low 32 bits, and
+   *        the 32 output bits (step j in bit j) in the high 32 bits,
+   *        after 32 steps from register bit b (b < 32), or from input
+   *        bit b - 32 with an all zero register.
+   * \param has_input if false, image[32..63] isn't used and the input is
+   *        taken to be all zeros.
+   */
+  void build(const uint64_t *image, bool has_input);
+
+  bool built() const { return !d_table.empty(); }
+
+  //! the new register in the low 32 bits, the output in the high 32 bits
+  uint64_t step32(uint32_t reg, uint32_t input = 0) const
+  {
+    const uint64_t *t = &d_table[0];
+    uint64_t r = (t[0 * 256 + (reg & 0xff)]
+		  ^ t[1 * 256 + ((reg >> 8) & 0xff)]
+		  ^ t[2 * 256 + ((reg >> 16) & 0xff)]
+		  ^ t[3 * 256 + (reg >> 24)]);
+    if (d_has_input)
+      r ^= (t[4 * 256 + (input & 0xff)]
+	    ^ t[5 * 256 + ((input >> 8) & 0xff)]
+	    ^ t[6 * 256 + ((input >> 16) & 0xff)]
+	    ^ t[7 * 256 + (input >> 24)]);
+    return r;
+  }
+};
+
+#endif /* INCLUDED_GRI_LFSR_JUMP_H */
@@ -0,0 +1,51 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_pack_bits.h>
+
+struct pack_tables {
+  unsigned char lsb_first[256][8];
+  unsigned char msb_first[256][8];
+  unsigned char reverse[256];
+
+  pack_tables()
+  {
+    for (int v = 0; v < 256; v++){
+      reverse[v] = 0;
+      for (int k = 0; k < 8; k++){
+	lsb_first[v][k] = (v >> k) & 1;
+	msb_first[v][k] = (v >> (7 - k)) & 1;
+	reverse[v] |= ((v >> k) & 1) << (7 - k);
+      }
+    }
+  }
+};
+
+static const pack_tables s_tables;
+
+const unsigned char (&gri_unpack_lsb_first)[256][8] = s_tables.lsb_first;
+const unsigned char (&gri_unpack_msb_first)[256][8] = s_tables.msb_first;
+const unsigned char (&gri_reverse_bits8)[256] = s_tables.reverse;
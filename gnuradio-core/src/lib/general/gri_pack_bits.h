@@ -0,0 +1,72 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_PACK_BITS_H
+#define INCLUDED_GRI_PACK_BITS_H
+
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Moving between one bit per byte, in the LSB, and packed bits.
+ */
+
+//! bit i of the result is the LSB of in[i], for i = 0 .. 31
+static inline uint32_t
+gri_pack_lsbs_32(const unsigned char *in)
+{
+#ifdef __SSE2__
+  // put each LSB in its byte's MSB, where movemask picks it up
+  __m128i lo = _mm_slli_epi16(_mm_loadu_si128((const __m128i *) in), 7);
+  __m128i hi = _mm_slli_epi16(_mm_loadu_si128((const __m128i *) (in + 16)), 7);
+  return (uint32_t) _mm_movemask_epi8(lo) | ((uint32_t) _mm_movemask_epi8(hi) << 16);
+#else
+  uint32_t bits = 0;
+  for (int i = 31; i >= 0; i--)
+    bits = (bits << 1) | (in[i] & 1);
+  return bits;
+#endif
+}
+
+//! 8 bytes of 0 or 1 for each byte value, LSB first
+extern const unsigned char (&gri_unpack_lsb_first)[256][8];
+
+//! 8 bytes of 0 or 1 for each byte value, MSB first
+extern const unsigned char (&gri_unpack_msb_first)[256][8];
+
+//! each byte value with its bits in the opposite order
+extern const unsigned char (&gri_reverse_bits8)[256];
+
+//! out[i] = bit i of bits, for i = 0 .. 31
+static inline void
+gri_unpack_lsbs_32(uint32_t bits, unsigned char *out)
+{
+  for (int i = 0; i < 32; i += 8, bits >>= 8){
+    const unsigned char *b = gri_unpack_lsb_first[bits & 0xff];
+    for (int k = 0; k < 8; k++)
+      out[i + k] = b[k];
+  }
+}
+
+#endif /* INCLUDED_GRI_PACK_BITS_H */
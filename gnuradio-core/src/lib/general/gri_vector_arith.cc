@@ -0,0 +1,413 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_vector_arith.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+#ifdef __SSE3__
+#include <pmmintrin.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+/*
+ * Each op knows how to combine one float, a vector of 4 (SSE) and a
+ * vector of 8 (AVX).  The loops below do as much as they can 8, then
+ * 4, then 1 at a time.  The buffers gr_buffer hands us are only item
+ * aligned, so all loads and stores are unaligned.
+ */
+
+struct op_add {
+  static inline float f(float a, float b) { return a + b; }
+#ifdef __SSE__
+  static inline __m128 f(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+#endif
+#ifdef __AVX__
+  static inline __m256 f(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+#endif
+};
+
+struct op_sub {
+  static inline float f(float a, float b) { return a - b; }
+#ifdef __SSE__
+  static inline __m128 f(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+#endif
+#ifdef __AVX__
+  static inline __m256 f(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+#endif
+};
+
+struct op_mul {
+  static inline float f(float a, float b) { return a * b; }
+#ifdef __SSE__
+  static inline __m128 f(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+#endif
+#ifdef __AVX__
+  static inline __m256 f(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+#endif
+};
+
+struct op_div {
+  static inline float f(float a, float b) { return a / b; }
+#ifdef __SSE__
+  static inline __m128 f(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+#endif
+#ifdef __AVX__
+  static inline __m256 f(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+#endif
+};
+
+// dst[i] = OP(a[i], b[i])
+template <class OP> static inline void
+binary_ff (float *dst, const float *a, const float *b, int n)
+{
+  int i = 0;
+
+#ifdef __AVX__
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, OP::f(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#endif
+#ifdef __SSE__
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, OP::f(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+
+  for (; i < n; i++)
+    dst[i] = OP::f(a[i], b[i]);
+}
+
+// dst[i] = OP(src[i], k[i % 2]); k is a pair so this does complex constants too
+template <class OP> static inline void
+binary_const_ff (float *dst, const float *src, int n, const float k[2])
+{
+  int i = 0;
+
+#ifdef __AVX__
+  __m256 k8 = _mm256_setr_ps(k[0], k[1], k[0], k[1], k[0], k[1], k[0], k[1]);
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, OP::f(_mm256_loadu_ps(src + i), k8));
+#endif
+#ifdef __SSE__
+  __m128 k4 = _mm_setr_ps(k[0], k[1], k[0], k[1]);
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, OP::f(_mm_loadu_ps(src + i), k4));
+#endif
+
+  for (; i < n; i++)
+    dst[i] = OP::f(src[i], k[i & 1]);
+}
+
+/*
+ * Complex multiply and divide, 2 (SSE) or 4 (AVX) at a time.
+ *
+ * With a = (ar, ai) and b = (br, bi),
+ *
+ *   a * b       = (ar br - ai bi, ai br + ar bi)
+ *   a * conj(b) = (ar br + ai bi, ai br - ar bi)
+ *
+ * Both are a * (br, br) -/+ (ai, ar) * (bi, bi), which is the same
+ * arithmetic std::complex does, so the products are bit for bit what
+ * the scalar code gives.
+ */
+#ifdef __SSE__
+#ifndef __SSE3__
+static const union { unsigned int i[4]; __m128 v; } sign_even = {{ 0x80000000, 0, 0x80000000, 0 }};
+#endif
+static const union { unsigned int i[4]; __m128 v; } sign_odd = {{ 0, 0x80000000, 0, 0x80000000 }};
+
+static inline __m128
+cmul_sse (__m128 a, __m128 b)
+{
+  __m128 b_re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2,2,0,0));
+  __m128 b_im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3,3,1,1));
+  __m128 a_sw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1));
+#ifdef __SSE3__
+  return _mm_addsub_ps(_mm_mul_ps(a, b_re), _mm_mul_ps(a_sw, b_im));
+#else
+  return _mm_add_ps(_mm_mul_ps(a, b_re),
+		    _mm_xor_ps(_mm_mul_ps(a_sw, b_im), sign_even.v));
+#endif
+}
+
+static const union { unsigned int i[4]; __m128 v; } exp_mask = {{ 0x7f800000, 0x7f800000, 0x7f800000, 0x7f800000 }};
+static const union { unsigned int i[4]; __m128 v; } abs_mask = {{ 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff }};
+
+/*
+ * a * conj(b) / |b|^2, with b first scaled by a power of two s near
+ * 1/max(|re b|, |im b|) so that |b|^2 neither overflows nor underflows.
+ * Any power of two will do, so s is the exponent of the approximate
+ * reciprocal.  Scaling by a power of two is exact, so where the
+ * unscaled formula was fine the result is the same.
+ */
+static inline __m128
+cdiv_sse (__m128 a, __m128 b)
+{
+  __m128 b_abs = _mm_and_ps(b, abs_mask.v);
+  __m128 m = _mm_max_ps(b_abs, _mm_shuffle_ps(b_abs, b_abs, _MM_SHUFFLE(2,3,0,1)));
+  // keep rcp(m) normal, whichever way it rounds
+  m = _mm_min_ps(_mm_max_ps(m, _mm_set1_ps(FLT_MIN)), _mm_set1_ps(0.5f / FLT_MIN));
+  __m128 s = _mm_and_ps(_mm_rcp_ps(m), exp_mask.v);
+  b = _mm_mul_ps(b, s);
+
+  __m128 b_re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2,2,0,0));
+  __m128 b_im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3,3,1,1));
+  __m128 a_sw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1));
+  __m128 num = _mm_add_ps(_mm_mul_ps(a, b_re),
+			  _mm_xor_ps(_mm_mul_ps(a_sw, b_im), sign_odd.v));
+  __m128 den = _mm_add_ps(_mm_mul_ps(b_re, b_re), _mm_mul_ps(b_im, b_im));
+  return _mm_mul_ps(_mm_div_ps(num, den), s);
+}
+#endif
+
+#ifdef __AVX__
+static inline __m256
+cmul_avx (__m256 a, __m256 b)
+{
+  __m256 b_re = _mm256_moveldup_ps(b);
+  __m256 b_im = _mm256_movehdup_ps(b);
+  __m256 a_sw = _mm256_permute_ps(a, _MM_SHUFFLE(2,3,0,1));
+  return _mm256_addsub_ps(_mm256_mul_ps(a, b_re), _mm256_mul_ps(a_sw, b_im));
+}
+#endif
+
+static inline gr_complex
+cdiv (gr_complex a, gr_complex b)
+{
+  // same as cdiv_sse
+  union { float f; unsigned int i; } m;
+  m.f = std::max(fabsf(b.real()), fabsf(b.imag()));
+  m.i &= 0x7f800000;
+  float s = 1.0f / std::min(std::max(m.f, FLT_MIN), 1.0f / FLT_MIN);
+  float b_re = b.real() * s;
+  float b_im = b.imag() * s;
+  float den = b_re * b_re + b_im * b_im;
+  return gr_complex((a.real() * b_re + a.imag() * b_im) / den * s,
+		    (a.imag() * b_re - a.real() * b_im) / den * s);
+}
+
+// ----------------------------------------------------------------
+
+void
+gri_add (float *dst, const float *a, const float *b, int n)
+{
+  binary_ff<op_add>(dst, a, b, n);
+}
+
+void
+gri_sub (float *dst, const float *a, const float *b, int n)
+{
+  binary_ff<op_sub>(dst, a, b, n);
+}
+
+void
+gri_multiply (float *dst, const float *a, const float *b, int n)
+{
+  binary_ff<op_mul>(dst, a, b, n);
+}
+
+void
+gri_divide (float *dst, const float *a, const float *b, int n)
+{
+  binary_ff<op_div>(dst, a, b, n);
+}
+
+void
+gri_add_const (float *dst, const float *src, int n, float k)
+{
+  float kk[2] = { k, k };
+  binary_const_ff<op_add>(dst, src, n, kk);
+}
+
+void
+gri_multiply_const (float *dst, const float *src, int n, float k)
+{
+  float kk[2] = { k, k };
+  binary_const_ff<op_mul>(dst, src, n, kk);
+}
+
+// ----------------------------------------------------------------
+
+void
+gri_add (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n)
+{
+  binary_ff<op_add>((float *) dst, (const float *) a, (const float *) b, 2 * n);
+}
+
+void
+gri_sub (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n)
+{
+  binary_ff<op_sub>((float *) dst, (const float *) a, (const float *) b, 2 * n);
+}
+
+void
+gri_multiply (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n)
+{
+  int i = 0;
+
+#ifdef __SSE__
+  float *d = (float *) dst;
+  const float *fa = (const float *) a;
+  const float *fb = (const float *) b;
+#endif
+#ifdef __AVX__
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_ps(d + 2*i, cmul_avx(_mm256_loadu_ps(fa + 2*i), _mm256_loadu_ps(fb + 2*i)));
+#endif
+#ifdef __SSE__
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_ps(d + 2*i, cmul_sse(_mm_loadu_ps(fa + 2*i), _mm_loadu_ps(fb + 2*i)));
+#endif
+
+  for (; i < n; i++)
+    dst[i] = a[i] * b[i];
+}
+
+void
+gri_divide (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n)
+{
+  int i = 0;
+
+#ifdef __SSE__
+  float *d = (float *) dst;
+  const float *fa = (const float *) a;
+  const float *fb = (const float *) b;
+
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_ps(d + 2*i, cdiv_sse(_mm_loadu_ps(fa + 2*i), _mm_loadu_ps(fb + 2*i)));
+#endif
+
+  for (; i < n; i++)
+    dst[i] = cdiv(a[i], b[i]);
+}
+
+void
+gri_add_const (gr_complex *dst, const gr_complex *src, int n, gr_complex k)
+{
+  float kk[2] = { k.real(), k.imag() };
+  binary_const_ff<op_add>((float *) dst, (const float *) src, 2 * n, kk);
+}
+
+void
+gri_multiply_const (gr_complex *dst, const gr_complex *src, int n, gr_complex k)
+{
+  int i = 0;
+
+#ifdef __SSE__
+  float *d = (float *) dst;
+  const float *s = (const float *) src;
+#endif
+#ifdef __AVX__
+  __m256 k8 = _mm256_setr_ps(k.real(), k.imag(), k.real(), k.imag(),
+			     k.real(), k.imag(), k.real(), k.imag());
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_ps(d + 2*i, cmul_avx(_mm256_loadu_ps(s + 2*i), k8));
+#endif
+#ifdef __SSE__
+  __m128 k4 = _mm_setr_ps(k.real(), k.imag(), k.real(), k.imag());
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_ps(d + 2*i, cmul_sse(_mm_loadu_ps(s + 2*i), k4));
+#endif
+
+  for (; i < n; i++)
+    dst[i] = src[i] * k;
+}
+
+// ----------------------------------------------------------------
+// Complex by real, and magnitudes.  These take 4 complex at a time,
+// split into a vector of real parts and one of imaginary parts.
+
+#ifdef __SSE__
+static inline void
+deinterleave (const float *s, __m128 &re, __m128 &im)
+{
+  __m128 a = _mm_loadu_ps(s);
+  __m128 b = _mm_loadu_ps(s + 4);
+  re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+  im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+}
+#endif
+
+void
+gri_multiply (gr_complex *dst, const gr_complex *a, const float *b, int n)
+{
+  int i = 0;
+
+#ifdef __SSE__
+  float *d = (float *) dst;
+  const float *fa = (const float *) a;
+
+  for (; i + 4 <= n; i += 4){
+    __m128 k = _mm_loadu_ps(b + i);
+    _mm_storeu_ps(d + 2*i, _mm_mul_ps(_mm_loadu_ps(fa + 2*i), _mm_unpacklo_ps(k, k)));
+    _mm_storeu_ps(d + 2*i + 4, _mm_mul_ps(_mm_loadu_ps(fa + 2*i + 4), _mm_unpackhi_ps(k, k)));
+  }
+#endif
+
+  for (; i < n; i++)
+    dst[i] = a[i] * b[i];
+}
+
+void
+gri_magnitude_squared (float *dst, const gr_complex *src, int n)
+{
+  int i = 0;
+
+#ifdef __SSE__
+  const float *s = (const float *) src;
+  for (; i + 4 <= n; i += 4){
+    __m128 re, im;
+    deinterleave(s + 2*i, re, im);
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+  }
+#endif
+
+  for (; i < n; i++)
+    dst[i] = src[i].real() * src[i].real() + src[i].imag() * src[i].imag();
+}
+
+void
+gri_magnitude (float *dst, const gr_complex *src, int n)
+{
+  int i = 0;
+
+#ifdef __SSE__
+  const float *s = (const float *) src;
+  for (; i + 4 <= n; i += 4){
+    __m128 re, im;
+    deinterleave(s + 2*i, re, im);
+    _mm_storeu_ps(dst + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im))));
+  }
+#endif
+
+  for (; i < n; i++)
+    dst[i] = sqrtf(src[i].real() * src[i].real() + src[i].imag() * src[i].imag());
+}
@@ -0,0 +1,114 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_VECTOR_ARITH_H
+#define INCLUDED_GRI_VECTOR_ARITH_H
+
+#include <gr_complex.h>
+
+/*
+ * Low-level, high-speed elementwise arithmetic used by the gengen
+ * blocks (gr_add_XX, gr_multiply_const_XX, ...).
+ *
+ * The templates are the plain scalar versions and work for any type.
+ * The float and gr_complex overloads use SSE (and AVX, when compiled
+ * for it) and are picked by overload resolution, so generated code
+ * can just call gri_add (dst, a, b, n) whatever its types are.
+ * Explicitly instantiating a template, e.g. gri_add<float>, gets the
+ * scalar reference.
+ *
+ * n counts elements of the destination type.  dst may be the same as
+ * any of the sources, but must not otherwise overlap them.
+ */
+
+// dst[i] = a[i] + b[i]
+template <class T> void
+gri_add (T *dst, const T *a, const T *b, int n)
+{
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] + b[i];
+}
+
+// dst[i] = a[i] - b[i]
+template <class T> void
+gri_sub (T *dst, const T *a, const T *b, int n)
+{
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] - b[i];
+}
+
+// dst[i] = a[i] * b[i]
+template <class T> void
+gri_multiply (T *dst, const T *a, const T *b, int n)
+{
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] * b[i];
+}
+
+// dst[i] = a[i] / b[i]
+template <class T> void
+gri_divide (T *dst, const T *a, const T *b, int n)
+{
+  for (int i = 0; i < n; i++)
+    dst[i] = a[i] / b[i];
+}
+
+// dst[i] = src[i] + k
+template <class O, class I, class K> void
+gri_add_const (O *dst, const I *src, int n, K k)
+{
+  for (int i = 0; i < n; i++)
+    dst[i] = src[i] + k;
+}
+
+// dst[i] = src[i] * k
+template <class O, class I, class K> void
+gri_multiply_const (O *dst, const I *src, int n, K k)
+{
+  for (int i = 0; i < n; i++)
+    dst[i] = src[i] * k;
+}
+
+void gri_add (float *dst, const float *a, const float *b, int n);
+void gri_sub (float *dst, const float *a, const float *b, int n);
+void gri_multiply (float *dst, const float *a, const float *b, int n);
+void gri_divide (float *dst, const float *a, const float *b, int n);
+void gri_add_const (float *dst, const float *src, int n, float k);
+void gri_multiply_const (float *dst, const float *src, int n, float k);
+
+void gri_add (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n);
+void gri_sub (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n);
+void gri_multiply (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n);
+void gri_divide (gr_complex *dst, const gr_complex *a, const gr_complex *b, int n);
+void gri_add_const (gr_complex *dst, const gr_complex *src, int n, gr_complex k);
+void gri_multiply_const (gr_complex *dst, const gr_complex *src, int n, gr_complex k);
+
+// dst[i] = a[i] * b[i], each complex scaled by a real
+void gri_multiply (gr_complex *dst, const gr_complex *a, const float *b, int n);
+
+// dst[i] = |src[i]|^2, src[i].real()^2 + src[i].imag()^2
+void gri_magnitude_squared (float *dst, const gr_complex *src, int n);
+
+// dst[i] = |src[i]|, the same as sqrtf of the above
+void gri_magnitude (float *dst, const gr_complex *src, int n);
+
+#endif /* INCLUDED_GRI_VECTOR_ARITH_H */
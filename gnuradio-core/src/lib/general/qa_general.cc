@@ -1,5 +1,5 @@
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -32,7 +32,9 @@
 #include <qa_gr_fxpt_nco.h>
 #include <qa_gr_fxpt_vco.h>
 #include <qa_gr_math.h>
+#include <qa_gri_fast_random.h>
 #include <qa_gri_lfsr.h>
+#include <qa_gri_vector_arith.h>
 
 CppUnit::TestSuite *
 qa_general::suite ()
@@ -45,7 +47,9 @@ qa_general::suite ()
   s->addTest (qa_gr_fxpt_nco::suite ());
   s->addTest (qa_gr_fxpt_vco::suite ());
   s->addTest (qa_gr_math::suite ());
+  s->addTest (qa_gri_fast_random::suite ());
   s->addTest (qa_gri_lfsr::suite ());
+  s->addTest (qa_gri_vector_arith::suite ());
   
   return s;
 }
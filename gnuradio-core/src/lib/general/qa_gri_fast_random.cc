@@ -0,0 +1,127 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gri_fast_random.h>
+#include <qa_gri_fast_random.h>
+#include <cppunit/TestAssert.h>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
+/*
+ * The first words for the default seed.  The SSE2 and scalar versions
+ * must both give these, on every machine.
+ */
+static const uint32_t golden[8] = {
+  0xe6086b46, 0x46137a8f, 0x7e9c7f3e, 0x2c4cb8e6,
+  0x92dbd3df, 0x569785e6, 0x69bb77c1, 0xf4cbb30a
+};
+
+void
+qa_gri_fast_random::t1_sequence()
+{
+  gri_fast_random r;
+  for (int i = 0; i < 8; i++)
+    CPPUNIT_ASSERT_EQUAL(golden[i], r.next_u32());
+
+  // reseeding starts the same sequence over
+  for (int i = 0; i < 1000; i++)
+    r.next_u32();
+  r.reseed(3021);
+  for (int i = 0; i < 8; i++)
+    CPPUNIT_ASSERT_EQUAL(golden[i], r.next_u32());
+}
+
+void
+qa_gri_fast_random::t2_streams()
+{
+  const int N = 1000;
+  gri_fast_random a(42, 0), b(42, 1), c(43, 0);
+
+  int same_ab = 0, same_ac = 0;
+  for (int i = 0; i < N; i++){
+    uint32_t x = a.next_u32();
+    if (x == b.next_u32())
+      same_ab++;
+    if (x == c.next_u32())
+      same_ac++;
+  }
+  CPPUNIT_ASSERT(same_ab < 2);
+  CPPUNIT_ASSERT(same_ac < 2);
+}
+
+void
+qa_gri_fast_random::t3_uniform()
+{
+  const int N = 10000;
+  gri_fast_random a(1), b(1);
+  std::vector<float> bulk(N);
+
+  // bulk fills in odd sized pieces match one at a time
+  for (int i = 0, n = 1; i < N; i += n, n = (n * 3 + 1) % 701)
+    b.uniform(&bulk[i], std::min(n, N - i));
+
+  double sum = 0;
+  for (int i = 0; i < N; i++){
+    float x = a.uniform();
+    CPPUNIT_ASSERT_EQUAL(x, bulk[i]);
+    CPPUNIT_ASSERT(x >= 0.0f && x < 1.0f);
+    sum += x;
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, sum / N, 0.01);
+}
+
+void
+qa_gri_fast_random::t4_gaussian()
+{
+  const int N = 1 << 20;
+  gri_fast_random a(7), b(7);
+  std::vector<float> x(N);
+
+  b.gaussian(&x[0], N);
+
+  double sum = 0, sum2 = 0;
+  int within1 = 0, beyond3 = 0, beyond4 = 0;
+  for (int i = 0; i < N; i++){
+    if (i < 10000)
+      CPPUNIT_ASSERT_EQUAL(a.gaussian(), x[i]);
+
+    double v = x[i];
+    sum += v;
+    sum2 += v * v;
+    if (fabs(v) <= 1)
+      within1++;
+    if (fabs(v) > 3)
+      beyond3++;
+    if (fabs(v) > 4)
+      beyond4++;
+  }
+
+  double mean = sum / N;
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, mean, 0.005);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, sum2 / N - mean * mean, 0.01);
+
+  // the ziggurat's layers and its tail both have to be right for these
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.682689, (double) within1 / N, 0.002);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.002700, (double) beyond3 / N, 0.0003);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(6.33e-5, (double) beyond4 / N, 4e-5);
+}
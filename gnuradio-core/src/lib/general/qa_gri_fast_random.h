@@ -0,0 +1,44 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef _QA_GRI_FAST_RANDOM_H_
+#define _QA_GRI_FAST_RANDOM_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCase.h>
+
+class qa_gri_fast_random : public CppUnit::TestCase {
+
+  CPPUNIT_TEST_SUITE(qa_gri_fast_random);
+  CPPUNIT_TEST(t1_sequence);
+  CPPUNIT_TEST(t2_streams);
+  CPPUNIT_TEST(t3_uniform);
+  CPPUNIT_TEST(t4_gaussian);
+  CPPUNIT_TEST_SUITE_END();
+
+ private:
+  void t1_sequence();
+  void t2_streams();
+  void t3_uniform();
+  void t4_gaussian();
+};
+
+#endif /* _QA_GRI_FAST_RANDOM_H_ */
@@ -20,10 +20,12 @@
  */
 
 #include <gri_lfsr.h>
+#include <gri_glfsr.h>
 #include <qa_gri_lfsr.h>
 #include <cppunit/TestAssert.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 
 void
 qa_gri_lfsr::test_lfsr ()
@@ -139,3 +141,65 @@ qa_gri_lfsr::test_descrambler()
 
   CPPUNIT_ASSERT(memcmp(expected, actual, len) == 0);
 }
+
+void
+qa_gri_lfsr::test_next_bits()
+{
+  // mask, seed, length; the last seed has bits above the register
+  static const int params[][3] = {
+    { 0x19, 0x01, 5 }, { 0x8A, 0x7F, 7 }, { 0x4001, 0x1234, 15 },
+    { 0x10000002, 0x5a5a5a5, 29 }, { (int) 0x80000057, 0x7fffffff, 31 },
+    { 0x29, 0x7fe1, 5 }
+  };
+  const int N = 1000;
+  unsigned char in[N], expected[N], actual[N];
+
+  srandom(1);
+  for (int i = 0; i < N; i++)
+    in[i] = random() & 0xff;	// only the LSB counts
+
+  for (unsigned int p = 0; p < sizeof(params) / sizeof(params[0]); p++){
+    for (int mode = 0; mode < 3; mode++){
+      gri_lfsr a(params[p][0], params[p][1], params[p][2]);
+      gri_lfsr b(params[p][0], params[p][1], params[p][2]);
+
+      for (int i = 0; i < N; i++)
+	expected[i] = (mode == 0 ? a.next_bit()
+		       : mode == 1 ? a.next_bit_scramble(in[i])
+		       : a.next_bit_descramble(in[i]));
+
+      // odd sized pieces, so the 32 bit steps start all over the place
+      for (int i = 0, n = 1; i < N; i += n, n = n * 3 % 97){
+	if (n > N - i)
+	  n = N - i;
+	if (mode == 0)
+	  b.next_bits(&actual[i], n);
+	else if (mode == 1)
+	  b.next_bits_scramble(&actual[i], &in[i], n);
+	else
+	  b.next_bits_descramble(&actual[i], &in[i], n);
+      }
+
+      CPPUNIT_ASSERT(memcmp(expected, actual, N) == 0);
+    }
+  }
+}
+
+void
+qa_gri_lfsr::test_glfsr_next_bits()
+{
+  const int N = 1000;
+  unsigned char expected[N], actual[N];
+
+  for (int degree = 1; degree <= 32; degree++){
+    gri_glfsr a(gri_glfsr::glfsr_mask(degree), 1);
+    gri_glfsr b(gri_glfsr::glfsr_mask(degree), 1);
+
+    for (int i = 0; i < N; i++)
+      expected[i] = a.next_bit();
+    for (int i = 0, n = 1; i < N; i += n, n = n * 3 % 97)
+      b.next_bits(&actual[i], n > N - i ? N - i : n);
+
+    CPPUNIT_ASSERT(memcmp(expected, actual, N) == 0);
+  }
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -31,12 +31,16 @@ class qa_gri_lfsr : public CppUnit::TestCase {
   CPPUNIT_TEST(test_lfsr);
   CPPUNIT_TEST(test_scrambler);
   CPPUNIT_TEST(test_descrambler);
+  CPPUNIT_TEST(test_next_bits);
+  CPPUNIT_TEST(test_glfsr_next_bits);
   CPPUNIT_TEST_SUITE_END();
 
  private:
   void test_lfsr();
   void test_scrambler();
   void test_descrambler();
+  void test_next_bits();
+  void test_glfsr_next_bits();
 };
 
 #endif /* _QA_GRI_LFSR_H_ */
@@ -0,0 +1,266 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gri_vector_arith.h>
+#include <qa_gri_vector_arith.h>
+#include <cppunit/TestAssert.h>
+#include <stdlib.h>
+#include <math.h>
+
+/*
+ * The SIMD overloads are checked against the scalar templates for all
+ * lengths up to a few vectors' worth and all alignments, so every
+ * AVX/SSE/scalar tail combination is covered.
+ */
+
+#define	MAXN	41
+#define	MAXOFF	4
+
+static float
+uniform ()
+{
+  return 2.0 * ((float) random () / RAND_MAX - 0.5);	// uniformly (-1, 1)
+}
+
+// divisors stay well away from zero
+static float
+divisor ()
+{
+  float x = uniform ();
+  return x < 0 ? x - 0.5 : x + 0.5;
+}
+
+static void
+assert_close (gr_complex expected, gr_complex actual, float tol)
+{
+  CPPUNIT_ASSERT_DOUBLES_EQUAL (expected.real (), actual.real (), tol);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL (expected.imag (), actual.imag (), tol);
+}
+
+void
+qa_gri_vector_arith::t1_float ()
+{
+  float a[MAXN + MAXOFF], b[MAXN + MAXOFF];
+  float ref[MAXN + MAXOFF], out[MAXN + MAXOFF];
+
+  for (int i = 0; i < MAXN + MAXOFF; i++){
+    a[i] = uniform ();
+    b[i] = divisor ();
+  }
+  float k = uniform ();
+
+  for (int off = 0; off < MAXOFF; off++){
+    for (int n = 0; n < MAXN; n++){
+      // IEEE add, sub, mul and div are exact, so these must match exactly
+
+      gri_add<float> (ref + off, a + off, b + off, n);
+      gri_add (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_EQUAL (ref[off + i], out[off + i]);
+
+      gri_sub<float> (ref + off, a + off, b + off, n);
+      gri_sub (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_EQUAL (ref[off + i], out[off + i]);
+
+      gri_multiply<float> (ref + off, a + off, b + off, n);
+      gri_multiply (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_EQUAL (ref[off + i], out[off + i]);
+
+      gri_divide<float> (ref + off, a + off, b + off, n);
+      gri_divide (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_EQUAL (ref[off + i], out[off + i]);
+
+      gri_add_const<float, float, float> (ref + off, a + off, n, k);
+      gri_add_const (out + off, a + off, n, k);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_EQUAL (ref[off + i], out[off + i]);
+
+      gri_multiply_const<float, float, float> (ref + off, a + off, n, k);
+      gri_multiply_const (out + off, a + off, n, k);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_EQUAL (ref[off + i], out[off + i]);
+    }
+  }
+}
+
+void
+qa_gri_vector_arith::t2_complex ()
+{
+  gr_complex a[MAXN + MAXOFF], b[MAXN + MAXOFF];
+  gr_complex ref[MAXN + MAXOFF], out[MAXN + MAXOFF];
+
+  for (int i = 0; i < MAXN + MAXOFF; i++){
+    a[i] = gr_complex (uniform (), uniform ());
+    b[i] = gr_complex (divisor (), divisor ());
+  }
+  gr_complex k (uniform (), uniform ());
+
+  for (int off = 0; off < MAXOFF; off++){
+    for (int n = 0; n < MAXN; n++){
+      gri_add<gr_complex> (ref + off, a + off, b + off, n);
+      gri_add (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	assert_close (ref[off + i], out[off + i], 0);
+
+      gri_sub<gr_complex> (ref + off, a + off, b + off, n);
+      gri_sub (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	assert_close (ref[off + i], out[off + i], 0);
+
+      // the compiler may fuse the scalar multiply-adds; allow an ulp or two
+
+      gri_multiply<gr_complex> (ref + off, a + off, b + off, n);
+      gri_multiply (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	assert_close (ref[off + i], out[off + i], 1e-6);
+
+      // std::complex divides differently (it scales to avoid overflow)
+
+      gri_divide<gr_complex> (ref + off, a + off, b + off, n);
+      gri_divide (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	assert_close (ref[off + i], out[off + i], 1e-5);
+
+      gri_add_const<gr_complex, gr_complex, gr_complex> (ref + off, a + off, n, k);
+      gri_add_const (out + off, a + off, n, k);
+      for (int i = 0; i < n; i++)
+	assert_close (ref[off + i], out[off + i], 0);
+
+      gri_multiply_const<gr_complex, gr_complex, gr_complex> (ref + off, a + off, n, k);
+      gri_multiply_const (out + off, a + off, n, k);
+      for (int i = 0; i < n; i++)
+	assert_close (ref[off + i], out[off + i], 1e-6);
+    }
+  }
+}
+
+/*
+ * The blocks accumulate their inputs in the output buffer, one input
+ * at a time, so dst == a has to work.
+ */
+void
+qa_gri_vector_arith::t3_in_place ()
+{
+  static const int N = 1000;
+  static const int NINPUTS = 5;
+  float fin[NINPUTS][N], fout[N];
+  gr_complex cin[NINPUTS][N], cout[N];
+
+  for (int j = 0; j < NINPUTS; j++){
+    for (int i = 0; i < N; i++){
+      fin[j][i] = divisor ();
+      cin[j][i] = gr_complex (divisor (), divisor ());
+    }
+  }
+
+  gri_add (fout, fin[0], fin[1], N);
+  for (int j = 2; j < NINPUTS; j++)
+    gri_add (fout, fout, fin[j], N);
+
+  for (int i = 0; i < N; i++){
+    float acc = fin[0][i];
+    for (int j = 1; j < NINPUTS; j++)
+      acc += fin[j][i];
+    CPPUNIT_ASSERT_EQUAL (acc, fout[i]);
+  }
+
+  gri_multiply (cout, cin[0], cin[1], N);
+  for (int j = 2; j < NINPUTS; j++)
+    gri_multiply (cout, cout, cin[j], N);
+
+  for (int i = 0; i < N; i++){
+    gr_complex acc = cin[0][i];
+    for (int j = 1; j < NINPUTS; j++)
+      acc *= cin[j][i];
+    assert_close (acc, cout[i], 1e-5 * abs (acc));
+  }
+}
+
+void
+qa_gri_vector_arith::t4_magnitude ()
+{
+  gr_complex a[MAXN + MAXOFF], out[MAXN + MAXOFF];
+  float b[MAXN + MAXOFF], fref[MAXN + MAXOFF], fout[MAXN + MAXOFF];
+
+  for (int i = 0; i < MAXN + MAXOFF; i++){
+    a[i] = gr_complex (uniform (), uniform ());
+    b[i] = uniform ();
+  }
+
+  for (int off = 0; off < MAXOFF; off++){
+    for (int n = 0; n < MAXN; n++){
+      gri_multiply (out + off, a + off, b + off, n);
+      for (int i = 0; i < n; i++)
+	assert_close (a[off + i] * b[off + i], out[off + i], 0);
+
+      for (int i = 0; i < n; i++)
+	fref[off + i] = norm (a[off + i]);
+      gri_magnitude_squared (fout + off, a + off, n);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (fref[off + i], fout[off + i], 1e-6);
+
+      for (int i = 0; i < n; i++)
+	fref[off + i] = abs (a[off + i]);
+      gri_magnitude (fout + off, a + off, n);
+      for (int i = 0; i < n; i++)
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (fref[off + i], fout[off + i], 1e-6);
+    }
+  }
+}
+
+/*
+ * |b|^2 over- or underflows a float well before a / b does; the
+ * results must still agree with the division done in double.
+ */
+void
+qa_gri_vector_arith::t5_divide_range ()
+{
+  static const float scale[] = { 1e-37, 1e-30, 1e-20, 1e-10, 1, 1e10, 1e20, 1e30, 1e38 };
+  static const int NSCALE = sizeof (scale) / sizeof (scale[0]);
+  gr_complex a[MAXN + MAXOFF], b[MAXN + MAXOFF], out[MAXN + MAXOFF];
+
+  for (int sa = 0; sa < NSCALE; sa++){
+    for (int sb = 0; sb < NSCALE; sb++){
+      float q = scale[sa] / scale[sb];
+      if (q > 1e30 || q < 1e-30 || !finite (q))	// quotient out of range
+	continue;
+
+      for (int i = 0; i < MAXN + MAXOFF; i++){
+	a[i] = gr_complex (uniform (), uniform ()) * scale[sa];
+	b[i] = gr_complex (divisor (), divisor ()) * scale[sb];
+      }
+
+      for (int off = 0; off < MAXOFF; off++){
+	int n = MAXN - off;
+	gri_divide (out + off, a + off, b + off, n);
+	for (int i = off; i < off + n; i++){
+	  std::complex<double> ref =
+	    std::complex<double> (a[i]) / std::complex<double> (b[i]);
+	  assert_close (gr_complex (ref), out[i], 1e-5 * abs (ref));
+	}
+      }
+    }
+  }
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004, 2009 Free Software Foundation, Inc.
+ * Copyright 2004, 2009, 2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,6 +28,7 @@
 
 #include <@NAME@.h>
 #include <gr_io_signature.h>
+#include <gri_vector_arith.h>
 
 @SPTR_NAME@
 gr_make_@BASE_NAME@ (size_t vlen)
@@ -49,15 +50,21 @@ int
 		   gr_vector_void_star &output_items)
 {
   @O_TYPE@ *optr = (@O_TYPE@ *) output_items[0];
+  const @I_TYPE@ **in = (const @I_TYPE@ **) &input_items[0];
 
   int ninputs = input_items.size ();
+  int n = noutput_items * d_vlen;
 
-  for (int i = 0; i < noutput_items*d_vlen; i++){
-    @I_TYPE@ acc = ((@I_TYPE@ *) input_items[0])[i];
-    for (int j = 1; j < ninputs; j++)
-      acc *= ((@I_TYPE@ *) input_items[j])[i];
-
-    *optr++ = (@O_TYPE@) acc;
+  if (ninputs == 1){
+    for (int i = 0; i < n; i++)
+      optr[i] = (@O_TYPE@) in[0][i];
+    return noutput_items;
   }
+
+  // One input at a time over the whole buffer, accumulating in the output
+  gri_multiply (optr, in[0], in[1], n);
+  for (int j = 2; j < ninputs; j++)
+    gri_multiply (optr, optr, in[j], n);
+
   return noutput_items;
 }
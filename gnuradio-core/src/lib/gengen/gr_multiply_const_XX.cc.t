@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,6 +28,7 @@
 
 #include <@NAME@.h>
 #include <gr_io_signature.h>
+#include <gri_vector_arith.h>
 
 @SPTR_NAME@
 gr_make_@BASE_NAME@ (@O_TYPE@ k)
@@ -51,22 +52,7 @@ int
   @I_TYPE@ *iptr = (@I_TYPE@ *) input_items[0];
   @O_TYPE@ *optr = (@O_TYPE@ *) output_items[0];
 
-  int	size = noutput_items;
+  gri_multiply_const (optr, iptr, noutput_items, d_k);
 
-  while (size >= 8){
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    *optr++ = *iptr++ * d_k;
-    size -= 8;
-  }
-
-  while (size-- > 0)
-    *optr++ = *iptr++ * d_k;
-  
   return noutput_items;
 }
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2006 Free Software Foundation, Inc.
+ * Copyright 2004,2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,6 +28,7 @@
 
 #include <@NAME@.h>
 #include <gr_io_signature.h>
+#include <gri_vector_arith.h>
 
 @SPTR_NAME@
 gr_make_@BASE_NAME@ (const std::vector<@I_TYPE@> k)
@@ -48,14 +49,16 @@ int
 		   gr_vector_const_void_star &input_items,
 		   gr_vector_void_star &output_items)
 {
-  @I_TYPE@ *iptr = (@O_TYPE@ *)input_items[0];
+  @I_TYPE@ *iptr = (@I_TYPE@ *)input_items[0];
   @O_TYPE@ *optr = (@O_TYPE@ *)output_items[0];
  
   int nitems_per_block = output_signature()->sizeof_stream_item(0)/sizeof(@I_TYPE@);
 
-  for (int i = 0; i < noutput_items; i++)
-    for (int j = 0; j < nitems_per_block; j++)
-      *optr++ = *iptr++ * d_k[j];
+  for (int i = 0; i < noutput_items; i++){
+    gri_multiply (optr, iptr, &d_k[0], nitems_per_block);
+    iptr += nitems_per_block;
+    optr += nitems_per_block;
+  }
   
   return noutput_items;
 }
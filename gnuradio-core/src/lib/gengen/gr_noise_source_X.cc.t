@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,7 +27,10 @@
 #endif
 #include <@NAME@.h>
 #include <gr_io_signature.h>
+#include <gri_vector_arith.h>
 #include <stdexcept>
+#include <algorithm>
+#include <math.h>
 
 
 @NAME@_sptr 
@@ -43,7 +46,8 @@ gr_make_@BASE_NAME@ (gr_noise_type_t type, float ampl, long seed)
 		   gr_make_io_signature (1, 1, sizeof (@TYPE@))),
     d_type (type),
     d_ampl (ampl),
-    d_rng (seed)
+    d_rng (seed),
+    d_samples (4096)
 {
 }
 
@@ -52,47 +56,61 @@ int
 		   gr_vector_const_void_star &input_items,
 		   gr_vector_void_star &output_items)
 {
-  @TYPE@ *out = (@TYPE@ *) output_items[0];
-  
-  switch (d_type){
 #if @IS_COMPLEX@	// complex?
+  float *out = (float *) output_items[0];	// I and Q are just two floats
+  int nout = 2 * noutput_items;
+#else
+  @TYPE@ *out = (@TYPE@ *) output_items[0];
+  int nout = noutput_items;
+#endif
 
-  case GR_UNIFORM:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = gr_complex (d_ampl * ((d_rng.ran1 () * 2.0) - 1.0),
-			   d_ampl * ((d_rng.ran1 () * 2.0) - 1.0));
-    break;
+  /*
+   * Generate a buffer full of deviates at a time, then scale them and
+   * convert to the output type with the vector kernels.
+   */
+  for (int i = 0; i < nout; ){
+    int n = std::min (nout - i, (int) d_samples.size ());
+    float *s = &d_samples[0];
 
-  case GR_GAUSSIAN:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = d_ampl * d_rng.rayleigh_complex ();
-    break;
+    switch (d_type){
+    case GR_UNIFORM:
+      d_rng.uniform (s, n);
+      gri_multiply_const (s, s, n, 2 * d_ampl);
+      gri_add_const (out + i, s, n, -d_ampl);
+      break;
 
-#else			// nope...
+    case GR_GAUSSIAN:
+      d_rng.gaussian (s, n);
+      gri_multiply_const (out + i, s, n, d_ampl);
+      break;
 
-  case GR_UNIFORM:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * ((d_rng.ran1 () * 2.0) - 1.0));
-    break;
+#if !@IS_COMPLEX@
+    case GR_LAPLACIAN:
+      for (int j = 0; j < n; j++){
+	// strictly inside (0, 1), so neither log blows up
+	float z = d_rng.uniform () + 0.5f / 16777216.0f;
+	if (z < 0.5f)
+	  s[j] = logf (2 * z) / M_SQRT2;
+	else
+	  s[j] = -logf (2 * (1 - z)) / M_SQRT2;
+      }
+      gri_multiply_const (out + i, s, n, d_ampl);
+      break;
 
-  case GR_GAUSSIAN:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * d_rng.gasdev ());
-    break;
-    
-  case GR_LAPLACIAN:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * d_rng.laplacian ());
-    break;
-    
-  case GR_IMPULSE:	// FIXME changeable impulse settings
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * d_rng.impulse (9));
-    break;
+    case GR_IMPULSE:	// FIXME changeable impulse settings
+      for (int j = 0; j < n; j++){
+	float z = -M_SQRT2 * logf (1 - d_rng.uniform ());
+	s[j] = fabsf (z) <= 9 ? 0 : z;
+      }
+      gri_multiply_const (out + i, s, n, d_ampl);
+      break;
 #endif
-    
-  default:
-    throw std::runtime_error ("invalid type");
+
+    default:
+      throw std::runtime_error ("invalid type");
+    }
+
+    i += n;
   }
 
   return noutput_items;
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,7 +27,8 @@
 
 #include <gr_sync_block.h>
 #include <gr_noise_type.h>
-#include <gr_random.h>
+#include <gri_fast_random.h>
+#include <vector>
 
 
 class @NAME@;
@@ -46,7 +47,8 @@ class @NAME@ : public gr_sync_block {
 
   gr_noise_type_t	d_type;
   float			d_ampl;
-  gr_random		d_rng;
+  gri_fast_random	d_rng;
+  std::vector<float>	d_samples;	// raw deviates, before scaling
 
   @NAME@ (gr_noise_type_t type, float ampl, long seed = 3021);
 
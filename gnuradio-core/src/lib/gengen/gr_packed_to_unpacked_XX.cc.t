@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -30,6 +30,7 @@
 #include <gr_io_signature.h>
 #include <assert.h>
 #include <gr_log2_const.h>
+#include <gri_pack_bits.h>
 
 static const unsigned int BITS_PER_TYPE = sizeof(@I_TYPE@) * 8;
 static const unsigned int LOG2_L_TYPE = gr_log2_const<sizeof(@I_TYPE@) * 8>();
@@ -102,6 +103,24 @@ int
     switch (d_endianness){
 
     case GR_MSB_FIRST:
+      if (d_bits_per_chunk == 1){
+	// a whole input item at a time, a byte at a time from the table
+	int i = 0;
+	for (; i < noutput_items && (index_tmp & (BITS_PER_TYPE-1)); i++, index_tmp++)
+	  out[i] = get_bit_be(in, index_tmp);
+	for (; i + (int) BITS_PER_TYPE <= noutput_items; i += BITS_PER_TYPE, index_tmp += BITS_PER_TYPE){
+	  @I_TYPE@ x = in[index_tmp>>LOG2_L_TYPE];
+	  for (unsigned int b = 0; b < BITS_PER_TYPE; b += 8){
+	    const unsigned char *t = gri_unpack_msb_first[(x >> (BITS_PER_TYPE-8-b)) & 0xff];
+	    for (int k = 0; k < 8; k++)
+	      out[i+b+k] = t[k];
+	  }
+	}
+	for (; i < noutput_items; i++, index_tmp++)
+	  out[i] = get_bit_be(in, index_tmp);
+	break;
+      }
+
       for (int i = 0; i < noutput_items; i++){
 	//printf("here msb %d\n",i);
 	@O_TYPE@ x = 0;
@@ -112,6 +131,23 @@ int
       break;
 
     case GR_LSB_FIRST:
+      if (d_bits_per_chunk == 1){
+	int i = 0;
+	for (; i < noutput_items && (index_tmp & (BITS_PER_TYPE-1)); i++, index_tmp++)
+	  out[i] = get_bit_le(in, index_tmp);
+	for (; i + (int) BITS_PER_TYPE <= noutput_items; i += BITS_PER_TYPE, index_tmp += BITS_PER_TYPE){
+	  @I_TYPE@ x = in[index_tmp>>LOG2_L_TYPE];
+	  for (unsigned int b = 0; b < BITS_PER_TYPE; b += 8){
+	    const unsigned char *t = gri_unpack_lsb_first[(x >> b) & 0xff];
+	    for (int k = 0; k < 8; k++)
+	      out[i+b+k] = t[k];
+	  }
+	}
+	for (; i < noutput_items; i++, index_tmp++)
+	  out[i] = get_bit_le(in, index_tmp);
+	break;
+      }
+
       for (int i = 0; i < noutput_items; i++){
 	//printf("here lsb %d\n",i);
 	@O_TYPE@ x = 0;
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2006 Free Software Foundation, Inc.
+ * Copyright 2004,2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,6 +29,7 @@
 #include <@NAME@.h>
 #include <gr_io_signature.h>
 #include <assert.h>
+#include <gri_pack_bits.h>
 
 static const unsigned int BITS_PER_TYPE = sizeof(@O_TYPE@) * 8;
 
@@ -92,10 +93,24 @@ int
 
     //assert((ninput_items[m]-d_index)*d_bits_per_chunk >= noutput_items*BITS_PER_TYPE);
   
+    int i = 0;
+
+    // one bit per byte: 32 input bytes at a time
+    if (d_bits_per_chunk == 1 && sizeof(@I_TYPE@) == 1){
+      const unsigned char *bytes = (const unsigned char *) in;
+      int nper = 32 / BITS_PER_TYPE;
+
+      for (; i + nper <= noutput_items; i += nper, index_tmp += 32){
+	uint32_t bits = gri_pack_lsbs_32(&bytes[index_tmp]);
+	for (int k = 0; k < nper; k++, bits >>= 8)
+	  out[i+k] = d_endianness == GR_MSB_FIRST ? gri_reverse_bits8[bits & 0xff] : bits & 0xff;
+      }
+    }
+
     switch(d_endianness){
 
     case GR_MSB_FIRST:
-      for(int i=0;i<noutput_items;i++) {
+      for(;i<noutput_items;i++) {
 	@O_TYPE@ tmp=0;
 	for(unsigned int j=0; j<BITS_PER_TYPE; j++) {
 	  tmp = (tmp<<1) | get_bit_be1(in,index_tmp,d_bits_per_chunk);
@@ -106,7 +121,7 @@ int
       break;
 
     case GR_LSB_FIRST:
-      for(int i=0;i<noutput_items;i++) {
+      for(;i<noutput_items;i++) {
 	unsigned long tmp=0;
 	for(unsigned int j=0; j<BITS_PER_TYPE; j++) {
 	  tmp = (tmp>>1)| (get_bit_be1(in,index_tmp,d_bits_per_chunk)<<(BITS_PER_TYPE-1));
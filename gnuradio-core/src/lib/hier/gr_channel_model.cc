@@ -1,5 +1,5 @@
 /*
- * Copyright 2009 Free Software Foundation, Inc.
+ * Copyright 2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -21,7 +21,6 @@
 
 #include <gr_channel_model.h>
 #include <gr_io_signature.h>
-#include <gr_sig_source_f.h>
 #include <iostream>
 
 // Shared pointer constructor
@@ -54,34 +53,23 @@ gr_channel_model::gr_channel_model(double noise_voltage,
     d_taps.push_back(0);
   }
   
-  d_timing_offset = gr_make_fractional_interpolator_cc(0, epsilon);
-  
-  d_multipath = gr_make_fir_filter_ccc(1, d_taps);
-  
-  d_noise_adder = gr_make_add_cc();
-  d_noise = gr_make_noise_source_c(GR_GAUSSIAN, noise_voltage, noise_seed);
-  d_freq_offset = gr_make_sig_source_c(1, GR_SIN_WAVE, frequency_offset, 1.0, 0.0);
-  d_mixer_offset = gr_make_multiply_cc();
-  
-  connect(self(), 0, d_timing_offset, 0);
-  connect(d_timing_offset, 0, d_multipath, 0);
-  connect(d_multipath, 0, d_mixer_offset, 0);
-  connect(d_freq_offset, 0, d_mixer_offset, 1);
-  connect(d_mixer_offset, 0, d_noise_adder, 1);
-  connect(d_noise, 0, d_noise_adder, 0);
-  connect(d_noise_adder, 0, self(), 0);
+  d_channel = gr_make_channel_model_cc(noise_voltage, frequency_offset,
+				       epsilon, d_taps, (long) noise_seed);
+
+  connect(self(), 0, d_channel, 0);
+  connect(d_channel, 0, self(), 0);
 }
 
 void
 gr_channel_model::set_noise_voltage(double noise_voltage)
 {
-  d_noise->set_amplitude(noise_voltage);
+  d_channel->set_noise_voltage(noise_voltage);
 }
    
 void
 gr_channel_model::set_frequency_offset(double frequency_offset)
 {
-  d_freq_offset->set_frequency(frequency_offset);
+  d_channel->set_frequency_offset(frequency_offset);
 }
      
 void
@@ -91,11 +79,11 @@ gr_channel_model::set_taps(const std::vector<gr_complex> &taps)
   while(d_taps.size() < 2) {
     d_taps.push_back(0);
   }
-  d_multipath->set_taps(d_taps);
+  d_channel->set_taps(d_taps);
 }
 
 void
 gr_channel_model::set_timing_offset(double epsilon)
 {
-  d_timing_offset->set_interp_ratio(epsilon);
+  d_channel->set_timing_offset(epsilon);
 }
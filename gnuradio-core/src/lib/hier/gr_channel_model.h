@@ -1,5 +1,5 @@
 /*
- * Copyright 2009 Free Software Foundation, Inc.
+ * Copyright 2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -20,12 +20,7 @@
  */
 
 #include <gr_top_block.h>
-#include <gr_fractional_interpolator_cc.h>
-#include <gr_sig_source_c.h>
-#include <gr_fir_filter_ccc.h>
-#include <gr_add_cc.h>
-#include <gr_noise_source_c.h>
-#include <gr_multiply_cc.h>
+#include <gr_channel_model_cc.h>
 
 class gr_channel_model;
 typedef boost::shared_ptr<gr_channel_model> gr_channel_model_sptr;
@@ -40,6 +35,9 @@ gr_channel_model_sptr gr_make_channel_model(double noise_voltage=0.0,
 /*!
  * \brief channel simulator
  * \ingroup misc_blk
+ *
+ * Timing offset, multipath, frequency offset and AWGN.  All the work
+ * is done by a single gr_channel_model_cc.
  */
 class gr_channel_model : public gr_hier_block2
 {
@@ -56,12 +54,7 @@ class gr_channel_model : public gr_hier_block2
 						     const std::vector<gr_complex> &taps,
 						     double noise_seed);
   
-  gr_fractional_interpolator_cc_sptr d_timing_offset;
-  gr_sig_source_c_sptr d_freq_offset;
-  gr_fir_filter_ccc_sptr d_multipath;
-  gr_add_cc_sptr d_noise_adder;
-  gr_noise_source_c_sptr d_noise;
-  gr_multiply_cc_sptr d_mixer_offset;
+  gr_channel_model_cc_sptr d_channel;
   
   std::vector<gr_complex> d_taps;
   
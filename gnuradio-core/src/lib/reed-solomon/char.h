@@ -17,6 +17,8 @@ struct rs {
   unsigned char fcr;        /* First consecutive root, index form */
   unsigned char prim;       /* Primitive element, index form */
   unsigned char iprim;      /* prim-th root of 1, index form */
+  unsigned char *synd_mul;  /* NROOTS x (NN+1): x times the i-th root */
+  unsigned char *synd_nib;  /* Nibble tables for the 16th power of each root */
 };
 
 static inline int modnn(struct rs *rs,int x){
@@ -43,12 +45,16 @@ static inline int modnn(struct rs *rs,int x){
 #define DECODE_RS decode_rs_char
 #define INIT_RS init_rs_char
 #define FREE_RS free_rs_char
+#define SYNDROME_RS syndrome_rs_char
+#define INIT_SYNDROME_RS init_syndrome_rs_char
 
 void ENCODE_RS(void *p,DTYPE *data,DTYPE *parity);
 int DECODE_RS(void *p,DTYPE *data,int *eras_pos,int no_eras);
 void *INIT_RS(unsigned int symsize,unsigned int gfpoly,unsigned int fcr,
 		   unsigned int prim,unsigned int nroots);
 void FREE_RS(void *p);
+int SYNDROME_RS(void *p,const DTYPE *data,int len,DTYPE *s);
+int INIT_SYNDROME_RS(struct rs *rs);
 
 
 
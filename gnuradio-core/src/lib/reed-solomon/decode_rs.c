@@ -40,6 +40,13 @@ DTYPE *data, int *eras_pos, int no_eras){
   int syn_error, count;
 
   /* form the syndromes; i.e., evaluate data(x) at roots of g(x) */
+#ifdef SYNDROME_RS
+  syn_error = SYNDROME_RS(rs,data,NN,s);
+  if (!syn_error) {
+    count = 0;
+    goto finish;
+  }
+#else
   for(i=0;i<NROOTS;i++)
     s[i] = data[0];
 
@@ -52,6 +59,7 @@ DTYPE *data, int *eras_pos, int no_eras){
       }
     }
   }
+#endif
 
   /* Convert syndromes to index form, checking for nonzero condition */
   syn_error = 0;
@@ -21,6 +21,10 @@ void FREE_RS(void *p){
   free(rs->alpha_to);
   free(rs->index_of);
   free(rs->genpoly);
+#ifdef SYNDROME_RS
+  free(rs->synd_mul);
+  free(rs->synd_nib);
+#endif
   free(rs);
 }
 
@@ -124,5 +128,12 @@ void *INIT_RS(unsigned int symsize,unsigned int gfpoly,unsigned fcr,unsigned pri
   }
 #endif
 
+#ifdef SYNDROME_RS
+  if(INIT_SYNDROME_RS(rs) != 0){
+    FREE_RS(rs);
+    return NULL;
+  }
+#endif
+
   return rs;
 }
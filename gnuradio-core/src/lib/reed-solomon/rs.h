@@ -11,6 +11,14 @@ void *init_rs_char(unsigned int symsize,unsigned int gfpoly,
 		   unsigned int fcr,unsigned int prim,unsigned int nroots);
 void free_rs_char(void *rs);
 
+/* Syndromes of a codeword of len <= nn symbols (shortened codes: the
+ * leading zeros are implied).  s receives the nroots syndromes in
+ * polynomial form; returns nonzero iff any of them is nonzero, i.e.,
+ * iff data is not a codeword.
+ */
+int syndrome_rs_char(void *rs,const unsigned char *data,int len,
+		     unsigned char *s);
+
 /* General purpose RS codec, integer symbols */
 void encode_rs_int(void *rs,int *data,int *parity);
 int decode_rs_int(void *rs,int *data,int *eras_pos,int no_eras);
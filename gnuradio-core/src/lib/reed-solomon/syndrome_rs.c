@@ -0,0 +1,166 @@
+/* -*- c -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Syndrome computation for the char RS codec.
+ *
+ * Syndrome i is data(x) evaluated at root r_i = alpha**((FCR+i)*PRIM),
+ * by Horner's rule: s = s*r_i ^ data[j].  Multiplying by the fixed r_i
+ * is a single lookup in a per-root table, instead of the log/antilog
+ * round trip (and zero test) of the original loop in decode_rs.c.
+ *
+ * With SSSE3, 16 consecutive symbols are handled at once: lane l
+ * accumulates the symbols at positions = l (mod 16), each step
+ * multiplying by r_i**16 with two PSHUFB nibble lookups.  The lanes
+ * are then combined with a final 16-step scalar Horner pass.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "char.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#define NROOTS4 ((NROOTS+3) & ~3)
+
+static DTYPE gf_mul(struct rs *rs,int log_a,int x){
+  if(x == 0 || x > NN)
+    return 0;
+  return ALPHA_TO[MODNN(INDEX_OF[x] + log_a)];
+}
+
+int INIT_SYNDROME_RS(struct rs *rs){
+  int i,x,root,root16;
+
+  rs->synd_mul = (DTYPE *)malloc(NROOTS*(NN+1));
+  /* Padded to a multiple of 4 roots; the extra tables are zero */
+  rs->synd_nib = (DTYPE *)calloc(NROOTS4,32);
+  if(rs->synd_mul == NULL || rs->synd_nib == NULL)
+    return -1;
+
+  for(i=0;i<NROOTS;i++){
+    root = MODNN((FCR+i)*PRIM);
+    root16 = MODNN(16*root);
+    for(x=0;x<=NN;x++)
+      rs->synd_mul[i*(NN+1)+x] = gf_mul(rs,root,x);
+    for(x=0;x<16;x++){
+      rs->synd_nib[32*i+x] = gf_mul(rs,root16,x);
+      rs->synd_nib[32*i+16+x] = gf_mul(rs,root16,x << 4);
+    }
+  }
+  return 0;
+}
+
+#ifdef __SSSE3__
+
+static inline __m128i gf_mul16(__m128i x,__m128i lo,__m128i hi,__m128i mask){
+  __m128i l = _mm_shuffle_epi8(lo,_mm_and_si128(x,mask));
+  __m128i h = _mm_shuffle_epi8(hi,_mm_and_si128(_mm_srli_epi16(x,4),mask));
+  return _mm_xor_si128(l,h);
+}
+
+int SYNDROME_RS(void *p,const DTYPE *data,int len,DTYPE *s){
+  struct rs *rs = (struct rs *)p;
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  int head = len & 15;
+  DTYPE first[16];
+  DTYPE lanes[4][16];
+  int syn_error = 0;
+  int i,j,k,l;
+
+  /* Left-pad the odd symbols at the front to a full vector */
+  memset(first,0,sizeof(first));
+  memcpy(&first[16-head],data,head);
+
+  for(i=0;i<NROOTS;i+=4){
+    const __m128i *nib = (const __m128i *)&rs->synd_nib[32*i];
+    __m128i lo0 = _mm_loadu_si128(&nib[0]), hi0 = _mm_loadu_si128(&nib[1]);
+    __m128i lo1 = _mm_loadu_si128(&nib[2]), hi1 = _mm_loadu_si128(&nib[3]);
+    __m128i lo2 = _mm_loadu_si128(&nib[4]), hi2 = _mm_loadu_si128(&nib[5]);
+    __m128i lo3 = _mm_loadu_si128(&nib[6]), hi3 = _mm_loadu_si128(&nib[7]);
+    __m128i a0,a1,a2,a3;
+
+    a0 = a1 = a2 = a3 = _mm_loadu_si128((const __m128i *)first);
+    for(j=head;j<len;j+=16){
+      __m128i d = _mm_loadu_si128((const __m128i *)&data[j]);
+      a0 = _mm_xor_si128(gf_mul16(a0,lo0,hi0,mask),d);
+      a1 = _mm_xor_si128(gf_mul16(a1,lo1,hi1,mask),d);
+      a2 = _mm_xor_si128(gf_mul16(a2,lo2,hi2,mask),d);
+      a3 = _mm_xor_si128(gf_mul16(a3,lo3,hi3,mask),d);
+    }
+    _mm_storeu_si128((__m128i *)lanes[0],a0);
+    _mm_storeu_si128((__m128i *)lanes[1],a1);
+    _mm_storeu_si128((__m128i *)lanes[2],a2);
+    _mm_storeu_si128((__m128i *)lanes[3],a3);
+
+    for(k=0;k<4 && i+k<NROOTS;k++){
+      const DTYPE *mul = &rs->synd_mul[(i+k)*(NN+1)];
+      DTYPE t = 0;
+      for(l=0;l<16;l++)
+	t = mul[t] ^ lanes[k][l];
+      s[i+k] = t;
+      syn_error |= t;
+    }
+  }
+  return syn_error;
+}
+
+#else /* !__SSSE3__ */
+
+int SYNDROME_RS(void *p,const DTYPE *data,int len,DTYPE *s){
+  struct rs *rs = (struct rs *)p;
+  int syn_error = 0;
+  int i,j;
+
+  /* Four roots at a time, to keep independent chains in flight */
+  for(i=0;i+4<=NROOTS;i+=4){
+    const DTYPE *m0 = &rs->synd_mul[i*(NN+1)];
+    const DTYPE *m1 = m0 + (NN+1);
+    const DTYPE *m2 = m1 + (NN+1);
+    const DTYPE *m3 = m2 + (NN+1);
+    DTYPE t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+
+    for(j=0;j<len;j++){
+      DTYPE d = data[j];
+      t0 = m0[t0] ^ d;
+      t1 = m1[t1] ^ d;
+      t2 = m2[t2] ^ d;
+      t3 = m3[t3] ^ d;
+    }
+    s[i] = t0; s[i+1] = t1; s[i+2] = t2; s[i+3] = t3;
+    syn_error |= t0 | t1 | t2 | t3;
+  }
+  for(;i<NROOTS;i++){
+    const DTYPE *m = &rs->synd_mul[i*(NN+1)];
+    DTYPE t = 0;
+
+    for(j=0;j<len;j++)
+      t = m[t] ^ data[j];
+    s[i] = t;
+    syn_error |= t;
+  }
+  return syn_error;
+}
+
+#endif /* __SSSE3__ */
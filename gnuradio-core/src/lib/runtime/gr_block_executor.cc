@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2004,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -68,16 +68,20 @@ min_available_space (gr_block_detail *d, int output_multiple)
   int	min_space = std::numeric_limits<int>::max();
 
   for (int i = 0; i < d->noutputs (); i++){
-    gruel::scoped_lock guard(*d->output(i)->mutex());
-#if 0
-    int n = round_down(d->output(i)->space_available(), output_multiple);
-#else
-    int n = round_down(std::min(d->output(i)->space_available(),
-				d->output(i)->bufsize()/2),
-		       output_multiple);
-#endif
+    gr_buffer_sptr out = d->output(i);
+    gruel::scoped_lock guard(*out->mutex(), boost::defer_lock);
+    int space;
+    if (out->locking()){
+      // Leave half for the readers to work on while we fill the rest
+      guard.lock();
+      space = std::min(out->space_available(), out->bufsize()/2);
+    }
+    else	// The readers only run between our calls; take it all
+      space = out->space_available();
+
+    int n = round_down(space, output_multiple);
     if (n == 0){			// We're blocked on output.
-      if (d->output(i)->done()){	// Downstream is done, therefore we're done.
+      if (out->done()){			// Downstream is done, therefore we're done.
 	return -1;
       }
       return 0;
@@ -101,6 +105,13 @@ gr_block_executor::gr_block_executor (gr_block_sptr block)
 	   << d_block << std::endl;
   }
 
+  gr_block_detail *d = d_block->detail().get();
+  d_ninput_items_required.resize(d->ninputs());
+  d_ninput_items.resize(d->ninputs());
+  d_input_items.resize(d->ninputs());
+  d_input_done.resize(d->ninputs());
+  d_output_items.resize(d->noutputs());
+
   d_block->start();			// enable any drivers, etc.
 }
 
@@ -129,12 +140,6 @@ gr_block_executor::run_one_iteration()
   }
 
   if (d->source_p ()){
-    d_ninput_items_required.resize (0);
-    d_ninput_items.resize (0);
-    d_input_items.resize (0);
-    d_input_done.resize(0);
-    d_output_items.resize (d->noutputs ());
-
     // determine the minimum available output space
     noutput_items = min_available_space (d, m->output_multiple ());
     LOG(*d_log << " source\n  noutput_items = " << noutput_items << std::endl);
@@ -150,22 +155,21 @@ gr_block_executor::run_one_iteration()
   }
 
   else if (d->sink_p ()){
-    d_ninput_items_required.resize (d->ninputs ());
-    d_ninput_items.resize (d->ninputs ());
-    d_input_items.resize (d->ninputs ());
-    d_input_done.resize(d->ninputs());
-    d_output_items.resize (0);
     LOG(*d_log << " sink\n");
 
     max_items_avail = 0;
     for (int i = 0; i < d->ninputs (); i++){
       {
 	/*
-	 * Acquire the mutex and grab local copies of items_available and done.
+	 * Acquire the mutex (unless the buffer doesn't use one) and grab
+	 * local copies of items_available and done.
 	 */
-	gruel::scoped_lock guard(*d->input(i)->mutex());
-	d_ninput_items[i] = d->input(i)->items_available();
-	d_input_done[i] = d->input(i)->done();
+	gr_buffer_reader_sptr in = d->input(i);
+	gruel::scoped_lock guard(*in->mutex(), boost::defer_lock);
+	if (in->locking())
+	  guard.lock();
+	d_ninput_items[i] = in->items_available();
+	d_input_done[i] = in->done();
       }
 
       LOG(*d_log << "  d_ninput_items[" << i << "] = " << d_ninput_items[i] << std::endl);
@@ -193,21 +197,19 @@ gr_block_executor::run_one_iteration()
 
   else {
     // do the regular thing
-    d_ninput_items_required.resize (d->ninputs ());
-    d_ninput_items.resize (d->ninputs ());
-    d_input_items.resize (d->ninputs ());
-    d_input_done.resize(d->ninputs());
-    d_output_items.resize (d->noutputs ());
-
     max_items_avail = 0;
     for (int i = 0; i < d->ninputs (); i++){
       {
 	/*
-	 * Acquire the mutex and grab local copies of items_available and done.
+	 * Acquire the mutex (unless the buffer doesn't use one) and grab
+	 * local copies of items_available and done.
 	 */
-	gruel::scoped_lock guard(*d->input(i)->mutex());
-	d_ninput_items[i] = d->input(i)->items_available ();
-	d_input_done[i] = d->input(i)->done();
+	gr_buffer_reader_sptr in = d->input(i);
+	gruel::scoped_lock guard(*in->mutex(), boost::defer_lock);
+	if (in->locking())
+	  guard.lock();
+	d_ninput_items[i] = in->items_available();
+	d_input_done[i] = in->done();
       }
       max_items_avail = std::max (max_items_avail, d_ninput_items[i]);
     }
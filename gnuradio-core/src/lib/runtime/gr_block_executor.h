@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2008 Free Software Foundation, Inc.
+ * Copyright 2004,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -40,7 +40,7 @@ protected:
   gr_block_sptr			d_block;	// The block we're trying to run
   std::ofstream	       	       *d_log;
 
-  // These are allocated here so we don't have to on each iteration
+  // These are allocated and sized here so we don't have to on each iteration
 
   gr_vector_int			d_ninput_items_required;
   gr_vector_int			d_ninput_items;
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2009 Free Software Foundation, Inc.
+ * Copyright 2004,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -80,7 +80,7 @@ minimum_buffer_items (long type_size, long page_size)
 gr_buffer::gr_buffer (int nitems, size_t sizeof_item, gr_block_sptr link)
   : d_base (0), d_bufsize (0), d_vmcircbuf (0),
     d_sizeof_item (sizeof_item), d_link(link),
-    d_write_index (0), d_done (false)
+    d_write_index (0), d_done (false), d_locking (true)
 {
   if (!allocate_buffer (nitems, sizeof_item))
     throw std::bad_alloc ();
@@ -175,6 +175,11 @@ gr_buffer::write_pointer ()
 void
 gr_buffer::update_write_pointer (int nitems)
 {
+  if (!d_locking){
+    d_write_index = index_add (d_write_index, nitems);
+    return;
+  }
+
   gruel::scoped_lock guard(*mutex());
   d_write_index = index_add (d_write_index, nitems);
 }
@@ -251,6 +256,11 @@ gr_buffer_reader::read_pointer ()
 void
 gr_buffer_reader::update_read_pointer (int nitems)
 {
+  if (!d_buffer->d_locking){
+    d_read_index = d_buffer->index_add (d_read_index, nitems);
+    return;
+  }
+
   gruel::scoped_lock guard(*mutex());
   d_read_index = d_buffer->index_add (d_read_index, nitems);
 }
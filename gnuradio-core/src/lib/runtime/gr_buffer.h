@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004,2009 Free Software Foundation, Inc.
+ * Copyright 2004,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -88,6 +88,15 @@ class gr_buffer {
 
   gruel::mutex *mutex() { return &d_mutex; }
 
+  /*!
+   * \brief Should updates to the read and write pointers take the mutex?
+   *
+   * True by default.  A scheduler that runs the writer and every reader
+   * of this buffer in the same thread can turn it off.
+   */
+  void set_locking (bool locking) { d_locking = locking; }
+  bool locking () const { return d_locking; }
+
   // -------------------------------------------------------------------------
 
  private:
@@ -111,6 +120,7 @@ class gr_buffer {
   gruel::mutex				d_mutex;
   unsigned int				d_write_index;	// in items [0,d_bufsize)
   bool					d_done;
+  bool					d_locking;
   
   unsigned
   index_add (unsigned a, unsigned b)
@@ -218,6 +228,7 @@ class gr_buffer_reader {
   bool done () const { return d_buffer->done (); }
 
   gruel::mutex *mutex() { return d_buffer->mutex(); }
+  bool locking () const { return d_buffer->locking(); }
 
 
   /*!
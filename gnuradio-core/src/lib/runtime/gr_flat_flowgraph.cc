@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -30,6 +30,7 @@
 #include <gr_buffer.h>
 #include <iostream>
 #include <map>
+#include <algorithm>
 
 #define GR_FLAT_FLOWGRAPH_DEBUG 0
 
@@ -176,13 +177,10 @@ gr_flat_flowgraph::merge_connections(gr_flat_flowgraph_sptr old_ffg)
     if (GR_FLAT_FLOWGRAPH_DEBUG)
       std::cout << "merge: testing old edge " << (*old_edge) << "...";
       
-    gr_edge_viter_t new_edge;
-    for (new_edge = d_edges.begin(); new_edge != d_edges.end(); new_edge++)
-      if (new_edge->src() == old_edge->src() &&
-	  new_edge->dst() == old_edge->dst())
-	break;
+    // A destination port has at most one edge into it
+    gr_edge new_edge = calc_upstream_edge(old_edge->dst().block(), old_edge->dst().port());
 
-    if (new_edge == d_edges.end()) { // not found in new edge list
+    if (!(new_edge.src() == old_edge->src())) { // not found in new edge list
       if (GR_FLAT_FLOWGRAPH_DEBUG)
 	std::cout << "not in new edge list" << std::endl;
       // zero the buffer reader on RHS of old edge
@@ -250,6 +248,80 @@ gr_flat_flowgraph::merge_connections(gr_flat_flowgraph_sptr old_ffg)
   }  
 }
 
+gr_basic_block_vector_t
+gr_flat_flowgraph::calc_changed_blocks(gr_flat_flowgraph_sptr old_ffg)
+{
+  std::vector<gr_basic_block_vector_t> old_parts = old_ffg->partition();
+  std::vector<gr_basic_block_vector_t> new_parts = partition();
+  std::vector<bool> old_same(old_parts.size(), false);
+  gr_basic_block_vector_t result;
+
+  // Index the old partitions by block
+  std::map<gr_basic_block_sptr, size_t> old_index;
+  for (size_t i = 0; i < old_parts.size(); i++)
+    for (gr_basic_block_viter_t p = old_parts[i].begin(); p != old_parts[i].end(); p++)
+      old_index[*p] = i;
+
+  for (size_t i = 0; i < new_parts.size(); i++) {
+    gr_basic_block_vector_t &part = new_parts[i];
+    std::map<gr_basic_block_sptr, size_t>::iterator o = old_index.find(part[0]);
+    bool same = (o != old_index.end() && part.size() == old_parts[o->second].size());
+
+    // Same blocks?  All of them must come from that one old partition
+    for (gr_basic_block_viter_t p = part.begin(); same && p != part.end(); p++) {
+      std::map<gr_basic_block_sptr, size_t>::iterator q = old_index.find(*p);
+      same = (q != old_index.end() && q->second == o->second);
+    }
+
+    // Same edges?
+    if (same) {
+      gr_edge_vector_t new_edges = calc_partition_edges(part);
+      gr_edge_vector_t old_edges = old_ffg->calc_partition_edges(old_parts[o->second]);
+      same = (new_edges.size() == old_edges.size());
+      for (gr_edge_viter_t e = new_edges.begin(); same && e != new_edges.end(); e++) {
+	gr_edge f = old_ffg->calc_upstream_edge(e->dst().block(), e->dst().port());
+	same = (f.src() == e->src());
+      }
+    }
+
+    if (same) {
+      if (GR_FLAT_FLOWGRAPH_DEBUG)
+	std::cout << "changed: partition of " << part[0] << " is unchanged" << std::endl;
+      old_same[o->second] = true;
+    }
+    else
+      result.insert(result.end(), part.begin(), part.end());
+  }
+
+  // Old partitions without a match are going away or changing too
+  for (size_t i = 0; i < old_parts.size(); i++) {
+    if (old_same[i])
+      continue;
+    result.insert(result.end(), old_parts[i].begin(), old_parts[i].end());
+  }
+
+  // A changed block can be in both
+  sort(result.begin(), result.end());
+  result.erase(unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+// Return the edges leaving any of blocks.  For a partition these are
+// all of its edges.
+gr_edge_vector_t
+gr_flat_flowgraph::calc_partition_edges(gr_basic_block_vector_t &blocks)
+{
+  gr_edge_vector_t result;
+  for (gr_basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++) {
+    gr_edge_index_t::iterator i = d_downstream.find(*p);
+    if (i != d_downstream.end())
+      for (std::vector<int>::iterator e = i->second.begin(); e != i->second.end(); e++)
+	result.push_back(d_edges[*e]);
+  }
+
+  return result;
+}
+
 void gr_flat_flowgraph::dump()
 {
   for (gr_edge_viter_t e = d_edges.begin(); e != d_edges.end(); e++)
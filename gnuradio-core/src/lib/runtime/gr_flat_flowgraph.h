@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -49,6 +49,15 @@ public:
   // Merge applicable connections from existing flat flowgraph
   void merge_connections(gr_flat_flowgraph_sptr sfg);
 
+  /*!
+   * \brief Return the blocks of partitions that differ from \p old_ffg.
+   *
+   * A partition (see partition()) with the same blocks and edges in
+   * both flow graphs is unchanged.  The result holds the blocks of all
+   * the other partitions of either flow graph.
+   */
+  gr_basic_block_vector_t calc_changed_blocks(gr_flat_flowgraph_sptr old_ffg);
+
   void dump();
 
   /*!
@@ -62,6 +71,7 @@ private:
   gr_block_detail_sptr allocate_block_detail(gr_basic_block_sptr block);
   gr_buffer_sptr allocate_buffer(gr_basic_block_sptr block, int port);
   void connect_block_inputs(gr_basic_block_sptr block);
+  gr_edge_vector_t calc_partition_edges(gr_basic_block_vector_t &blocks);
 };
 
 #endif /* INCLUDED_GR_FLAT_FLOWGRAPH_H */
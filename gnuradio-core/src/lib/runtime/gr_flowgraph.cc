@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,6 +28,8 @@
 #include <gr_io_signature.h>
 #include <stdexcept>
 #include <sstream>
+#include <algorithm>
+#include <iterator>
 
 #define GR_FLOWGRAPH_DEBUG 0
 
@@ -62,6 +64,23 @@ unique_vector(std::vector<T> v)
   return result;
 }
 
+// Remove edge i of block from index, and renumber the edges after it
+static void
+unindex_edge(gr_edge_index_t &index, gr_basic_block_sptr block, int i)
+{
+  gr_edge_index_t::iterator b = index.find(block);
+  std::vector<int> &edges = b->second;
+
+  edges.erase(std::find(edges.begin(), edges.end(), i));
+  if (edges.empty())
+    index.erase(b);
+
+  for (b = index.begin(); b != index.end(); b++)
+    for (std::vector<int>::iterator p = b->second.begin(); p != b->second.end(); p++)
+      if (*p > i)
+	(*p)--;
+}
+
 void
 gr_flowgraph::connect(const gr_endpoint &src, const gr_endpoint &dst)
 {
@@ -71,6 +90,8 @@ gr_flowgraph::connect(const gr_endpoint &src, const gr_endpoint &dst)
   check_type_match(src, dst);
 
   // All ist klar, Herr Kommisar
+  d_upstream[dst.block()].push_back(d_edges.size());
+  d_downstream[src.block()].push_back(d_edges.size());
   d_edges.push_back(gr_edge(src,dst));
 }
 
@@ -79,6 +100,9 @@ gr_flowgraph::disconnect(const gr_endpoint &src, const gr_endpoint &dst)
 {
   for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++) {
     if (src == p->src() && dst == p->dst()) {
+      int i = p - d_edges.begin();
+      unindex_edge(d_upstream, dst.block(), i);
+      unindex_edge(d_downstream, src.block(), i);
       d_edges.erase(p);
       return;
     }
@@ -125,20 +149,24 @@ gr_flowgraph::clear()
   // Boost shared pointers will deallocate as needed
   d_blocks.clear();
   d_edges.clear();
+  d_upstream.clear();
+  d_downstream.clear();
 }
 
 void
 gr_flowgraph::check_valid_port(gr_io_signature_sptr sig, int port)
 {
-  std::stringstream msg;
-
+  // The message is only made when needed; connect() is called for
+  // every edge of a flattened flow graph
   if (port < 0) {
+    std::stringstream msg;
     msg << "negative port number " << port << " is invalid";
     throw std::invalid_argument(msg.str());
   }
 
   int max = sig->max_streams();
   if (max != gr_io_signature::IO_INFINITE && port >= max) {
+    std::stringstream msg;
     msg << "port number " << port << " exceeds max of ";
     if (max == 0)
       msg << "(none)";
@@ -152,10 +180,14 @@ void
 gr_flowgraph::check_dst_not_used(const gr_endpoint &dst)
 {
   // A destination is in use if it is already on the edge list
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++)
-    if (p->dst() == dst) {
+  gr_edge_index_t::iterator i = d_upstream.find(dst.block());
+  if (i == d_upstream.end())
+    return;
+
+  for (std::vector<int>::iterator p = i->second.begin(); p != i->second.end(); p++)
+    if (d_edges[*p].dst() == dst) {
       std::stringstream msg;
-      msg << "destination already in use by edge " << (*p);
+      msg << "destination already in use by edge " << d_edges[*p];
       throw std::invalid_argument(msg.str());
     }
 }
@@ -177,15 +209,18 @@ gr_flowgraph::check_type_match(const gr_endpoint &src, const gr_endpoint &dst)
 gr_basic_block_vector_t
 gr_flowgraph::calc_used_blocks()
 {
-  gr_basic_block_vector_t tmp;
+  gr_basic_block_vector_t srcs, dsts, result;
+  gr_edge_index_t::iterator p;
 
-  // Collect all blocks in the edge list
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++) {
-    tmp.push_back(p->src().block());
-    tmp.push_back(p->dst().block());
-  }
+  // Collect all blocks in the edge list.  The indices are already sorted.
+  for (p = d_downstream.begin(); p != d_downstream.end(); p++)
+    srcs.push_back(p->first);
+  for (p = d_upstream.begin(); p != d_upstream.end(); p++)
+    dsts.push_back(p->first);
 
-  return unique_vector<gr_basic_block_sptr>(tmp);
+  std::set_union(srcs.begin(), srcs.end(), dsts.begin(), dsts.end(),
+		 std::back_inserter(result));
+  return result;
 }
 
 std::vector<int>
@@ -209,17 +244,12 @@ gr_edge_vector_t
 gr_flowgraph::calc_connections(gr_basic_block_sptr block, bool check_inputs)
 {
   gr_edge_vector_t result;
+  gr_edge_index_t &index = check_inputs ? d_upstream : d_downstream;
+  gr_edge_index_t::iterator i = index.find(block);
 
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++) {
-    if (check_inputs) {
-      if (p->dst().block() == block)
-	result.push_back(*p);
-    }
-    else {
-      if (p->src().block() == block)
-	result.push_back(*p);
-    }
-  }
+  if (i != index.end())
+    for (std::vector<int>::iterator p = i->second.begin(); p != i->second.end(); p++)
+      result.push_back(d_edges[*p]);
 
   return result; // assumes no duplicates
 }
@@ -229,8 +259,6 @@ gr_flowgraph::check_contiguity(gr_basic_block_sptr block,
 			       const std::vector<int> &used_ports,
 			       bool check_inputs)
 {
-  std::stringstream msg;
-
   gr_io_signature_sptr sig =
     check_inputs ? block->input_signature() : block->output_signature();
 
@@ -242,6 +270,7 @@ gr_flowgraph::check_contiguity(gr_basic_block_sptr block,
     return;
 
   if (nports < min_ports) {
+    std::stringstream msg;
     msg << block << ": insufficient connected "
        << (check_inputs ? "input ports " : "output ports ")
        << "(" << min_ports << " needed, " << nports << " connected)";
@@ -249,6 +278,7 @@ gr_flowgraph::check_contiguity(gr_basic_block_sptr block,
   }
 
   if (nports > max_ports && max_ports != gr_io_signature::IO_INFINITE) {
+    std::stringstream msg;
     msg << block << ": too many connected "
        << (check_inputs ? "input ports " : "output ports ")
        << "(" << max_ports << " allowed, " << nports << " connected)";
@@ -258,6 +288,7 @@ gr_flowgraph::check_contiguity(gr_basic_block_sptr block,
   if (used_ports[nports-1]+1 != nports) {
     for (int i = 0; i < nports; i++) {
       if (used_ports[i] != i) {
+	std::stringstream msg;
 	msg << block << ": missing connection " 
 	    << (check_inputs ? "to input port " : "from output port ")
 	    << i;
@@ -271,9 +302,10 @@ gr_basic_block_vector_t
 gr_flowgraph::calc_downstream_blocks(gr_basic_block_sptr block, int port)
 {
   gr_basic_block_vector_t tmp;
+  gr_edge_vector_t edges = calc_connections(block, false);
 
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++)
-    if (p->src() == gr_endpoint(block, port))
+  for (gr_edge_viter_t p = edges.begin(); p != edges.end(); p++)
+    if (p->src().port() == port)
       tmp.push_back(p->dst().block());
 
   return unique_vector<gr_basic_block_sptr>(tmp);
@@ -283,10 +315,10 @@ gr_basic_block_vector_t
 gr_flowgraph::calc_downstream_blocks(gr_basic_block_sptr block)
 {
   gr_basic_block_vector_t tmp;
+  gr_edge_vector_t edges = calc_connections(block, false);
 
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++)
-    if (p->src().block() == block)
-      tmp.push_back(p->dst().block());
+  for (gr_edge_viter_t p = edges.begin(); p != edges.end(); p++)
+    tmp.push_back(p->dst().block());
 
   return unique_vector<gr_basic_block_sptr>(tmp);
 }
@@ -294,30 +326,23 @@ gr_flowgraph::calc_downstream_blocks(gr_basic_block_sptr block)
 gr_edge_vector_t
 gr_flowgraph::calc_upstream_edges(gr_basic_block_sptr block)
 {
-  gr_edge_vector_t result;
-
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++)
-    if (p->dst().block() == block)
-      result.push_back(*p);
-
-  return result; // Assume no duplicates
+  return calc_connections(block, true);
 }
 
 bool
 gr_flowgraph::has_block_p(gr_basic_block_sptr block)
 {
-  gr_basic_block_viter_t result;
-  result = std::find(d_blocks.begin(), d_blocks.end(), block);
-  return (result != d_blocks.end());
+  return std::binary_search(d_blocks.begin(), d_blocks.end(), block);
 }
 
 gr_edge
 gr_flowgraph::calc_upstream_edge(gr_basic_block_sptr block, int port)
 {
   gr_edge result;
+  gr_edge_vector_t edges = calc_connections(block, true);
 
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++) {
-    if (p->dst() == gr_endpoint(block, port)) {
+  for (gr_edge_viter_t p = edges.begin(); p != edges.end(); p++) {
+    if (p->dst().port() == port) {
       result = (*p);
       break;
     }
@@ -333,66 +358,58 @@ gr_flowgraph::partition()
   gr_basic_block_vector_t blocks = calc_used_blocks();
   gr_basic_block_vector_t graph;
 
-  while (blocks.size() > 0) {
-    graph = calc_reachable_blocks(blocks[0], blocks);
-    assert(graph.size());
-    result.push_back(topological_sort(graph));
-
-    for (gr_basic_block_viter_t p = graph.begin(); p != graph.end(); p++)
-      blocks.erase(find(blocks.begin(), blocks.end(), *p));
-  }
-
-  return result;
-}
-
-gr_basic_block_vector_t
-gr_flowgraph::calc_reachable_blocks(gr_basic_block_sptr block, gr_basic_block_vector_t &blocks)
-{
-  gr_basic_block_vector_t result;
-
-  // Mark all blocks as unvisited
+  // Mark all blocks as unvisited.  Each search below leaves the blocks
+  // it reaches marked, so the next starts from one it hasn't.
   for (gr_basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++)
     (*p)->set_color(gr_basic_block::WHITE);
 
-  // Recursively mark all reachable blocks
-  reachable_dfs_visit(block, blocks);
+  for (gr_basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++) {
+    if ((*p)->color() != gr_basic_block::WHITE)
+      continue;
 
-  // Collect all the blocks that have been visited
-  for (gr_basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++)
-    if ((*p)->color() == gr_basic_block::BLACK)
-      result.push_back(*p);
+    graph.clear();
+    reachable_dfs_visit(*p, graph);
+    assert(graph.size());
+    sort(graph.begin(), graph.end());
+    result.push_back(topological_sort(graph));
+  }
 
   return result;
 }
 
-// Recursively mark all reachable blocks from given block and block list
+// Recursively mark all reachable blocks from given block, appending
+// each to reached as it is marked
 void 
-gr_flowgraph::reachable_dfs_visit(gr_basic_block_sptr block, gr_basic_block_vector_t &blocks)
+gr_flowgraph::reachable_dfs_visit(gr_basic_block_sptr block, gr_basic_block_vector_t &reached)
 {
   // Mark the current one as visited
   block->set_color(gr_basic_block::BLACK);
+  reached.push_back(block);
 
   // Recurse into adjacent vertices
-  gr_basic_block_vector_t adjacent = calc_adjacent_blocks(block, blocks);
+  gr_basic_block_vector_t adjacent = calc_adjacent_blocks(block);
 
   for (gr_basic_block_viter_t p = adjacent.begin(); p != adjacent.end(); p++)
     if ((*p)->color() == gr_basic_block::WHITE)
-      reachable_dfs_visit(*p, blocks);
+      reachable_dfs_visit(*p, reached);
 }
 
 // Return a list of block adjacent to a given block along any edge
 gr_basic_block_vector_t 
-gr_flowgraph::calc_adjacent_blocks(gr_basic_block_sptr block, gr_basic_block_vector_t &blocks)
+gr_flowgraph::calc_adjacent_blocks(gr_basic_block_sptr block)
 {
   gr_basic_block_vector_t tmp;
+  gr_edge_vector_t edges;
+  gr_edge_viter_t p;
     
   // Find any blocks that are inputs or outputs
-  for (gr_edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++) {
-    if (p->src().block() == block)
-      tmp.push_back(p->dst().block());
-    if (p->dst().block() == block)
-      tmp.push_back(p->src().block());
-  }    
+  edges = calc_connections(block, false);
+  for (p = edges.begin(); p != edges.end(); p++)
+    tmp.push_back(p->dst().block());
+
+  edges = calc_connections(block, true);
+  for (p = edges.begin(); p != edges.end(); p++)
+    tmp.push_back(p->src().block());
 
   return unique_vector<gr_basic_block_sptr>(tmp);
 }
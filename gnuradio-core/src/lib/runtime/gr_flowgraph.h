@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,7 @@
 
 #include <gr_basic_block.h>
 #include <iostream>
+#include <map>
 
 /*!
  * \brief Class representing a specific input or output graph endpoint
@@ -39,7 +40,7 @@ private:
 public:
   gr_endpoint() : d_basic_block(), d_port(0) { }
   gr_endpoint(gr_basic_block_sptr block, int port) { d_basic_block = block; d_port = port; }
-  gr_basic_block_sptr block() const { return d_basic_block; }
+  const gr_basic_block_sptr &block() const { return d_basic_block; }
   int port() const { return d_port; }
 
   bool operator==(const gr_endpoint &other) const;
@@ -78,6 +79,9 @@ private:
 typedef std::vector<gr_edge> gr_edge_vector_t;
 typedef std::vector<gr_edge>::iterator gr_edge_viter_t;
 
+// Positions in an edge vector of the edges into or out of each block
+typedef std::map<gr_basic_block_sptr, std::vector<int> > gr_edge_index_t;
+
 
 // Create a shared pointer to a heap allocated flowgraph
 // (types defined in gr_runtime_types.h)
@@ -129,8 +133,10 @@ public:
   std::vector<gr_basic_block_vector_t> partition();
 
 protected:
-  gr_basic_block_vector_t d_blocks;
+  gr_basic_block_vector_t d_blocks;	// sorted, see validate()
   gr_edge_vector_t d_edges;
+  gr_edge_index_t d_upstream;		// d_edges by destination block
+  gr_edge_index_t d_downstream;		// d_edges by source block
 
   gr_flowgraph();
   std::vector<int> calc_used_ports(gr_basic_block_sptr block, bool check_inputs); 
@@ -148,9 +154,8 @@ private:
   void check_contiguity(gr_basic_block_sptr block, const std::vector<int> &used_ports, bool check_inputs);
 
   gr_basic_block_vector_t calc_downstream_blocks(gr_basic_block_sptr block);
-  gr_basic_block_vector_t calc_reachable_blocks(gr_basic_block_sptr block, gr_basic_block_vector_t &blocks);
-  void reachable_dfs_visit(gr_basic_block_sptr block, gr_basic_block_vector_t &blocks);
-  gr_basic_block_vector_t calc_adjacent_blocks(gr_basic_block_sptr block, gr_basic_block_vector_t &blocks);
+  void reachable_dfs_visit(gr_basic_block_sptr block, gr_basic_block_vector_t &reached);
+  gr_basic_block_vector_t calc_adjacent_blocks(gr_basic_block_sptr block);
   gr_basic_block_vector_t sort_sources_first(gr_basic_block_vector_t &blocks);
   bool source_p(gr_basic_block_sptr block);
   void topological_dfs_visit(gr_basic_block_sptr block, gr_basic_block_vector_t &output);
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006,2007,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -33,7 +33,8 @@
 gr_hier_block2_detail::gr_hier_block2_detail(gr_hier_block2 *owner) :
   d_owner(owner), 
   d_parent_detail(0),
-  d_fg(gr_make_flowgraph())
+  d_fg(gr_make_flowgraph()),
+  d_flat_valid(false)
 {
   int min_inputs = owner->input_signature()->min_streams();
   int max_inputs = owner->input_signature()->max_streams();
@@ -63,6 +64,8 @@ gr_hier_block2_detail::connect(gr_basic_block_sptr block)
 {
   std::stringstream msg;
 
+  clear_flat_edges();
+
   // Check if duplicate
   if (std::find(d_blocks.begin(), d_blocks.end(), block) != d_blocks.end()) {
     msg << "Block " << block << " already connected.";
@@ -97,6 +100,8 @@ gr_hier_block2_detail::connect(gr_basic_block_sptr src, int src_port,
     std::cout << "connecting: " << gr_endpoint(src, src_port)
               << " -> " << gr_endpoint(dst, dst_port) << std::endl;
 
+  clear_flat_edges();
+
   if (src.get() == dst.get())
     throw std::invalid_argument("connect: src and destination blocks cannot be the same");
 
@@ -146,6 +151,8 @@ gr_hier_block2_detail::connect(gr_basic_block_sptr src, int src_port,
 void
 gr_hier_block2_detail::disconnect(gr_basic_block_sptr block)
 {
+  clear_flat_edges();
+
   // Check on singleton list
   for (gr_basic_block_viter_t p = d_blocks.begin(); p != d_blocks.end(); p++) {
     if (*p == block) {
@@ -194,6 +201,8 @@ gr_hier_block2_detail::disconnect(gr_basic_block_sptr src, int src_port,
     std::cout << "disconnecting: " << gr_endpoint(src, src_port)
               << " -> " << gr_endpoint(dst, dst_port) << std::endl;
 
+  clear_flat_edges();
+
   if (src.get() == dst.get())
     throw std::invalid_argument("disconnect: source and destination blocks cannot be the same");
 
@@ -363,6 +372,7 @@ gr_hier_block2_detail::resolve_port(int port, bool is_input)
 void
 gr_hier_block2_detail::disconnect_all()
 {
+  clear_flat_edges();
   d_fg->clear();
   d_blocks.clear();
   d_inputs.clear();
@@ -372,7 +382,6 @@ gr_hier_block2_detail::disconnect_all()
 gr_endpoint_vector_t
 gr_hier_block2_detail::resolve_endpoint(const gr_endpoint &endp, bool is_input) const
 {
-  std::stringstream msg;
   gr_endpoint_vector_t result;
 
   // Check if endpoint is a leaf node
@@ -393,6 +402,7 @@ gr_hier_block2_detail::resolve_endpoint(const gr_endpoint &endp, bool is_input)
     return hier_block2->d_detail->resolve_port(endp.port(), is_input);
   }
 
+  std::stringstream msg;
   msg << "unable to resolve" << (is_input ? " input " : " output ")
       << "endpoint " << endp;
   throw std::runtime_error(msg.str());
@@ -404,9 +414,27 @@ gr_hier_block2_detail::flatten_aux(gr_flat_flowgraph_sptr sfg) const
   if (GR_HIER_BLOCK2_DETAIL_DEBUG)
     std::cout << "Flattening " << d_owner->name() << std::endl;
 
-  // Add my edges to the flow graph, resolving references to actual endpoints
-  gr_edge_vector_t edges = d_fg->edges();
-  gr_edge_viter_t p;
+  const gr_edge_vector_t &edges = flat_edges();
+  for (gr_edge_vector_t::const_iterator p = edges.begin(); p != edges.end(); p++)
+    sfg->connect(p->src(), p->dst());
+}
+
+// Return the leaf edges of this block and everything inside it,
+// recalculating only those of the blocks that have changed
+const gr_edge_vector_t &
+gr_hier_block2_detail::flat_edges() const
+{
+  if (flat_edges_valid()) {
+    if (GR_HIER_BLOCK2_DETAIL_DEBUG)
+      std::cout << "flat_edges: reusing edges of " << d_owner->name() << std::endl;
+    return d_flat_edges;
+  }
+
+  clear_flat_edges();
+
+  // Add my edges, resolving references to actual endpoints
+  const gr_edge_vector_t &edges = d_fg->edges();
+  gr_edge_vector_t::const_iterator p;
 
   for (p = edges.begin(); p != edges.end(); p++) {
     if (GR_HIER_BLOCK2_DETAIL_DEBUG)
@@ -420,7 +448,7 @@ gr_hier_block2_detail::flatten_aux(gr_flat_flowgraph_sptr sfg) const
       for (d = dst_endps.begin(); d != dst_endps.end(); d++) {
 	if (GR_HIER_BLOCK2_DETAIL_DEBUG)
 	  std::cout << (*s) << "->" << (*d) << std::endl;
-	sfg->connect(*s, *d);
+	d_flat_edges.push_back(gr_edge(*s, *d));
       }
     }
   }
@@ -431,7 +459,7 @@ gr_hier_block2_detail::flatten_aux(gr_flat_flowgraph_sptr sfg) const
   gr_basic_block_vector_t tmp = d_fg->calc_used_blocks();
 
   // First add the list of singleton blocks
-  std::vector<gr_basic_block_sptr>::const_iterator b;   // Because flatten_aux is const
+  std::vector<gr_basic_block_sptr>::const_iterator b;   // Because flat_edges is const
   for (b = d_blocks.begin(); b != d_blocks.end(); b++)
     tmp.push_back(*b);
 
@@ -462,15 +490,44 @@ gr_hier_block2_detail::flatten_aux(gr_flat_flowgraph_sptr sfg) const
   std::insert_iterator<gr_basic_block_vector_t> inserter(blocks, blocks.begin());
   unique_copy(tmp.begin(), tmp.end(), inserter);
 
-  // Recurse hierarchical children
+  // Add the edges of hierarchical children
   for (gr_basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++) {
     gr_hier_block2_sptr hier_block2(cast_to_hier_block2_sptr(*p));
     if (hier_block2) {
       if (GR_HIER_BLOCK2_DETAIL_DEBUG)
-	std::cout << "flatten_aux: recursing into hierarchical block " << hier_block2 << std::endl;
-      hier_block2->d_detail->flatten_aux(sfg);
+	std::cout << "flat_edges: recursing into hierarchical block " << hier_block2 << std::endl;
+      const gr_edge_vector_t &child_edges = hier_block2->d_detail->flat_edges();
+      d_flat_edges.insert(d_flat_edges.end(), child_edges.begin(), child_edges.end());
+      d_flat_children.push_back(hier_block2);
     }
   }
+
+  d_flat_valid = true;
+  return d_flat_edges;
+}
+
+// The edges are still good if neither this block nor any hierarchical
+// block inside it has been connected or disconnected since
+bool
+gr_hier_block2_detail::flat_edges_valid() const
+{
+  if (!d_flat_valid)
+    return false;
+
+  std::vector<gr_hier_block2_sptr>::const_iterator p;
+  for (p = d_flat_children.begin(); p != d_flat_children.end(); p++)
+    if (!(*p)->d_detail->flat_edges_valid())
+      return false;
+
+  return true;
+}
+
+void
+gr_hier_block2_detail::clear_flat_edges() const
+{
+  d_flat_valid = false;
+  d_flat_edges.clear();
+  d_flat_children.clear();
 }
 
 void
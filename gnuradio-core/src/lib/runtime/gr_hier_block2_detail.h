@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -55,6 +55,12 @@ private:
   std::vector<gr_endpoint_vector_t> d_inputs; // Multiple internal endpoints per external input
   gr_endpoint_vector_t d_outputs;             // Single internal endpoint per external output
   gr_basic_block_vector_t d_blocks;
+
+  // The leaf edges of this block and of the hierarchical blocks inside
+  // it, kept from one flatten to the next until one of them changes
+  mutable gr_edge_vector_t d_flat_edges;
+  mutable std::vector<gr_hier_block2_sptr> d_flat_children;
+  mutable bool d_flat_valid;
   
   void connect_input(int my_port, int port, gr_basic_block_sptr block);
   void connect_output(int my_port, int port, gr_basic_block_sptr block);
@@ -63,6 +69,10 @@ private:
 
   gr_endpoint_vector_t resolve_port(int port, bool is_input);
   gr_endpoint_vector_t resolve_endpoint(const gr_endpoint &endp, bool is_input) const;
+
+  const gr_edge_vector_t &flat_edges() const;
+  bool flat_edges_valid() const;
+  void clear_flat_edges() const;
 };
 
 #endif /* INCLUDED_GR_HIER_BLOCK2_DETAIL_H */
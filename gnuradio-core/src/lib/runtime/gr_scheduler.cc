@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -31,3 +31,9 @@ gr_scheduler::gr_scheduler(gr_flat_flowgraph_sptr ffg)
 gr_scheduler::~gr_scheduler()
 {
 }
+
+bool
+gr_scheduler::reconfigure(gr_flat_flowgraph_sptr new_ffg)
+{
+  return false;
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -59,6 +59,15 @@ public:
    * \brief Block until the graph is done.
    */
   virtual void wait() = 0;
+
+  /*!
+   * \brief Switch to executing \p new_ffg while running.
+   *
+   * \p new_ffg has been validated but not connected.  Returns false
+   * if the scheduler can't do this, in which case the caller must stop
+   * it and start a new one.
+   */
+  virtual bool reconfigure(gr_flat_flowgraph_sptr new_ffg);
 };
 
 #endif /* INCLUDED_GR_SCHEDULER_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,15 +29,16 @@
 class sts_container
 {
   gr_block_vector_t	d_blocks;
+  bool			d_data_driven;
   
 public:
 
-  sts_container(gr_block_vector_t blocks)
-    : d_blocks(blocks) {}
+  sts_container(gr_block_vector_t blocks, bool data_driven)
+    : d_blocks(blocks), d_data_driven(data_driven) {}
 
   void operator()()
   {
-    gr_make_single_threaded_scheduler(d_blocks)->run();
+    gr_make_single_threaded_scheduler(d_blocks, d_data_driven)->run();
   }
 };
 
@@ -48,7 +49,13 @@ gr_scheduler_sts::make(gr_flat_flowgraph_sptr ffg)
   return gr_scheduler_sptr(new gr_scheduler_sts(ffg));
 }
 
-gr_scheduler_sts::gr_scheduler_sts(gr_flat_flowgraph_sptr ffg)
+gr_scheduler_sptr
+gr_scheduler_sts::make_data_driven(gr_flat_flowgraph_sptr ffg)
+{
+  return gr_scheduler_sptr(new gr_scheduler_sts(ffg, true));
+}
+
+gr_scheduler_sts::gr_scheduler_sts(gr_flat_flowgraph_sptr ffg, bool data_driven)
   : gr_scheduler(ffg)
 {
   // Split the flattened flow graph into discrete partitions, each
@@ -64,7 +71,7 @@ gr_scheduler_sts::gr_scheduler_sts(gr_flat_flowgraph_sptr ffg)
 
     gr_block_vector_t blocks = gr_flat_flowgraph::make_block_vector(*p);
     d_threads.create_thread(
-        gruel::thread_body_wrapper<sts_container>(sts_container(blocks),
+        gruel::thread_body_wrapper<sts_container>(sts_container(blocks, data_driven),
 						  "single-threaded-scheduler"));
   }
 }
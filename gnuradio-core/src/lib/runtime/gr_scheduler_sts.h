@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -38,11 +38,17 @@ protected:
    * The scheduler will continue running until all blocks until they
    * report that they are done or the stop method is called.
    */
-  gr_scheduler_sts(gr_flat_flowgraph_sptr ffg);
+  gr_scheduler_sts(gr_flat_flowgraph_sptr ffg, bool data_driven = false);
 
 public:
   static gr_scheduler_sptr make(gr_flat_flowgraph_sptr ffg);
 
+  /*!
+   * \brief As make, but each partition only runs the blocks whose
+   * buffers have changed.  See gr_single_threaded_scheduler.
+   */
+  static gr_scheduler_sptr make_data_driven(gr_flat_flowgraph_sptr ffg);
+
   ~gr_scheduler_sts();
 
   /*!
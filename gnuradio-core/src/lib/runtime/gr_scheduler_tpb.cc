@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,6 +26,21 @@
 #include <gr_tpb_thread_body.h>
 #include <gruel/thread_body_wrapper.h>
 #include <sstream>
+#include <algorithm>
+#include <cassert>
+
+/*
+ * Tells the scheduler when a block's thread body is done, however it
+ * got there (done, interrupted or an exception).
+ */
+class tpb_exit_notifier
+{
+  gr_scheduler_tpb *d_sched;
+
+public:
+  tpb_exit_notifier(gr_scheduler_tpb *sched) : d_sched(sched) {}
+  ~tpb_exit_notifier() { d_sched->thread_exited(); }
+};
 
 /*
  * You know, a lambda expression would be sooo much easier...
@@ -33,12 +48,15 @@
 class tpb_container
 {
   gr_block_sptr	d_block;
+  gr_scheduler_tpb *d_sched;
   
 public:
-  tpb_container(gr_block_sptr block) : d_block(block) {}
+  tpb_container(gr_block_sptr block, gr_scheduler_tpb *sched)
+    : d_block(block), d_sched(sched) {}
 
   void operator()()
   {
+    tpb_exit_notifier	notifier(d_sched);
     gr_tpb_thread_body	body(d_block);
   }
 };
@@ -51,7 +69,8 @@ gr_scheduler_tpb::make(gr_flat_flowgraph_sptr ffg)
 }
 
 gr_scheduler_tpb::gr_scheduler_tpb(gr_flat_flowgraph_sptr ffg)
-  : gr_scheduler(ffg)
+  : gr_scheduler(ffg), d_ffg(ffg), d_nrunning(0), d_reconfiguring(false),
+    d_thread_counter(0)
 {
   // Get a topologically sorted vector of all the blocks in use.
   // Being topologically sorted probably isn't going to matter, but
@@ -61,6 +80,22 @@ gr_scheduler_tpb::gr_scheduler_tpb(gr_flat_flowgraph_sptr ffg)
   used_blocks = ffg->topological_sort(used_blocks);
   gr_block_vector_t blocks = gr_flat_flowgraph::make_block_vector(used_blocks);
 
+  gruel::scoped_lock guard(d_mutex);
+  start_threads(blocks);
+}
+
+gr_scheduler_tpb::~gr_scheduler_tpb()
+{
+  stop();
+  wait();	// the threads call back into us on exit
+}
+
+/*
+ * Called with d_mutex held
+ */
+void
+gr_scheduler_tpb::start_threads(gr_block_vector_t &blocks)
+{
   // Ensure that the done flag is clear on all blocks
 
   for (size_t i = 0; i < blocks.size(); i++){
@@ -70,26 +105,113 @@ gr_scheduler_tpb::gr_scheduler_tpb(gr_flat_flowgraph_sptr ffg)
   // Fire off a thead for each block
 
   for (size_t i = 0; i < blocks.size(); i++){
+    assert(d_threads.find(blocks[i]) == d_threads.end());
+
     std::stringstream name;
-    name << "thread-per-block[" << i << "]: " << blocks[i];
-    d_threads.create_thread(
-      gruel::thread_body_wrapper<tpb_container>(tpb_container(blocks[i]), name.str()));
+    name << "thread-per-block[" << d_thread_counter++ << "]: " << blocks[i];
+    d_nrunning++;
+    d_threads[blocks[i]] = new boost::thread(
+      gruel::thread_body_wrapper<tpb_container>(tpb_container(blocks[i], this), name.str()));
   }
 }
 
-gr_scheduler_tpb::~gr_scheduler_tpb()
+/*
+ * Interrupt the threads running any of blocks and wait for them to exit
+ */
+void
+gr_scheduler_tpb::stop_threads(gr_basic_block_vector_t &blocks)
 {
-  stop();
+  std::vector<boost::thread *> threads;
+  {
+    gruel::scoped_lock guard(d_mutex);
+    for (gr_basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++){
+      thread_map_t::iterator t = d_threads.find(cast_to_block_sptr(*p));
+      if (t != d_threads.end()){
+	t->second->interrupt();
+	threads.push_back(t->second);
+	d_threads.erase(t);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < threads.size(); i++){
+    threads[i]->join();
+    delete threads[i];
+  }
+}
+
+void
+gr_scheduler_tpb::thread_exited()
+{
+  gruel::scoped_lock guard(d_mutex);
+  d_nrunning--;
+  d_cond.notify_all();
 }
 
 void
 gr_scheduler_tpb::stop()
 {
-  d_threads.interrupt_all();
+  gruel::scoped_lock guard(d_mutex);
+  for (thread_map_t::iterator t = d_threads.begin(); t != d_threads.end(); t++)
+    t->second->interrupt();
 }
 
 void
 gr_scheduler_tpb::wait()
 {
-  d_threads.join_all();
+  gruel::scoped_lock guard(d_mutex);
+  while (d_nrunning > 0 || d_reconfiguring)
+    d_cond.wait(guard);
+
+  // Every thread body has returned, reap the threads
+  thread_map_t threads;
+  threads.swap(d_threads);
+  guard.unlock();
+
+  for (thread_map_t::iterator t = threads.begin(); t != threads.end(); t++){
+    t->second->join();
+    delete t->second;
+  }
+}
+
+bool
+gr_scheduler_tpb::reconfigure(gr_flat_flowgraph_sptr new_ffg)
+{
+  {
+    gruel::scoped_lock guard(d_mutex);
+    if (d_nrunning == 0)	// all done or stopped; let the caller start over
+      return false;
+    d_reconfiguring = true;	// keep wait() from returning part way through
+  }
+
+  gr_basic_block_vector_t changed;
+  gr_block_vector_t blocks;
+  try {
+    changed = new_ffg->calc_changed_blocks(d_ffg);
+
+    // Stop the changed partitions, the rest keep running
+    stop_threads(changed);
+
+    // Reuse the buffers and readers of all the unchanged connections
+    new_ffg->merge_connections(d_ffg);
+    d_ffg = new_ffg;
+
+    // Restart the changed blocks that are still in use
+    gr_basic_block_vector_t used = d_ffg->calc_used_blocks();
+    for (gr_basic_block_viter_t p = changed.begin(); p != changed.end(); p++)
+      if (std::binary_search(used.begin(), used.end(), *p))
+	blocks.push_back(cast_to_block_sptr(*p));
+  }
+  catch (...) {
+    gruel::scoped_lock guard(d_mutex);
+    d_reconfiguring = false;
+    d_cond.notify_all();
+    throw;
+  }
+
+  gruel::scoped_lock guard(d_mutex);
+  start_threads(blocks);
+  d_reconfiguring = false;
+  d_cond.notify_all();
+  return true;
 }
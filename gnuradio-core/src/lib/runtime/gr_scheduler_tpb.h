@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -22,14 +22,30 @@
 #define INCLUDED_GR_SCHEDULER_TPB_H
 
 #include <gr_scheduler.h>
-#include <gruel/thread_group.h>
+#include <gruel/thread.h>
+#include <map>
 
 /*!
  * \brief Concrete scheduler that uses a kernel thread-per-block
+ *
+ * reconfigure() only stops and restarts the threads of the partitions
+ * that changed; the others keep running with their buffers intact.
  */
 class gr_scheduler_tpb : public gr_scheduler
 {
-  gruel::thread_group		       d_threads;
+  typedef std::map<gr_block_sptr, boost::thread *> thread_map_t;
+
+  gr_flat_flowgraph_sptr		d_ffg;
+
+  gruel::mutex				d_mutex;	// protects everything below
+  gruel::condition_variable		d_cond;		// a thread exited, or reconfigure done
+  thread_map_t				d_threads;	// thread running each block
+  int					d_nrunning;	// threads still in their body
+  bool					d_reconfiguring;
+  int					d_thread_counter; // for thread names
+
+  void start_threads(gr_block_vector_t &blocks);
+  void stop_threads(gr_basic_block_vector_t &blocks);
 
 protected:
   /*!
@@ -54,6 +70,13 @@ public:
    * \brief Block until the graph is done.
    */
   void wait();
+
+  /*!
+   * \brief Switch to \p new_ffg, restarting only the changed partitions.
+   */
+  bool reconfigure(gr_flat_flowgraph_sptr new_ffg);
+
+  void thread_exited();		// really private
 };
 
 
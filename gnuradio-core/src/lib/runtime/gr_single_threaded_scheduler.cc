@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,9 +28,12 @@
 #include <gr_block.h>
 #include <gr_block_detail.h>
 #include <gr_buffer.h>
+#include <gr_block_executor.h>
 #include <boost/thread.hpp>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <algorithm>
 #include <assert.h>
 #include <stdio.h>
 
@@ -46,15 +49,17 @@
 static int which_scheduler  = 0;
 
 gr_single_threaded_scheduler_sptr
-gr_make_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks)
+gr_make_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks,
+				   bool data_driven)
 {
   return
-    gr_single_threaded_scheduler_sptr (new gr_single_threaded_scheduler (blocks));
+    gr_single_threaded_scheduler_sptr (new gr_single_threaded_scheduler (blocks,
+									 data_driven));
 }
 
 gr_single_threaded_scheduler::gr_single_threaded_scheduler (
-    const std::vector<gr_block_sptr> &blocks)
-  : d_blocks (blocks), d_enabled (true), d_log(0)
+    const std::vector<gr_block_sptr> &blocks, bool data_driven)
+  : d_blocks (blocks), d_enabled (true), d_data_driven (data_driven), d_log(0)
 {
   if (ENABLE_LOGGING){
     char name[100];
@@ -76,7 +81,10 @@ void
 gr_single_threaded_scheduler::run ()
 {
   // d_enabled = true;		// KLUDGE
-  main_loop ();
+  if (d_data_driven)
+    data_driven_loop ();
+  else
+    main_loop ();
 }
 
 void
@@ -362,3 +370,207 @@ gr_single_threaded_scheduler::main_loop ()
   for (unsigned i = 0; i < d_blocks.size (); i++)	// disable any drivers, etc.
     d_blocks[i]->stop();
 }
+
+// ----------------------------------------------------------------------------
+
+/*
+ * The blocks that have something to look at, in the order they got
+ * it.  Sources wait in a queue of their own and are only run when
+ * nothing else is ready, as in main_loop.  A block is never queued
+ * twice, so neither queue needs more room than there are blocks.
+ */
+class sts_ready_list
+{
+  std::vector<int>	d_queue[2];	// [0] for sources, [1] for the rest
+  unsigned int		d_head[2];
+  unsigned int		d_count[2];
+  std::vector<bool>	d_queued;
+  std::vector<bool>	d_source;
+
+public:
+  sts_ready_list (const std::vector<gr_block_detail *> &details)
+    : d_queued (details.size ()), d_source (details.size ())
+  {
+    for (int q = 0; q < 2; q++){
+      d_queue[q].resize (details.size ());
+      d_head[q] = d_count[q] = 0;
+    }
+    for (unsigned int i = 0; i < details.size (); i++)
+      d_source[i] = details[i]->source_p ();
+  }
+
+  void push (int bi)
+  {
+    if (d_queued[bi])
+      return;
+
+    d_queued[bi] = true;
+    int q = d_source[bi] ? 0 : 1;
+    unsigned int tail = d_head[q] + d_count[q]++;
+    if (tail >= d_queue[q].size ())
+      tail -= d_queue[q].size ();
+    d_queue[q][tail] = bi;
+  }
+
+  // returns -1 if nothing is ready
+  int pop ()
+  {
+    int q = d_count[1] ? 1 : 0;
+    if (d_count[q] == 0)
+      return -1;
+
+    int bi = d_queue[q][d_head[q]];
+    if (++d_head[q] == d_queue[q].size ())
+      d_head[q] = 0;
+    d_count[q]--;
+    d_queued[bi] = false;
+    return bi;
+  }
+};
+
+/*
+ * Would the block find itself blocked if we ran it now?  That's so if
+ * its inputs are all empty or one of its outputs is full, unless the
+ * buffer is done, when it has to run to find out it's done too.
+ */
+static gr_block_executor::state
+sts_blocked (gr_block_detail *d)
+{
+  if (d->ninputs () > 0){
+    int i;
+    for (i = 0; i < d->ninputs (); i++){
+      gr_buffer_reader_sptr in = d->input(i);
+      if (in->items_available () > 0 || in->done ())
+	break;
+    }
+    if (i == d->ninputs ())
+      return gr_block_executor::BLKD_IN;
+  }
+
+  for (int i = 0; i < d->noutputs (); i++){
+    gr_buffer_sptr out = d->output(i);
+    if (out->space_available () == 0 && !out->done ())
+      return gr_block_executor::BLKD_OUT;
+  }
+
+  return gr_block_executor::READY;
+}
+
+void
+gr_single_threaded_scheduler::data_driven_loop ()
+{
+  typedef boost::shared_ptr<gr_block_executor> executor_sptr;
+
+  unsigned int				nblocks = d_blocks.size ();
+  std::vector<gr_block_detail *>	details (nblocks);
+  std::vector<std::vector<int> >	upstream (nblocks);
+  std::vector<std::vector<int> >	downstream (nblocks);
+  std::vector<gr_block_executor::state>	last_state (nblocks, gr_block_executor::READY);
+  std::vector<executor_sptr>		executors (nblocks);
+  std::map<gr_block *, int>		index;
+  unsigned int				nalive;
+
+  for (unsigned i = 0; i < nblocks; i++){
+    details[i] = d_blocks[i]->detail().get ();
+    details[i]->set_done (false);			// reset any done flags
+    index[d_blocks[i].get ()] = i;
+  }
+
+  // Find each block's neighbours, the blocks on the other end of its
+  // buffers, once up front.  Nothing outside this thread uses those
+  // buffers, so they can do without their mutexes while we run.
+  for (unsigned i = 0; i < nblocks; i++){
+    for (int j = 0; j < details[i]->noutputs (); j++){
+      gr_buffer_sptr out = details[i]->output(j);
+      out->set_locking (false);
+
+      for (size_t k = 0; k < out->nreaders (); k++){
+	std::map<gr_block *, int>::iterator r = index.find (out->reader(k)->link().get ());
+	if (r == index.end ())
+	  continue;
+	downstream[i].push_back (r->second);
+	upstream[r->second].push_back (i);
+      }
+    }
+  }
+
+  for (unsigned i = 0; i < nblocks; i++){
+    std::sort (upstream[i].begin (), upstream[i].end ());
+    upstream[i].erase (std::unique (upstream[i].begin (), upstream[i].end ()),
+		       upstream[i].end ());
+    std::sort (downstream[i].begin (), downstream[i].end ());
+    downstream[i].erase (std::unique (downstream[i].begin (), downstream[i].end ()),
+			 downstream[i].end ());
+  }
+
+  for (unsigned i = 0; i < nblocks; i++)	// enable any drivers, etc.
+    executors[i] = executor_sptr (new gr_block_executor (d_blocks[i]));
+
+  // Everybody gets a first look, in topological order
+  sts_ready_list ready (details);
+  for (unsigned i = 0; i < nblocks; i++)
+    ready.push (i);
+
+  nalive = nblocks;
+  while (d_enabled && nalive > 0){
+
+    if (boost::this_thread::interruption_requested())
+      break;
+
+    int bi = ready.pop ();
+    if (bi < 0){
+      // Nothing has changed since each block last looked, yet some
+      // aren't done.  They're waiting on something outside the graph
+      // (hardware, a message queue); poll them all, as main_loop would.
+      for (unsigned i = 0; i < nblocks; i++)
+	if (!details[i]->done ())
+	  ready.push (i);
+      continue;
+    }
+
+    gr_block_executor::state state = executors[bi]->run_one_iteration ();
+    last_state[bi] = state;
+
+    switch (state){
+    case gr_block_executor::BLKD_IN:		// wait for a neighbour to move
+    case gr_block_executor::BLKD_OUT:
+      break;
+
+    case gr_block_executor::READY:
+    case gr_block_executor::READY_NO_OUTPUT:
+      // If there may be more to do, look again.  If not, count it
+      // as blocked until a neighbour wakes it.
+      last_state[bi] = sts_blocked (details[bi]);
+      if (last_state[bi] == gr_block_executor::READY)
+	ready.push (bi);
+
+      // Wake the neighbours this can unblock: downstream blocks waiting
+      // for input if we produced, upstream ones waiting for space since
+      // we may have consumed.
+      if (state == gr_block_executor::READY)
+	for (size_t j = 0; j < downstream[bi].size (); j++)
+	  if (last_state[downstream[bi][j]] == gr_block_executor::BLKD_IN)
+	    ready.push (downstream[bi][j]);
+      for (size_t j = 0; j < upstream[bi].size (); j++)
+	if (last_state[upstream[bi][j]] == gr_block_executor::BLKD_OUT)
+	  ready.push (upstream[bi][j]);
+      break;
+
+    case gr_block_executor::DONE:		// all of them need to notice
+      nalive--;
+      for (size_t j = 0; j < downstream[bi].size (); j++)
+	if (!details[downstream[bi][j]]->done ())
+	  ready.push (downstream[bi][j]);
+      for (size_t j = 0; j < upstream[bi].size (); j++)
+	if (!details[upstream[bi][j]]->done ())
+	  ready.push (upstream[bi][j]);
+      break;
+    }
+  }
+
+  executors.clear ();				// disable any drivers, etc.
+
+  for (unsigned i = 0; i < nblocks; i++)
+    for (int j = 0; j < details[i]->noutputs (); j++)
+      details[i]->output(j)->set_locking (true);
+}
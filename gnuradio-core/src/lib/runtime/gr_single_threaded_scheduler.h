@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -33,6 +33,12 @@ typedef boost::shared_ptr<gr_single_threaded_scheduler>	gr_single_threaded_sched
 /*!
  * \brief Simple scheduler for stream computations.
  * \ingroup internal
+ *
+ * By default every block is visited in turn, whether or not anything
+ * has changed for it.  If \p data_driven is true, a block is only
+ * visited after one of its neighbours has produced into or consumed
+ * from a buffer it shares with it.  Since all the blocks run in this
+ * thread, their buffers are then used without taking their mutexes.
  */
 
 class gr_single_threaded_scheduler {
@@ -45,17 +51,22 @@ class gr_single_threaded_scheduler {
  private:
   const std::vector<gr_block_sptr>	d_blocks;
   volatile bool				d_enabled;
+  bool					d_data_driven;
   std::ofstream			       *d_log;
 
-  gr_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks);
+  gr_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks,
+				bool data_driven);
 
   void main_loop ();
+  void data_driven_loop ();
   
   friend gr_single_threaded_scheduler_sptr
-  gr_make_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks);
+  gr_make_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks,
+				     bool data_driven);
 };
 
 gr_single_threaded_scheduler_sptr
-gr_make_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks);
+gr_make_single_threaded_scheduler (const std::vector<gr_block_sptr> &blocks,
+				   bool data_driven = false);
 
 #endif /* INCLUDED_GR_SINGLE_THREADED_SCHEDULER_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -46,7 +46,8 @@ static struct scheduler_table {
   scheduler_maker	f;
 } scheduler_table[] = {
   { "TPB",	gr_scheduler_tpb::make },	// first entry is default
-  { "STS",	gr_scheduler_sts::make }
+  { "STS",	gr_scheduler_sts::make },
+  { "STS_DD",	gr_scheduler_sts::make_data_driven }	// data-driven STS
 };
 
 static gr_scheduler_sptr
@@ -158,12 +159,20 @@ gr_top_block_impl::unlock()
 void
 gr_top_block_impl::restart()
 {
-  stop();		     // Stop scheduler and wait for completion
-  wait();
-
   // Create new simple flow graph
   gr_flat_flowgraph_sptr new_ffg = d_owner->flatten();        
   new_ffg->validate();		       // check consistency, sanity, etc
+
+  // Let the scheduler swap it in, stopping only the partitions that
+  // changed, if it can
+  if (d_scheduler && d_scheduler->reconfigure(new_ffg)){
+    d_ffg = new_ffg;
+    return;
+  }
+
+  stop();		     // Stop scheduler and wait for completion
+  wait();
+
   new_ffg->merge_connections(d_ffg);   // reuse buffers, etc
   d_ffg = new_ffg;
 
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,6 +29,8 @@
 #include <gr_io_signature.h>
 #include <gr_null_source.h>
 #include <gr_null_sink.h>
+#include <gr_head.h>
+#include <gr_flat_flowgraph.h>
 
 void qa_gr_hier_block2::test_make()
 {
@@ -54,4 +56,46 @@ void qa_gr_hier_block2::test_make()
 
 }
 
+// Flattening again reuses the edges of unchanged hierarchical blocks,
+// but must see a change made inside one
+void qa_gr_hier_block2::test_flatten_cache()
+{
+    gr_hier_block2_sptr top(gr_make_hier_block2("top",
+						gr_make_io_signature(0, 0, 0),
+						gr_make_io_signature(0, 0, 0)));
+    gr_hier_block2_sptr inner(gr_make_hier_block2("inner",
+						  gr_make_io_signature(1, 1, sizeof(int)),
+						  gr_make_io_signature(1, 1, sizeof(int))));
+    gr_block_sptr src(gr_make_null_source(sizeof(int)));
+    gr_block_sptr head1(gr_make_head(sizeof(int), 1000));
+    gr_block_sptr head2(gr_make_head(sizeof(int), 1000));
+    gr_block_sptr dst(gr_make_null_sink(sizeof(int)));
+
+    inner->connect(inner, 0, head1, 0);
+    inner->connect(head1, 0, inner, 0);
+    top->connect(src, 0, inner, 0);
+    top->connect(inner, 0, dst, 0);
+
+    gr_flat_flowgraph_sptr ffg = top->flatten();
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, ffg->edges().size());
+    CPPUNIT_ASSERT(ffg->edges()[0].dst().block() == head1);
 
+    ffg = top->flatten();
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, ffg->edges().size());
+    CPPUNIT_ASSERT(ffg->edges()[0].dst().block() == head1);
+    CPPUNIT_ASSERT(ffg->edges()[1].src().block() == head1);
+
+    // Replace head1 with head2, touching only inner
+    inner->disconnect(inner, 0, head1, 0);
+    inner->disconnect(head1, 0, inner, 0);
+    inner->connect(inner, 0, head2, 0);
+    inner->connect(head2, 0, inner, 0);
+
+    ffg = top->flatten();
+    ffg->validate();
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, ffg->edges().size());
+    CPPUNIT_ASSERT(ffg->edges()[0].src().block() == src);
+    CPPUNIT_ASSERT(ffg->edges()[0].dst().block() == head2);
+    CPPUNIT_ASSERT(ffg->edges()[1].src().block() == head2);
+    CPPUNIT_ASSERT(ffg->edges()[1].dst().block() == dst);
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -32,11 +32,13 @@ class qa_gr_hier_block2 : public CppUnit::TestCase
     CPPUNIT_TEST_SUITE(qa_gr_hier_block2);
 
     CPPUNIT_TEST(test_make);
+    CPPUNIT_TEST(test_flatten_cache);
         
     CPPUNIT_TEST_SUITE_END();
 
 private:
     void test_make();
+    void test_flatten_cache();
 };
 
 #endif /* INCLUDED_QA_GR_HIER_BLOCK2_H */
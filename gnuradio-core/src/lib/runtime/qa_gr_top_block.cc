@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007 Free Software Foundation, Inc.
+ * Copyright 2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,13 +26,75 @@
 
 #include <qa_gr_top_block.h>
 #include <gr_top_block.h>
+#include <gr_flat_flowgraph.h>
+#include <gr_scheduler_sts.h>
 #include <gr_head.h>
 #include <gr_null_source.h>
 #include <gr_null_sink.h>
+#include <gr_vector_source_i.h>
+#include <gr_vector_sink_i.h>
+#include <gr_keep_one_in_n.h>
+#include <gr_repeat.h>
+#include <gr_sync_block.h>
+#include <gr_io_signature.h>
+#include <gruel/thread.h>
+#include <boost/thread/thread_time.hpp>
 #include <iostream>
+#include <string.h>
+#include <stdlib.h>
 
 #define VERBOSE 0
 
+/*
+ * Stands in for a hardware source that keeps producing at a fixed rate
+ * whether or not anyone is reading it.  Samples that arrive between a
+ * stop() and the following start() are counted as dropped.
+ */
+class qa_device_source : public gr_sync_block
+{
+  double		d_rate;
+  int			d_start_count;
+  bool			d_stopped;
+  boost::system_time	d_stop_time;
+  long			d_dropped;
+
+public:
+  qa_device_source(double rate)
+    : gr_sync_block("qa_device_source",
+		    gr_make_io_signature(0, 0, 0),
+		    gr_make_io_signature(1, 1, sizeof(int))),
+      d_rate(rate), d_start_count(0), d_stopped(false), d_dropped(0) {}
+
+  bool start()
+  {
+    if (d_stopped){
+      boost::posix_time::time_duration gap = boost::get_system_time() - d_stop_time;
+      d_dropped += (long) (gap.total_microseconds() * 1e-6 * d_rate);
+      d_stopped = false;
+    }
+    d_start_count++;
+    return true;
+  }
+
+  bool stop()
+  {
+    d_stopped = true;
+    d_stop_time = boost::get_system_time();
+    return true;
+  }
+
+  int work(int noutput_items,
+	   gr_vector_const_void_star &input_items,
+	   gr_vector_void_star &output_items)
+  {
+    memset(output_items[0], 0, noutput_items * sizeof(int));
+    return noutput_items;
+  }
+
+  int start_count() const { return d_start_count; }
+  long dropped() const { return d_dropped; }
+};
+
 void qa_gr_top_block::t0()
 {
   if (VERBOSE) std::cout << "qa_gr_top_block::t0()\n";
@@ -119,3 +181,89 @@ void qa_gr_top_block::t4_reconfigure()
   // Wait for flowgraph to end on its own
   tb->wait();
 }
+
+void qa_gr_top_block::t5_reconfigure_partition()
+{
+  if (VERBOSE) std::cout << "qa_gr_top_block::t5()\n";
+
+  // Only the thread-per-block scheduler reconfigures incrementally
+  char *v = getenv("GR_SCHEDULER");
+  if (v && strcmp(v, "TPB") != 0)
+    return;
+
+  gr_top_block_sptr tb = gr_make_top_block("top");
+
+  boost::shared_ptr<qa_device_source> dev = 
+    boost::shared_ptr<qa_device_source>(new qa_device_source(1e9));
+  gr_block_sptr dev_dst = gr_make_null_sink(sizeof(int));
+  gr_block_sptr src = gr_make_null_source(sizeof(int));
+  gr_block_sptr head = gr_make_head(sizeof(int), 100000);
+  gr_block_sptr dst = gr_make_null_sink(sizeof(int));
+
+  // Two unconnected partitions, both infinite
+  tb->connect(dev, 0, dev_dst, 0);
+  tb->connect(src, 0, dst, 0);
+  tb->start();
+
+  // Let the device get going
+  while (dev->start_count() == 0)
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+  // Reconfigure the second one with gr_head in the middle
+  tb->lock();
+  tb->disconnect(src, 0, dst, 0);
+  tb->connect(src, 0, head, 0);
+  tb->connect(head, 0, dst, 0);
+  tb->unlock();
+
+  // Give a restarted device time to call start() again
+  boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+
+  // The device partition must have kept running throughout
+  CPPUNIT_ASSERT_EQUAL(1, dev->start_count());
+  CPPUNIT_ASSERT_EQUAL(0L, dev->dropped());
+
+  tb->stop();
+  tb->wait();
+}
+
+void qa_gr_top_block::t6_sts_data_driven()
+{
+  if (VERBOSE) std::cout << "qa_gr_top_block::t6()\n";
+
+  std::vector<int> data(100000);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = i;
+
+  gr_top_block_sptr tb = gr_make_top_block("top");
+
+  gr_block_sptr src = gr_make_vector_source_i(data);
+  gr_block_sptr keep = gr_make_keep_one_in_n(sizeof(int), 3);
+  gr_block_sptr repeat = gr_make_repeat(sizeof(int), 2);
+  gr_vector_sink_i_sptr dst0 = gr_make_vector_sink_i();
+  gr_vector_sink_i_sptr dst1 = gr_make_vector_sink_i();
+  gr_block_sptr head = gr_make_head(sizeof(int), 100000);
+
+  // A fan out, a decimator and an interpolator, and a second partition
+  tb->connect(src, 0, keep, 0);
+  tb->connect(keep, 0, repeat, 0);
+  tb->connect(repeat, 0, dst0, 0);
+  tb->connect(src, 0, dst1, 0);
+  tb->connect(gr_make_null_source(sizeof(int)), 0, head, 0);
+  tb->connect(head, 0, gr_make_null_sink(sizeof(int)), 0);
+
+  // Run it with the data-driven STS, whatever GR_SCHEDULER says
+  gr_flat_flowgraph_sptr ffg = tb->flatten();
+  ffg->validate();
+  ffg->setup_connections();
+  gr_scheduler_sts::make_data_driven(ffg)->wait();
+
+  std::vector<int> expected;
+  for (size_t i = 2; i < data.size(); i += 3){
+    expected.push_back(data[i]);
+    expected.push_back(data[i]);
+  }
+
+  CPPUNIT_ASSERT(dst0->data() == expected);
+  CPPUNIT_ASSERT(dst1->data() == data);
+}
@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 #
-# Copyright 2004,2007 Free Software Foundation, Inc.
+# Copyright 2004,2007,2010 Free Software Foundation, Inc.
 # 
 # This file is part of GNU Radio
 # 
@@ -411,6 +411,39 @@ class test_sig_source (gr_unittest.TestCase):
         self.assertComplexTuplesAlmostEqual (expected_result, dst_data, 4)
 
 
+    def test_006(self):
+        ''' Test the multichannel squelch and AGC against pwr_squelch_cc and agc2_cc on each channel '''
+        tb = self.tb
+        nchans = 6
+        n = 2000
+        levels = (1.0, 0.01, 3.0, 0.3, 0.001, 10.0)
+
+        s2v = gr.streams_to_vector (gr.sizeof_gr_complex, nchans)
+        agc = gr.agc_squelch_vcc (nchans, -20, 0.01, 1e-1, 1e-2, 1.0, 1.0, 100.0)
+        v2s = gr.vector_to_streams (gr.sizeof_gr_complex, nchans)
+        tb.connect (s2v, agc, v2s)
+
+        dst = []
+        expected = []
+        for i in range(nchans):
+            src = gr.sig_source_c (1, gr.GR_SIN_WAVE, 0.01 * (i + 1), levels[i])
+            head = gr.head (gr.sizeof_gr_complex, n)
+            squelch = gr.pwr_squelch_cc (-20, 0.01)
+            agc2 = gr.agc2_cc (1e-1, 1e-2, 1.0, 1.0, 100.0)
+            dst.append (gr.vector_sink_c ())
+            expected.append (gr.vector_sink_c ())
+            tb.connect (src, head, squelch, agc2, expected[i])
+            tb.connect (head, (s2v, i))
+            tb.connect ((v2s, i), dst[i])
+
+        tb.run ()
+        for i in range(nchans):
+            self.assertEqual (n, len (dst[i].data ()))
+            self.assertComplexTuplesAlmostEqual (expected[i].data (), dst[i].data (), 4)
+        self.assertFalse (agc.unmuted (1))
+        self.assertTrue (agc.unmuted (2))
+
+
     def test_100(self):        # FIXME needs work
         ''' Test complex feedforward agc with constant input '''
         input_data = 16*(0.0,) + 64*(1.0,) + 64*(0.0,)
@@ -428,6 +461,31 @@ class test_sig_source (gr_unittest.TestCase):
         dst_data = dst.data ()
         #self.assertComplexTuplesAlmostEqual (expected_result, dst_data, 4)
 
+    def test_101(self):
+        ''' Test complex feedforward agc against the largest envelope in each window '''
+        nsamples = 16
+        reference = 2.0
+        input_data = [complex(math.sin(0.3*i) * (1 + (i // 50) % 3), math.cos(0.7*i))
+                      for i in range(300)]
+
+        def envelope(x):
+            r, i = abs(x.real), abs(x.imag)
+            return max(r, i) + 0.4 * min(r, i)
+
+        # the block's history starts out as zeros
+        padded = (nsamples - 1) * [0j] + input_data
+        expected_result = []
+        for i in range(len(input_data)):
+            max_env = max([1e-4] + [envelope(x) for x in padded[i:i+nsamples]])
+            expected_result.append(reference / max_env * padded[i])
+
+        src = gr.vector_source_c(input_data)
+        agc = gr.feedforward_agc_cc(nsamples, reference)
+        dst = gr.vector_sink_c ()
+        self.tb.connect (src, agc, dst)
+        self.tb.run ()
+        self.assertComplexTuplesAlmostEqual (expected_result, dst.data (), 5)
+
 
 if __name__ == '__main__':
     gr_unittest.main ()
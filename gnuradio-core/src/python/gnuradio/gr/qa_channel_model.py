@@ -0,0 +1,69 @@
+#!/usr/bin/env python
+#
+# Copyright 2010 Free Software Foundation, Inc.
+# 
+# This file is part of GNU Radio
+# 
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr, gr_unittest
+import math
+
+class test_channel_model(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_channel(self, chan, src_data):
+        src = gr.vector_source_c(src_data)
+        dst = gr.vector_sink_c()
+        self.tb.connect(src, chan, dst)
+        self.tb.run()
+        return dst.data()
+
+    def test_001_passthrough(self):
+        # with no impairments the output is the input, delayed by the
+        # timing interpolator
+        src_data = [complex(i, -i) for i in range(100)]
+        result = self.run_channel(gr.channel_model_cc(), src_data)
+        self.assertComplexTuplesAlmostEqual(src_data[3:3+len(result)], result, 5)
+
+    def test_002_frequency_offset(self):
+        src_data = 1000 * [1+0j]
+        result = self.run_channel(gr.channel_model_cc(0.0, 0.01), src_data)
+        expected = [complex(math.cos(2*math.pi*0.01*i), math.sin(2*math.pi*0.01*i))
+                    for i in range(len(result))]
+        self.assertComplexTuplesAlmostEqual(expected, result, 4)
+
+    def test_003_noise(self):
+        src_data = 20000 * [0j]
+        result = self.run_channel(gr.channel_model_cc(0.5, 0.0, 1.0, [1+0j], 42), src_data)
+        power = sum([abs(x)**2 for x in result]) / len(result)
+        self.assertAlmostEqual(0.5, power, 1)
+
+    def test_004_reproducible(self):
+        src_data = 20000 * [0j]
+        r1 = self.run_channel(gr.channel_model_cc(0.5, 0.0, 1.0, [1+0j], 42), src_data)
+        self.tb = gr.top_block()
+        r2 = self.run_channel(gr.channel_model(0.5, 0.0, 1.0, [1+0j], 42), src_data)
+        self.assertEqual(r1, r2)
+
+if __name__ == '__main__':
+    gr_unittest.main()
@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 #
-# Copyright 2006,2007 Free Software Foundation, Inc.
+# Copyright 2006,2007,2010 Free Software Foundation, Inc.
 # 
 # This file is part of GNU Radio
 # 
@@ -38,6 +38,17 @@ def string_to_1_0_list(s):
 def to_1_0_string(L):
     return ''.join(map(lambda x: chr(x + ord('0')), L))
 
+def pack_1_0_list(L):
+    # MSB first, zero padded to a whole number of bytes
+    L = list(L) + [0] * (-len(L) % 8)
+    r = []
+    for i in range(0, len(L), 8):
+        x = 0
+        for b in L[i:i+8]:
+            x = (x << 1) | b
+        r.append(x)
+    return tuple(r)
+
 class test_correlate_access_code(gr_unittest.TestCase):
 
     def setUp(self):
@@ -76,7 +87,48 @@ class test_correlate_access_code(gr_unittest.TestCase):
         result_data = dst.data ()
         self.assertEqual (expected_result, result_data)
         
-        
+    def test_003(self):
+        # 1011 ends on bit 3 of the first byte and bit 7 of the third
+        src_data = (0xB0, 0x00, 0x0B, 0x00)
+        expected_flags = (0x08, 0x00, 0x00, 0x80)
+        src = gr.vector_source_b (src_data)
+        op = gr.correlate_access_code_packed_bb("1011", 0)
+        dst0 = gr.vector_sink_b ()
+        dst1 = gr.vector_sink_b ()
+        self.tb.connect (src, op)
+        self.tb.connect ((op, 0), dst0)
+        self.tb.connect ((op, 1), dst1)
+        self.tb.run ()
+        self.assertEqual (src_data, dst0.data ())
+        self.assertEqual (expected_flags, dst1.data ())
+
+    def test_004(self):
+        # the same packet, unpacked through correlate_access_code_bb and
+        # framer_sink_1, and packed through framer_sink_packed
+        code = string_to_1_0_list(default_access_code)
+        access_code = to_1_0_string(code)
+        header = [((0x20032003 >> i) & 1) for i in range(31, -1, -1)]
+        payload = []
+        for ch in 'abc':
+            payload += [((ord(ch) >> i) & 1) for i in range(7, -1, -1)]
+        bits = [0, 1, 1] + code + header + payload
+
+        q1 = gr.msg_queue()
+        src = gr.vector_source_b (tuple(bits) + (0,) * 64)
+        op = gr.correlate_access_code_bb(access_code, 0)
+        self.tb.connect (src, op, gr.framer_sink_1(q1))
+
+        q2 = gr.msg_queue()
+        src = gr.vector_source_b (pack_1_0_list(bits + [0] * 64))
+        self.tb.connect (src, gr.framer_sink_packed(access_code, 0, q2))
+        self.tb.run ()
+
+        for q in (q1, q2):
+            self.assertEqual (1, q.count())
+            msg = q.delete_head()
+            self.assertEqual ('abc', msg.to_string())
+            self.assertEqual (2, msg.arg1())
+
 
 if __name__ == '__main__':
     gr_unittest.main ()
@@ -152,6 +152,56 @@ class test_fft_filter(gr_unittest.TestCase):
         #self.assertComplexTuplesAlmostEqual (expected_result, result_data, 5)
         self.assert_fft_ok2(expected_result, result_data)
 
+    def run_fft(self, src_data, fft_size, forward, window, shift):
+        tb = gr.top_block()
+        src = gr.vector_source_c(src_data)
+        s2v = gr.stream_to_vector(gr.sizeof_gr_complex, fft_size)
+        fft = gr.fft_vcc(fft_size, forward, window, shift)
+        v2s = gr.vector_to_stream(gr.sizeof_gr_complex, fft_size)
+        dst = gr.vector_sink_c()
+        tb.connect(src, s2v, fft, v2s, dst)
+        tb.run()
+        return dst.data()
+
+    def test_003(self):
+        # Many vectors (batched transforms), with window and fftshift,
+        # checked against the unshifted output rotated by hand
+        random.seed(0)
+        for fft_size in (32, 33):
+            nvecs = 1000
+            src_data = tuple([complex(random.uniform(-1, 1), random.uniform(-1, 1))
+                              for i in range(fft_size * nvecs)])
+            window = [0.5 + 0.25 * (i % 3) for i in range(fft_size)]
+
+            unshifted = self.run_fft(src_data, fft_size, True, window, False)
+            shifted = self.run_fft(src_data, fft_size, True, window, True)
+
+            half = (fft_size + 1) // 2
+            expected_result = []
+            for v in range(nvecs):
+                x = unshifted[v*fft_size:(v+1)*fft_size]
+                expected_result.extend(x[half:] + x[:half])
+
+            self.assertEqual(len(expected_result), len(shifted))
+            self.assertComplexTuplesAlmostEqual2(expected_result, shifted,
+                                                 abs_eps=1e-4, rel_eps=1e-4)
+
+    def test_004(self):
+        # Inverse with ifftshift over many vectors
+        fft_size = 16
+        nvecs = 500
+        src_data = tuple([complex(i % 13, -(i % 7)) for i in range(fft_size * nvecs)])
+
+        rotated = []
+        for v in range(nvecs):
+            x = list(src_data[v*fft_size:(v+1)*fft_size])
+            rotated.extend(x[fft_size//2:] + x[:fft_size//2])
+
+        expected_result = self.run_fft(tuple(rotated), fft_size, False, [], False)
+        result_data = self.run_fft(src_data, fft_size, False, [], True)
+        self.assertComplexTuplesAlmostEqual2(expected_result, result_data,
+                                             abs_eps=1e-4, rel_eps=1e-4)
+
 
 if __name__ == '__main__':
     gr_unittest.main ()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+#
+# Copyright 2010 Free Software Foundation, Inc.
+# 
+# This file is part of GNU Radio
+# 
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr, gr_unittest
+import math, cmath, random
+
+SPS = 2
+SETTLE = 1000
+
+class test_mpsk_sync(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def make_sync(self, block_size):
+        # blks2.dqpsk_demod's settings
+        alpha = 0.15
+        gain_mu = 0.05
+        return gr.mpsk_sync_cc(4, math.pi/4, alpha, 0.25*alpha*alpha, -0.25, 0.25,
+                               0.5, gain_mu, SPS, 0.25*gain_mu*gain_mu, 0.005,
+                               block_size)
+
+    def run_dqpsk(self, rx, data):
+        # differentially encoded QPSK, RRC shaped, with a frequency and
+        # timing offset
+        s = 0
+        symbols = []
+        for d in data:
+            s = (s + d) % 4
+            symbols.append(cmath.exp(1j*(math.pi/4 + math.pi/2*s)))
+
+        src = gr.vector_source_c(symbols)
+        tx_rrc = gr.interp_fir_filter_ccf(SPS, gr.firdes.root_raised_cosine(
+            SPS, SPS, 1.0, 0.35, 11*SPS))
+        chan = gr.channel_model_cc(0.0, 0.002, 1.0001)
+        rx_rrc = gr.fir_filter_ccf(1, gr.firdes.root_raised_cosine(
+            1.0, SPS, 1.0, 0.35, 11*SPS))
+        dst = gr.vector_sink_c()
+        self.tb.connect(src, tx_rrc, chan, rx_rrc, rx, dst)
+        self.tb.run()
+        return dst.data()
+
+    def count_errors(self, data, result):
+        # differentially decode, then line the result up with the data
+        dec = [int(round(cmath.phase(result[k] * result[k-1].conjugate()) / (math.pi/2))) % 4
+               for k in range(1, len(result))]
+        n = min(len(dec), len(data)) - SETTLE
+        errors = []
+        for delay in range(64):
+            errors.append(len([k for k in range(SETTLE, SETTLE + n - 64)
+                               if dec[k] != data[k - delay]]))
+        return min(errors)
+
+    def test_001_block_size_1(self):
+        random.seed(1)
+        data = [random.randint(0, 3) for i in range(5000)]
+        result = self.run_dqpsk(self.make_sync(1), data)
+        self.assertEqual(0, self.count_errors(data, result))
+
+    def test_002_default_block_size(self):
+        random.seed(2)
+        data = [random.randint(0, 3) for i in range(5000)]
+        result = self.run_dqpsk(self.make_sync(4), data)
+        self.assertEqual(0, self.count_errors(data, result))
+
+    def test_003_rate(self):
+        result = self.run_dqpsk(self.make_sync(16), [0] * 5000)
+        # about one output per SPS inputs, less what the filters and
+        # interpolator hold back
+        self.assert_(abs(len(result) - 5000) < 64)
+
+if __name__ == '__main__':
+    gr_unittest.main()
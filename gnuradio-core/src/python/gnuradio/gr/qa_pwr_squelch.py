@@ -0,0 +1,100 @@
+#!/usr/bin/env python
+#
+# Copyright 2010 Free Software Foundation, Inc.
+# 
+# This file is part of GNU Radio
+# 
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr, gr_unittest
+import math, cmath
+
+MUTED, ATTACK, UNMUTED, DECAY = range(4)
+
+def pwr_squelch(data, db, alpha, ramp, gate):
+    """What gr.pwr_squelch_cc does, one sample at a time."""
+    threshold = 10**(db / 10.0)
+    pwr = 0.0
+    state = MUTED
+    if ramp:
+        envelope = 0.0
+    else:
+        envelope = 1.0
+    ramped = 0
+    result = []
+    for x in data:
+        pwr = alpha * abs(x)**2 + (1 - alpha) * pwr
+        mute = pwr < threshold
+        if state == MUTED:
+            if not mute:
+                state = (ramp and ATTACK) or UNMUTED
+        elif state == UNMUTED:
+            if mute:
+                state = (ramp and DECAY) or MUTED
+        elif state == ATTACK:
+            ramped += 1
+            envelope = 0.5 - math.cos(math.pi * ramped / ramp) / 2.0
+            if ramped >= ramp:
+                state = UNMUTED
+                envelope = 1.0
+        elif state == DECAY:
+            ramped -= 1
+            envelope = 0.5 - math.cos(math.pi * ramped / ramp) / 2.0
+            if ramped == 0:
+                state = MUTED
+        if state != MUTED:
+            result.append(x * envelope)
+        elif not gate:
+            result.append(0j)
+    return result
+
+class test_pwr_squelch(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_squelch(self, ramp, gate):
+        # bursts well above the threshold with gaps well below it
+        data = [cmath.exp(0.1j * i) * ((i // 200) % 3 and 0.01 or 1.0)
+                for i in range(3000)]
+        expected_result = pwr_squelch(data, -20, 0.05, ramp, gate)
+
+        src = gr.vector_source_c(data)
+        squelch = gr.pwr_squelch_cc(-20, 0.05, ramp, gate)
+        dst = gr.vector_sink_c()
+        self.tb.connect(src, squelch, dst)
+        self.tb.run()
+        self.assertEqual(len(expected_result), len(dst.data()))
+        self.assertComplexTuplesAlmostEqual(expected_result, dst.data(), 5)
+
+    def test_001_no_ramp(self):
+        self.run_squelch(0, False)
+
+    def test_002_ramp(self):
+        self.run_squelch(8, False)
+
+    def test_003_gate(self):
+        self.run_squelch(0, True)
+
+    def test_004_ramp_gate(self):
+        self.run_squelch(8, True)
+
+if __name__ == '__main__':
+    gr_unittest.main()
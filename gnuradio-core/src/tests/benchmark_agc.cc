@@ -0,0 +1,254 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Throughput of the AGC blocks' work methods, next to the
+ * sample-by-sample loops they used to run.  Then, in flow graphs,
+ * gr_pwr_squelch_cc next to a squelch that only has the per-sample
+ * update_state and mute, and gr_agc_squelch_vcc on NCHANS channels next
+ * to a gr_pwr_squelch_cc and gr_agc2_cc for each channel.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include <gr_complex.h>
+#include <gr_agc_cc.h>
+#include <gr_agc2_cc.h>
+#include <gr_feedforward_agc_cc.h>
+#include <gr_pwr_squelch_cc.h>
+#include <gr_single_pole_iir.h>
+#include <gr_agc_squelch_vcc.h>
+#include <gr_top_block.h>
+#include <gr_vector_source_c.h>
+#include <gr_head.h>
+#include <gr_null_sink.h>
+#include <gr_vector_to_streams.h>
+
+#define ITERATIONS	50000000	// samples per test
+#define BLOCK_SIZE	(4 * 1024)	// samples per work call; fits in cache
+#define WINDOW		64		// gr_feedforward_agc_cc's nsamples
+#define NCHANS		60
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+report (const char *name, double t_new, double t_old)
+{
+  if (t_old == 0)
+    printf ("%-36s  Msamples/s: %8.1f\n", name, ITERATIONS / t_new * 1e-6);
+  else
+    printf ("%-36s  Msamples/s: %8.1f  old: %8.1f  speedup: %5.2f\n",
+	    name, ITERATIONS / t_new * 1e-6, ITERATIONS / t_old * 1e-6, t_old / t_new);
+}
+
+// ----------------------------------------------------------------
+// The loops the blocks used to run
+
+static float
+envelope (gr_complex x)
+{
+  float r_abs = std::fabs (x.real ());
+  float i_abs = std::fabs (x.imag ());
+
+  if (r_abs > i_abs)
+    return r_abs + 0.4 * i_abs;
+  else
+    return i_abs + 0.4 * r_abs;
+}
+
+static void
+old_feedforward (gr_complex *out, const gr_complex *in, int n)
+{
+  for (int i = 0; i < n; i++){
+    float max_env = 1e-4;
+    for (int j = 0; j < WINDOW; j++)
+      max_env = std::max (max_env, envelope (in[i+j]));
+    out[i] = (1.0f / max_env) * in[i];
+  }
+}
+
+// gr_pwr_squelch_cc without update_state_n, so gr_squelch_base_cc
+// makes a virtual update_state and mute call for every sample
+class per_sample_squelch : public gr_squelch_base_cc
+{
+  double d_threshold;
+  double d_pwr;
+  gr_single_pole_iir<double,double,double> d_iir;
+
+protected:
+  void update_state(const gr_complex &in)
+  {
+    d_pwr = d_iir.filter(in.real()*in.real()+in.imag()*in.imag());
+  }
+  bool mute() const { return d_pwr < d_threshold; }
+
+public:
+  per_sample_squelch(double db, double alpha)
+    : gr_squelch_base_cc("per_sample_squelch", 0, false),
+      d_threshold(pow(10.0, db/10)), d_pwr(0), d_iir(alpha) {}
+
+  std::vector<float> squelch_range() const { return std::vector<float>(3); }
+};
+
+// ----------------------------------------------------------------
+
+static double
+time_work (boost::shared_ptr<gr_sync_block> block, std::vector<gr_complex> &in, std::vector<gr_complex> &out,
+	   int noutput_items)
+{
+  gr_vector_const_void_star inv (1, &in[0]);
+  gr_vector_void_star outv (1, &out[0]);
+
+  double t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    block->work (noutput_items, inv, outv);
+  return cpu_time () - t0;
+}
+
+// source -> head -> block -> null sink
+static double
+time_in_flow_graph (gr_block_sptr block, const std::vector<gr_complex> &in)
+{
+  gr_top_block_sptr tb = gr_make_top_block ("benchmark_agc");
+  gr_block_sptr head = gr_make_head (sizeof (gr_complex), ITERATIONS);
+  tb->connect (gr_make_vector_source_c (in, true), 0, head, 0);
+  tb->connect (head, 0, block, 0);
+  tb->connect (block, 0, gr_make_null_sink (sizeof (gr_complex)), 0);
+
+  double t0 = cpu_time ();
+  tb->run ();
+  return cpu_time () - t0;
+}
+
+int
+main (int argc, char **argv)
+{
+  std::vector<gr_complex> in (BLOCK_SIZE + WINDOW);
+  std::vector<gr_complex> out (BLOCK_SIZE);
+  double t0, t_old, t_new;
+
+  // noise, with the level stepping between bursts and quiet
+  for (size_t i = 0; i < in.size (); i++){
+    float level = (i / 1000) % 2 ? 1.0 : 0.01;
+    in[i] = gr_complex (level * (random () % 2001 - 1000) * 1e-3,
+			level * (random () % 2001 - 1000) * 1e-3);
+  }
+
+  gri_agc_cc agc (1e-3, 1.0, 1.0, 1000);
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    for (int j = 0; j < BLOCK_SIZE; j++)
+      out[j] = agc.scale (in[j]);
+  t_old = cpu_time () - t0;
+  report ("gr_agc_cc", time_work (gr_make_agc_cc (1e-3, 1.0, 1.0, 1000), in, out, BLOCK_SIZE),
+	  t_old);
+
+  gri_agc2_cc agc2 (1e-1, 1e-2, 1.0, 1.0, 1000);
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    for (int j = 0; j < BLOCK_SIZE; j++)
+      out[j] = agc2.scale (in[j]);
+  t_old = cpu_time () - t0;
+  report ("gr_agc2_cc",
+	  time_work (gr_make_agc2_cc (1e-1, 1e-2, 1.0, 1.0, 1000), in, out, BLOCK_SIZE), t_old);
+
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    old_feedforward (&out[0], &in[0], BLOCK_SIZE);
+  t_old = cpu_time () - t0;
+  report ("gr_feedforward_agc_cc, 64 samples",
+	  time_work (gr_make_feedforward_agc_cc (WINDOW, 1.0), in, out, BLOCK_SIZE), t_old);
+
+  in.resize (BLOCK_SIZE);
+  report ("gr_pwr_squelch_cc, in a flow graph",
+	  time_in_flow_graph (gr_make_pwr_squelch_cc (-20, 1e-2), in),
+	  time_in_flow_graph (gr_block_sptr (new per_sample_squelch (-20, 1e-2)), in));
+
+  // NCHANS channels, as a channelizer puts them out, each at its own
+  // point in the bursts
+  std::vector<gr_complex> vin (NCHANS * BLOCK_SIZE);
+  for (int k = 0; k < BLOCK_SIZE; k++)
+    for (int c = 0; c < NCHANS; c++)
+      vin[k * NCHANS + c] = in[(k + 37 * c) % BLOCK_SIZE];
+
+  gr_top_block_sptr tb = gr_make_top_block ("agc_squelch_vcc");
+  gr_block_sptr head = gr_make_head (NCHANS * sizeof (gr_complex), ITERATIONS / NCHANS);
+  gr_block_sptr vagc = gr_make_agc_squelch_vcc (NCHANS, -20, 1e-2, 1e-1, 1e-2, 1.0, 1.0, 1000);
+  tb->connect (gr_make_vector_source_c (vin, true, NCHANS), 0, head, 0);
+  tb->connect (head, 0, vagc, 0);
+  tb->connect (vagc, 0, gr_make_null_sink (NCHANS * sizeof (gr_complex)), 0);
+  t0 = cpu_time ();
+  tb->run ();
+  t_new = cpu_time () - t0;
+
+  tb = gr_make_top_block ("squelch_and_agc2");
+  head = gr_make_head (NCHANS * sizeof (gr_complex), ITERATIONS / NCHANS);
+  gr_block_sptr split = gr_make_vector_to_streams (sizeof (gr_complex), NCHANS);
+  tb->connect (gr_make_vector_source_c (vin, true, NCHANS), 0, head, 0);
+  tb->connect (head, 0, split, 0);
+  for (int c = 0; c < NCHANS; c++){
+    gr_block_sptr squelch = gr_make_pwr_squelch_cc (-20, 1e-2);
+    gr_block_sptr agc2 = gr_make_agc2_cc (1e-1, 1e-2, 1.0, 1.0, 1000);
+    tb->connect (split, c, squelch, 0);
+    tb->connect (squelch, 0, agc2, 0);
+    tb->connect (agc2, 0, gr_make_null_sink (sizeof (gr_complex)), 0);
+  }
+  t0 = cpu_time ();
+  tb->run ();
+  t_old = cpu_time () - t0;
+
+  char name[64];
+  snprintf (name, sizeof (name), "gr_agc_squelch_vcc, %d channels", NCHANS);
+  report (name, t_new, t_old);
+
+  return 0;
+}
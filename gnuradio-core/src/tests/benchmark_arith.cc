@@ -0,0 +1,176 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Throughput of the gengen arithmetic blocks' work methods, next to the
+ * item-by-item scalar loop they used to run.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <string.h>
+#include <vector>
+#include <gr_complex.h>
+#include <gr_add_ff.h>
+#include <gr_add_cc.h>
+#include <gr_sub_ff.h>
+#include <gr_multiply_ff.h>
+#include <gr_multiply_cc.h>
+#include <gr_divide_ff.h>
+#include <gr_divide_cc.h>
+#include <gr_add_const_ff.h>
+#include <gr_multiply_const_ff.h>
+#include <gr_multiply_const_cc.h>
+#include <gr_multiply_const_vcc.h>
+
+#define ITERATIONS	200000000	// items per test
+#define BLOCK_SIZE	(4 * 1024)	// items per work call; fits in cache
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+// ----------------------------------------------------------------
+// The scalar loops the generated blocks used to run
+
+template <class T> static void
+old_add (int n, gr_vector_const_void_star &in, gr_vector_void_star &out)
+{
+  T *optr = (T *) out[0];
+  for (int i = 0; i < n; i++){
+    T acc = ((T *) in[0])[i];
+    for (size_t j = 1; j < in.size (); j++)
+      acc += ((T *) in[j])[i];
+    *optr++ = acc;
+  }
+}
+
+template <class T> static void
+old_multiply (int n, gr_vector_const_void_star &in, gr_vector_void_star &out)
+{
+  T *optr = (T *) out[0];
+  for (int i = 0; i < n; i++){
+    T acc = ((T *) in[0])[i];
+    for (size_t j = 1; j < in.size (); j++)
+      acc *= ((T *) in[j])[i];
+    *optr++ = acc;
+  }
+}
+
+template <class T> static void
+old_divide (int n, gr_vector_const_void_star &in, gr_vector_void_star &out)
+{
+  T *optr = (T *) out[0];
+  for (int i = 0; i < n; i++){
+    T acc = ((T *) in[0])[i];
+    for (size_t j = 1; j < in.size (); j++)
+      acc /= ((T *) in[j])[i];
+    *optr++ = acc;
+  }
+}
+
+// ----------------------------------------------------------------
+
+typedef void (*scalar_work_t)(int n, gr_vector_const_void_star &in, gr_vector_void_star &out);
+
+static void
+benchmark (const char *name, boost::shared_ptr<gr_sync_block> block, scalar_work_t old_work,
+	   int ninputs, size_t itemsize)
+{
+  std::vector<char> inbuf (ninputs * BLOCK_SIZE * itemsize);
+  std::vector<char> outbuf (BLOCK_SIZE * itemsize);
+  gr_vector_const_void_star in (ninputs);
+  gr_vector_void_star out (1);
+
+  // fill with floats near 1 so nothing over- or underflows
+  float *f = (float *) &inbuf[0];
+  for (size_t i = 0; i < inbuf.size () / sizeof (float); i++)
+    f[i] = 1.0 + (random () % 1000) * 1e-6;
+
+  for (int j = 0; j < ninputs; j++)
+    in[j] = &inbuf[j * BLOCK_SIZE * itemsize];
+  out[0] = &outbuf[0];
+
+  double t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    block->work (BLOCK_SIZE, in, out);
+  double t_new = cpu_time () - t0;
+
+  if (old_work == 0){
+    printf ("%-28s  Msamples/s: %8.1f\n", name, ITERATIONS / t_new * 1e-6);
+    return;
+  }
+
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    old_work (BLOCK_SIZE, in, out);
+  double t_old = cpu_time () - t0;
+
+  printf ("%-28s  Msamples/s: %8.1f  scalar: %8.1f  speedup: %5.2f\n",
+	  name, ITERATIONS / t_new * 1e-6, ITERATIONS / t_old * 1e-6, t_old / t_new);
+}
+
+int
+main (int argc, char **argv)
+{
+  benchmark ("gr_add_ff, 2 inputs", gr_make_add_ff (), old_add<float>, 2, sizeof (float));
+  benchmark ("gr_add_ff, 4 inputs", gr_make_add_ff (), old_add<float>, 4, sizeof (float));
+  benchmark ("gr_add_cc, 2 inputs", gr_make_add_cc (), old_add<gr_complex>, 2, sizeof (gr_complex));
+  benchmark ("gr_add_cc, 4 inputs", gr_make_add_cc (), old_add<gr_complex>, 4, sizeof (gr_complex));
+  benchmark ("gr_sub_ff, 2 inputs", gr_make_sub_ff (), 0, 2, sizeof (float));
+  benchmark ("gr_multiply_ff, 2 inputs", gr_make_multiply_ff (), old_multiply<float>, 2, sizeof (float));
+  benchmark ("gr_multiply_cc, 2 inputs", gr_make_multiply_cc (), old_multiply<gr_complex>, 2, sizeof (gr_complex));
+  benchmark ("gr_multiply_cc, 4 inputs", gr_make_multiply_cc (), old_multiply<gr_complex>, 4, sizeof (gr_complex));
+  benchmark ("gr_divide_ff, 2 inputs", gr_make_divide_ff (), old_divide<float>, 2, sizeof (float));
+  benchmark ("gr_divide_cc, 2 inputs", gr_make_divide_cc (), old_divide<gr_complex>, 2, sizeof (gr_complex));
+  benchmark ("gr_add_const_ff", gr_make_add_const_ff (0.5), 0, 1, sizeof (float));
+  benchmark ("gr_multiply_const_ff", gr_make_multiply_const_ff (0.5), 0, 1, sizeof (float));
+  benchmark ("gr_multiply_const_cc", gr_make_multiply_const_cc (gr_complex (0.5, 0.5)), 0, 1, sizeof (gr_complex));
+  benchmark ("gr_multiply_const_vcc, 16",
+	     gr_make_multiply_const_vcc (std::vector<gr_complex> (16, gr_complex (0.5, 0.5))),
+	     0, 1, 16 * sizeof (gr_complex));
+}
@@ -0,0 +1,147 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Throughput of the access code correlators and framers, one bit per
+ * byte as gr_correlate_access_code_bb and gr_framer_sink_1 take them,
+ * and packed 8 to a byte.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <vector>
+#include <string>
+#include <gr_correlate_access_code_bb.h>
+#include <gr_correlate_access_code_packed_bb.h>
+#include <gr_framer_sink_1.h>
+#include <gr_framer_sink_packed.h>
+
+#define NBITS		(200 * 1000 * 1000)	// bits per test
+#define BLOCK_BITS	(32 * 1024)		// bits per work call
+
+static const std::string access_code =
+  "1010110011011101101001001110001011110010100011000010000011111100";
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+report (const char *name, double t)
+{
+  printf ("%-36s  Mbits/s: %8.1f\n", name, NBITS / t * 1e-6);
+}
+
+int
+main (int argc, char **argv)
+{
+  // random bits, with a 64 byte packet after the access code now and then
+  std::vector<unsigned char> bits (BLOCK_BITS);
+  for (int i = 0; i < BLOCK_BITS; i++)
+    bits[i] = random () & 1;
+
+  for (int i = 1000; i + 64 + 32 + 512 < BLOCK_BITS; i += 4000){
+    unsigned int header = (64 << 16) | 64;
+    for (int k = 0; k < 64; k++)
+      bits[i + k] = access_code[k] & 1;
+    for (int k = 0; k < 32; k++)
+      bits[i + 64 + k] = (header >> (31 - k)) & 1;
+  }
+
+  std::vector<unsigned char> packed (BLOCK_BITS / 8);
+  for (int i = 0; i < BLOCK_BITS; i++)
+    packed[i / 8] = (packed[i / 8] << 1) | bits[i];
+
+  std::vector<unsigned char> out0 (BLOCK_BITS), out1 (BLOCK_BITS);
+  gr_msg_queue_sptr q = gr_make_msg_queue ();
+  gr_vector_void_star no_outputs;
+  double t0;
+
+  // correlation alone
+
+  gr_correlate_access_code_bb_sptr cu =
+    gr_make_correlate_access_code_bb (access_code, 3);
+  gr_vector_const_void_star in_u (1, &bits[0]);
+  gr_vector_void_star out_u (1, &out0[0]);
+  t0 = cpu_time ();
+  for (int i = 0; i < NBITS / BLOCK_BITS; i++)
+    cu->work (BLOCK_BITS, in_u, out_u);
+  report ("correlate_access_code_bb", cpu_time () - t0);
+
+  gr_correlate_access_code_packed_bb_sptr cp =
+    gr_make_correlate_access_code_packed_bb (access_code, 3);
+  gr_vector_const_void_star in_p (1, &packed[0]);
+  gr_vector_void_star out_p;
+  out_p.push_back (&out0[0]);
+  out_p.push_back (&out1[0]);
+  t0 = cpu_time ();
+  for (int i = 0; i < NBITS / BLOCK_BITS; i++)
+    cp->work (BLOCK_BITS / 8, in_p, out_p);
+  report ("correlate_access_code_packed_bb", cpu_time () - t0);
+
+  // correlation and framing
+
+  gr_framer_sink_1_sptr fu = gr_make_framer_sink_1 (q);
+  gr_vector_const_void_star in_f (1, &out0[0]);
+  t0 = cpu_time ();
+  for (int i = 0; i < NBITS / BLOCK_BITS; i++){
+    cu->work (BLOCK_BITS, in_u, out_u);
+    fu->work (BLOCK_BITS, in_f, no_outputs);
+    q->flush ();
+  }
+  report ("correlate_access_code_bb + framer_sink_1", cpu_time () - t0);
+
+  gr_framer_sink_packed_sptr fp = gr_make_framer_sink_packed (access_code, 3, q);
+  t0 = cpu_time ();
+  for (int i = 0; i < NBITS / BLOCK_BITS; i++){
+    fp->work (BLOCK_BITS / 8, in_p, no_outputs);
+    q->flush ();
+  }
+  report ("framer_sink_packed", cpu_time () - t0);
+
+  return 0;
+}
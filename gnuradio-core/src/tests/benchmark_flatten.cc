@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * The time each phase of starting and reconfiguring a large
+ * hierarchical flow graph takes.  The graph is a channelizer, here a
+ * gr_vector_to_streams, feeding nchans (argv[1], default NCHANS)
+ * hierarchical "demodulators", each NSTAGES gr_multiply_const_ff around
+ * a hierarchical "filter" of NFILTER more, and a null sink per
+ * channel.
+ *
+ * The phases are those of gr_top_block::start, less the scheduler,
+ * and then of an unlock() after channel 0's demodulator is swapped for
+ * a new one, as gr_top_block_impl::restart does them when the
+ * scheduler can't reconfigure itself.  Nothing is run.
+ *
+ * Every output gets a gr_buffer, and with it shared memory segments,
+ * so a few hundred channels may need kernel.shmmni raised.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <vector>
+#include <gr_top_block.h>
+#include <gr_hier_block2.h>
+#include <gr_flat_flowgraph.h>
+#include <gr_io_signature.h>
+#include <gr_vector_source_f.h>
+#include <gr_vector_to_streams.h>
+#include <gr_multiply_const_ff.h>
+#include <gr_null_sink.h>
+
+#define NCHANS		100
+#define NSTAGES		6
+#define NFILTER		4
+
+static double
+wall_time ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+// Print the time since *t0 and restart the clock
+static void
+report (const char *phase, double *t0)
+{
+  double t = wall_time ();
+  printf ("  %-28s %10.3f ms\n", phase, (t - *t0) * 1e3);
+  *t0 = t;
+}
+
+// Connect n multipliers after prev; returns the last
+static gr_basic_block_sptr
+connect_stages (gr_hier_block2_sptr hb, gr_basic_block_sptr prev, int n)
+{
+  for (int i = 0; i < n; i++){
+    gr_block_sptr mult = gr_make_multiply_const_ff (1.0);
+    hb->connect (prev, 0, mult, 0);
+    prev = mult;
+  }
+  return prev;
+}
+
+static gr_hier_block2_sptr
+make_filter ()
+{
+  gr_hier_block2_sptr filter =
+    gr_make_hier_block2 ("filter",
+			 gr_make_io_signature (1, 1, sizeof (float)),
+			 gr_make_io_signature (1, 1, sizeof (float)));
+  filter->connect (connect_stages (filter, filter, NFILTER), 0, filter, 0);
+  return filter;
+}
+
+static gr_hier_block2_sptr
+make_demod ()
+{
+  gr_hier_block2_sptr demod =
+    gr_make_hier_block2 ("demod",
+			 gr_make_io_signature (1, 1, sizeof (float)),
+			 gr_make_io_signature (1, 1, sizeof (float)));
+  gr_hier_block2_sptr filter = make_filter ();
+  demod->connect (connect_stages (demod, demod, NSTAGES / 2), 0, filter, 0);
+  demod->connect (connect_stages (demod, filter, NSTAGES - NSTAGES / 2), 0, demod, 0);
+  return demod;
+}
+
+int
+main (int argc, char **argv)
+{
+  int nchans = argc > 1 ? atoi (argv[1]) : NCHANS;
+  if (nchans < 1){
+    fprintf (stderr, "usage: %s [nchans]\n", argv[0]);
+    exit (1);
+  }
+
+  printf ("%d channels, %d blocks:\n", nchans, 2 + nchans * (NSTAGES + NFILTER + 1));
+
+  double t0 = wall_time ();
+
+  gr_top_block_sptr tb = gr_make_top_block ("benchmark_flatten");
+  std::vector<float> data (nchans, 1.0);
+  gr_block_sptr split = gr_make_vector_to_streams (sizeof (float), nchans);
+  tb->connect (gr_make_vector_source_f (data, true, nchans), 0, split, 0);
+
+  std::vector<gr_hier_block2_sptr> demods (nchans);
+  std::vector<gr_block_sptr> sinks (nchans);
+  for (int i = 0; i < nchans; i++){
+    demods[i] = make_demod ();
+    sinks[i] = gr_make_null_sink (sizeof (float));
+    tb->connect (split, i, demods[i], 0);
+    tb->connect (demods[i], 0, sinks[i], 0);
+  }
+  report ("build", &t0);
+
+  // gr_top_block_impl::start
+  gr_flat_flowgraph_sptr ffg = tb->flatten ();
+  report ("flatten", &t0);
+  ffg->validate ();
+  report ("validate", &t0);
+  ffg->setup_connections ();
+  report ("setup_connections", &t0);
+
+  // what the schedulers do with it
+  gr_basic_block_vector_t blocks = ffg->calc_used_blocks ();
+  ffg->topological_sort (blocks);
+  report ("topological_sort (TPB)", &t0);
+  ffg->partition ();
+  report ("partition (STS)", &t0);
+
+  // lock(), swap channel 0's demodulator, unlock()
+  tb->disconnect (split, 0, demods[0], 0);
+  tb->disconnect (demods[0], 0, sinks[0], 0);
+  demods[0] = make_demod ();
+  tb->connect (split, 0, demods[0], 0);
+  tb->connect (demods[0], 0, sinks[0], 0);
+  t0 = wall_time ();
+
+  gr_flat_flowgraph_sptr new_ffg = tb->flatten ();
+  report ("reconfigure: flatten", &t0);
+  new_ffg->validate ();
+  report ("reconfigure: validate", &t0);
+  new_ffg->calc_changed_blocks (ffg);
+  report ("reconfigure: changed blocks", &t0);
+  new_ffg->merge_connections (ffg);
+  report ("reconfigure: merge", &t0);
+
+  return 0;
+}
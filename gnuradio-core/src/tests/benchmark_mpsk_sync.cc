@@ -0,0 +1,231 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * DQPSK through gr_channel_model_cc, received by gr_mpsk_receiver_cc
+ * and by gr_mpsk_sync_cc with a few block sizes.  The loop settings
+ * are blks2.dqpsk_demod's defaults.  Prints the symbol and bit error
+ * rates after the loops have locked, and how fast each receiver is on
+ * its own.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include <gr_top_block.h>
+#include <gr_firdes.h>
+#include <gr_expj.h>
+#include <gr_vector_source_c.h>
+#include <gr_vector_sink_c.h>
+#include <gr_null_sink.h>
+#include <gr_interp_fir_filter_ccf.h>
+#include <gr_fir_filter_ccf.h>
+#include <gr_channel_model_cc.h>
+#include <gr_mpsk_receiver_cc.h>
+#include <gr_mpsk_sync_cc.h>
+
+#define NSYMBOLS	200000
+#define SPS		2		// samples per symbol
+#define SETTLE		5000		// symbols to let the loops lock
+#define MAX_DELAY	64		// symbols through the filters and receiver
+#define WINDOW		1000		// symbols to count errors over at one delay
+
+static const float costas_alpha = 0.15;
+static const float gain_mu = 0.05;
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static gr_block_sptr
+make_receiver (int block_size)
+{
+  if (block_size == 0)
+    return gr_make_mpsk_receiver_cc (4, M_PI / 4,
+				     costas_alpha, 0.25 * costas_alpha * costas_alpha,
+				     -0.25, 0.25,
+				     0.5, gain_mu,
+				     SPS, 0.25 * gain_mu * gain_mu, 0.005);
+  else
+    return gr_make_mpsk_sync_cc (4, M_PI / 4,
+				 costas_alpha, 0.25 * costas_alpha * costas_alpha,
+				 -0.25, 0.25,
+				 0.5, gain_mu,
+				 SPS, 0.25 * gain_mu * gain_mu, 0.005,
+				 block_size);
+}
+
+/*
+ * Differentially decode the receiver's output and count the errors
+ * against the data.  The delay that lines them up is found again for
+ * each WINDOW symbols, so a symbol the timing loop drops or repeats
+ * costs a few errors instead of the rest of the run.
+ */
+static void
+count_errors (const std::vector<gr_complex> &rx, const std::vector<int> &data,
+	      double *ser, double *ber)
+{
+  int nrx = std::min (rx.size (), data.size ());
+  std::vector<int> dec (nrx);
+  for (int k = 1; k < nrx; k++){
+    gr_complex z = rx[k] * conj (rx[k - 1]);
+    dec[k] = (int) lrintf (atan2f (z.imag (), z.real ()) / (M_PI / 2)) & 3;
+  }
+
+  long nsym = 0, nsym_errors = 0, nbit_errors = 0;
+  for (int w = SETTLE; w + WINDOW <= nrx; w += WINDOW){
+    int best = 0, best_errors = WINDOW + 1;
+    for (int d = 0; d < MAX_DELAY; d++){
+      int errors = 0;
+      for (int k = w; k < w + WINDOW; k++)
+	errors += dec[k] != data[k - d];
+      if (errors < best_errors){
+	best_errors = errors;
+	best = d;
+      }
+    }
+
+    for (int k = w; k < w + WINDOW; k++){
+      int diff = (dec[k] ^ (dec[k] >> 1)) ^ (data[k - best] ^ (data[k - best] >> 1));
+      nsym++;
+      nsym_errors += diff != 0;
+      nbit_errors += (diff & 1) + (diff >> 1);
+    }
+  }
+  *ser = (double) nsym_errors / nsym;
+  *ber = (double) nbit_errors / (2 * nsym);
+}
+
+int
+main (int argc, char **argv)
+{
+  static const float noise[] = { 0.2, 0.25, 0.3 };
+  static const int block_sizes[] = { 0, 1, 4, 8, 16 };	// 0 is gr_mpsk_receiver_cc
+  const int nnoise = sizeof (noise) / sizeof (noise[0]);
+  const int nblock_sizes = sizeof (block_sizes) / sizeof (block_sizes[0]);
+
+  // DQPSK, as blks2.dqpsk_mod sends it
+  std::vector<int> data (NSYMBOLS);
+  std::vector<gr_complex> symbols (NSYMBOLS);
+  unsigned int r = 1, s = 0;
+  for (int k = 0; k < NSYMBOLS; k++){
+    r = r * 1103515245 + 12345;
+    data[k] = (r >> 16) & 3;
+    s = (s + data[k]) & 3;
+    symbols[k] = gr_expj (M_PI / 4 + M_PI / 2 * s);
+  }
+
+  std::vector<float> tx_taps =
+    gr_firdes::root_raised_cosine (SPS, SPS, 1.0, 0.35, 11 * SPS);
+  std::vector<float> rx_taps =
+    gr_firdes::root_raised_cosine (1.0, SPS, 1.0, 0.35, 11 * SPS);
+
+  std::vector<std::vector<double> > ser (nnoise, std::vector<double> (nblock_sizes));
+  std::vector<std::vector<double> > ber (nnoise, std::vector<double> (nblock_sizes));
+  std::vector<double> t (nblock_sizes);
+  size_t nsamples = 0;
+
+  for (int i = 0; i < nnoise; i++){
+
+    // modulator, channel and matched filter
+    gr_top_block_sptr tb = gr_make_top_block ("dqpsk_mod");
+    gr_block_sptr src = gr_make_vector_source_c (symbols);
+    gr_block_sptr shape = gr_make_interp_fir_filter_ccf (SPS, tx_taps);
+    gr_block_sptr chan =
+      gr_make_channel_model_cc (noise[i], 0.002, 1.0001, std::vector<gr_complex> (1, 1));
+    gr_block_sptr matched = gr_make_fir_filter_ccf (1, rx_taps);
+    gr_vector_sink_c_sptr samples = gr_make_vector_sink_c ();
+    tb->connect (src, 0, shape, 0);
+    tb->connect (shape, 0, chan, 0);
+    tb->connect (chan, 0, matched, 0);
+    tb->connect (matched, 0, samples, 0);
+    tb->run ();
+    nsamples = samples->data ().size ();
+
+    // the receivers on their own
+    for (int j = 0; j < nblock_sizes; j++){
+      tb = gr_make_top_block ("dqpsk_demod");
+      gr_block_sptr rx = make_receiver (block_sizes[j]);
+      gr_vector_sink_c_sptr out = gr_make_vector_sink_c ();
+      tb->connect (gr_make_vector_source_c (samples->data ()), 0, rx, 0);
+      tb->connect (rx, 0, out, 0);
+      tb->run ();
+
+      // and again into a null sink for the timing
+      tb = gr_make_top_block ("dqpsk_demod");
+      rx = make_receiver (block_sizes[j]);
+      tb->connect (gr_make_vector_source_c (samples->data ()), 0, rx, 0);
+      tb->connect (rx, 0, gr_make_null_sink (sizeof (gr_complex)), 0);
+      double t0 = cpu_time ();
+      tb->run ();
+      t[j] += cpu_time () - t0;
+
+      count_errors (out->data (), data, &ser[i][j], &ber[i][j]);
+    }
+  }
+
+  printf ("%-32s", "noise voltage");
+  for (int i = 0; i < nnoise; i++)
+    printf ("  %-17.2f", noise[i]);
+  printf ("  Msamples/s\n");
+
+  for (int j = 0; j < nblock_sizes; j++){
+    char name[64];
+    if (block_sizes[j] == 0)
+      snprintf (name, sizeof (name), "gr_mpsk_receiver_cc");
+    else
+      snprintf (name, sizeof (name), "gr_mpsk_sync_cc, block_size %d", block_sizes[j]);
+    printf ("%-32s", name);
+    for (int i = 0; i < nnoise; i++)
+      printf ("  SER %.4f BER %.4f", ser[i][j], ber[i][j]);
+    printf ("  %6.2f\n", nnoise * nsamples / t[j] * 1e-6);
+  }
+
+  return 0;
+}
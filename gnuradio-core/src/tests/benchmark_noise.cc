@@ -0,0 +1,161 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Throughput of the noise sources and gr_channel_model_cc, next to
+ * gr_random, which the noise sources used to be built on.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <vector>
+#include <gr_random.h>
+#include <gri_fast_random.h>
+#include <gr_noise_source_f.h>
+#include <gr_noise_source_c.h>
+#include <gr_channel_model_cc.h>
+#include <gr_top_block.h>
+#include <gr_null_source.h>
+#include <gr_null_sink.h>
+#include <gr_head.h>
+#include <gr_fractional_interpolator_cc.h>
+#include <gr_fir_filter_ccc.h>
+#include <gr_sig_source_c.h>
+#include <gr_multiply_cc.h>
+#include <gr_add_cc.h>
+
+#define ITERATIONS	50000000	// samples per test
+#define BLOCK_SIZE	(4 * 1024)	// samples per work call; fits in cache
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+report (const char *name, double t)
+{
+  printf ("%-32s  Msamples/s: %8.1f\n", name, ITERATIONS / t * 1e-6);
+}
+
+int
+main (int argc, char **argv)
+{
+  std::vector<gr_complex> out (BLOCK_SIZE);
+  float *fout = (float *) &out[0];
+  volatile float sink = 0;
+  double t0;
+
+  // the generators on their own
+
+  gr_random old_rng;
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink += old_rng.gasdev ();
+  report ("gr_random::gasdev", cpu_time () - t0);
+
+  gri_fast_random rng;
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink += rng.gaussian ();
+  report ("gri_fast_random::gaussian", cpu_time () - t0);
+
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    rng.gaussian (fout, BLOCK_SIZE);
+  report ("gri_fast_random::gaussian, bulk", cpu_time () - t0);
+
+  // the blocks
+
+  gr_vector_const_void_star no_inputs;
+  gr_vector_void_star outputs (1, &out[0]);
+
+  gr_noise_source_f_sptr nf = gr_make_noise_source_f (GR_GAUSSIAN, 1.0);
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    nf->work (BLOCK_SIZE, no_inputs, outputs);
+  report ("gr_noise_source_f, gaussian", cpu_time () - t0);
+
+  gr_noise_source_c_sptr nc = gr_make_noise_source_c (GR_GAUSSIAN, 1.0);
+  t0 = cpu_time ();
+  for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++)
+    nc->work (BLOCK_SIZE, no_inputs, outputs);
+  report ("gr_noise_source_c, gaussian", cpu_time () - t0);
+
+  // the channel model, fused and as the blocks gr_channel_model used to be
+
+  std::vector<gr_complex> taps (3, gr_complex (0.5, 0.1));
+
+  gr_top_block_sptr tb = gr_make_top_block ("fused");
+  gr_block_sptr head = gr_make_head (sizeof (gr_complex), ITERATIONS);
+  gr_block_sptr chan = gr_make_channel_model_cc (0.1, 0.01, 1.0, taps);
+  tb->connect (gr_make_null_source (sizeof (gr_complex)), 0, head, 0);
+  tb->connect (head, 0, chan, 0);
+  tb->connect (chan, 0, gr_make_null_sink (sizeof (gr_complex)), 0);
+  t0 = cpu_time ();
+  tb->run ();
+  report ("gr_channel_model_cc", cpu_time () - t0);
+
+  tb = gr_make_top_block ("separate");
+  head = gr_make_head (sizeof (gr_complex), ITERATIONS);
+  gr_block_sptr interp = gr_make_fractional_interpolator_cc (0, 1.0);
+  gr_block_sptr fir = gr_make_fir_filter_ccc (1, taps);
+  gr_block_sptr mixer = gr_make_multiply_cc ();
+  gr_block_sptr adder = gr_make_add_cc ();
+  tb->connect (gr_make_null_source (sizeof (gr_complex)), 0, head, 0);
+  tb->connect (head, 0, interp, 0);
+  tb->connect (interp, 0, fir, 0);
+  tb->connect (fir, 0, mixer, 0);
+  tb->connect (gr_make_sig_source_c (1, GR_SIN_WAVE, 0.01, 1.0, 0.0), 0, mixer, 1);
+  tb->connect (mixer, 0, adder, 0);
+  tb->connect (gr_make_noise_source_c (GR_GAUSSIAN, 0.1), 0, adder, 1);
+  tb->connect (adder, 0, gr_make_null_sink (sizeof (gr_complex)), 0);
+  t0 = cpu_time ();
+  tb->run ();
+  report ("the same as six blocks", cpu_time () - t0);
+
+  return sink == 12345.0;	// keep the loops from being optimized away
+}
@@ -0,0 +1,212 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * OFDM loopback: packets go through the blks2 ofdm_mod chain and
+ * gr_channel_model_cc into a vector, then the receive chain is timed
+ * on its own, from gr_ofdm_sampler to gr_ofdm_frame_sink.  The timing
+ * signal comes from where the preambles were put in rather than from
+ * a synchronizer, so this is the throughput of the blocks after it.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <vector>
+#include <gr_top_block.h>
+#include <gr_msg_queue.h>
+#include <gr_ofdm_mapper_bcv.h>
+#include <gr_ofdm_insert_preamble.h>
+#include <gr_fft_vcc.h>
+#include <gr_ofdm_cyclic_prefixer.h>
+#include <gr_channel_model_cc.h>
+#include <gr_ofdm_sampler.h>
+#include <gr_ofdm_frame_acquisition.h>
+#include <gr_ofdm_frame_sink.h>
+#include <gr_vector_source_c.h>
+#include <gr_vector_source_b.h>
+#include <gr_vector_sink_c.h>
+#include <gr_vector_sink_b.h>
+#include <gr_null_sink.h>
+
+#define NPACKETS	1000
+#define PAYLOAD_LEN	400		// bytes
+#define FFT_LENGTH	512
+#define OCCUPIED	200
+#define CP_LENGTH	128
+#define SYMBOL_LENGTH	(FFT_LENGTH + CP_LENGTH)
+#define EARLY		8		// samples into the cyclic prefix to start the FFT
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+report (const char *name, size_t nsymbols, double t)
+{
+  printf ("%-40s  ksymbols/s: %8.1f  Msamples/s: %6.2f\n", name,
+	  nsymbols / t * 1e-3, nsymbols * SYMBOL_LENGTH / t * 1e-6);
+}
+
+// what ofdm_packet_utils.make_packet sends, without the whitening and CRC
+static gr_message_sptr
+make_packet (int n)
+{
+  gr_message_sptr msg = gr_make_message (0, 0, 0, 4 + PAYLOAD_LEN);
+  unsigned char *p = msg->msg ();
+  p[0] = p[2] = PAYLOAD_LEN >> 8;
+  p[1] = p[3] = PAYLOAD_LEN & 0xff;
+  for (int i = 0; i < PAYLOAD_LEN; i++)
+    p[4 + i] = (n * 131 + i * 7) & 0xff;
+  return msg;
+}
+
+int
+main (int argc, char **argv)
+{
+  int zeros_on_left = (FFT_LENGTH - OCCUPIED + 1) / 2;
+  double t0;
+
+  // QPSK, rotated as blks2.ofdm_mod does, and a BPSK known symbol on
+  // every other carrier
+  std::vector<gr_complex> constellation;
+  constellation.push_back (gr_complex (-0.707, -0.707));
+  constellation.push_back (gr_complex (0.707, -0.707));
+  constellation.push_back (gr_complex (-0.707, 0.707));
+  constellation.push_back (gr_complex (0.707, 0.707));
+  std::vector<unsigned char> values;
+  for (unsigned int i = 0; i < constellation.size (); i++)
+    values.push_back (i);
+
+  std::vector<gr_complex> known (OCCUPIED);
+  unsigned int pn = 0x1234;
+  for (int i = 0; i < OCCUPIED; i++){
+    pn = pn * 1103515245 + 12345;
+    if (!((zeros_on_left + i) & 1))
+      known[i] = (pn & 0x10000) ? 1 : -1;
+  }
+  std::vector<std::vector<gr_complex> > preamble (1, std::vector<gr_complex> (FFT_LENGTH));
+  std::copy (known.begin (), known.end (), preamble[0].begin () + zeros_on_left);
+
+  // modulator and channel
+
+  std::vector<gr_complex> taps;
+  taps.push_back (gr_complex (1.0, 0.0));
+  taps.push_back (gr_complex (0.2, -0.1));
+
+  gr_top_block_sptr tb = gr_make_top_block ("ofdm_mod");
+  gr_ofdm_mapper_bcv_sptr mapper =
+    gr_make_ofdm_mapper_bcv (constellation, 0, OCCUPIED, FFT_LENGTH);
+  gr_block_sptr insert = gr_make_ofdm_insert_preamble (FFT_LENGTH, preamble);
+  gr_block_sptr ifft = gr_make_fft_vcc (FFT_LENGTH, false, std::vector<float> (), true);
+  gr_block_sptr cp = gr_make_ofdm_cyclic_prefixer (FFT_LENGTH, SYMBOL_LENGTH);
+  gr_block_sptr chan = gr_make_channel_model_cc (0.5, 0.0, 1.0, taps);
+  gr_vector_sink_c_sptr samples = gr_make_vector_sink_c ();
+  gr_vector_sink_b_sptr flags = gr_make_vector_sink_b ();
+  tb->connect (mapper, 0, insert, 0);
+  tb->connect (mapper, 1, insert, 1);
+  tb->connect (insert, 0, ifft, 0);
+  tb->connect (insert, 1, flags, 0);
+  tb->connect (ifft, 0, cp, 0);
+  tb->connect (cp, 0, chan, 0);
+  tb->connect (chan, 0, samples, 0);
+
+  for (int n = 0; n < NPACKETS; n++)
+    mapper->msgq ()->insert_tail (make_packet (n));
+  mapper->msgq ()->insert_tail (gr_make_message (1, 0, 0, 0));	// EOF
+
+  t0 = cpu_time ();
+  tb->run ();
+  double t = cpu_time () - t0;
+
+  std::vector<unsigned char> flag = flags->data ();
+  size_t nsymbols = flag.size ();
+  report ("transmit: mapper to channel model", nsymbols, t);
+
+  // a trigger at the end of each preamble's FFT window
+  std::vector<unsigned char> trigger (samples->data ().size ());
+  for (size_t k = 0; k < nsymbols; k++)
+    if (flag[k])
+      trigger[(k + 1) * SYMBOL_LENGTH - 1 - EARLY] = 1;
+
+  // demodulator
+
+  tb = gr_make_top_block ("ofdm_demod");
+  gr_msg_queue_sptr rcvd = gr_make_msg_queue ();
+  gr_block_sptr src = gr_make_vector_source_c (samples->data (), false);
+  gr_block_sptr trig = gr_make_vector_source_b (trigger, false);
+  gr_block_sptr sampler = gr_make_ofdm_sampler (FFT_LENGTH, SYMBOL_LENGTH);
+  gr_block_sptr fft = gr_make_fft_vcc (FFT_LENGTH, true, std::vector<float> (), true);
+  gr_block_sptr acq = gr_make_ofdm_frame_acquisition (OCCUPIED, FFT_LENGTH, CP_LENGTH, known);
+  gr_block_sptr sink = gr_make_ofdm_frame_sink (constellation, values, rcvd, OCCUPIED);
+  tb->connect (src, 0, sampler, 0);
+  tb->connect (trig, 0, sampler, 1);
+  tb->connect (sampler, 0, fft, 0);
+  tb->connect (fft, 0, acq, 0);
+  tb->connect (sampler, 1, acq, 1);
+  tb->connect (acq, 0, sink, 0);
+  tb->connect (acq, 1, sink, 1);
+  tb->connect (sink, 0, gr_make_null_sink (sizeof (gr_complex) * OCCUPIED), 0);
+
+  t0 = cpu_time ();
+  tb->run ();
+  t = cpu_time () - t0;
+  report ("receive: sampler to frame sink", nsymbols, t);
+
+  int good = 0;
+  for (int n = 0; n < NPACKETS && rcvd->count () > 0; n++){
+    gr_message_sptr msg = rcvd->delete_head ();
+    gr_message_sptr sent = make_packet (n);
+    if (msg->length () == PAYLOAD_LEN
+	&& memcmp (msg->msg (), sent->msg () + 4, PAYLOAD_LEN) == 0)
+      good++;
+  }
+  printf ("%d of %d packets received\n", good, NPACKETS);
+
+  return good != NPACKETS;
+}
@@ -0,0 +1,193 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * The schedulers on the same flow graphs of cheap blocks, each fed by
+ * a repeating vector source through gr_head:
+ *
+ *   chain:    NSTAGES gr_multiply_const_ff and a null sink
+ *   branches: NBRANCHES of gr_keep_one_in_n (DECIM) followed by
+ *             NSTAGES gr_multiply_const_ff and a null sink, so that
+ *             most blocks have nothing to do most of the time
+ *
+ * Each is run NRUNS times with a short head, the way a small embedded
+ * flow graph gets started over and over, and then once with a long
+ * one.  Each run gets its own scheduler, made directly, since
+ * GR_SCHEDULER is only looked at once.  CPU time is summed over all
+ * the threads.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <vector>
+#include <gr_top_block.h>
+#include <gr_flat_flowgraph.h>
+#include <gr_scheduler_tpb.h>
+#include <gr_scheduler_sts.h>
+#include <gr_vector_source_f.h>
+#include <gr_head.h>
+#include <gr_keep_one_in_n.h>
+#include <gr_multiply_const_ff.h>
+#include <gr_null_sink.h>
+
+#define NSTAGES		8
+#define NBRANCHES	8
+#define DECIM		100
+#define NRUNS		2000
+#define SHORT_ITEMS	1000
+#define LONG_ITEMS	50000000
+
+typedef gr_scheduler_sptr (*scheduler_maker)(gr_flat_flowgraph_sptr ffg);
+typedef int (*graph_builder)(gr_top_block_sptr tb, gr_basic_block_sptr src);
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+wall_time ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return timeval_to_double (&tv);
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime) + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+// NSTAGES multipliers and a sink after src; returns the number of blocks
+static int
+build_chain (gr_top_block_sptr tb, gr_basic_block_sptr src)
+{
+  gr_basic_block_sptr prev = src;
+  for (int i = 0; i < NSTAGES; i++){
+    gr_block_sptr mult = gr_make_multiply_const_ff (1.0);
+    tb->connect (prev, 0, mult, 0);
+    prev = mult;
+  }
+  tb->connect (prev, 0, gr_make_null_sink (sizeof (float)), 0);
+  return NSTAGES + 1;
+}
+
+static int
+build_branches (gr_top_block_sptr tb, gr_basic_block_sptr src)
+{
+  int nblocks = 0;
+  for (int i = 0; i < NBRANCHES; i++){
+    gr_block_sptr keep = gr_make_keep_one_in_n (sizeof (float), DECIM);
+    tb->connect (src, 0, keep, 0);
+    nblocks += 1 + build_chain (tb, keep);
+  }
+  return nblocks;
+}
+
+static void
+time_graph (const char *name, scheduler_maker make, graph_builder build,
+	    int nruns, int nitems)
+{
+  std::vector<float> data (4096, 1.0);
+
+  gr_top_block_sptr tb = gr_make_top_block ("benchmark_scheduler");
+  gr_head_sptr head = gr_make_head (sizeof (float), nitems);
+  tb->connect (gr_make_vector_source_f (data, true), 0, head, 0);
+  build (tb, head);
+
+  // what gr_top_block::start does, less the scheduler
+  gr_flat_flowgraph_sptr ffg = tb->flatten ();
+  ffg->validate ();
+  ffg->setup_connections ();
+
+  double w0 = wall_time ();
+  double c0 = cpu_time ();
+  for (int i = 0; i < nruns; i++){
+    head->reset ();
+    make (ffg)->wait ();
+  }
+  double wall = wall_time () - w0;
+  double cpu = cpu_time () - c0;
+
+  printf ("  %-8s  wall: %7.3f s  cpu: %7.3f s  Mitems/s: %7.2f\n",
+	  name, wall, cpu, (double) nruns * nitems / wall * 1e-6);
+}
+
+int
+main (int argc, char **argv)
+{
+  static const struct {
+    const char	       *name;
+    scheduler_maker	make;
+  } schedulers[] = {
+    { "TPB",	gr_scheduler_tpb::make },
+    { "STS",	gr_scheduler_sts::make },
+    { "STS_DD",	gr_scheduler_sts::make_data_driven }
+  };
+  static const int nschedulers = sizeof (schedulers) / sizeof (schedulers[0]);
+
+  static const struct {
+    const char	       *name;
+    graph_builder	build;
+  } graphs[] = {
+    { "chain",		build_chain },
+    { "branches",	build_branches }
+  };
+  static const int ngraphs = sizeof (graphs) / sizeof (graphs[0]);
+
+  for (int g = 0; g < ngraphs; g++){
+    gr_top_block_sptr tb = gr_make_top_block ("count");
+    int nblocks = 2 + graphs[g].build (tb, gr_make_head (sizeof (float), 0));
+
+    printf ("%s, %d blocks, %d runs of %d items:\n",
+	    graphs[g].name, nblocks, NRUNS, SHORT_ITEMS);
+    for (int i = 0; i < nschedulers; i++)
+      time_graph (schedulers[i].name, schedulers[i].make, graphs[g].build,
+		  NRUNS, SHORT_ITEMS);
+
+    printf ("%s, %d blocks, 1 run of %d items:\n", graphs[g].name, nblocks, LONG_ITEMS);
+    for (int i = 0; i < nschedulers; i++)
+      time_graph (schedulers[i].name, schedulers[i].make, graphs[g].build,
+		  1, LONG_ITEMS);
+  }
+
+  return 0;
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -51,12 +51,15 @@ atsc_rs_decoder::work (int noutput_items,
   const atsc_mpeg_packet_rs_encoded *in = (const atsc_mpeg_packet_rs_encoded *) input_items[0];
   atsc_mpeg_packet_no_sync *out = (atsc_mpeg_packet_no_sync *) output_items[0];
 
+  if ((int) d_ncorrections.size() < noutput_items)
+    d_ncorrections.resize(noutput_items);
+
+  d_rs_decoder.decode(out, in, noutput_items, &d_ncorrections[0]);
+
   for (int i = 0; i < noutput_items; i++){
     assert(in[i].pli.regular_seg_p());
     out[i].pli = in[i].pli;			// copy pipeline info...
-
-    int nerrors_corrrected = d_rs_decoder.decode(out[i], in[i]);
-    out[i].pli.set_transport_error(nerrors_corrrected == -1);
+    out[i].pli.set_transport_error(d_ncorrections[i] == -1);
   }
 
   return noutput_items;
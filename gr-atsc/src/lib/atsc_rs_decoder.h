@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,7 @@
 
 #include <gr_sync_block.h>
 #include <atsci_reed_solomon.h>
+#include <vector>
 
 class atsc_rs_decoder;
 typedef boost::shared_ptr<atsc_rs_decoder> atsc_rs_decoder_sptr;
@@ -41,6 +42,7 @@ class atsc_rs_decoder : public gr_sync_block
   friend atsc_rs_decoder_sptr atsc_make_rs_decoder();
 
   atsci_reed_solomon	d_rs_decoder;
+  std::vector<int>	d_ncorrections;
 
   atsc_rs_decoder();
 
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -76,9 +76,16 @@ int
 atsci_reed_solomon::decode (atsc_mpeg_packet_no_sync &out, const atsc_mpeg_packet_rs_encoded &in)
 {
   unsigned char tmp[N];
+  unsigned char syndromes[rs_init_nroots];
   int		ncorrections;
 
   assert ((int)(amount_of_pad + sizeof (in.data)) == N);
+
+  // the usual case: a valid codeword, nothing to correct
+  if (!syndrome_rs_char (d_rs, in.data, sizeof (in.data), syndromes)){
+    memcpy (out.data, in.data, sizeof (out.data));
+    return 0;
+  }
   
   // add missing prefix zero padding to message
   memset (tmp, 0, amount_of_pad);
@@ -92,3 +99,18 @@ atsci_reed_solomon::decode (atsc_mpeg_packet_no_sync &out, const atsc_mpeg_packe
 
   return ncorrections;
 }
+
+int
+atsci_reed_solomon::decode (atsc_mpeg_packet_no_sync out[],
+			    const atsc_mpeg_packet_rs_encoded in[],
+			    int n, int ncorrections[])
+{
+  int nfailed = 0;
+
+  for (int i = 0; i < n; i++){
+    ncorrections[i] = decode (out[i], in[i]);
+    if (ncorrections[i] < 0)
+      nfailed++;
+  }
+  return nfailed;
+}
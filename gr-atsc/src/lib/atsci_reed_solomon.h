@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -49,6 +49,15 @@ class atsci_reed_solomon {
    */
   int decode (atsc_mpeg_packet_no_sync &out, const atsc_mpeg_packet_rs_encoded &in);
 
+  /*!
+   * Decode \p n RS encoded packets; ncorrections[i] receives what
+   * decode() would return for packet i.  Only the data is written, not
+   * the pipeline info.
+   * \returns the number of uncorrectable packets.
+   */
+  int decode (atsc_mpeg_packet_no_sync out[], const atsc_mpeg_packet_rs_encoded in[],
+	      int n, int ncorrections[]);
+
  private:
   void	*d_rs;
 };
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,10 @@
 #include <atsci_single_viterbi.h>
 #include <iostream>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 using std::cerr;
 using std::cout;
 
@@ -61,6 +65,72 @@ atsci_single_viterbi::atsci_single_viterbi()
   reset();
 }
 
+#ifdef __SSE__
+/*
+ * was_sent and transition_table regrouped by symbol_sent, so that the
+ * entries for next_state 0..7 are adjacent: [symbol_sent][next_state]
+ */
+static float was_sent_by_symbol[4][8];
+static int   transition_by_symbol[4][8];
+
+struct atsci_single_viterbi_by_symbol {
+  atsci_single_viterbi_by_symbol()
+  {
+    for (int ns = 0; ns < 8; ns++)
+      for (int s = 0; s < 4; s++){
+	was_sent_by_symbol[s][ns] = atsci_single_viterbi::was_sent[ns * 4 + s];
+	transition_by_symbol[s][ns] = atsci_single_viterbi::transition_table[ns * 4 + s];
+      }
+  }
+};
+
+static atsci_single_viterbi_by_symbol s_by_symbol_init;
+
+/*
+ * Same decisions as the scalar version below: add-compare-select for
+ * four next states at a time, ties going to the lowest symbol_sent.
+ */
+char
+atsci_single_viterbi::decode(float input)
+{
+  const float *pm = path_metrics[phase];
+  const __m128 vinput = _mm_set1_ps(input);
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  float min_metric_symb[8];
+
+  for (unsigned int h = 0; h < 8; h += 4) {
+    __m128 min_metric = _mm_set1_ps(0.0f);
+    __m128 min_symb = _mm_setzero_ps();
+
+    for (unsigned int symbol_sent = 0; symbol_sent < 4; symbol_sent++) {
+      const int *tt = &transition_by_symbol[symbol_sent][h];
+      __m128 d = _mm_sub_ps(vinput, _mm_loadu_ps(&was_sent_by_symbol[symbol_sent][h]));
+      __m128 m = _mm_add_ps(_mm_andnot_ps(sign, d),	// fabs
+			    _mm_setr_ps(pm[tt[0]], pm[tt[1]], pm[tt[2]], pm[tt[3]]));
+      if (symbol_sent == 0)
+	min_metric = m;
+      else {
+	__m128 lt = _mm_cmplt_ps(m, min_metric);
+	min_metric = _mm_min_ps(m, min_metric);
+	min_symb = _mm_or_ps(_mm_and_ps(lt, _mm_set1_ps((float) symbol_sent)),
+			     _mm_andnot_ps(lt, min_symb));
+      }
+    }
+    _mm_storeu_ps(&path_metrics[phase^1][h], min_metric);
+    _mm_storeu_ps(&min_metric_symb[h], min_symb);
+  }
+
+  for (unsigned int next_state = 0; next_state < 8; next_state++) {
+    unsigned int symb = (unsigned int) min_metric_symb[next_state];
+    traceback[phase^1][next_state] = (((unsigned long long)symb) << 62) |
+      (traceback[phase][transition_by_symbol[symb][next_state]] >> 2);
+  }
+
+  return finish_decode();
+}
+
+#else
+
 char
 atsci_single_viterbi::decode(float input)
 {
@@ -83,6 +153,15 @@ atsci_single_viterbi::decode(float input)
     traceback[phase^1][next_state] = (((unsigned long long)min_metric_symb) << 62) |
       (traceback[phase][transition_table[index+min_metric_symb]] >> 2);
   }
+  return finish_decode();
+}
+
+#endif
+
+// pick the best state, renormalize, and emit its oldest dibit
+char
+atsci_single_viterbi::finish_decode()
+{
   unsigned int best_state = 0;
   float best_state_metric = path_metrics[phase^1][0];
   for (unsigned int state = 1; state < 8; state++)
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -46,6 +46,10 @@ public:
   int delay () { return TB_LEN - 1; }
 
 protected:
+  friend struct atsci_single_viterbi_by_symbol;
+
+  char finish_decode ();
+
   static const int transition_table[32];
   static const float was_sent[32];
   float path_metrics [2][8];
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,6 +26,8 @@
 #include <cmath>
 #include "atsci_viterbi_mux.cc"
 #include <string.h>
+#include <algorithm>
+#include <boost/bind.hpp>
 
 
 /* How many separate Trellis encoders / Viterbi decoders run in parallel */
@@ -36,7 +38,8 @@ static const float	DSEG_SYNC_SYM2 = -5;
 static const float	DSEG_SYNC_SYM3 = -5;
 static const float	DSEG_SYNC_SYM4 =  5;
 
-atsci_viterbi_decoder::atsci_viterbi_decoder ()
+atsci_viterbi_decoder::atsci_viterbi_decoder (int nthreads)
+  : d_generation (0), d_pending (0), d_shutdown (false), d_out (0), d_in (0)
 {
   debug = true;
 
@@ -56,14 +59,55 @@ atsci_viterbi_decoder::atsci_viterbi_decoder ()
     fifo[i] = new fifo_t(fifo_size);
 
   reset ();
+
+  if (nthreads <= 0)
+    nthreads = boost::thread::hardware_concurrency ();
+  d_nthreads = std::max (1, std::min (nthreads, NCODERS));
+
+  for (int t = 1; t < d_nthreads; t++)
+    d_threads.create_thread (boost::bind (&atsci_viterbi_decoder::worker, this, t));
 }
 
 atsci_viterbi_decoder::~atsci_viterbi_decoder ()
 {
+  {
+    gruel::scoped_lock guard (d_mutex);
+    d_shutdown = true;
+    d_start.notify_all ();
+  }
+  d_threads.join_all ();
+
   for (int i = 0; i < NCODERS; i++)
     delete fifo[i];
 }
 
+void
+atsci_viterbi_decoder::worker (int t)
+{
+  unsigned long seen = 0;
+
+  while (1){
+    unsigned char *out;
+    const float *in;
+    {
+      gruel::scoped_lock guard (d_mutex);
+      while (d_generation == seen && !d_shutdown)
+	d_start.wait (guard);
+      if (d_shutdown)
+	return;
+      seen = d_generation;
+      out = d_out;
+      in = d_in;
+    }
+
+    decode_encoders (t, out, in);
+
+    gruel::scoped_lock guard (d_mutex);
+    if (--d_pending == 0)
+      d_done.notify_one ();
+  }
+}
+
 void
 atsci_viterbi_decoder::reset ()
 {
@@ -110,14 +154,7 @@ void
 atsci_viterbi_decoder::decode_helper (unsigned char out[OUTPUT_SIZE],
 				     const float symbols_in[INPUT_SIZE])
 {
-  int encoder;
   unsigned int i;
-  int dbi;
-  int dbwhere;
-  int dbindex;
-  int shift;
-  unsigned char dibit;
-  float symbol;
 
   /* Memset is not necessary if it's all working... */
   memset (out, 0, OUTPUT_SIZE);
@@ -150,10 +187,46 @@ atsci_viterbi_decoder::decode_helper (unsigned char out[OUTPUT_SIZE],
 #undef VERBOSE
 
   // printf ("@@@ DIBITS @@@\n");
-  
-  /* Now run each of the 12 Trellis encoders over their subset of
-     the input symbols */
-  for (encoder = 0; encoder < NCODERS; encoder++) {
+
+  if (d_nthreads == 1){
+    decode_encoders (0, out, symbols_in);
+    return;
+  }
+
+  /* The encoders write disjoint sets of output bytes, so the workers
+     can share out without further locking. */
+  {
+    gruel::scoped_lock guard (d_mutex);
+    d_out = out;
+    d_in = symbols_in;
+    d_pending = d_nthreads - 1;
+    d_generation++;
+    d_start.notify_all ();
+  }
+
+  decode_encoders (0, out, symbols_in);
+
+  gruel::scoped_lock guard (d_mutex);
+  while (d_pending > 0)
+    d_done.wait (guard);
+}
+
+void
+atsci_viterbi_decoder::decode_encoders (int t, unsigned char out[OUTPUT_SIZE],
+					const float symbols_in[INPUT_SIZE])
+{
+  int encoder;
+  unsigned int i;
+  int dbi;
+  int dbwhere;
+  int dbindex;
+  int shift;
+  unsigned char dibit;
+  float symbol;
+
+  /* Now run this thread's share of the 12 Trellis encoders over
+     their subset of the input symbols */
+  for (encoder = t; encoder < NCODERS; encoder += d_nthreads) {
     dbi = 0;			/* Reinitialize dibit index for new encoder */
     fifo_t	*dibit_fifo = fifo[encoder];
     
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,6 +27,8 @@
 
 #include <atsc_types.h>
 #include <interleaver_fifo.h>
+#include <gruel/thread.h>
+#include <gruel/thread_group.h>
 
 #if (USE_SIMPLE_SLICER)
 #include <atsci_fake_single_viterbi.h>
@@ -44,7 +46,12 @@ class atsci_viterbi_decoder {
 public:
   static const int	NCODERS = 12;
 
-  atsci_viterbi_decoder ();
+  /*!
+   * The 12 decoders are independent; they are spread over \p nthreads
+   * threads (the caller's included).  0 means one per CPU, up to 12.
+   * Results do not depend on the number of threads.
+   */
+  atsci_viterbi_decoder (int nthreads = 0);
   ~atsci_viterbi_decoder ();
 
   //! reset all decoder states
@@ -71,11 +78,28 @@ public:
   void decode_helper (unsigned char out[OUTPUT_SIZE],
 		      const float in[INPUT_SIZE]);
 
+  //! run the encoders assigned to thread \p t (encoder % nthreads == t)
+  void decode_encoders (int t, unsigned char out[OUTPUT_SIZE],
+			const float in[INPUT_SIZE]);
+
+  void worker (int t);
+
   
   single_viterbi_t	viterbi[NCODERS];
   fifo_t		*fifo[NCODERS];	
   bool			debug;
 
+  int				d_nthreads;
+  gruel::thread_group		d_threads;
+  gruel::mutex			d_mutex;
+  gruel::condition_variable	d_start;	// new work or shutdown
+  gruel::condition_variable	d_done;		// d_pending dropped to 0
+  unsigned long			d_generation;
+  int				d_pending;
+  bool				d_shutdown;
+  unsigned char			*d_out;
+  const float			*d_in;
+
 };
 
 
@@ -0,0 +1,112 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Time atsci_reed_solomon::decode on a clean packet set, and on noisy
+ * sets where a given fraction of the packets carry errors (a mix of
+ * correctable and uncorrectable ones).
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <atsci_reed_solomon.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <sys/time.h>
+
+static const int NPACKETS = 4096;
+static const int NROOTS = 20;
+static const double ATSC_PAYLOAD_RATE = 19.39e6;
+
+static double
+now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+static void
+make_packets(atsci_reed_solomon &rs, double noisy,
+	     std::vector<atsc_mpeg_packet_rs_encoded> &enc)
+{
+  atsc_mpeg_packet_no_sync in;
+
+  srandom(1);
+  enc.resize(NPACKETS);
+  for (int i = 0; i < NPACKETS; i++){
+    for (int j = 0; j < ATSC_MPEG_DATA_LENGTH; j++)
+      in.data[j] = random() & 0xff;
+    rs.encode(enc[i], in);
+
+    if ((double) random() / RAND_MAX < noisy){
+      int errors = 1 + random() % (NROOTS/2 + 4);	// some uncorrectable
+      for (int j = 0; j < errors; j++)
+	enc[i].data[random() % ATSC_MPEG_RS_ENCODED_LENGTH] ^= 1 + random() % 255;
+    }
+  }
+}
+
+static void
+benchmark(const char *name, double noisy, int npasses)
+{
+  atsci_reed_solomon rs;
+  std::vector<atsc_mpeg_packet_rs_encoded> enc;
+  std::vector<atsc_mpeg_packet_no_sync> out(NPACKETS);
+  std::vector<int> ncorrections(NPACKETS);
+
+  make_packets(rs, noisy, enc);
+
+  int nfailed = 0;
+  double t0 = now();
+  for (int p = 0; p < npasses; p++)
+    for (int i = 0; i < NPACKETS; i++)
+      if (rs.decode(out[i], enc[i]) < 0)
+	nfailed++;
+  double t_single = now() - t0;
+
+  t0 = now();
+  for (int p = 0; p < npasses; p++)
+    rs.decode(&out[0], &enc[0], NPACKETS, &ncorrections[0]);
+  double t_batch = now() - t0;
+
+  double bits = (double) npasses * NPACKETS * ATSC_MPEG_DATA_LENGTH * 8;
+  printf("%-12s  decode %9.1f Mb/s   batch %9.1f Mb/s   (%.1f%% uncorrectable)\n",
+	 name, bits / t_single * 1e-6, bits / t_batch * 1e-6,
+	 100.0 * nfailed / ((double) npasses * NPACKETS));
+}
+
+int
+main(int argc, char **argv)
+{
+  int npasses = argc > 1 ? atoi(argv[1]) : 20;
+
+  printf("%d packets x %d passes, real time is %.2f Mb/s\n",
+	 NPACKETS, npasses, ATSC_PAYLOAD_RATE * 1e-6);
+  benchmark("clean", 0.0, npasses);
+  benchmark("1% noisy", 0.01, npasses);
+  benchmark("10% noisy", 0.10, npasses);
+  benchmark("all noisy", 1.0, npasses);
+  return 0;
+}
@@ -0,0 +1,195 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Time atsci_viterbi_decoder on one ATSC field with 1 .. N threads.
+ *
+ * The field is read from a capture of atsc_soft_data_segment records
+ * (e.g. the output of atsc_ds_to_softds written with gr.file_sink), or
+ * else synthesized by trellis encoding random packets and adding noise.
+ * The decoded output of every thread count must match the 1-thread run.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <atsci_viterbi_decoder.h>
+#include <atsci_trellis_encoder.h>
+#include <gruel/thread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/time.h>
+#include <unistd.h>
+
+static const int NCODERS = atsci_viterbi_decoder::NCODERS;
+static const int NGROUPS = ATSC_DSEGS_PER_FIELD / NCODERS;	// 26
+static const double ATSC_PAYLOAD_RATE = 19.39e6;
+
+static double
+now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+static bool
+read_capture(const char *filename, std::vector<atsc_soft_data_segment> &field)
+{
+  FILE *fp = fopen(filename, "rb");
+  if (fp == 0){
+    perror(filename);
+    return false;
+  }
+
+  atsc_soft_data_segment seg;
+  while (field.size() < (size_t) ATSC_DSEGS_PER_FIELD
+	 && fread(&seg, sizeof(seg), 1, fp) == 1){
+    if (field.empty() && seg.pli.segno() % NCODERS != 0)
+      continue;					// align to the encoder mux
+    field.push_back(seg);
+  }
+  fclose(fp);
+
+  field.resize(field.size() / NCODERS * NCODERS);
+  if (field.empty()){
+    fprintf(stderr, "%s: no aligned segments\n", filename);
+    return false;
+  }
+  return true;
+}
+
+static void
+synthesize(std::vector<atsc_soft_data_segment> &field, float noise)
+{
+  atsci_trellis_encoder		enc;
+  atsc_mpeg_packet_rs_encoded	in[NCODERS];
+  atsc_data_segment		out[NCODERS];
+
+  srandom(1);
+  field.resize(ATSC_DSEGS_PER_FIELD);
+  for (int g = 0; g < NGROUPS; g++){
+    for (int i = 0; i < NCODERS; i++){
+      for (int j = 0; j < ATSC_MPEG_RS_ENCODED_LENGTH; j++)
+	in[i].data[j] = (random() >> 8) & 0xff;
+      in[i].pli.set_regular_seg(false, g * NCODERS + i);
+    }
+    enc.encode(out, in);
+
+    for (int i = 0; i < NCODERS; i++){
+      atsc_soft_data_segment &s = field[g * NCODERS + i];
+      s.pli = out[i].pli;
+      for (int j = 0; j < ATSC_DATA_SEGMENT_LENGTH; j++)
+	s.data[j] = out[i].data[j] * 2 - 7
+	  + noise * ((float) random() / RAND_MAX - 0.5f);
+    }
+  }
+}
+
+static double
+run(int nthreads, int nfields, const std::vector<atsc_soft_data_segment> &field,
+    std::vector<atsc_mpeg_packet_rs_encoded> &out)
+{
+  atsci_viterbi_decoder viterbi(nthreads);
+  int ngroups = field.size() / NCODERS;
+
+  out.resize(field.size());
+  double t0 = now();
+  for (int f = 0; f < nfields; f++)
+    for (int g = 0; g < ngroups; g++)
+      viterbi.decode(&out[g * NCODERS], &field[g * NCODERS]);
+  return now() - t0;
+}
+
+static void
+usage(const char *name)
+{
+  fprintf(stderr,
+	  "usage: %s [-f nfields] [-t max_threads] [-s noise] [-w file] [capture]\n"
+	  "  capture is a file of atsc_soft_data_segment records; without\n"
+	  "  one a field is synthesized (and written to file with -w)\n",
+	  name);
+  exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+  int nfields = 20;
+  int max_threads = boost::thread::hardware_concurrency();
+  float noise = 2.0;
+  const char *write_to = 0;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "f:t:s:w:")) != -1){
+    switch (ch){
+    case 'f': nfields = atoi(optarg); break;
+    case 't': max_threads = atoi(optarg); break;
+    case 's': noise = atof(optarg); break;
+    case 'w': write_to = optarg; break;
+    default: usage(argv[0]);
+    }
+  }
+  if (max_threads < 1)
+    max_threads = 1;
+  if (max_threads > NCODERS)
+    max_threads = NCODERS;
+
+  std::vector<atsc_soft_data_segment> field;
+  if (optind < argc){
+    if (!read_capture(argv[optind], field))
+      return 1;
+  }
+  else {
+    synthesize(field, noise);
+    if (write_to){
+      FILE *fp = fopen(write_to, "wb");
+      if (fp == 0 || fwrite(&field[0], sizeof(field[0]), field.size(), fp) != field.size()){
+	perror(write_to);
+	return 1;
+      }
+      fclose(fp);
+    }
+  }
+
+  double bits = (double) nfields * field.size() * ATSC_MPEG_DATA_LENGTH * 8;
+  printf("%d segments x %d passes, real time is %.2f Mb/s\n",
+	 (int) field.size(), nfields, ATSC_PAYLOAD_RATE * 1e-6);
+
+  std::vector<atsc_mpeg_packet_rs_encoded> ref, out;
+  for (int n = 1; n <= max_threads; n++){
+    double t = run(n, nfields, field, n == 1 ? ref : out);
+    bool ok = true;
+    if (n > 1)
+      for (size_t i = 0; i < ref.size(); i++)
+	if (ref[i] != out[i])
+	  ok = false;
+    printf("%2d threads: %8.2f Mb/s  (%5.2fx real time)%s\n",
+	   n, bits / t * 1e-6, bits / t / ATSC_PAYLOAD_RATE,
+	   ok ? "" : "  MISMATCH");
+    if (!ok)
+      return 1;
+  }
+  return 0;
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -113,3 +113,38 @@ qa_atsci_reed_solomon::t0_reed_solomon ()
 
   CPPUNIT_ASSERT (decoder_errors == 0);
 }
+
+void
+qa_atsci_reed_solomon::t1_batch ()
+{
+  static const int NPACKETS = 64;
+  atsc_mpeg_packet_no_sync	in;
+  atsc_mpeg_packet_rs_encoded  	enc[NPACKETS];
+  atsc_mpeg_packet_no_sync	out[NPACKETS];
+  atsc_mpeg_packet_no_sync	expected;
+  int				ncorrections[NPACKETS];
+  int				nfailed = 0;
+
+  // a mix of clean, correctable and uncorrectable packets
+  for (int i = 0; i < NPACKETS; i++){
+    for (int j = 0; j < ATSC_MPEG_DATA_LENGTH; j++)
+      in.data[j] = random () & 0xff;
+    rs.encode (enc[i], in);
+
+    int errors = (i % 4 == 0) ? 0 : random () % (NROOTS + 1);
+    for (int j = 0; j < errors; j++)
+      enc[i].data[random () % NN] ^= 1 + random () % 255;
+  }
+
+  nfailed = rs.decode (out, enc, NPACKETS, ncorrections);
+
+  int n = 0;
+  for (int i = 0; i < NPACKETS; i++){
+    int derrors = rs.decode (expected, enc[i]);
+    CPPUNIT_ASSERT_EQUAL (derrors, ncorrections[i]);
+    CPPUNIT_ASSERT (expected == out[i]);
+    if (derrors < 0)
+      n++;
+  }
+  CPPUNIT_ASSERT_EQUAL (n, nfailed);
+}
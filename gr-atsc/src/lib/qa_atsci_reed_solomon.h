@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2002 Free Software Foundation, Inc.
+ * Copyright 2002,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -32,12 +32,14 @@ class qa_atsci_reed_solomon : public CppUnit::TestCase {
 
   CPPUNIT_TEST_SUITE (qa_atsci_reed_solomon);
   CPPUNIT_TEST (t0_reed_solomon);
+  CPPUNIT_TEST (t1_batch);
   CPPUNIT_TEST_SUITE_END ();
 
  private:
   atsci_reed_solomon	rs;
 
   void t0_reed_solomon ();
+  void t1_batch ();
 };
 
 #endif /* _QA_ATSC_REED_SOLOMON_H_ */
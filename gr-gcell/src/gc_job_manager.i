@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -47,13 +47,22 @@ struct gc_jm_options {
   bool enable_logging;		    // shall we log SPE events?
   uint32_t log2_nlog_entries;    	   // log2 of number of log entries (default is 12 == 4k)
   spe_program_handle_sptr program_handle;  // program to load into SPEs
+  bool use_host;		    // run jobs on host threads, not SPEs
+
+  gc_jm_options() :
+    max_jobs(0), max_client_threads(0), nspes(0),
+    gang_schedule(false), use_affinity(false),
+    enable_logging(false), log2_nlog_entries(12),
+    use_host(false)
+  {
+  }
 
   gc_jm_options(spe_program_handle_sptr program_handle_,
 		unsigned int nspes_ = 0) :
     max_jobs(0), max_client_threads(0), nspes(nspes_),
     gang_schedule(false), use_affinity(false),
     enable_logging(false), log2_nlog_entries(12),
-    program_handle(program_handle_)
+    program_handle(program_handle_), use_host(false)
   {
   }
 };
@@ -0,0 +1,72 @@
+#!/usr/bin/env python
+#
+# Copyright 2010 Free Software Foundation, Inc.
+# 
+# This file is part of GNU Radio
+# 
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+"""
+Compare the time taken to decode a synthetic multichannel FLEX signal
+with pager.flex_multichannel against one pager.flex_demod per channel.
+"""
+
+from gnuradio import gr, pager
+from gnuradio.eng_option import eng_option
+from optparse import OptionParser
+import time
+
+def run(options, multi):
+    pages = [[(1000+i, "Channel %d page" % (i,))] for i in range(options.channels)]
+    freqs = [929.0e6+i*25e3 for i in range(options.channels)]
+    queue = gr.msg_queue()
+
+    tb = gr.top_block()
+    src = pager.flex_multichannel_source(pages, repeat=True)
+    head = gr.head(gr.sizeof_gr_complex*options.channels, options.nsamples)
+    tb.connect(src, head)
+
+    if multi:
+        tb.connect(head, pager.flex_multichannel(queue, freqs))
+    else:
+        v2s = gr.vector_to_streams(gr.sizeof_gr_complex, options.channels)
+        tb.connect(head, v2s)
+        for i in range(options.channels):
+            tb.connect((v2s, i), pager.flex_demod(queue, freqs[i]))
+
+    start = time.time()
+    tb.run()
+    delta = time.time()-start
+
+    print "%-18s %8.3f s  %10.0f channel samples/s  %4d pages" % \
+        (("flex_demod x %d" % (options.channels,), "flex_multichannel")[multi],
+         delta, options.nsamples*options.channels/delta, queue.count())
+
+def main():
+    parser = OptionParser(option_class=eng_option)
+    parser.add_option("-c", "--channels", type="int", default=64,
+                      help="set number of channels [default=%default]")
+    parser.add_option("-N", "--nsamples", type="eng_float", default=250e3,
+                      help="set number of samples per channel [default=%default]")
+    (options, args) = parser.parse_args()
+    options.nsamples = int(options.nsamples)
+
+    run(options, False)
+    run(options, True)
+
+if __name__ == "__main__":
+    main()
@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 #
-# Copyright 2006,2007,2009 Free Software Foundation, Inc.
+# Copyright 2006,2007,2009,2010 Free Software Foundation, Inc.
 # 
 # This file is part of GNU Radio
 # 
@@ -62,6 +62,10 @@ class app_top_block(gr.top_block):
             src_sink = gr.file_sink(gr.sizeof_gr_complex, 'usrp.dat')
             self.connect(src, src_sink)
 
+        # In-band channels are decoded together by flex_multichannel,
+        # unless logging, which needs the per-channel flex_demod taps.
+        chans = []
+        freqs = []
         for i in range(128):
 	    if i < 64:
 		freq = 930.5e6+i*25e3
@@ -70,10 +74,18 @@ class app_top_block(gr.top_block):
 
 	    if (freq < 929.0e6 or freq > 932.0e6):
                 self.connect((bank, i), gr.null_sink(gr.sizeof_gr_complex))
-	    else:
+	    elif options.log:
             	self.connect((bank, i), pager.flex_demod(queue, freq, options.verbose, options.log))
-                if options.log:
-                    self.connect((bank, i), gr.file_sink(gr.sizeof_gr_complex, 'chan_'+'%3.3f'%(freq/1e6)+'.dat'))
+                self.connect((bank, i), gr.file_sink(gr.sizeof_gr_complex, 'chan_'+'%3.3f'%(freq/1e6)+'.dat'))
+	    else:
+                chans.append(i)
+                freqs.append(freq)
+
+        if len(chans) > 0:
+            s2v = gr.streams_to_vector(gr.sizeof_gr_complex, len(chans))
+            for (k, i) in enumerate(chans):
+                self.connect((bank, i), (s2v, k))
+            self.connect(s2v, pager.flex_multichannel(queue, freqs))
 
 def main():
     parser = OptionParser(option_class=eng_option)
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -41,9 +41,6 @@ private:
     friend pager_flex_deinterleave_sptr pager_make_flex_deinterleave();
     pager_flex_deinterleave();
 
-    // One FLEX block of deinterleaved data
-    gr_int32 d_codewords[8];
-   
 public:
 
     int work(int noutput_items,
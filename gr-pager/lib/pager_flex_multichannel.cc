@@ -0,0 +1,171 @@
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pager_flex_multichannel.h>
+#include <pageri_util.h>
+#include <gr_io_signature.h>
+#include <gr_firdes.h>
+#include <gr_math.h>
+#include <stdexcept>
+#include <cmath>
+
+pager_flex_multichannel_sptr pager_make_flex_multichannel(gr_msg_queue_sptr queue,
+                                                          const std::vector<float> &freqs)
+{
+    return pager_flex_multichannel_sptr(new pager_flex_multichannel(queue, freqs));
+}
+
+pager_flex_multichannel::pager_flex_multichannel(gr_msg_queue_sptr queue,
+                                                 const std::vector<float> &freqs) :
+    gr_sync_block("flex_multichannel",
+    gr_make_io_signature(1, 1, sizeof(gr_complex)*freqs.size()),
+    gr_make_io_signature(0, 0, 0)),
+    d_nchan(freqs.size()),
+    d_prev(freqs.size()),
+    d_hist_pos(0),
+    d_phase(0),
+    d_resamp(freqs.size()),
+    d_avg(freqs.size()),
+    d_sync(freqs.size()),
+    d_bits(freqs.size()*4*BLOCK_BITS),
+    d_nbits(freqs.size())
+{
+    if (d_nchan < 1)
+        throw std::invalid_argument("pager_flex_multichannel: need at least one channel");
+
+    // Same as pager.flex_demod
+    d_gain = 25000/(2*M_PI*1600);	  // 4800 Hz max deviation
+    d_alpha = 5e-6;			  // DC removal averaging filter constant
+    d_beta = 1.0-d_alpha;
+
+    // Same taps as blks2.rational_resampler_fff(16, 25), split into
+    // INTERP phases.  Phase p computes sum(taps[p+INTERP*i]*x[n-i]).
+    std::vector<float> taps = gr_firdes::low_pass(INTERP, 1,
+                                                  0.45/INTERP, 0.1/INTERP,
+                                                  gr_firdes::WIN_KAISER, 5.0);
+    d_ntaps = (taps.size() + INTERP - 1)/INTERP;
+    d_taps.resize(INTERP*d_ntaps);
+    for (int p = 0; p < INTERP; p++)
+        for (int i = 0; i < d_ntaps; i++) {
+            unsigned int k = p + INTERP*i;
+            d_taps[p*d_ntaps + d_ntaps-1-i] = k < taps.size() ? taps[k] : 0;
+        }
+    d_hist.resize(2*d_ntaps*d_nchan);
+
+    for (int i = 0; i < d_nchan; i++)
+        for (int k = 0; k < 4; k++)
+            d_parse.push_back(boost::shared_ptr<pageri_flex_parse>(
+                                  new pageri_flex_parse(queue, freqs[i])));
+}
+
+// Compute one resampler output for every channel, using the taps for
+// the current phase.
+void pager_flex_multichannel::resample()
+{
+    const float *taps = &d_taps[d_phase*d_ntaps];
+    const float *hist = &d_hist[(d_hist_pos+1)*d_nchan]; // oldest first
+    float *acc = &d_resamp[0];
+
+    for (int c = 0; c < d_nchan; c++)
+        acc[c] = 0;
+
+    for (int i = 0; i < d_ntaps; i++) {
+        float t = taps[i];
+        for (int c = 0; c < d_nchan; c++)
+            acc[c] += t*hist[c];
+        hist += d_nchan;
+    }
+}
+
+// Slice one 16 ksps sample of channel chan and run it through sync,
+// deinterleave and parse.
+void pager_flex_multichannel::symbol(int chan, float sample)
+{
+    // Same as pager_slicer_fb
+    d_avg[chan] = d_avg[chan]*d_beta+sample*d_alpha;
+    sample -= d_avg[chan];
+
+    unsigned char sym;
+    if (sample > 0)
+        sym = sample > 2.0 ? 3 : 2;
+    else
+        sym = sample < -2.0 ? 0 : 1;
+
+    unsigned char *bits = &d_bits[chan*4*BLOCK_BITS];
+    int nbits = d_nbits[chan];
+    unsigned char *out[4];
+    for (int k = 0; k < 4; k++)
+        out[k] = &bits[k*BLOCK_BITS + nbits];
+
+    if (!d_sync[chan].process(sym, out))
+        return;
+
+    if (++nbits < BLOCK_BITS) {
+        d_nbits[chan] = nbits;
+        return;
+    }
+
+    // A whole FLEX block on each phase
+    for (int k = 0; k < 4; k++) {
+        gr_int32 datawords[8];
+        pageri_flex_deinterleave(&bits[k*BLOCK_BITS], datawords);
+        for (int j = 0; j < 8; j++)
+            d_parse[chan*4 + k]->put(datawords[j]);
+    }
+    d_nbits[chan] = 0;
+}
+
+int pager_flex_multichannel::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items)
+{
+    const gr_complex *in = (const gr_complex *)input_items[0];
+
+    for (int n = 0; n < noutput_items; n++) {
+        // Quadrature demod into both copies of the resampler history
+        if (++d_hist_pos == d_ntaps)
+            d_hist_pos = 0;
+        float *h0 = &d_hist[d_hist_pos*d_nchan];
+        float *h1 = &d_hist[(d_hist_pos+d_ntaps)*d_nchan];
+
+        for (int c = 0; c < d_nchan; c++) {
+            gr_complex product = in[c]*conj(d_prev[c]);
+            d_prev[c] = in[c];
+            h0[c] = h1[c] = d_gain*gr_fast_atan2f(imag(product), real(product));
+        }
+        in += d_nchan;
+
+        // Emit the 16 ksps outputs that fall on this input sample
+        while (d_phase < INTERP) {
+            resample();
+            for (int c = 0; c < d_nchan; c++)
+                symbol(c, d_resamp[c]);
+            d_phase += DECIM;
+        }
+        d_phase -= INTERP;
+    }
+
+    return noutput_items;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_PAGER_FLEX_MULTICHANNEL_H
+#define INCLUDED_PAGER_FLEX_MULTICHANNEL_H
+
+#include <gr_sync_block.h>
+#include <gr_msg_queue.h>
+#include <pageri_flex_sync.h>
+#include <pageri_flex_parse.h>
+
+class pager_flex_multichannel;
+typedef boost::shared_ptr<pager_flex_multichannel> pager_flex_multichannel_sptr;
+
+pager_flex_multichannel_sptr pager_make_flex_multichannel(gr_msg_queue_sptr queue,
+                                                          const std::vector<float> &freqs);
+
+/*!
+ * \brief FLEX receiver for many channels at once
+ * \ingroup pager_blk
+ *
+ * Input is a vector of freqs.size() complex samples per item, one per
+ * FLEX channel at 25 ksps, e.g. the channelized output of a polyphase
+ * filterbank.  For every channel this does the work of pager.flex_demod:
+ * quadrature demod, 25 to 16 ksps resampling, slicing, sync, deinterleave
+ * and parse.  Pages are sent to the queue as by pager_flex_parse, with
+ * freqs[i] as the frequency of channel i.
+ *
+ * The per-channel state is kept in arrays indexed by channel, so that
+ * the demodulator and resampler loops run across all the channels.
+ */
+class pager_flex_multichannel : public gr_sync_block
+{
+private:
+    // Constructors
+    friend pager_flex_multichannel_sptr pager_make_flex_multichannel(gr_msg_queue_sptr queue,
+                                                                     const std::vector<float> &freqs);
+    pager_flex_multichannel(gr_msg_queue_sptr queue, const std::vector<float> &freqs);
+
+    enum { INTERP = 16, DECIM = 25 };	  // 25 ksps -> 16 ksps
+    enum { BLOCK_BITS = 256 };		  // One FLEX block per phase
+
+    int d_nchan;
+
+    // Quadrature demodulator
+    float d_gain;
+    std::vector<gr_complex> d_prev;	  // [nchan] previous input sample
+
+    // Rational resampler.  The phase and history position are the
+    // same for all channels.
+    int d_ntaps;			  // Taps per phase
+    std::vector<float> d_taps;		  // [INTERP][d_ntaps] oldest sample first
+    std::vector<float> d_hist;		  // [2*d_ntaps][nchan] stored twice
+    int d_hist_pos;
+    int d_phase;
+    std::vector<float> d_resamp;	  // [nchan] resampler output
+
+    // Slicer
+    float d_alpha;			  // DC removal time constant
+    float d_beta;			  // 1.0-d_alpha
+    std::vector<float> d_avg;		  // [nchan] DC offset
+
+    // Sync, deinterleave and parse
+    std::vector<pageri_flex_sync> d_sync; // [nchan]
+    std::vector<unsigned char> d_bits;	  // [nchan][4][BLOCK_BITS]
+    std::vector<int> d_nbits;		  // [nchan] bits in d_bits
+    std::vector<boost::shared_ptr<pageri_flex_parse> > d_parse; // [nchan][4]
+
+    void resample();
+    void symbol(int chan, float sample);
+
+public:
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items, 
+             gr_vector_void_star &output_items);
+
+    int nchan() const { return d_nchan; }
+    float dc_offset(int chan) const { return d_avg[chan]; }
+};
+
+#endif /* INCLUDED_PAGER_FLEX_MULTICHANNEL_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,16 +24,13 @@
 
 #include <gr_sync_block.h>
 #include <gr_msg_queue.h>
-#include <pageri_flex_modes.h>
-#include <sstream>
+#include <pageri_flex_parse.h>
 
 class pager_flex_parse;
 typedef boost::shared_ptr<pager_flex_parse> pager_flex_parse_sptr;
 
 pager_flex_parse_sptr pager_make_flex_parse(gr_msg_queue_sptr queue, float freq);
 
-#define FIELD_DELIM ((unsigned char)128)
-
 /*!
  * \brief flex parse description
  * \ingroup pager_blk
@@ -45,24 +42,8 @@ private:
     friend pager_flex_parse_sptr pager_make_flex_parse(gr_msg_queue_sptr queue, float freq);
     pager_flex_parse(gr_msg_queue_sptr queue, float freq);
 
-    std::ostringstream d_payload;
-    gr_msg_queue_sptr d_queue;		  // Destination for decoded pages
-
-    int d_count;	                  // Count of received codewords
-    gr_int32 d_datawords[88];             // 11 blocks of 8 32-bit words
+    pageri_flex_parse d_parser;		  // The parser proper
 
-    page_type_t d_type;		  	  // Current page type
-    int d_capcode;	                  // Current page destination address
-    bool d_laddr;	                  // Current page has long address
-    float d_freq;			  // Channel frequency
-    
-    void parse_data();	      		  // Handle a frame's worth of data
-    void parse_capcode(gr_int32 aw1, gr_int32 aw2);     
-    void parse_alphanumeric(int mw1, int mw2, int j);
-    void parse_numeric(int mw1, int mw2, int j);
-    void parse_tone_only();
-    void parse_unknown(int mw1, int mw2);
-    
 public:
     int work(int noutput_items,
         gr_vector_const_void_star &input_items, 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -23,10 +23,10 @@
 #define INCLUDED_PAGER_FLEX_SYNC_H
 
 #include <gr_block.h>
+#include <pageri_flex_sync.h>
 
 class pager_flex_sync;
 typedef boost::shared_ptr<pager_flex_sync> pager_flex_sync_sptr;
-typedef std::vector<gr_int64> gr_int64_vector;
 
 pager_flex_sync_sptr pager_make_flex_sync();
 
@@ -42,51 +42,7 @@ private:
     friend pager_flex_sync_sptr pager_make_flex_sync();
     pager_flex_sync();
    
-    // State machine transitions
-    void enter_idle();
-    void enter_syncing();
-    void enter_sync1();
-    void enter_sync2();
-    void enter_data();
-
-    int index_avg(int start, int end);
-    bool test_sync(unsigned char sym);
-    void parse_fiw();
-    int output_symbol(unsigned char sym);    
-    
-    // Simple state machine
-    enum state_t { ST_IDLE, ST_SYNCING, ST_SYNC1, ST_SYNC2, ST_DATA };
-    state_t d_state;     
-
-    int d_index;    // Index into current baud
-    int d_start;    // Start of good sync 
-    int d_center;   // Center of bit
-    int d_end;      // End of good sync
-    int d_count;    // Bit counter
-
-    int d_mode;     // Current packet mode
-    int d_baudrate; // Current decoding baud rate
-    int d_levels;   // Current decoding levels
-    int d_spb;      // Current samples per baud
-    bool d_hibit;   // Alternating bit indicator for 3200 bps
-    
-    gr_int32 d_fiw; // Frame information word
-    int d_frame;    // Current FLEX frame
-    int d_cycle;    // Current FLEX cycle
-    int d_unknown1;
-    int d_unknown2;
-
-    unsigned char d_bit_a;
-    unsigned char d_bit_b;
-    unsigned char d_bit_c;
-    unsigned char d_bit_d;
-    
-    unsigned char *d_phase_a;  
-    unsigned char *d_phase_b;
-    unsigned char *d_phase_c;
-    unsigned char *d_phase_d;
-    
-    gr_int64_vector d_sync; // Trial synchronizers
+    pageri_flex_sync d_sync; // The state machine proper
 
 public:
     void forecast(int noutput_items, gr_vector_int &inputs_required);
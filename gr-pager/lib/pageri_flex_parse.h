@@ -0,0 +1,73 @@
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_PAGERI_FLEX_PARSE_H
+#define INCLUDED_PAGERI_FLEX_PARSE_H
+
+#include <gr_msg_queue.h>
+#include <pageri_flex_modes.h>
+#include <sstream>
+
+#define FIELD_DELIM ((unsigned char)128)
+
+/*!
+ * \brief Parses the data words of one FLEX phase into pages
+ *
+ * Each decoded page is sent to the queue as a message whose text is
+ * frequency, capcode, page type and body, separated by FIELD_DELIM.
+ * Used by pager_flex_parse and pager_flex_multichannel.
+ */
+class pageri_flex_parse
+{
+private:
+    std::ostringstream d_payload;
+    gr_msg_queue_sptr d_queue;		  // Destination for decoded pages
+
+    int d_count;	                  // Count of received codewords
+    gr_int32 d_datawords[88];             // 11 blocks of 8 32-bit words
+
+    page_type_t d_type;		  	  // Current page type
+    int d_capcode;	                  // Current page destination address
+    bool d_laddr;	                  // Current page has long address
+    float d_freq;			  // Channel frequency
+    
+    void parse_data();	      		  // Handle a frame's worth of data
+    void parse_capcode(gr_int32 aw1, gr_int32 aw2);     
+    void parse_alphanumeric(int mw1, int mw2, int j);
+    void parse_numeric(int mw1, int mw2, int j);
+    void parse_tone_only();
+    void parse_unknown(int mw1, int mw2);
+    
+public:
+    pageri_flex_parse(gr_msg_queue_sptr queue, float freq);
+
+    //! Accumulate one data word, parsing each frame's worth (88 of them)
+    void put(gr_int32 dataword)
+    {
+	d_datawords[d_count] = dataword;
+	if (++d_count == 88) {
+	    parse_data();
+	    d_count = 0;
+	}
+    }
+};
+
+#endif /* INCLUDED_PAGERI_FLEX_PARSE_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006 Free Software Foundation, Inc.
+ * Copyright 2006,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,4 +27,8 @@
 unsigned char pageri_reverse_bits8(unsigned char val);
 gr_int32 pageri_reverse_bits32(gr_int32 val);
 
+// Deinterleave one FLEX block (256 bits, one per byte) into eight
+// error corrected data words
+void pageri_flex_deinterleave(const unsigned char *in, gr_int32 *out);
+
 #endif /* INCLUDED_PAGERI_UTIL_H */
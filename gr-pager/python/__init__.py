@@ -1,5 +1,5 @@
 #
-# Copyright 2006 Free Software Foundation, Inc.
+# Copyright 2006,2010 Free Software Foundation, Inc.
 # 
 # This file is part of GNU Radio
 # 
@@ -23,4 +23,5 @@
 
 from pager_swig import *
 from flex_demod import flex_demod
+from flex_gen import flex_multichannel_source
 from pager_utils import *
@@ -0,0 +1,148 @@
+#
+# Copyright 2010 Free Software Foundation, Inc.
+# 
+# This file is part of GNU Radio
+# 
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+"""
+Synthetic FLEX test signals.
+
+These build 1600 bps, 2-level FLEX frames carrying alphanumeric pages,
+for exercising the decoder without a receiver.  Only phase A is used and
+the BCH parity bits are left zero, as the decoder does not check them.
+"""
+
+from gnuradio import gr
+from math import pi
+
+FLEX_SYNC_A      = 0x870C       # 1600 bps, 2-level
+FLEX_SYNC_MARKER = 0xA6C6AAAA
+FLEX_BAUD        = 1600
+FLEX_DEVIATION   = 4800         # Hz
+FLEX_FILL        = 0x03
+
+def _word_bits(word, nbits):
+    return [(word >> (nbits-1-i)) & 1 for i in range(nbits)]
+
+def _reverse_bits32(x):
+    r = 0
+    for i in range(32):
+        r = (r << 1) | ((x >> i) & 1)
+    return r
+
+def _alphanumeric_words(text):
+    """
+    Pack text into message words, three 7-bit characters per word.  The
+    first character position of the first word is skipped by the parser.
+    """
+    chars = [FLEX_FILL] + [ord(c) & 0x7F for c in text]
+    while len(chars) % 3:
+        chars.append(FLEX_FILL)
+    return [chars[i] | (chars[i+1] << 7) | (chars[i+2] << 14)
+            for i in range(0, len(chars), 3)]
+
+def flex_datawords(capcode, text):
+    """
+    Return the 88 data words of a frame holding a single alphanumeric
+    page to the (short address) capcode.
+    """
+    if capcode < 1 or capcode > 0x1E0000-0x8000:
+        raise ValueError("capcode out of short address range")
+
+    msg = _alphanumeric_words(text)
+    if len(msg) > 88-4:
+        raise ValueError("text too long for one frame")
+
+    biw = 2 << 10                       # Vector field at word 2, address at word 1
+    addr = capcode + 0x8000
+    viw = (5 << 4) | (3 << 7) | ((len(msg)+1) << 14) # Alphanumeric, header at word 3
+    header = 3 << 11                    # Single fragment
+
+    words = [biw, addr, viw, header] + msg
+    return words + [0x1FFFFF]*(88-len(words))
+
+def flex_data_bits(datawords):
+    """
+    Convert data words to codewords and interleave them in blocks of 8,
+    the inverse of pager.flex_deinterleave.
+    """
+    bits = []
+    for b in range(0, len(datawords), 8):
+        codewords = [_reverse_bits32(dw ^ 0x1FFFFF) for dw in datawords[b:b+8]]
+        for i in range(32):
+            for cw in codewords:
+                bits.append((cw >> (31-i)) & 1)
+    return bits
+
+def flex_frame_bits(capcode, text, preamble=32):
+    """
+    Return the bits of one FLEX frame: preamble, sync, frame information
+    word, idle bits at the data rate and the 2816 data bits.
+    """
+    bits = [i & 1 for i in range(preamble)]
+    bits += _word_bits(FLEX_SYNC_A, 16)
+    bits += _word_bits(FLEX_SYNC_MARKER, 32)
+    bits += _word_bits(FLEX_SYNC_A ^ 0xFFFF, 16)
+    bits += [i & 1 for i in range(16)]  # Dotting
+    bits += [0]*32                      # Frame information word
+    bits += [1]*(FLEX_BAUD//40)         # 25 ms idle
+    bits += flex_data_bits(flex_datawords(capcode, text))
+    return bits
+
+def flex_frequencies(bits, rate):
+    """
+    Return the instantaneous frequency in Hz of each sample of the
+    2-level FSK signal for bits, sampled at rate.  A one bit is sent at
+    the lower frequency.
+    """
+    nsamples = len(bits)*rate//FLEX_BAUD
+    return [(-FLEX_DEVIATION, FLEX_DEVIATION)[bits[n*FLEX_BAUD//rate] == 0]
+            for n in range(nsamples)]
+
+class flex_multichannel_source(gr.hier_block2):
+    """
+    Synthetic multichannel FLEX signal.
+
+    Output is a vector of len(pages) complex samples per item at rate,
+    as produced by a channelizer.  pages[i] is a list of (capcode, text)
+    tuples, one FLEX frame each, sent on channel i.  Channels with fewer
+    pages are padded with idle bits.
+    """
+
+    def __init__(self, pages, rate=25000, repeat=False):
+        nchan = len(pages)
+        gr.hier_block2.__init__(self, "flex_multichannel_source",
+                                gr.io_signature(0, 0, 0),
+                                gr.io_signature(1, 1, gr.sizeof_gr_complex*nchan))
+
+        chan_bits = []
+        for chan_pages in pages:
+            bits = []
+            for (capcode, text) in chan_pages:
+                bits += flex_frame_bits(capcode, text)
+            chan_bits.append(bits)
+
+        nbits = max([len(bits) for bits in chan_bits]) + FLEX_BAUD//10
+        s2v = gr.streams_to_vector(gr.sizeof_gr_complex, nchan)
+        for i in range(nchan):
+            bits = chan_bits[i] + [1]*(nbits-len(chan_bits[i]))
+            src = gr.vector_source_f(flex_frequencies(bits, rate), repeat)
+            fm = gr.frequency_modulator_fc(2*pi/rate)
+            self.connect(src, fm, (s2v, i))
+
+        self.connect(s2v, self)
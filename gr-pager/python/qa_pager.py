@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 #
-# Copyright 2004,2006 Free Software Foundation, Inc.
+# Copyright 2004,2006,2010 Free Software Foundation, Inc.
 # 
 # This file is part of GNU Radio
 # 
@@ -22,6 +22,7 @@
 
 from gnuradio import gr, gr_unittest
 import pager_swig
+import flex_gen
 
 class qa_pgr(gr_unittest.TestCase):
 
@@ -31,5 +32,33 @@ class qa_pgr(gr_unittest.TestCase):
     def tearDown (self):
         self.tb = None
 
+    def test_flex_multichannel(self):
+        pages = [[(1234, "Hello channel zero")],
+                 [],
+                 [(99999, "The quick brown fox jumps over the lazy dog"),
+                  (42, "second frame")]]
+        freqs = [929.0e6, 929.025e6, 929.05e6]
+        expected = [(freqs[0], 1234, "Hello channel zero"),
+                    (freqs[2], 99999, "The quick brown fox jumps over the lazy dog"),
+                    (freqs[2], 42, "second frame")]
+
+        queue = gr.msg_queue()
+        src = flex_gen.flex_multichannel_source(pages)
+        dst = pager_swig.flex_multichannel(queue, freqs)
+        self.tb.connect(src, dst)
+        self.tb.run()
+
+        result = []
+        while queue.count():
+            fields = queue.delete_head().to_string().split(chr(128))
+            result.append((float(fields[0])*1e6, int(fields[1]), fields[3]))
+        result.sort()
+        expected.sort()
+
+        self.assertEqual(len(expected), len(result))
+        for (e, r) in zip(expected, result):
+            self.assertAlmostEqual(e[0], r[0], -2)
+            self.assertEqual(e[1:], r[1:])
+
 if __name__ == '__main__':
     gr_unittest.main ()
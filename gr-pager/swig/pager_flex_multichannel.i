@@ -0,0 +1,14 @@
+GR_SWIG_BLOCK_MAGIC(pager,flex_multichannel);
+
+pager_flex_multichannel_sptr pager_make_flex_multichannel(gr_msg_queue_sptr queue,
+                                                          const std::vector<float> &freqs);
+
+class pager_flex_multichannel : public gr_sync_block
+{
+private:
+    pager_flex_multichannel(gr_msg_queue_sptr queue, const std::vector<float> &freqs);
+
+public:
+    int nchan() const;
+    float dc_offset(int chan) const;
+};
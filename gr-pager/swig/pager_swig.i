@@ -1,5 +1,5 @@
 /*
- * Copyright 2005,2006,2009 Free Software Foundation, Inc.
+ * Copyright 2005,2006,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,6 +27,7 @@
 #include "pager_flex_sync.h"
 #include "pager_flex_deinterleave.h"
 #include "pager_flex_parse.h"
+#include "pager_flex_multichannel.h"
 %}
 
 %include "pager_flex_frame.i"
@@ -34,3 +35,4 @@
 %include "pager_flex_sync.i"
 %include "pager_flex_deinterleave.i"
 %include "pager_flex_parse.i"
+%include "pager_flex_multichannel.i"
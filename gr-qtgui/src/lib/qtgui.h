@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,8 @@
 #define INCLUDED_QTGUI_H
 
 #include <qapplication.h>
+#include <QTimerEvent>
+#include <algorithm>
 #include "SpectrumGUIClass.h"
 
 class qtgui_event : public QEvent
@@ -67,4 +69,61 @@ public:
   }
 };
 
+/*!
+ * \brief Something that redraws from the GUI thread on a timer
+ */
+class qtgui_renderer
+{
+public:
+  virtual ~qtgui_renderer() {}
+  virtual void render() = 0;
+};
+
+/*!
+ * \brief Calls a qtgui_renderer at a fixed rate from the GUI thread.
+ *
+ * set_rate may be called from any thread; the timer itself is only
+ * touched from the event loop.
+ */
+class qtgui_render_timer : public QObject
+{
+private:
+  qtgui_renderer *d_renderer;
+  volatile double d_rate;
+  int d_timer_id;
+
+public:
+  qtgui_render_timer(QObject *p, qtgui_renderer *renderer)
+    : QObject(p), d_renderer(renderer), d_rate(0), d_timer_id(0)
+  {
+  }
+
+  //! Render \p rate times per second, or never if \p rate is 0
+  void set_rate(double rate)
+  {
+    d_rate = rate;
+    qApp->postEvent(this, new QEvent((QEvent::Type)(QEvent::User+102)));
+  }
+
+  double rate() const { return d_rate; }
+
+  void customEvent(QEvent *e)
+  {
+    if(e->type() == (QEvent::Type)(QEvent::User+102)) {
+      if(d_timer_id) {
+	killTimer(d_timer_id);
+	d_timer_id = 0;
+      }
+      if(d_rate > 0) {
+	d_timer_id = startTimer(std::max(1, (int)(1000.0/d_rate)));
+      }
+    }
+  }
+
+  void timerEvent(QTimerEvent *e)
+  {
+    d_renderer->render();
+  }
+};
+
 #endif /* INCLUDED_QTGUI_H */
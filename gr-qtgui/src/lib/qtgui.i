@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008,2009 Free Software Foundation, Inc.
+ * Copyright 2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -69,6 +69,8 @@ public:
 			      double ymin, double ymax);
   void set_frequency_axis(double min, double max);
   void set_constellation_pen_size(int size);
+  void set_update_rate(double rate);
+  void set_fft_average(int nffts, bool max_hold=false);
 };
 
 
@@ -118,5 +120,7 @@ public:
 			      double ymin, double ymax);
   void set_frequency_axis(double min, double max);
   void set_constellation_pen_size(int size);
+  void set_update_rate(double rate);
+  void set_fft_average(int nffts, bool max_hold=false);
 };
 
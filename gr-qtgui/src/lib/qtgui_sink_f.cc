@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008,2009 Free Software Foundation, Inc.
+ * Copyright 2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -27,6 +27,8 @@
 #include <qtgui_sink_f.h>
 #include <gr_io_signature.h>
 #include <string.h>
+#include <algorithm>
+#include <cmath>
 
 #include <QTimer>
 
@@ -69,6 +71,7 @@ qtgui_sink_f::qtgui_sink_f (int fftsize, int wintype,
     d_parent(parent)
 {
   d_main_gui = NULL;
+  d_render_timer = NULL;
   pthread_mutex_init(&d_pmutex, NULL);
   lock();
 
@@ -83,14 +86,25 @@ qtgui_sink_f::qtgui_sink_f (int fftsize, int wintype,
 
   buildwindow();
 
+  d_update_rate = 0;
+  d_new_fft_average = 1;
+  d_fft_average = 0;
+  d_new_max_hold = false;
+  d_max_hold = false;
+  d_fft_batch = NULL;
+  d_nbatched = 0;
+  d_naccum = 0;
+
   initialize(use_openGL);
 }
 
 qtgui_sink_f::~qtgui_sink_f()
 {
+  delete d_render_timer;
   delete d_object;
   delete [] d_residbuf;
   delete d_fft;
+  delete d_fft_batch;
 }
 
 void
@@ -141,6 +155,7 @@ qtgui_sink_f::initialize(const bool opengl)
 				 opengl);
 
   d_object = new qtgui_obj(d_qApplication);
+  d_render_timer = new qtgui_render_timer(d_qApplication, this);
   qApp->postEvent(d_object, new qtgui_event(&d_pmutex));
 }
 
@@ -201,6 +216,36 @@ qtgui_sink_f::set_frequency_axis(double min, double max)
   d_main_gui->SetFrequencyAxis(min, max);
 }
 
+void
+qtgui_sink_f::set_update_rate(double rate)
+{
+  d_update_rate = std::max(rate, 0.0);
+  d_render_timer->set_rate(d_update_rate);
+}
+
+void
+qtgui_sink_f::set_fft_average(int nffts, bool max_hold)
+{
+  d_new_fft_average = std::max(nffts, 1);
+  d_new_max_hold = max_hold;
+}
+
+// Called from the GUI thread by d_render_timer
+void
+qtgui_sink_f::render()
+{
+  const double rate = d_update_rate;
+  const qtgui_spectrum_frame *frame = d_spectra.acquire();
+  if(frame == NULL || frame->fft.empty() || rate <= 0) {
+    return;
+  }
+
+  d_main_gui->UpdateWindow(true, &frame->fft[0], frame->fft.size(),
+			   frame->time.empty() ? NULL : &frame->time[0],
+			   frame->time.size(), NULL, 0,
+			   1.0/rate, frame->timestamp, true);
+}
+
 void
 qtgui_sink_f::fft(const float *data_in, int size)
 {
@@ -262,6 +307,116 @@ qtgui_sink_f::fftresize()
   }
 }
 
+void
+qtgui_sink_f::averagereset()
+{
+  int nffts = d_new_fft_average;
+  int batch = std::min(nffts, (int)MAX_FFT_BATCH);
+
+  if(d_fft_batch == NULL || d_fft_batch->batch() != batch ||
+     d_fft_batch->inbuf_length() != batch*d_fftsize) {
+    delete d_fft_batch;
+    d_fft_batch = new gri_fft_complex(d_fftsize, true, batch);
+    d_nbatched = 0;
+  }
+
+  if(nffts != d_fft_average || d_new_max_hold != d_max_hold ||
+     d_accum.size() != (unsigned int)d_fftsize) {
+    d_fft_average = nffts;
+    d_max_hold = d_new_max_hold;
+    d_accum.assign(d_fftsize, 0);
+    d_naccum = 0;
+  }
+}
+
+// Window one FFT's worth of input into the next slot of the batch,
+// and run the batch when it is full.
+void
+qtgui_sink_f::batch_fft(const float *data_in)
+{
+  gr_complex *dst = d_fft_batch->get_inbuf() + d_nbatched*d_fftsize;
+  if(d_window.size()) {
+    for(int i = 0; i < d_fftsize; i++)	// apply window
+      dst[i] = data_in[i] * d_window[i];
+  }
+  else {
+    for(int i = 0; i < d_fftsize; i++)	// float to complex conversion
+      dst[i] = data_in[i];
+  }
+
+  // Keep the input of the last FFT of each spectrum for the time plots
+  if((d_naccum + d_nbatched + 1) % d_fft_average == 0) {
+    std::vector<float> &time = d_spectra.back()->time;
+    time.resize(d_fftsize);
+    memcpy(&time[0], data_in, sizeof(float)*d_fftsize);
+  }
+
+  if(++d_nbatched == d_fft_batch->batch()) {
+    fold_batch();
+  }
+}
+
+// Fold the batch into d_accum, publishing a spectrum every
+// d_fft_average FFTs.
+void
+qtgui_sink_f::fold_batch()
+{
+  d_fft_batch->execute();
+
+  const gr_complex *out = d_fft_batch->get_outbuf();
+  for(int b = 0; b < d_nbatched; b++) {
+    if(d_max_hold) {
+      for(int i = 0; i < d_fftsize; i++)
+	d_accum[i] = std::max(d_accum[i], std::norm(out[i]));
+    }
+    else {
+      for(int i = 0; i < d_fftsize; i++)
+	d_accum[i] += std::norm(out[i]);
+    }
+    out += d_fftsize;
+
+    if(++d_naccum == d_fft_average) {
+      // The display wants magnitudes, it takes the power itself
+      qtgui_spectrum_frame *frame = d_spectra.back();
+      float scale = d_max_hold ? 1.0 : 1.0/d_naccum;
+      frame->fft.resize(d_fftsize);
+      for(int i = 0; i < d_fftsize; i++)
+	frame->fft[i] = gr_complex(sqrtf(d_accum[i]*scale), 0);
+      frame->timestamp = get_highres_clock();
+      d_spectra.publish();
+
+      std::fill(d_accum.begin(), d_accum.end(), 0);
+      d_naccum = 0;
+    }
+  }
+  d_nbatched = 0;
+}
+
+// FFT all complete frames of input, straight from the input buffer
+// when possible; anything left over is kept in d_residbuf.
+int
+qtgui_sink_f::decoupled_work(const float *in, int ninput)
+{
+  int j = 0;
+  while(j < ninput) {
+    if(d_index == 0 && ninput - j >= d_fftsize) {
+      batch_fft(&in[j]);
+      j += d_fftsize;
+    }
+    else {
+      int n = std::min(d_fftsize - d_index, ninput - j);
+      memcpy(d_residbuf+d_index, &in[j], sizeof(float)*n);
+      d_index += n;
+      j += n;
+
+      if(d_index == d_fftsize) {
+	d_index = 0;
+	batch_fft(d_residbuf);
+      }
+    }
+  }
+  return j;
+}
 
 int
 qtgui_sink_f::general_work (int noutput_items,
@@ -278,31 +433,37 @@ qtgui_sink_f::general_work (int noutput_items,
   fftresize();
   windowreset();
 
-  for(int i=0; i < noutput_items; i+=d_fftsize) {
-    unsigned int datasize = noutput_items - i;
-    unsigned int resid = d_fftsize-d_index;
+  if(d_update_rate > 0) {
+    averagereset();
+    j = decoupled_work(in, noutput_items);
+  }
+  else {
+    for(int i=0; i < noutput_items; i+=d_fftsize) {
+      unsigned int datasize = noutput_items - i;
+      unsigned int resid = d_fftsize-d_index;
 
-    // If we have enough input for one full FFT, do it
-    if(datasize >= resid) {
-      const timespec currentTime = get_highres_clock();
+      // If we have enough input for one full FFT, do it
+      if(datasize >= resid) {
+        const timespec currentTime = get_highres_clock();
       
-      // Fill up residbuf with d_fftsize number of items
-      memcpy(d_residbuf+d_index, &in[j], sizeof(float)*resid);
-      d_index = 0;
+        // Fill up residbuf with d_fftsize number of items
+        memcpy(d_residbuf+d_index, &in[j], sizeof(float)*resid);
+        d_index = 0;
 
-      j += resid;
-      fft(d_residbuf, d_fftsize);
+        j += resid;
+        fft(d_residbuf, d_fftsize);
       
-      d_main_gui->UpdateWindow(true, d_fft->get_outbuf(), d_fftsize,
-			       (float*)d_residbuf, d_fftsize, NULL, 0,
-			       1.0/4.0, currentTime, true);
+        d_main_gui->UpdateWindow(true, d_fft->get_outbuf(), d_fftsize,
+				 (float*)d_residbuf, d_fftsize, NULL, 0,
+				 1.0/4.0, currentTime, true);
+      }
+      // Otherwise, copy what we received into the residbuf for next time
+      else {
+        memcpy(d_residbuf+d_index, &in[j], sizeof(float)*datasize);
+        d_index += datasize;
+        j += datasize;
+      }   
     }
-    // Otherwise, copy what we received into the residbuf for next time
-    else {
-      memcpy(d_residbuf+d_index, &in[j], sizeof(float)*datasize);
-      d_index += datasize;
-      j += datasize;
-    }   
   }
 
   pthread_mutex_unlock(&d_pmutex);
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008,2009 Free Software Foundation, Inc.
+ * Copyright 2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -30,6 +30,7 @@
 #include <qtgui.h>
 #include <Python.h>
 #include "SpectrumGUIClass.h"
+#include "qtgui_spectrum_buffer.h"
 
 class qtgui_sink_f;
 typedef boost::shared_ptr<qtgui_sink_f> qtgui_sink_f_sptr;
@@ -43,7 +44,7 @@ qtgui_sink_f_sptr qtgui_make_sink_f (int fftsize, int wintype,
 				     bool use_openGL=true,
 				     QWidget *parent=NULL);
 
-class qtgui_sink_f : public gr_block
+class qtgui_sink_f : public gr_block, public qtgui_renderer
 {
 private:
   friend qtgui_sink_f_sptr qtgui_make_sink_f (int fftsize, int wintype,
@@ -87,10 +88,26 @@ private:
   QWidget *d_parent;
   SpectrumGUIClass *d_main_gui; 
 
+  // Decoupled rendering, see set_update_rate()
+  enum { MAX_FFT_BATCH = 16 };
+  volatile double d_update_rate;
+  int d_new_fft_average, d_fft_average;
+  bool d_new_max_hold, d_max_hold;
+  gri_fft_complex *d_fft_batch;		// up to MAX_FFT_BATCH FFTs at once
+  int d_nbatched;			// FFT inputs waiting in d_fft_batch
+  std::vector<float> d_accum;		// power, summed or max held
+  int d_naccum;				// FFTs folded into d_accum
+  qtgui_spectrum_buffer d_spectra;
+  qtgui_render_timer *d_render_timer;
+
   void windowreset();
   void buildwindow();
   void fftresize();
+  void averagereset();
   void fft(const float *data_in, int size);
+  void batch_fft(const float *data_in);
+  void fold_batch();
+  int decoupled_work(const float *in, int ninput);
   
 public:
   ~qtgui_sink_f();
@@ -109,6 +126,27 @@ public:
   void set_constellation_pen_size(int size);
   void set_frequency_axis(double min, double max);
 
+  /*!
+   * \brief Limit GUI updates to \p rate per second.
+   *
+   * With \p rate > 0 the spectra are computed in batches, folded
+   * together as set by set_fft_average, and handed to the GUI through a
+   * lock free triple buffer that the GUI reads at \p rate.  The data
+   * path never waits for the GUI and spectra the GUI has no time for
+   * are dropped.  With \p rate = 0 (the default) every FFT is sent to
+   * the GUI as it is computed.
+   */
+  void set_update_rate(double rate);
+
+  /*!
+   * \brief Fold \p nffts FFTs into each displayed spectrum, by
+   * averaging their power or, if \p max_hold, taking the maximum.
+   * Only used when an update rate is set.
+   */
+  void set_fft_average(int nffts, bool max_hold=false);
+
+  void render();		// really private
+
   QApplication *d_qApplication;
   qtgui_obj *d_object;
 
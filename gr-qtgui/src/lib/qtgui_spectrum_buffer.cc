@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <qtgui_spectrum_buffer.h>
+
+qtgui_spectrum_buffer::qtgui_spectrum_buffer()
+  : d_back(0), d_front(1), d_middle(2), d_overwritten(0)
+{
+  for(int i = 0; i < 3; i++) {
+    d_frame[i].timestamp.tv_sec = 0;
+    d_frame[i].timestamp.tv_nsec = 0;
+  }
+}
+
+// Swap v into d_middle with a full barrier, so the frame contents
+// written before the swap are seen by whoever swaps it out.
+int
+qtgui_spectrum_buffer::exchange_middle(int v)
+{
+  int old;
+  do {
+    old = d_middle;
+  } while(!__sync_bool_compare_and_swap(&d_middle, old, v));
+  return old;
+}
+
+void
+qtgui_spectrum_buffer::publish()
+{
+  int old = exchange_middle(d_back | FRESH);
+  if(old & FRESH) {
+    d_overwritten++;
+  }
+  d_back = old & ~FRESH;
+}
+
+const qtgui_spectrum_frame *
+qtgui_spectrum_buffer::acquire()
+{
+  if(!(d_middle & FRESH)) {
+    return 0;
+  }
+  d_front = exchange_middle(d_front) & ~FRESH;
+  return &d_frame[d_front];
+}
@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_QTGUI_SPECTRUM_BUFFER_H
+#define INCLUDED_QTGUI_SPECTRUM_BUFFER_H
+
+#include <complex>
+#include <vector>
+#include <ctime>
+
+/*!
+ * \brief One spectrum as handed from a sink to the GUI.
+ *
+ * fft holds magnitudes in the (unshifted) order of the FFT output, as
+ * the display takes the power of each point.  time holds the input of
+ * the last FFT, interleaved I/Q for complex sinks.
+ */
+struct qtgui_spectrum_frame
+{
+  std::vector<std::complex<float> > fft;
+  std::vector<float> time;
+  timespec timestamp;
+};
+
+/*!
+ * \brief Lock free triple buffer of spectra.
+ *
+ * A single writer (the scheduler thread) fills back() and publishes it;
+ * a single reader (the GUI thread) takes the latest published frame
+ * with acquire().  Neither side ever waits for the other: a frame the
+ * reader has not picked up is simply replaced by the next one.
+ */
+class qtgui_spectrum_buffer
+{
+  enum { FRESH = 4 };			// d_middle holds a frame not yet read
+
+  qtgui_spectrum_frame d_frame[3];
+  int d_back;				// writer only
+  int d_front;				// reader only
+  volatile int d_middle;		// index | FRESH, swapped atomically
+  volatile unsigned int d_overwritten;	// frames replaced before being read
+
+  int exchange_middle(int v);
+
+public:
+  qtgui_spectrum_buffer();
+
+  //! The frame the writer is filling
+  qtgui_spectrum_frame *back() { return &d_frame[d_back]; }
+
+  //! Make back() the latest frame and start filling another one
+  void publish();
+
+  /*!
+   * \brief Return the latest published frame, or 0 if there has been
+   * none since the last call.  The frame stays valid until the next call.
+   */
+  const qtgui_spectrum_frame *acquire();
+
+  //! Number of frames published but never acquired
+  unsigned int overwritten() const { return d_overwritten; }
+};
+
+#endif /* INCLUDED_QTGUI_SPECTRUM_BUFFER_H */
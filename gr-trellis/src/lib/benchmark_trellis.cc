@@ -0,0 +1,390 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Time the Viterbi and SISO kernels against the straightforward
+ * vector-of-vectors versions they replaced, and check that both agree.
+ * The combined (metrics + Viterbi) decoder is also timed against the
+ * split metrics_f -> viterbi pipeline.
+ *
+ *   benchmark_trellis [-k K] [-n NBLOCKS] [-t NTHREADS] [file.fsm ...]
+ *
+ * With no files, a few generated FSMs are used; the ones shipped in
+ * gr-trellis/src/examples/fsm_files make a good set.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <core_algorithms.h>
+#include <boost/bind.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <vector>
+
+static const float INF = 1.0e9;
+
+static double
+now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+// ----------------------------------------------------------------
+// reference implementations
+
+/*
+ * With TABLE, in holds K*D observations and the metrics are computed one
+ * step at a time, as trellis_viterbi_combined_XX used to.
+ */
+static void
+ref_viterbi(const fsm &F, int K, int S0, int SK, const float *in, int *out,
+	    int D = 0, const std::vector<float> *TABLE = 0)
+{
+  int S = F.S(), I = F.I(), O = F.O();
+  std::vector<float> metric(O);
+  const std::vector<int> &OS = F.OS();
+  const std::vector< std::vector<int> > &PS = F.PS();
+  const std::vector< std::vector<int> > &PI = F.PI();
+  std::vector<int> trace(S*K);
+  std::vector<float> alpha(S*2);
+  int alphai = 0;
+  float norm, mm, minm;
+  int minmi, st;
+
+  for (int i = 0; i < S; i++) alpha[i] = S0 < 0 ? 0 : INF;
+  if (S0 >= 0) alpha[S0] = 0;
+
+  for (int k = 0; k < K; k++){
+    const float *x = &in[k*O];
+    if (TABLE){
+      calc_metric(O, D, *TABLE, &in[k*D], &metric[0], TRELLIS_EUCLIDEAN);
+      x = &metric[0];
+    }
+    norm = INF;
+    for (int j = 0; j < S; j++){
+      minm = INF;
+      minmi = 0;
+      for (unsigned int i = 0; i < PS[j].size(); i++)
+	if ((mm = alpha[alphai*S+PS[j][i]] + x[OS[PS[j][i]*I+PI[j][i]]]) < minm)
+	  minm = mm, minmi = i;
+      trace[k*S+j] = minmi;
+      alpha[((alphai+1)%2)*S+j] = minm;
+      if (minm < norm) norm = minm;
+    }
+    for (int j = 0; j < S; j++)
+      alpha[((alphai+1)%2)*S+j] -= norm;
+    alphai = (alphai+1)%2;
+  }
+
+  if (SK < 0){
+    minm = INF;
+    minmi = 0;
+    for (int i = 0; i < S; i++)
+      if ((mm = alpha[alphai*S+i]) < minm) minm = mm, minmi = i;
+    st = minmi;
+  }
+  else
+    st = SK;
+
+  for (int k = K-1; k >= 0; k--){
+    int i0 = trace[k*S+st];
+    out[k] = PI[st][i0];
+    st = PS[st][i0];
+  }
+}
+
+static float
+ref_min(float a, float b)
+{
+  return a <= b ? a : b;
+}
+
+static float
+ref_min_star(float a, float b)
+{
+  return (a <= b ? a : b)-log(1+exp(a <= b ? a-b : b-a));
+}
+
+// POSTI and POSTO
+static void
+ref_siso(const fsm &F, int K, float (*op)(float, float),
+	 const float *priori, const float *prioro, float *post)
+{
+  int S = F.S(), I = F.I(), O = F.O();
+  const std::vector<int> &NS = F.NS();
+  const std::vector<int> &OS = F.OS();
+  const std::vector< std::vector<int> > &PS = F.PS();
+  const std::vector< std::vector<int> > &PI = F.PI();
+  std::vector<float> alpha(S*(K+1));
+  std::vector<float> beta(S*(K+1));
+  float norm, mm, minm;
+
+  for (int i = 0; i < S; i++) alpha[i] = 0;
+  for (int k = 0; k < K; k++){
+    norm = INF;
+    for (int j = 0; j < S; j++){
+      minm = INF;
+      for (unsigned int i = 0; i < PS[j].size(); i++){
+	mm = alpha[k*S+PS[j][i]] + priori[k*I+PI[j][i]] + prioro[k*O+OS[PS[j][i]*I+PI[j][i]]];
+	minm = op(minm, mm);
+      }
+      alpha[(k+1)*S+j] = minm;
+      if (minm < norm) norm = minm;
+    }
+    for (int j = 0; j < S; j++) alpha[(k+1)*S+j] -= norm;
+  }
+
+  for (int i = 0; i < S; i++) beta[K*S+i] = 0;
+  for (int k = K-1; k >= 0; k--){
+    norm = INF;
+    for (int j = 0; j < S; j++){
+      minm = INF;
+      for (int i = 0; i < I; i++){
+	int i0 = j*I+i;
+	mm = beta[(k+1)*S+NS[i0]] + priori[k*I+i] + prioro[k*O+OS[i0]];
+	minm = op(minm, mm);
+      }
+      beta[k*S+j] = minm;
+      if (minm < norm) norm = minm;
+    }
+    for (int j = 0; j < S; j++) beta[k*S+j] -= norm;
+  }
+
+  for (int k = 0; k < K; k++){
+    norm = INF;
+    for (int i = 0; i < I; i++){
+      minm = INF;
+      for (int j = 0; j < S; j++){
+	mm = alpha[k*S+j] + prioro[k*O+OS[j*I+i]] + beta[(k+1)*S+NS[j*I+i]];
+	minm = op(minm, mm);
+      }
+      post[k*(I+O)+i] = minm;
+      if (minm < norm) norm = minm;
+    }
+    for (int i = 0; i < I; i++) post[k*(I+O)+i] -= norm;
+  }
+
+  for (int k = 0; k < K; k++){
+    norm = INF;
+    for (int n = 0; n < O; n++){
+      minm = INF;
+      for (int j = 0; j < S; j++)
+	for (int i = 0; i < I; i++){
+	  mm = (n == OS[j*I+i] ? alpha[k*S+j]+priori[k*I+i]+beta[(k+1)*S+NS[j*I+i]] : INF);
+	  minm = op(minm, mm);
+	}
+      post[k*(I+O)+I+n] = minm;
+      if (minm < norm) norm = minm;
+    }
+    for (int n = 0; n < O; n++) post[k*(I+O)+I+n] -= norm;
+  }
+}
+
+// ----------------------------------------------------------------
+
+struct viterbi_job {
+  const trellis_flat *T;
+  int K;
+  const float *in;
+  int *out;
+  std::vector<trellis_workspace> *ws;
+
+  void operator()(int n, int thread) const
+  {
+    trellis_workspace &w = (*ws)[thread];
+    int st = viterbi_forward(*T, K, 0, -1, &in[n*K*T->O()], w);
+    viterbi_traceback(*T, K, st, w, &out[n*K]);
+  }
+};
+
+static float
+max_diff(const std::vector<float> &a, const std::vector<float> &b)
+{
+  float d = 0;
+  for (size_t i = 0; i < a.size(); i++)
+    d = std::max(d, fabsf(a[i] - b[i]));
+  return d;
+}
+
+static void
+benchmark(const char *name, const fsm &F, int K, int nblocks, int nthreads)
+{
+  const int I = F.I(), O = F.O();
+  trellis_flat T(F);
+  std::vector<trellis_workspace> ws(nthreads);
+
+  std::vector<float> in(nblocks*K*O);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = (float) random() / RAND_MAX * 4;
+
+  std::vector<int> ref(nblocks*K), out(nblocks*K);
+
+  printf("%-24s I=%-3d S=%-4d O=%-3d\n", name, I, F.S(), O);
+
+  // Viterbi
+  double t0 = now();
+  for (int n = 0; n < nblocks; n++)
+    ref_viterbi(F, K, 0, -1, &in[n*K*O], &ref[n*K]);
+  double t_ref = now() - t0;
+
+  viterbi_job job = { &T, K, &in[0], &out[0], &ws };
+  double t_flat[2];
+  int nt[2] = { 1, nthreads };
+  for (int r = 0; r < (nthreads > 1 ? 2 : 1); r++){
+    trellis_thread_pool pool(nt[r]);
+    t0 = now();
+    pool.run(nblocks, job);
+    t_flat[r] = now() - t0;
+  }
+  double steps = (double) nblocks * K;
+
+  printf("  viterbi         ref %9.3e   flat %9.3e",
+	 steps / t_ref, steps / t_flat[0]);
+  if (nthreads > 1)
+    printf("   %d threads %9.3e", nthreads, steps / t_flat[1]);
+  printf("  steps/s  %s\n", ref == out ? "ok" : "MISMATCH");
+
+  // Viterbi from observations: a 1-D, O point constellation
+  std::vector<float> TABLE(O), table;
+  for (int o = 0; o < O; o++)
+    TABLE[o] = o;
+  int C = calc_metric_table(O, 1, TABLE, table);
+  std::vector<float> obs(nblocks*K);
+  for (size_t i = 0; i < obs.size(); i++)
+    obs[i] = random() % O + (float) random() / RAND_MAX - 0.5;
+
+  t0 = now();
+  for (int n = 0; n < nblocks; n++)
+    ref_viterbi(F, K, 0, -1, &obs[n*K], &ref[n*K], 1, &TABLE);
+  t_ref = now() - t0;
+
+  t0 = now();
+  for (int n = 0; n < nblocks; n++){
+    for (int k = 0; k < K; k++)
+      calc_metric(O, 1, TABLE, &obs[n*K+k], &in[n*K*O+k*O], TRELLIS_EUCLIDEAN);
+    int st = viterbi_forward(T, K, 0, -1, &in[n*K*O], ws[0]);
+    viterbi_traceback(T, K, st, ws[0], &out[n*K]);
+  }
+  double t_split = now() - t0;
+  bool ok = ref == out;
+
+  t0 = now();
+  for (int n = 0; n < nblocks; n++){
+    int st = viterbi_forward_combined(T, K, 0, -1, 1, C, &table[0],
+				      TRELLIS_EUCLIDEAN, &obs[n*K], ws[0]);
+    viterbi_traceback(T, K, st, ws[0], &out[n*K]);
+  }
+  double t_fused = now() - t0;
+  ok = ok && ref == out;
+
+  printf("  combined        ref %9.3e   split %9.3e   fused %9.3e  steps/s  %s\n",
+	 steps / t_ref, steps / t_split, steps / t_fused, ok ? "ok" : "MISMATCH");
+
+  // SISO, input and output posteriors
+  int nsiso = std::max(1, nblocks / 16);
+  std::vector<float> priori(nsiso*K*I);
+  for (size_t i = 0; i < priori.size(); i++)
+    priori[i] = (float) random() / RAND_MAX;
+  std::vector<float> p_ref(nsiso*K*(I+O)), p_new(nsiso*K*(I+O));
+
+  static const struct {
+    const char *name;
+    trellis_siso_type_t type;
+    float (*op)(float, float);
+  } types[] = {
+    { "min-sum", TRELLIS_MIN_SUM, ref_min },
+    { "sum-product", TRELLIS_SUM_PRODUCT, ref_min_star },
+    { "sum-product-table", TRELLIS_SUM_PRODUCT_TABLE, ref_min_star },
+  };
+
+  for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++){
+    t0 = now();
+    for (int n = 0; n < nsiso; n++)
+      ref_siso(F, K, types[t].op, &priori[n*K*I], &in[n*K*O], &p_ref[n*K*(I+O)]);
+    t_ref = now() - t0;
+
+    t0 = now();
+    for (int n = 0; n < nsiso; n++)
+      siso_algorithm(T, K, -1, -1, true, true, types[t].type,
+		     &priori[n*K*I], &in[n*K*O], &p_new[n*K*(I+O)], ws[0]);
+    double t_new = now() - t0;
+
+    steps = (double) nsiso * K;
+    printf("  siso %-17s ref %9.3e   flat %9.3e  steps/s  max diff %.2e\n",
+	   types[t].name, steps / t_ref, steps / t_new, max_diff(p_ref, p_new));
+  }
+}
+
+static void
+usage(const char *progname)
+{
+  fprintf(stderr, "usage: %s [-k K] [-n NBLOCKS] [-t NTHREADS] [file.fsm ...]\n",
+	  progname);
+}
+
+int
+main(int argc, char **argv)
+{
+  int K = 1000;
+  int nblocks = 64;
+  int nthreads = 4;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "k:n:t:h")) != EOF){
+    switch (ch){
+    case 'k':
+      K = atoi(optarg);
+      break;
+    case 'n':
+      nblocks = atoi(optarg);
+      break;
+    case 't':
+      nthreads = std::max(1, atoi(optarg));
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (optind < argc){
+    for (int i = optind; i < argc; i++)
+      benchmark(argv[i], fsm(argv[i]), K, nblocks, nthreads);
+    return 0;
+  }
+
+  std::vector<int> G(2);
+  G[0] = 05; G[1] = 07;
+  benchmark("cc (1,2) [5,7]", fsm(1, 2, G), K, nblocks, nthreads);
+  G[0] = 0171; G[1] = 0133;
+  benchmark("cc (1,2) [171,133]", fsm(1, 2, G), K, nblocks, nthreads);
+  benchmark("isi 4-PAM, L=3", fsm(4, 3), K, nblocks, nthreads);
+  benchmark("isi 8-PAM, L=3", fsm(8, 3), K, nblocks, nthreads);
+  return 0;
+}
@@ -0,0 +1,602 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <core_algorithms.h>
+#include <boost/bind.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+static const float INF = 1.0e9;
+
+// metric of the padding state; never less than a real candidate
+static const float PAD = 2.0e9;
+
+// metrics computed ahead of the ACS in viterbi_forward_combined (8 KB)
+static const int METRIC_TILE_FLOATS = 2048;
+
+trellis_flat::trellis_flat(const fsm &FSM)
+  : d_I(FSM.I()), d_S(FSM.S()), d_O(FSM.O()), d_P(1),
+    d_NS(FSM.NS()), d_OS(FSM.OS())
+{
+  const std::vector< std::vector<int> > &PS = FSM.PS();
+  const std::vector< std::vector<int> > &PI = FSM.PI();
+
+  for (int j = 0; j < d_S; j++)
+    d_P = std::max(d_P, (int) PS[j].size());
+
+  d_PS.assign(d_P * d_S + 1, d_S);
+  d_PI.assign(d_P * d_S + 1, 0);
+  d_POS.assign(d_P * d_S + 1, 0);
+
+  for (int j = 0; j < d_S; j++){
+    for (unsigned int i = 0; i < PS[j].size(); i++){
+      int i0 = i * d_S + j;
+      d_PS[i0] = PS[j][i];
+      d_PI[i0] = PI[j][i];
+      d_POS[i0] = d_OS[PS[j][i] * d_I + PI[j][i]];
+    }
+  }
+}
+
+// ----------------------------------------------------------------
+// combining operators
+
+static const int   MIN_STAR_RES = 64;		// table entries per unit
+static const float MIN_STAR_MAX = 16.0;		// log(1+exp(-16)) ~ 1e-7
+static const int   MIN_STAR_SIZE = 16 * MIN_STAR_RES + 2;
+
+static float s_min_star[MIN_STAR_SIZE];
+
+static struct min_star_init {
+  min_star_init()
+  {
+    for (int i = 0; i < MIN_STAR_SIZE; i++)
+      s_min_star[i] = log(1 + exp(-(float) i / MIN_STAR_RES));
+  }
+} s_min_star_init;
+
+float
+min_star_table(float a, float b)
+{
+  float m = a <= b ? a : b;
+  float d = a <= b ? b - a : a - b;
+  if (d >= MIN_STAR_MAX)
+    return m;
+  float x = d * MIN_STAR_RES;
+  int i = (int) x;
+  return m - (s_min_star[i] + (x - i) * (s_min_star[i+1] - s_min_star[i]));
+}
+
+namespace {
+
+  struct min_op {
+    float operator()(float a, float b) const { return a <= b ? a : b; }
+  };
+
+  struct min_star_op {
+    float operator()(float a, float b) const {
+      return (a <= b ? a : b)-log(1+exp(a <= b ? a-b : b-a));
+    }
+  };
+
+  struct min_star_table_op {
+    float operator()(float a, float b) const { return min_star_table(a, b); }
+  };
+
+} // namespace
+
+static inline float
+normalize(float *x, int n)
+{
+  float norm = INF;
+  for (int i = 0; i < n; i++)
+    if (x[i] < norm)
+      norm = x[i];
+  for (int i = 0; i < n; i++)
+    x[i] -= norm;
+  return norm;
+}
+
+// ----------------------------------------------------------------
+// Viterbi
+
+/*
+ * One add-compare-select step: an[j] = min_i a[PS(i,j)] + x[POS(i,j)],
+ * recording the winning slot i in trace[j].  Ties go to the lowest i.
+ */
+static void
+viterbi_acs(const trellis_flat &T, const float *a, const float *x,
+	    float *an, int *trace)
+{
+  const int S = T.S();
+  const int P = T.P();
+  const int *PS = T.PS();
+  const int *POS = T.POS();
+  int j = 0;
+
+#ifdef __SSE__
+  for (; j + 4 <= S; j += 4){
+    __m128 best = _mm_set1_ps(INF);
+    __m128 besti = _mm_setzero_ps();
+    for (int i = 0; i < P; i++){
+      const int *ps = &PS[i*S+j];
+      const int *pos = &POS[i*S+j];
+      __m128 m = _mm_add_ps(_mm_setr_ps(a[ps[0]], a[ps[1]], a[ps[2]], a[ps[3]]),
+			    _mm_setr_ps(x[pos[0]], x[pos[1]], x[pos[2]], x[pos[3]]));
+      __m128 lt = _mm_cmplt_ps(m, best);
+      best = _mm_min_ps(m, best);
+      besti = _mm_or_ps(_mm_and_ps(lt, _mm_set1_ps((float) i)),
+			_mm_andnot_ps(lt, besti));
+    }
+    float idx[4];
+    _mm_storeu_ps(idx, besti);
+    _mm_storeu_ps(&an[j], best);
+    for (int n = 0; n < 4; n++)
+      trace[j+n] = (int) idx[n];
+  }
+#endif
+
+  for (; j < S; j++){
+    float minm = INF;
+    int minmi = 0;
+    for (int i = 0; i < P; i++){
+      float mm = a[PS[i*S+j]] + x[POS[i*S+j]];
+      if (mm < minm)
+	minm = mm, minmi = i;
+    }
+    an[j] = minm;
+    trace[j] = minmi;
+  }
+}
+
+static float *
+viterbi_init(const trellis_flat &T, int K, int S0, trellis_workspace &ws)
+{
+  const int S = T.S();
+
+  if ((int) ws.trace.size() < S * K)
+    ws.trace.resize(S * K);
+  if ((int) ws.alpha.size() < 2 * (S + 1))
+    ws.alpha.resize(2 * (S + 1));
+
+  float *a = &ws.alpha[0];
+  if (S0 < 0){ // initial state not specified
+    for (int i = 0; i < S; i++) a[i] = 0;
+  }
+  else {
+    for (int i = 0; i < S; i++) a[i] = INF;
+    a[S0] = 0.0;
+  }
+  a[S] = a[2*S+1] = PAD;
+  return a;
+}
+
+// ACS for step k over metrics x; a and an are swapped afterwards
+static inline void
+viterbi_step(const trellis_flat &T, int k, const float *x,
+	     float *&a, float *&an, trellis_workspace &ws)
+{
+  const int S = T.S();
+  viterbi_acs(T, a, x, an, &ws.trace[k*S]);
+  normalize(an, S); // so total metrics do not explode
+  std::swap(a, an);
+}
+
+static int
+viterbi_final(const trellis_flat &T, int SK, const float *a)
+{
+  if (SK >= 0)
+    return SK;
+
+  // final state not specified
+  float minm = INF;
+  int st = 0;
+  for (int i = 0; i < T.S(); i++)
+    if (a[i] < minm)
+      minm = a[i], st = i;
+  return st;
+}
+
+int
+viterbi_forward(const trellis_flat &T, int K, int S0, int SK,
+		const float *in, trellis_workspace &ws)
+{
+  const int O = T.O();
+  float *a = viterbi_init(T, K, S0, ws);
+  float *an = a + T.S() + 1;
+
+  for (int k = 0; k < K; k++)
+    viterbi_step(T, k, &in[k*O], a, an, ws);
+
+  return viterbi_final(T, SK, a);
+}
+
+int
+viterbi_forward_combined(const trellis_flat &T, int K, int S0, int SK,
+			 int D, int C, const float *table,
+			 trellis_metric_type_t TYPE,
+			 const float *in, trellis_workspace &ws)
+{
+  const int O = T.O();
+  const int tile = std::max(1, std::min(K, METRIC_TILE_FLOATS / O));
+
+  if ((int) ws.metric.size() < tile * O)
+    ws.metric.resize(tile * O);
+
+  float *a = viterbi_init(T, K, S0, ws);
+  float *an = a + T.S() + 1;
+
+  for (int k0 = 0; k0 < K; k0 += tile){
+    int n = std::min(tile, K - k0);
+    calc_metric_tile(O, D, C, table, &in[k0*D*C], n, &ws.metric[0], TYPE);
+    for (int k = 0; k < n; k++)
+      viterbi_step(T, k0 + k, &ws.metric[k*O], a, an, ws);
+  }
+
+  return viterbi_final(T, SK, a);
+}
+
+// ----------------------------------------------------------------
+// SISO
+
+// an[j] = op_i a[PS(i,j)] + priori[PI(i,j)] + prioro[POS(i,j)]
+template <class OP>
+static void
+siso_forward_step(const trellis_flat &T, OP op, const float *a,
+		  const float *priori, const float *prioro, float *an)
+{
+  const int S = T.S();
+  const int P = T.P();
+  const int *PS = T.PS();
+  const int *PI = T.PI();
+  const int *POS = T.POS();
+
+  for (int j = 0; j < S; j++){
+    float minm = INF;
+    for (int i = 0; i < P; i++){
+      int i0 = i * S + j;
+      minm = op(minm, a[PS[i0]] + priori[PI[i0]] + prioro[POS[i0]]);
+    }
+    an[j] = minm;
+  }
+}
+
+// b[j] = op_i bn[NS(j,i)] + priori[i] + prioro[OS(j,i)]
+template <class OP>
+static void
+siso_backward_step(const trellis_flat &T, OP op, const float *bn,
+		   const float *priori, const float *prioro, float *b)
+{
+  const int S = T.S();
+  const int I = T.I();
+  const int *NS = T.NS();
+  const int *OS = T.OS();
+
+  for (int j = 0; j < S; j++){
+    float minm = INF;
+    for (int i = 0; i < I; i++){
+      int i0 = j * I + i;
+      minm = op(minm, bn[NS[i0]] + priori[i] + prioro[OS[i0]]);
+    }
+    b[j] = minm;
+  }
+}
+
+#ifdef __SSE__
+template <>
+void
+siso_forward_step(const trellis_flat &T, min_op op, const float *a,
+		  const float *priori, const float *prioro, float *an)
+{
+  const int S = T.S();
+  const int P = T.P();
+  const int *PS = T.PS();
+  const int *PI = T.PI();
+  const int *POS = T.POS();
+  int j = 0;
+
+  for (; j + 4 <= S; j += 4){
+    __m128 best = _mm_set1_ps(INF);
+    for (int i = 0; i < P; i++){
+      const int *ps = &PS[i*S+j];
+      const int *pi = &PI[i*S+j];
+      const int *pos = &POS[i*S+j];
+      __m128 m = _mm_add_ps(_mm_setr_ps(a[ps[0]], a[ps[1]], a[ps[2]], a[ps[3]]),
+			    _mm_setr_ps(priori[pi[0]], priori[pi[1]],
+					priori[pi[2]], priori[pi[3]]));
+      m = _mm_add_ps(m, _mm_setr_ps(prioro[pos[0]], prioro[pos[1]],
+				    prioro[pos[2]], prioro[pos[3]]));
+      best = _mm_min_ps(m, best);
+    }
+    _mm_storeu_ps(&an[j], best);
+  }
+
+  for (; j < S; j++){
+    float minm = INF;
+    for (int i = 0; i < P; i++){
+      int i0 = i * S + j;
+      minm = op(minm, a[PS[i0]] + priori[PI[i0]] + prioro[POS[i0]]);
+    }
+    an[j] = minm;
+  }
+}
+
+template <>
+void
+siso_backward_step(const trellis_flat &T, min_op op, const float *bn,
+		   const float *priori, const float *prioro, float *b)
+{
+  const int S = T.S();
+  const int I = T.I();
+  const int *NS = T.NS();
+  const int *OS = T.OS();
+  int j = 0;
+
+  for (; j + 4 <= S; j += 4){
+    __m128 best = _mm_set1_ps(INF);
+    for (int i = 0; i < I; i++){
+      const int *ns = &NS[j*I+i];
+      const int *os = &OS[j*I+i];
+      __m128 m = _mm_add_ps(_mm_setr_ps(bn[ns[0]], bn[ns[I]], bn[ns[2*I]], bn[ns[3*I]]),
+			    _mm_set1_ps(priori[i]));
+      m = _mm_add_ps(m, _mm_setr_ps(prioro[os[0]], prioro[os[I]],
+				    prioro[os[2*I]], prioro[os[3*I]]));
+      best = _mm_min_ps(m, best);
+    }
+    _mm_storeu_ps(&b[j], best);
+  }
+
+  for (; j < S; j++){
+    float minm = INF;
+    for (int i = 0; i < I; i++){
+      int i0 = j * I + i;
+      minm = op(minm, bn[NS[i0]] + priori[i] + prioro[OS[i0]]);
+    }
+    b[j] = minm;
+  }
+}
+#endif
+
+template <class OP>
+static void
+siso_run(const trellis_flat &T, OP op, int K, int S0, int SK,
+	 bool POSTI, bool POSTO,
+	 const float *priori, const float *prioro, float *post,
+	 trellis_workspace &ws)
+{
+  const int I = T.I();
+  const int S = T.S();
+  const int O = T.O();
+  const int SS = S + 1;		// row stride, including the padding state
+  const int *NS = T.NS();
+  const int *OS = T.OS();
+
+  if (!POSTI && !POSTO)
+    throw std::runtime_error ("Not both POSTI and POSTO can be false.");
+
+  if ((int) ws.alpha.size() < SS * (K + 1))
+    ws.alpha.resize(SS * (K + 1));
+  if ((int) ws.beta.size() < SS * (K + 1))
+    ws.beta.resize(SS * (K + 1));
+  float *alpha = &ws.alpha[0];
+  float *beta = &ws.beta[0];
+
+  if (S0 < 0){ // initial state not specified
+    for (int i = 0; i < S; i++) alpha[i] = 0;
+  }
+  else {
+    for (int i = 0; i < S; i++) alpha[i] = INF;
+    alpha[S0] = 0.0;
+  }
+  alpha[S] = PAD;
+
+  for (int k = 0; k < K; k++){ // forward recursion
+    float *an = &alpha[(k+1)*SS];
+    siso_forward_step(T, op, &alpha[k*SS], &priori[k*I], &prioro[k*O], an);
+    normalize(an, S);
+    an[S] = PAD;
+  }
+
+  if (SK < 0){ // final state not specified
+    for (int i = 0; i < S; i++) beta[K*SS+i] = 0;
+  }
+  else {
+    for (int i = 0; i < S; i++) beta[K*SS+i] = INF;
+    beta[K*SS+SK] = 0.0;
+  }
+
+  for (int k = K - 1; k >= 0; k--){ // backward recursion
+    float *b = &beta[k*SS];
+    siso_backward_step(T, op, &beta[(k+1)*SS], &priori[k*I], &prioro[k*O], b);
+    normalize(b, S);
+  }
+
+  const int stride = (POSTI ? I : 0) + (POSTO ? O : 0);
+
+  for (int k = 0; k < K; k++){
+    const float *a = &alpha[k*SS];
+    const float *bn = &beta[(k+1)*SS];
+    const float *pi = &priori[k*I];
+    const float *po = &prioro[k*O];
+
+    if (POSTI){ // input combining
+      float *p = &post[k*stride];
+      for (int i = 0; i < I; i++){
+	float minm = INF;
+	for (int j = 0; j < S; j++)
+	  minm = op(minm, a[j] + po[OS[j*I+i]] + bn[NS[j*I+i]]);
+	p[i] = minm;
+      }
+      normalize(p, I);
+    }
+
+    if (POSTO){ // output combining, one pass over the transitions
+      float *p = &post[k*stride + (POSTI ? I : 0)];
+      for (int n = 0; n < O; n++)
+	p[n] = INF;
+      for (int j = 0; j < S; j++){
+	for (int i = 0; i < I; i++){
+	  int i0 = j * I + i;
+	  p[OS[i0]] = op(p[OS[i0]], a[j] + pi[i] + bn[NS[i0]]);
+	}
+      }
+      normalize(p, O);
+    }
+  }
+}
+
+void
+siso_algorithm(const trellis_flat &T, int K, int S0, int SK,
+	       bool POSTI, bool POSTO, trellis_siso_type_t SISO_TYPE,
+	       const float *priori, const float *prioro, float *post,
+	       trellis_workspace &ws)
+{
+  switch (SISO_TYPE){
+  case TRELLIS_MIN_SUM:
+    siso_run(T, min_op(), K, S0, SK, POSTI, POSTO, priori, prioro, post, ws);
+    break;
+
+  case TRELLIS_SUM_PRODUCT:
+    siso_run(T, min_star_op(), K, S0, SK, POSTI, POSTO, priori, prioro, post, ws);
+    break;
+
+  case TRELLIS_SUM_PRODUCT_TABLE:
+    siso_run(T, min_star_table_op(), K, S0, SK, POSTI, POSTO, priori, prioro, post, ws);
+    break;
+
+  default:
+    throw std::runtime_error ("siso_algorithm: invalid SISO_TYPE");
+  }
+}
+
+// ----------------------------------------------------------------
+
+static void
+run_range(const boost::function<void (int, int)> &f,
+	  int first, int last, int thread)
+{
+  for (int n = first; n < last; n++)
+    f(n, thread);
+}
+
+trellis_thread_pool::trellis_thread_pool(int nthreads)
+  : d_nthreads(1), d_generation(0), d_pending(0), d_shutdown(false),
+    d_njobs(0), d_f(0)
+{
+  resize(nthreads);
+}
+
+trellis_thread_pool::~trellis_thread_pool()
+{
+  stop();
+}
+
+void
+trellis_thread_pool::stop()
+{
+  if (!d_threads)
+    return;
+
+  {
+    gruel::scoped_lock guard(d_mutex);
+    d_shutdown = true;
+    d_start.notify_all();
+  }
+  d_threads->join_all();
+  d_threads.reset();
+  d_shutdown = false;
+}
+
+void
+trellis_thread_pool::resize(int nthreads)
+{
+  nthreads = std::max(1, nthreads);
+  if (nthreads == d_nthreads)
+    return;
+
+  stop();
+  d_nthreads = nthreads;
+  if (d_nthreads == 1)
+    return;
+
+  d_generation = 0;
+  d_threads.reset(new gruel::thread_group);
+  for (int t = 1; t < d_nthreads; t++)
+    d_threads->create_thread(boost::bind(&trellis_thread_pool::worker, this, t));
+}
+
+void
+trellis_thread_pool::worker(int t)
+{
+  unsigned long seen = 0;
+
+  while (1){
+    {
+      gruel::scoped_lock guard(d_mutex);
+      while (d_generation == seen && !d_shutdown)
+	d_start.wait(guard);
+      if (d_shutdown)
+	return;
+      seen = d_generation;
+    }
+
+    // d_njobs and d_f don't change until every worker has checked in
+    run_range(*d_f, t * d_njobs / d_nthreads, (t + 1) * d_njobs / d_nthreads, t);
+
+    gruel::scoped_lock guard(d_mutex);
+    if (--d_pending == 0)
+      d_done.notify_one();
+  }
+}
+
+void
+trellis_thread_pool::run(int njobs, const boost::function<void (int, int)> &f)
+{
+  if (d_nthreads == 1 || njobs <= 1){
+    run_range(f, 0, njobs, 0);
+    return;
+  }
+
+  {
+    gruel::scoped_lock guard(d_mutex);
+    d_njobs = njobs;
+    d_f = &f;
+    d_pending = d_nthreads - 1;
+    d_generation++;
+    d_start.notify_all();
+  }
+
+  run_range(f, 0, njobs / d_nthreads, 0);
+
+  gruel::scoped_lock guard(d_mutex);
+  while (d_pending > 0)
+    d_done.wait(guard);
+}
@@ -0,0 +1,195 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TRELLIS_CORE_ALGORITHMS_H
+#define INCLUDED_TRELLIS_CORE_ALGORITHMS_H
+
+#include "fsm.h"
+#include "trellis_siso_type.h"
+#include "trellis_calc_metric.h"
+#include <gruel/thread.h>
+#include <gruel/thread_group.h>
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <vector>
+
+/*!
+ * \brief Flat, precomputed view of an fsm for the inner decoding loops.
+ *
+ * The predecessor lists PS/PI are padded to P() entries per state and
+ * stored slot-major: entry (i,j) -- the i-th predecessor of state j --
+ * is at index i*S()+j, so that consecutive states are adjacent and can
+ * be processed four at a time.  POS() holds the output symbol of each
+ * predecessor transition, saving the OS[PS*I+PI] lookup.  Padding
+ * entries point at the extra state S(), whose metric the algorithms
+ * keep at 2*INF so that it never wins a comparison.
+ */
+class trellis_flat {
+  int d_I;
+  int d_S;
+  int d_O;
+  int d_P;
+  std::vector<int> d_NS;
+  std::vector<int> d_OS;
+  std::vector<int> d_PS;
+  std::vector<int> d_PI;
+  std::vector<int> d_POS;
+
+public:
+  trellis_flat(const fsm &FSM);
+  int I () const { return d_I; }
+  int S () const { return d_S; }
+  int O () const { return d_O; }
+  int P () const { return d_P; }
+  const int *NS () const { return &d_NS[0]; }
+  const int *OS () const { return &d_OS[0]; }
+  const int *PS () const { return &d_PS[0]; }
+  const int *PI () const { return &d_PI[0]; }
+  const int *POS () const { return &d_POS[0]; }
+};
+
+/*!
+ * \brief Scratch storage for one decoder, reused across blocks.
+ */
+struct trellis_workspace {
+  std::vector<int> trace;
+  std::vector<float> alpha;
+  std::vector<float> beta;
+  std::vector<float> metric;
+  std::vector<float> input;
+};
+
+/*!
+ * \brief min(a,b) - log(1+exp(-|a-b|)) with the correction term read
+ * from a table (linear interpolation at 1/64 resolution, zero beyond 16)
+ */
+float min_star_table(float a, float b);
+
+/*!
+ * \brief Viterbi forward pass over K steps of metrics in (K*O floats).
+ *
+ * Leaves the survivor trace in ws and returns the state to start the
+ * traceback from (SK, or the best final state if SK < 0).
+ */
+int viterbi_forward(const trellis_flat &T, int K, int S0, int SK,
+		    const float *in, trellis_workspace &ws);
+
+/*!
+ * \brief viterbi_forward on raw observations: K inputs of D*C floats
+ * (C=2 for complex), compared against a calc_metric_table() table.
+ *
+ * Metrics are computed a tile of symbols at a time into ws.metric,
+ * small enough to stay in L1, and consumed by the ACS straight away.
+ */
+int viterbi_forward_combined(const trellis_flat &T, int K, int S0, int SK,
+			     int D, int C, const float *table,
+			     trellis_metric_type_t TYPE,
+			     const float *in, trellis_workspace &ws);
+
+/*!
+ * \brief View n inputs as floats, converting into buf if need be
+ */
+template <class T>
+inline const float *
+trellis_input_as_float(const T *in, int n, std::vector<float> &buf)
+{
+  if ((int) buf.size() < n)
+    buf.resize(n);
+  for (int i = 0; i < n; i++)
+    buf[i] = in[i];
+  return &buf[0];
+}
+
+inline const float *
+trellis_input_as_float(const float *in, int n, std::vector<float> &buf)
+{
+  return in;
+}
+
+inline const float *
+trellis_input_as_float(const gr_complex *in, int n, std::vector<float> &buf)
+{
+  return (const float *) in;
+}
+
+/*!
+ * \brief Write the K decoded input symbols, following the trace left by
+ * viterbi_forward from final state st.
+ */
+template <class T>
+void
+viterbi_traceback(const trellis_flat &F, int K, int st,
+		  const trellis_workspace &ws, T *out)
+{
+  const int S = F.S();
+  const int *PS = F.PS();
+  const int *PI = F.PI();
+  const int *trace = &ws.trace[0];
+
+  for (int k = K - 1; k >= 0; k--){
+    int i0 = trace[k*S+st] * S + st;
+    out[k] = (T) PI[i0];
+    st = PS[i0];
+  }
+}
+
+/*!
+ * \brief SISO (forward-backward) algorithm; see trellis_siso_f.
+ */
+void siso_algorithm(const trellis_flat &T, int K, int S0, int SK,
+		    bool POSTI, bool POSTO, trellis_siso_type_t SISO_TYPE,
+		    const float *priori, const float *prioro, float *post,
+		    trellis_workspace &ws);
+
+/*!
+ * \brief Persistent worker threads for decoding independent blocks.
+ *
+ * run(njobs, f) calls f(job, thread) for job = 0 .. njobs-1 on the
+ * pool's threads (the caller's is thread 0), each thread taking a
+ * contiguous range of jobs, and returns when all jobs are done.  The
+ * workers sleep between calls, so a run costs a wakeup, not a thread
+ * start.  resize() must not be called while run() is in progress.
+ */
+class trellis_thread_pool {
+  int d_nthreads;
+  boost::scoped_ptr<gruel::thread_group> d_threads;
+  gruel::mutex d_mutex;
+  gruel::condition_variable d_start;	// new work or shutdown
+  gruel::condition_variable d_done;	// d_pending dropped to 0
+  unsigned long d_generation;
+  int d_pending;
+  bool d_shutdown;
+  int d_njobs;
+  const boost::function<void (int, int)> *d_f;
+
+  void worker(int t);
+  void stop();
+
+public:
+  trellis_thread_pool(int nthreads = 1);
+  ~trellis_thread_pool();
+  int size() const { return d_nthreads; }
+  void resize(int nthreads);
+  void run(int njobs, const boost::function<void (int, int)> &f);
+};
+
+#endif
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,6 +24,10 @@
 #include <stdexcept>
 #include "trellis_calc_metric.h"
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 
 
 template <class T> 
@@ -248,3 +252,112 @@ void calc_metric(int O, int D, const std::vector<gr_complex> &TABLE, const gr_co
     throw std::runtime_error ("Invalid metric type.");
   }
 }
+
+
+
+template <class T>
+int calc_metric_table(int O, int D, const std::vector<T> &TABLE, std::vector<float> &table)
+{
+  table.resize(O*D);
+  for(int o=0;o<O;o++)
+    for (int m=0;m<D;m++)
+      table[m*O+o] = TABLE[o*D+m];
+  return 1;
+}
+
+template
+int calc_metric_table<short>(int O, int D, const std::vector<short> &TABLE, std::vector<float> &table);
+
+template
+int calc_metric_table<int>(int O, int D, const std::vector<int> &TABLE, std::vector<float> &table);
+
+template
+int calc_metric_table<float>(int O, int D, const std::vector<float> &TABLE, std::vector<float> &table);
+
+
+int calc_metric_table(int O, int D, const std::vector<gr_complex> &TABLE, std::vector<float> &table)
+{
+  table.resize(O*D*2);
+  for(int o=0;o<O;o++)
+    for (int m=0;m<D;m++) {
+      table[(2*m)*O+o] = TABLE[o*D+m].real();
+      table[(2*m+1)*O+o] = TABLE[o*D+m].imag();
+    }
+  return 2;
+}
+
+
+// metric[o] += (x-t[o])^2
+static inline void
+accumulate_real(int O, float x, const float *t, float *metric)
+{
+  int o=0;
+#ifdef __SSE__
+  __m128 vx = _mm_set1_ps(x);
+  for(;o+4<=O;o+=4) {
+    __m128 d = _mm_sub_ps(vx, _mm_loadu_ps(&t[o]));
+    _mm_storeu_ps(&metric[o], _mm_add_ps(_mm_loadu_ps(&metric[o]), _mm_mul_ps(d, d)));
+  }
+#endif
+  for(;o<O;o++) {
+    float d = x-t[o];
+    metric[o] += d*d;
+  }
+}
+
+// metric[o] += |(xr,xi)-(tr[o],ti[o])|^2
+static inline void
+accumulate_complex(int O, float xr, float xi, const float *tr, const float *ti, float *metric)
+{
+  int o=0;
+#ifdef __SSE__
+  __m128 vxr = _mm_set1_ps(xr);
+  __m128 vxi = _mm_set1_ps(xi);
+  for(;o+4<=O;o+=4) {
+    __m128 dr = _mm_sub_ps(vxr, _mm_loadu_ps(&tr[o]));
+    __m128 di = _mm_sub_ps(vxi, _mm_loadu_ps(&ti[o]));
+    __m128 d2 = _mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(di, di));
+    _mm_storeu_ps(&metric[o], _mm_add_ps(_mm_loadu_ps(&metric[o]), d2));
+  }
+#endif
+  for(;o<O;o++) {
+    float dr = xr-tr[o];
+    float di = xi-ti[o];
+    metric[o] += dr*dr+di*di;
+  }
+}
+
+void calc_metric_tile(int O, int D, int C, const float *table, const float *in, int n, float *metric, trellis_metric_type_t type)
+{
+  if (type == TRELLIS_HARD_BIT)
+    throw std::runtime_error ("Invalid metric type (not yet implemented).");
+  if (type != TRELLIS_EUCLIDEAN && type != TRELLIS_HARD_SYMBOL)
+    throw std::runtime_error ("Invalid metric type.");
+
+  for(int k=0;k<n;k++) {
+    const float *x = &in[k*D*C];
+    float *mk = &metric[k*O];
+
+    for(int o=0;o<O;o++)
+      mk[o]=0.0;
+    for (int m=0;m<D;m++) {
+      if (C == 1)
+        accumulate_real(O, x[m], &table[m*O], mk);
+      else
+        accumulate_complex(O, x[2*m], x[2*m+1], &table[(2*m)*O], &table[(2*m+1)*O], mk);
+    }
+
+    if (type == TRELLIS_HARD_SYMBOL) {
+      float minm = FLT_MAX;
+      int minmi = 0;
+      for(int o=0;o<O;o++) {
+        if(mk[o]<minm) {
+          minm=mk[o];
+          minmi=o;
+        }
+      }
+      for(int o=0;o<O;o++)
+        mk[o] = (o==minmi?0.0:1.0);
+    }
+  }
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -42,5 +42,22 @@ void calc_metric(int O, int D, const std::vector<float> &TABLE, const float *in,
 void calc_metric(int O, int D, const std::vector<gr_complex> &TABLE, const gr_complex *in, float *metric, trellis_metric_type_t type);
 
 
+/*!
+ * \brief Rearrange TABLE for calc_metric_tile: component-major floats,
+ * table[(m*C+c)*O+o] for dimension m, component c (C=2 for complex).
+ * Returns C.
+ */
+template <class T>
+int calc_metric_table(int O, int D, const std::vector<T> &TABLE, std::vector<float> &table);
+
+int calc_metric_table(int O, int D, const std::vector<gr_complex> &TABLE, std::vector<float> &table);
+
+/*!
+ * \brief calc_metric for n consecutive inputs of D*C floats each, writing
+ * n*O metrics.  The inner loops run over o, four at a time.
+ */
+void calc_metric_tile(int O, int D, int C, const float *table, const float *in, int n, float *metric, trellis_metric_type_t type);
+
+
 
 #endif
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,11 +26,11 @@
 
 #include <trellis_siso_combined_f.h>
 #include <gr_io_signature.h>
+#include <boost/bind.hpp>
 #include <stdexcept>
 #include <assert.h>
 #include <iostream>
-  
-static const float INF = 1.0e9;
+#include <algorithm>
 
 trellis_siso_combined_f_sptr 
 trellis_make_siso_combined_f (
@@ -71,9 +71,10 @@ trellis_siso_combined_f::trellis_siso_combined_f (
   d_SISO_TYPE (SISO_TYPE),
   d_D (D),
   d_TABLE (TABLE),
-  d_TYPE (TYPE)//,
-  //d_alpha(FSM.S()*(K+1)),
-  //d_beta(FSM.S()*(K+1))
+  d_TYPE (TYPE),
+  d_flat (FSM),
+  d_nthreads (1),
+  d_ws (1)
 {
     int multiple;
     if (d_POSTI && d_POSTO) 
@@ -125,178 +126,55 @@ trellis_siso_combined_f::forecast (int noutput_items, gr_vector_int &ninput_item
   }
 }
 
-inline float min(float a, float b)
+void
+trellis_siso_combined_f::set_nthreads (int nthreads)
 {
-  return a <= b ? a : b;
+  d_nthreads = std::max (1, nthreads);
 }
 
-inline float min_star(float a, float b)
-{
-  return (a <= b ? a : b)-log(1+exp(a <= b ? a-b : b-a));
-}
 
-void siso_algorithm_combined(int I, int S, int O, 
-             const std::vector<int> &NS,
-             const std::vector<int> &OS,
-             const std::vector< std::vector<int> > &PS,
-             const std::vector< std::vector<int> > &PI,
-             int K,
-             int S0,int SK,
-             bool POSTI, bool POSTO,
-             float (*p2mymin)(float,float),
-             int D,
-             const std::vector<float> &TABLE,
-             trellis_metric_type_t TYPE,
-             const float *priori, const float *observations, float *post//,
-             //std::vector<float> &alpha,
-             //std::vector<float> &beta
-             ) 
+void
+trellis_siso_combined_f::decode_block (gr_vector_const_void_star &input_items,
+                                       gr_vector_void_star &output_items,
+                                       int nblocks, int job, int thread)
 {
-  float norm,mm,minm;
-  std::vector<float> alpha(S*(K+1));
-  std::vector<float> beta(S*(K+1));
-  float *prioro = new float[O*K];
-
-
-  if(S0<0) { // initial state not specified
-      for(int i=0;i<S;i++) alpha[0*S+i]=0;
-  }
-  else {
-      for(int i=0;i<S;i++) alpha[0*S+i]=INF;
-      alpha[0*S+S0]=0.0;
-  }
-
-  for(int k=0;k<K;k++) { // forward recursion
-      calc_metric(O, D, TABLE, &(observations[k*D]), &(prioro[k*O]),TYPE); // calc metrics
-      norm=INF;
-      for(int j=0;j<S;j++) {
-          minm=INF;
-          for(unsigned int i=0;i<PS[j].size();i++) {
-              //int i0 = j*I+i;
-              mm=alpha[k*S+PS[j][i]]+priori[k*I+PI[j][i]]+prioro[k*O+OS[PS[j][i]*I+PI[j][i]]];
-              minm=(*p2mymin)(minm,mm);
-          }
-          alpha[(k+1)*S+j]=minm;
-          if(minm<norm) norm=minm;
-      }
-      for(int j=0;j<S;j++) 
-          alpha[(k+1)*S+j]-=norm; // normalize total metrics so they do not explode
-  }
-
-  if(SK<0) { // final state not specified
-      for(int i=0;i<S;i++) beta[K*S+i]=0;
-  }
-  else {
-      for(int i=0;i<S;i++) beta[K*S+i]=INF;
-      beta[K*S+SK]=0.0;
-  }
-
-  for(int k=K-1;k>=0;k--) { // backward recursion
-      norm=INF;
-      for(int j=0;j<S;j++) { 
-          minm=INF;
-          for(int i=0;i<I;i++) {
-              int i0 = j*I+i;
-              mm=beta[(k+1)*S+NS[i0]]+priori[k*I+i]+prioro[k*O+OS[i0]];
-              minm=(*p2mymin)(minm,mm);
-          }
-          beta[k*S+j]=minm;
-          if(minm<norm) norm=minm;
-      }
-      for(int j=0;j<S;j++)
-          beta[k*S+j]-=norm; // normalize total metrics so they do not explode
-  }
-
-
-  if (POSTI && POSTO)
-  {
-    for(int k=0;k<K;k++) { // input combining
-        norm=INF;
-        for(int i=0;i<I;i++) {
-            minm=INF;
-            for(int j=0;j<S;j++) {
-                mm=alpha[k*S+j]+prioro[k*O+OS[j*I+i]]+beta[(k+1)*S+NS[j*I+i]];
-                minm=(*p2mymin)(minm,mm);
-            }
-            post[k*(I+O)+i]=minm;
-            if(minm<norm) norm=minm;
-        }
-        for(int i=0;i<I;i++)
-            post[k*(I+O)+i]-=norm; // normalize metrics
-    }
-
-
-    for(int k=0;k<K;k++) { // output combining
-        norm=INF;
-        for(int n=0;n<O;n++) {
-            minm=INF;
-            for(int j=0;j<S;j++) {
-                for(int i=0;i<I;i++) {
-                    mm= (n==OS[j*I+i] ? alpha[k*S+j]+priori[k*I+i]+beta[(k+1)*S+NS[j*I+i]] : INF);
-                    minm=(*p2mymin)(minm,mm);
-                }
-            }
-            post[k*(I+O)+I+n]=minm;
-            if(minm<norm) norm=minm;
-        }
-        for(int n=0;n<O;n++)
-            post[k*(I+O)+I+n]-=norm; // normalize metrics
-    }
-  } 
-  else if(POSTI) 
-  {
-    for(int k=0;k<K;k++) { // input combining
-        norm=INF;
-        for(int i=0;i<I;i++) {
-            minm=INF;
-            for(int j=0;j<S;j++) {
-                mm=alpha[k*S+j]+prioro[k*O+OS[j*I+i]]+beta[(k+1)*S+NS[j*I+i]];
-                minm=(*p2mymin)(minm,mm);
-            }
-            post[k*I+i]=minm;
-            if(minm<norm) norm=minm;
-        }
-        for(int i=0;i<I;i++)
-            post[k*I+i]-=norm; // normalize metrics
-    }
-  }
-  else if(POSTO)
-  {
-    for(int k=0;k<K;k++) { // output combining
-        norm=INF;
-        for(int n=0;n<O;n++) {
-            minm=INF;
-            for(int j=0;j<S;j++) {
-                for(int i=0;i<I;i++) {
-                    mm= (n==OS[j*I+i] ? alpha[k*S+j]+priori[k*I+i]+beta[(k+1)*S+NS[j*I+i]] : INF);
-                    minm=(*p2mymin)(minm,mm);
-                }
-            }
-            post[k*O+n]=minm;
-            if(minm<norm) norm=minm;
-        }
-        for(int n=0;n<O;n++)
-            post[k*O+n]-=norm; // normalize metrics
-    }
-  }
-  else
-    throw std::runtime_error ("Not both POSTI and POSTO can be false.");
-
-  delete [] prioro;
-
+  int m = job / nblocks;
+  int n = job % nblocks;
+  int O = d_FSM.O();
+  int multiple = (d_POSTI ? d_FSM.I() : 0) + (d_POSTO ? O : 0);
+  const float *in1 = (const float *) input_items[2*m];
+  const float *in2 = (const float *) input_items[2*m+1];
+  float *out = (float *) output_items[m];
+  trellis_workspace &ws = d_ws[thread];
+
+  if ((int) ws.metric.size() < d_K*O)
+    ws.metric.resize(d_K*O);
+  const float *observations = &(in2[n*d_K*d_D]);
+  for(int k=0;k<d_K;k++)
+    calc_metric(O, d_D, d_TABLE, &(observations[k*d_D]), &(ws.metric[k*O]), d_TYPE); // calc metrics
+
+  siso_algorithm(d_flat,d_K,d_S0,d_SK,
+    d_POSTI,d_POSTO,d_SISO_TYPE,
+    &(in1[n*d_K*d_FSM.I()]),&(ws.metric[0]),
+    &(out[n*d_K*multiple]),
+    ws);
 }
 
 
-
-
-
-
 int
 trellis_siso_combined_f::general_work (int noutput_items,
                         gr_vector_int &ninput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items)
 {
+  // set_nthreads may be called from another thread while we run;
+  // it only records the count, which is applied here
+  int nthreads = d_nthreads;
+  if ((int) d_ws.size() != nthreads){
+    d_ws.resize (nthreads);
+    d_pool.resize (nthreads);
+  }
+
   assert (input_items.size() == 2*output_items.size());
   int nstreams = output_items.size();
   //printf("general_work:Streams:  %d\n",nstreams); 
@@ -316,30 +194,11 @@ trellis_siso_combined_f::general_work (int noutput_items,
   //for(int i=0;i<ninput_items.size();i++)
       //printf("general_work:Input items available:  %d\n",ninput_items[i]);
 
-  float (*p2min)(float, float) = NULL; 
-  if(d_SISO_TYPE == TRELLIS_MIN_SUM)
-    p2min = &min;
-  else if(d_SISO_TYPE == TRELLIS_SUM_PRODUCT)
-    p2min = &min_star;
-
-
-  for (int m=0;m<nstreams;m++) {
-    const float *in1 = (const float *) input_items[2*m];
-    const float *in2 = (const float *) input_items[2*m+1];
-    float *out = (float *) output_items[m];
-    for (int n=0;n<nblocks;n++) {
-      siso_algorithm_combined(d_FSM.I(),d_FSM.S(),d_FSM.O(),
-        d_FSM.NS(),d_FSM.OS(),d_FSM.PS(),d_FSM.PI(),
-        d_K,d_S0,d_SK,
-        d_POSTI,d_POSTO,
-        p2min,
-        d_D,d_TABLE,d_TYPE,
-        &(in1[n*d_K*d_FSM.I()]),&(in2[n*d_K*d_D]),
-        &(out[n*d_K*multiple])//,
-        //d_alpha,d_beta
-        );
-    }
-  }
+  d_pool.run (nstreams * nblocks,
+              boost::bind (&trellis_siso_combined_f::decode_block, this,
+                           boost::ref (input_items),
+                           boost::ref (output_items),
+                           nblocks, _1, _2));
 
   for (unsigned int i = 0; i < input_items.size()/2; i++) {
     consume(2*i,d_FSM.I() * noutput_items / multiple );
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,7 @@
 
 #include "fsm.h"
 #include "trellis_siso_type.h"
+#include "core_algorithms.h"
 #include <gr_block.h>
 
 class trellis_siso_f;
@@ -37,7 +38,7 @@ trellis_siso_f_sptr trellis_make_siso_f (
     int SK,		// final state (put -1 if not specified)
     bool POSTI,		// true if you want a-posteriori info about the input symbols to be mux-ed in the output
     bool POSTO,		// true if you want a-posteriori info about the output symbols to be mux-ed in the output
-    trellis_siso_type_t d_SISO_TYPE // perform "min-sum" or "sum-product" combining 
+    trellis_siso_type_t d_SISO_TYPE // perform "min-sum" or "sum-product" (exact or tabulated max*) combining
 );
 
 
@@ -53,8 +54,10 @@ class trellis_siso_f : public gr_block
   bool d_POSTI;
   bool d_POSTO;
   trellis_siso_type_t d_SISO_TYPE;
-  //std::vector<float> d_alpha;
-  //std::vector<float> d_beta;
+  trellis_flat d_flat;
+  volatile int d_nthreads;		// applied at the next general_work
+  std::vector<trellis_workspace> d_ws;
+  trellis_thread_pool d_pool;
 
   friend trellis_siso_f_sptr trellis_make_siso_f (
     const fsm &FSM,
@@ -75,6 +78,9 @@ class trellis_siso_f : public gr_block
     bool POSTO,
     trellis_siso_type_t d_SISO_TYPE);
 
+  void decode_block (gr_vector_const_void_star &input_items,
+		     gr_vector_void_star &output_items,
+		     int nblocks, int job, int thread);
 
 public:
   fsm FSM () const { return d_FSM; }
@@ -84,6 +90,10 @@ public:
   bool POSTI () const { return d_POSTI; }
   bool POSTO () const { return d_POSTO; }
   trellis_siso_type_t SISO_TYPE () const { return d_SISO_TYPE; }
+  int nthreads () const { return d_nthreads; }
+  //! Decode independent blocks on up to \p nthreads threads (default 1),
+  //! starting with the next call to general_work
+  void set_nthreads (int nthreads);
   void forecast (int noutput_items,
                  gr_vector_int &ninput_items_required);
   int general_work (int noutput_items,
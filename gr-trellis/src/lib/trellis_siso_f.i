@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -52,4 +52,6 @@ public:
     bool POSTI () const { return d_POSTI; }
     bool POSTO () const { return d_POSTO; }
     trellis_siso_type_t SISO_TYPE () const { return d_SISO_TYPE; }
+    int nthreads () const { return d_nthreads; }
+    void set_nthreads (int nthreads);
 };
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -24,7 +24,7 @@
 #define INCLUDED_TRELLIS_SISO_TYPE_H
 
 typedef enum {
-  TRELLIS_MIN_SUM = 200, TRELLIS_SUM_PRODUCT
+  TRELLIS_MIN_SUM = 200, TRELLIS_SUM_PRODUCT, TRELLIS_SUM_PRODUCT_TABLE
 } trellis_siso_type_t;
 
 #endif
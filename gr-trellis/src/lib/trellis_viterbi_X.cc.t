@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -28,10 +28,10 @@
 
 #include <@NAME@.h>
 #include <gr_io_signature.h>
+#include <boost/bind.hpp>
 #include <assert.h>
 #include <iostream>
-  
-static const float INF = 1.0e9;
+#include <algorithm>
 
 @SPTR_NAME@ 
 trellis_make_@BASE_NAME@ (
@@ -54,8 +54,10 @@ trellis_make_@BASE_NAME@ (
   d_FSM (FSM),
   d_K (K),
   d_S0 (S0),
-  d_SK (SK)//,
-  //d_trace(FSM.S()*K)
+  d_SK (SK),
+  d_flat (FSM),
+  d_nthreads (1),
+  d_ws (1)
 {
     set_relative_rate (1.0 / ((double) d_FSM.O()));
     set_output_multiple (d_K);
@@ -76,74 +78,27 @@ void
 
 
 
-void viterbi_algorithm(int I, int S, int O, 
-             const std::vector<int> &NS,
-             const std::vector<int> &OS,
-             const std::vector< std::vector<int> > &PS,
-             const std::vector< std::vector<int> > &PI,
-             int K,
-             int S0,int SK,
-             const float *in, @TYPE@ *out)//,
-             //std::vector<int> &trace) 
+void
+@NAME@::set_nthreads (int nthreads)
 {
-  std::vector<int> trace(S*K);
-  std::vector<float> alpha(S*2);
-  int alphai;
-  float norm,mm,minm;
-  int minmi;
-  int st;
-
-
-  if(S0<0) { // initial state not specified
-      for(int i=0;i<S;i++) alpha[0*S+i]=0;
-  }
-  else {
-      for(int i=0;i<S;i++) alpha[0*S+i]=INF;
-      alpha[0*S+S0]=0.0;
-  }
-
-  alphai=0;
-  for(int k=0;k<K;k++) {
-      norm=INF;
-      for(int j=0;j<S;j++) { // for each next state do ACS
-          minm=INF;
-          minmi=0;
-          for(unsigned int i=0;i<PS[j].size();i++) {
-              //int i0 = j*I+i;
-              if((mm=alpha[alphai*S+PS[j][i]]+in[k*O+OS[PS[j][i]*I+PI[j][i]]])<minm)
-                  minm=mm,minmi=i;
-          }
-          trace[k*S+j]=minmi;
-          alpha[((alphai+1)%2)*S+j]=minm;
-          if(minm<norm) norm=minm;
-      }
-      for(int j=0;j<S;j++) 
-          alpha[((alphai+1)%2)*S+j]-=norm; // normalize total metrics so they do not explode
-      alphai=(alphai+1)%2;
-  }
-
-  if(SK<0) { // final state not specified
-      minm=INF;
-      minmi=0;
-      for(int i=0;i<S;i++)
-          if((mm=alpha[alphai*S+i])<minm) minm=mm,minmi=i;
-      st=minmi;
-  }
-  else {
-      st=SK;
-  }
-
-  for(int k=K-1;k>=0;k--) { // traceback
-      int i0=trace[k*S+st];
-      out[k]= (@TYPE@) PI[st][i0];
-      st=PS[st][i0];
-  }
-
+  d_nthreads = std::max (1, nthreads);
 }
 
 
-
-
+void
+@NAME@::decode_block (gr_vector_const_void_star &input_items,
+                      gr_vector_void_star &output_items,
+                      int nblocks, int job, int thread)
+{
+  int m = job / nblocks;
+  int n = job % nblocks;
+  const float *in = (const float *) input_items[m];
+  @TYPE@ *out = (@TYPE@ *) output_items[m];
+  trellis_workspace &ws = d_ws[thread];
+
+  int st = viterbi_forward (d_flat, d_K, d_S0, d_SK, &(in[n*d_K*d_FSM.O()]), ws);
+  viterbi_traceback (d_flat, d_K, st, ws, &(out[n*d_K]));
+}
 
 
 int
@@ -152,18 +107,24 @@ int
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items)
 {
+  // set_nthreads may be called from another thread while we run;
+  // it only records the count, which is applied here
+  int nthreads = d_nthreads;
+  if ((int) d_ws.size() != nthreads){
+    d_ws.resize (nthreads);
+    d_pool.resize (nthreads);
+  }
+
   assert (input_items.size() == output_items.size());
   int nstreams = input_items.size();
   assert (noutput_items % d_K == 0);
   int nblocks = noutput_items / d_K;
 
-  for (int m=0;m<nstreams;m++) {
-    const float *in = (const float *) input_items[m];
-    @TYPE@ *out = (@TYPE@ *) output_items[m];
-    for (int n=0;n<nblocks;n++) {
-      viterbi_algorithm(d_FSM.I(),d_FSM.S(),d_FSM.O(),d_FSM.NS(),d_FSM.OS(),d_FSM.PS(),d_FSM.PI(),d_K,d_S0,d_SK,&(in[n*d_K*d_FSM.O()]),&(out[n*d_K]));//,d_trace);
-    }
-  }
+  d_pool.run (nstreams * nblocks,
+              boost::bind (&@NAME@::decode_block, this,
+                           boost::ref (input_items),
+                           boost::ref (output_items),
+                           nblocks, _1, _2));
 
   consume_each (d_FSM.O() * noutput_items );
   return noutput_items;
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,6 +26,7 @@
 #define @GUARD_NAME@
 
 #include "fsm.h"
+#include "core_algorithms.h"
 #include <gr_block.h>
 
 class @NAME@;
@@ -48,7 +49,10 @@ class @NAME@ : public gr_block
   int d_K;
   int d_S0;
   int d_SK;
-  //std::vector<int> d_trace;
+  trellis_flat d_flat;
+  volatile int d_nthreads;		// applied at the next general_work
+  std::vector<trellis_workspace> d_ws;
+  trellis_thread_pool d_pool;
 
   friend @SPTR_NAME@ trellis_make_@BASE_NAME@ (
     const fsm &FSM,
@@ -63,13 +67,19 @@ class @NAME@ : public gr_block
     int S0,
     int SK);
 
+  void decode_block (gr_vector_const_void_star &input_items,
+		     gr_vector_void_star &output_items,
+		     int nblocks, int job, int thread);
 
 public:
   fsm FSM () const { return d_FSM; }
   int K () const { return d_K; }
   int S0 () const { return d_S0; }
   int SK () const { return d_SK; }
-  //std::vector<int> trace () const { return d_trace; }
+  int nthreads () const { return d_nthreads; }
+  //! Decode independent blocks on up to \p nthreads threads (default 1),
+  //! starting with the next call to general_work
+  void set_nthreads (int nthreads);
   void forecast (int noutput_items,
                  gr_vector_int &ninput_items_required);
   int general_work (int noutput_items,
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -45,5 +45,6 @@ public:
     int K () const { return d_K; }
     int S0 () const { return d_S0; }
     int SK () const { return d_SK; }
-    //std::vector<short> trace () const { return d_trace; }
+    int nthreads () const { return d_nthreads; }
+    void set_nthreads (int nthreads);
 };
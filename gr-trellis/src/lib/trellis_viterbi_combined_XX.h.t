@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,6 +26,7 @@
 #define @GUARD_NAME@
 
 #include "fsm.h"
+#include "core_algorithms.h"
 #include <gr_block.h>
 #include "trellis_calc_metric.h"
 
@@ -54,7 +55,12 @@ class @NAME@ : public gr_block
   int d_D;
   std::vector<@I_TYPE@> d_TABLE;
   trellis_metric_type_t d_TYPE;
-  //std::vector<int> d_trace;
+  trellis_flat d_flat;
+  std::vector<float> d_table;
+  int d_C;
+  volatile int d_nthreads;		// applied at the next general_work
+  std::vector<trellis_workspace> d_ws;
+  trellis_thread_pool d_pool;
 
   friend @SPTR_NAME@ trellis_make_@BASE_NAME@ (
     const fsm &FSM,
@@ -75,6 +81,9 @@ class @NAME@ : public gr_block
     const std::vector<@I_TYPE@> &TABLE,
     trellis_metric_type_t TYPE);
 
+  void decode_block (gr_vector_const_void_star &input_items,
+		     gr_vector_void_star &output_items,
+		     int nblocks, int job, int thread);
 
 public:
   fsm FSM () const { return d_FSM; }
@@ -84,7 +93,10 @@ public:
   int D () const { return d_D; }
   std::vector<@I_TYPE@> TABLE () const { return d_TABLE; }
   trellis_metric_type_t TYPE () const { return d_TYPE; }
-  //std::vector<int> trace () const { return d_trace; }
+  int nthreads () const { return d_nthreads; }
+  //! Decode independent blocks on up to \p nthreads threads (default 1),
+  //! starting with the next call to general_work
+  void set_nthreads (int nthreads);
   void set_TABLE (const std::vector<@I_TYPE@> &table);
   void forecast (int noutput_items,
                  gr_vector_int &ninput_items_required);
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2004 Free Software Foundation, Inc.
+ * Copyright 2004,2010 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -54,6 +54,7 @@ public:
     int D () const { return d_D; }
     std::vector<@I_TYPE@> TABLE () const { return d_TABLE; }
     trellis_metric_type_t TYPE () const { return d_TYPE; }
-    //std::vector<short> trace () const { return d_trace; }
+    int nthreads () const { return d_nthreads; }
+    void set_nthreads (int nthreads);
     void set_TABLE (const std::vector<@I_TYPE@> &table);
 };
@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 #
-# Copyright 2004 Free Software Foundation, Inc.
+# Copyright 2004,2010 Free Software Foundation, Inc.
 # 
 # This file is part of GNU Radio
 # 
@@ -67,6 +67,61 @@ class qa_trellis (gr_unittest.TestCase):
         DIN = (4,0,1,2,3)
         i = trellis.interleaver(K,IN)
         self.assertEqual((K,IN,DIN),(i.K(),i.INTER(),i.DEINTER()))
+    def _coded_metrics (self, f, src):
+        # noiseless 1-D "constellation" 0..O-1, squared distance metrics
+        table = [float(x) for x in range(f.O())]
+        return (gr.vector_source_s (src), trellis.encoder_ss (f, 0),
+                gr.short_to_float (), trellis.metrics_f (f.O(), 1, table, trellis.TRELLIS_EUCLIDEAN))
+
+    def test_001_viterbi (self):
+        f = trellis.fsm(2, 4, 4, (0, 2, 0, 2, 1, 3, 1, 3), (0, 3, 3, 0, 1, 2, 2, 1))
+        K = 50
+        src = tuple([(i * 7 + i / 3) % 2 for i in range(8 * K)])
+        for nthreads in (1, 3):
+            vit = trellis.viterbi_s (f, K, 0, -1)
+            vit.set_nthreads (nthreads)
+            self.assertEqual (nthreads, vit.nthreads ())
+            dst = gr.vector_sink_s ()
+            self.tb = gr.top_block ()
+            self.tb.connect (*(self._coded_metrics (f, src) + (vit, dst)))
+            self.tb.run ()
+            self.assertEqual (src, dst.data ())
+
+    def test_001_viterbi_combined (self):
+        f = trellis.fsm(2, 4, 4, (0, 2, 0, 2, 1, 3, 1, 3), (0, 3, 3, 0, 1, 2, 2, 1))
+        K = 50
+        table = [float(x) for x in range(f.O())]
+        src = tuple([(i * 3 + i / 5) % 2 for i in range(8 * K)])
+        vit = trellis.viterbi_combined_fs (f, K, 0, -1, 1, table, trellis.TRELLIS_EUCLIDEAN)
+        dst = gr.vector_sink_s ()
+        self.tb.connect (gr.vector_source_s (src), trellis.encoder_ss (f, 0),
+                         gr.short_to_float (), vit, dst)
+        self.tb.run ()
+        self.assertEqual (src, dst.data ())
+
+    def test_001_siso (self):
+        f = trellis.fsm(2, 4, 4, (0, 2, 0, 2, 1, 3, 1, 3), (0, 3, 3, 0, 1, 2, 2, 1))
+        K = 50
+        src = tuple([(i * 5 + i / 7) % 2 for i in range(4 * K)])
+        result = {}
+        for siso_type in (trellis.TRELLIS_MIN_SUM, trellis.TRELLIS_SUM_PRODUCT,
+                          trellis.TRELLIS_SUM_PRODUCT_TABLE):
+            siso = trellis.siso_f (f, K, 0, -1, True, False, siso_type)
+            siso.set_nthreads (2)
+            dst = gr.vector_sink_f ()
+            self.tb = gr.top_block ()
+            self.tb.connect (gr.vector_source_f ([0.0] * (2 * len(src))), (siso, 0))
+            self.tb.connect (*(self._coded_metrics (f, src) + ((siso, 1),)))
+            self.tb.connect (siso, dst)
+            self.tb.run ()
+            post = dst.data ()
+            decided = tuple([int(post[2*k+1] < post[2*k]) for k in range(len(src))])
+            self.assertEqual (src, decided)
+            result[siso_type] = post
+        self.assertFloatTuplesAlmostEqual (result[trellis.TRELLIS_SUM_PRODUCT],
+                                           result[trellis.TRELLIS_SUM_PRODUCT_TABLE], 3)
+
+
 
 
 
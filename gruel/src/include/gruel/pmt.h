@@ -765,6 +765,39 @@ bool pmt_serialize(pmt_t obj, std::streambuf &sink);
  */
 pmt_t pmt_deserialize(std::streambuf &source);
 
+/*!
+ * \brief Append portable byte-serial representation of \p obj to \p buf
+ *
+ * Uniform vectors are written in host byte order with a single copy,
+ * padded so that their data is aligned relative to the start of \p buf.
+ */
+void pmt_serialize(pmt_t obj, std::string &buf);
+
+//! Return portable byte-serial representation of \p obj as a string
+std::string pmt_serialize_str(pmt_t obj);
+
+/*!
+ * \brief Create obj from the portable byte-serial representation in \p buf
+ *
+ * \p consumed is set to the number of bytes used.
+ * Returns PMT_EOF if \p len is zero.
+ */
+pmt_t pmt_deserialize(const void *buf, size_t len, size_t &consumed);
+
+//! Create obj from a string returned by pmt_serialize_str
+pmt_t pmt_deserialize_str(const std::string &str);
+
+/*!
+ * \brief Create obj from the portable byte-serial representation in \p blob,
+ * starting \p offset bytes in, without copying uniform vector data.
+ *
+ * Uniform vectors in the result share \p blob's storage (and hold a
+ * reference to it) when their data is in host byte order and suitably
+ * aligned; otherwise they are copied.  \p offset is advanced past the
+ * object, so a blob containing several objects can be read in turn.
+ */
+pmt_t pmt_deserialize_nocopy(pmt_t blob, size_t &offset);
+
 
 void pmt_dump_sizeof();	// debugging
 
@@ -28,15 +28,26 @@
 namespace pmt {
 
 /*!
- * \brief very simple thread-safe fixed-size allocation pool
+ * \brief thread-safe fixed-size allocation pool
  *
- * FIXME may want to go to global allocation with per-thread free list.
- * This would eliminate virtually all lock contention.
+ * Each thread keeps a small private free list for each pool, so malloc
+ * and free normally touch no shared state.  A thread whose list grows
+ * too long hands a batch of items back to the pool with a lock-free
+ * push; a thread whose list is empty takes the pool's lock just long
+ * enough to pop a batch (or carve one from a new chunk).
+ *
+ * Pools created with a \p max_items limit use a single locked free
+ * list, since items held by other threads can't be counted.  So do
+ * pools created while 32 others with per-thread lists exist.
+ *
+ * If the environment variable GR_PMT_POOL_USE_HEAP is set, every item
+ * is allocated separately from the heap instead (e.g., for valgrind).
  */
 class pmt_pool {
 
   struct item {
     struct item	*d_next;
+    struct item *d_next_batch;		// used by the first item of a batch
   };
   
   typedef boost::unique_lock<boost::mutex>  scoped_lock;
@@ -50,6 +61,16 @@ class pmt_pool {
   size_t	      d_n_items;
   item	       	     *d_freelist;
   std::vector<char *> d_allocations;
+  int		      d_id;		// index of our per-thread free lists, or -1
+  unsigned long	      d_gen;		// tells our lists from a past owner's of d_id
+  item * volatile     d_returned;	// stack of batches handed back by threads
+
+  item *new_chunk();
+  item *take_batch(size_t &n);
+  void *cached_malloc();
+  void cached_free(void *p);
+  void push_returned(item *head, item *tail);
+  static void release_thread_caches(void *arg);
 
 public:
   /*!
@@ -65,6 +86,9 @@ public:
 
   void *malloc();
   void free(void *p);
+
+  //! True if pools are allocating from the heap (GR_PMT_POOL_USE_HEAP is set)
+  static bool use_heap();
 };
 
 } /* namespace pmt */
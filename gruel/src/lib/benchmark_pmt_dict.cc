@@ -0,0 +1,87 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Compare a-list and hash dictionaries: per-packet style updates of an
+ * existing key, and lookups, across a range of dictionary sizes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <gruel/pmt.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <vector>
+
+using namespace pmt;
+
+static const long OPS = 200000;
+
+static double
+now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+static void
+benchmark(const char *name, pmt_t empty, size_t nkeys)
+{
+  std::vector<pmt_t> keys(nkeys);
+  for (size_t i = 0; i < nkeys; i++){
+    char buf[32];
+    snprintf(buf, sizeof(buf), "key-%zd", i);
+    keys[i] = pmt_string_to_symbol(buf);
+  }
+
+  pmt_t dict = empty;
+  for (size_t i = 0; i < nkeys; i++)
+    dict = pmt_dict_add(dict, keys[i], pmt_from_long(i));
+
+  double t0 = now();
+  for (long i = 0; i < OPS; i++)
+    dict = pmt_dict_add(dict, keys[i % nkeys], pmt_from_long(i));
+  double t_add = now() - t0;
+
+  long sum = 0;
+  t0 = now();
+  for (long i = 0; i < OPS; i++)
+    sum += pmt_to_long(pmt_dict_ref(dict, keys[i % nkeys], PMT_NIL));
+  double t_ref = now() - t0;
+
+  printf("%6s  %5zd keys:  update %10.3e/s   ref %10.3e/s   (%ld)\n",
+	 name, nkeys, OPS / t_add, OPS / t_ref, sum & 1);
+}
+
+int
+main(int argc, char **argv)
+{
+  static const size_t sizes[] = { 4, 16, 64, 256 };
+
+  for (size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++){
+    benchmark("alist", PMT_NIL, sizes[i]);
+    benchmark("hash", pmt_make_dict(), sizes[i]);
+  }
+  return 0;
+}
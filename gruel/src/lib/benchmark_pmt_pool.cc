@@ -0,0 +1,117 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Allocation rate of pmt objects, in one thread and in several
+ * threads at once, and of a raw pmt_pool against operator new.
+ * Run with GR_PMT_POOL_USE_HEAP set to compare against the heap.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <gruel/pmt.h>
+#include <gruel/pmt_pool.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <vector>
+
+using namespace pmt;
+
+static const long NOPS = 4000000;
+static const int  LIST_LEN = 64;
+
+static double
+now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+// Build and drop short lists: one pair and one integer per element.
+// (The lists don't end in PMT_NIL, so the threads share no reference counts.)
+static void
+cons_lists(long nops)
+{
+  for (long i = 0; i < nops; i += 2 * LIST_LEN){
+    pmt_t l = pmt_from_long(0);
+    for (int j = 0; j < LIST_LEN; j++)
+      l = pmt_cons(pmt_from_long(j), l);
+  }
+}
+
+static void
+bench_threads(int nthreads)
+{
+  boost::thread_group threads;
+  double t0 = now();
+  for (int i = 0; i < nthreads; i++)
+    threads.create_thread(boost::bind(cons_lists, NOPS));
+  threads.join_all();
+  double dt = now() - t0;
+
+  printf("pmt objects, %d thread(s):  %10.3e allocs/s\n",
+	 nthreads, nthreads * NOPS / dt);
+}
+
+static void
+bench_raw()
+{
+  static const size_t NITEMS = 256;
+  std::vector<void *> items(NITEMS);
+  pmt_pool pool(32, 16);
+
+  double t0 = now();
+  for (long i = 0; i < NOPS; i += NITEMS){
+    for (size_t j = 0; j < NITEMS; j++)
+      items[j] = pool.malloc();
+    for (size_t j = 0; j < NITEMS; j++)
+      pool.free(items[j]);
+  }
+  double dt = now() - t0;
+  printf("pmt_pool malloc/free:       %10.3e allocs/s\n", NOPS / dt);
+
+  t0 = now();
+  for (long i = 0; i < NOPS; i += NITEMS){
+    for (size_t j = 0; j < NITEMS; j++)
+      items[j] = ::operator new(32);
+    for (size_t j = 0; j < NITEMS; j++)
+      ::operator delete(items[j]);
+  }
+  dt = now() - t0;
+  printf("operator new/delete:        %10.3e allocs/s\n", NOPS / dt);
+}
+
+int
+main(int argc, char **argv)
+{
+  printf("pools %s\n", pmt_pool::use_heap() ? "using the heap" : "enabled");
+
+  bench_raw();
+  for (int n = 1; n <= 4; n *= 2)
+    bench_threads(n);
+  return 0;
+}
@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Small-message rate and large uniform-vector bandwidth of
+ * pmt_serialize / pmt_deserialize, through a std::streambuf and
+ * through a contiguous buffer.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <gruel/pmt.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <sstream>
+#include <vector>
+
+using namespace pmt;
+
+static double
+now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+static void
+report(const char *name, long n, size_t nbytes, double secs)
+{
+  printf("%-30s %10.3e msgs/s  %8.1f MB/s\n",
+	 name, n / secs, (double) n * nbytes / secs / 1e6);
+}
+
+static void
+benchmark(const char *label, pmt_t msg, long n)
+{
+  char name[64];
+  std::string buf = pmt_serialize_str(msg);
+  size_t nbytes = buf.size();
+  size_t consumed;
+
+  double t0 = now();
+  for (long i = 0; i < n; i++){
+    std::stringbuf sb;
+    pmt_serialize(msg, sb);
+  }
+  snprintf(name, sizeof(name), "%s serialize (streambuf)", label);
+  report(name, n, nbytes, now() - t0);
+
+  t0 = now();
+  for (long i = 0; i < n; i++){
+    buf.clear();
+    pmt_serialize(msg, buf);
+  }
+  snprintf(name, sizeof(name), "%s serialize (buffer)", label);
+  report(name, n, nbytes, now() - t0);
+
+  std::stringbuf sb;
+  pmt_serialize(msg, sb);
+  t0 = now();
+  for (long i = 0; i < n; i++){
+    sb.pubseekpos(0, std::ios_base::in);
+    pmt_deserialize(sb);
+  }
+  snprintf(name, sizeof(name), "%s deserialize (streambuf)", label);
+  report(name, n, nbytes, now() - t0);
+
+  t0 = now();
+  for (long i = 0; i < n; i++)
+    pmt_deserialize(buf.data(), buf.size(), consumed);
+  snprintf(name, sizeof(name), "%s deserialize (buffer)", label);
+  report(name, n, nbytes, now() - t0);
+
+  pmt_t blob = pmt_make_blob(buf.data(), buf.size());
+  t0 = now();
+  for (long i = 0; i < n; i++){
+    size_t offset = 0;
+    pmt_deserialize_nocopy(blob, offset);
+  }
+  snprintf(name, sizeof(name), "%s deserialize (nocopy)", label);
+  report(name, n, nbytes, now() - t0);
+}
+
+int
+main(int argc, char **argv)
+{
+  // a typical control message
+  pmt_t small = pmt_list3(pmt_intern("cmd-set-freq"),
+			  pmt_from_long(7),
+			  pmt_list2(pmt_from_double(2.4e9), pmt_intern("rx")));
+  benchmark("small", small, 500000);
+
+  // a block of samples
+  std::vector<std::complex<float> > samples(256 * 1024);
+  pmt_t large = pmt_list2(pmt_intern("samples"),
+			  pmt_init_c32vector(samples.size(), &samples[0]));
+  benchmark("2MB", large, 200);
+
+  return 0;
+}
@@ -33,26 +33,44 @@
 
 namespace pmt {
 
-static const int CACHE_LINE_SIZE = 64;		// good guess
-
 # if (PMT_LOCAL_ALLOCATOR)
 
-static pmt_pool global_pmt_pool(sizeof(pmt_pair), CACHE_LINE_SIZE);
+/*
+ * Size classes for pmt objects; anything larger comes from the heap.
+ * The pools are never destroyed, since static pmt objects elsewhere may
+ * outlive this file's statics.
+ */
+static pmt_pool *
+pool_for_size(size_t size)
+{
+  static pmt_pool *pool_32  = new pmt_pool(32, 16);
+  static pmt_pool *pool_64  = new pmt_pool(64, 16);
+  static pmt_pool *pool_128 = new pmt_pool(128, 16);
+
+  if (size <= 32)
+    return pool_32;
+  if (size <= 64)
+    return pool_64;
+  if (size <= 128)
+    return pool_128;
+  return 0;
+}
 
 void *
 pmt_base::operator new(size_t size)
 {
-  void *p = global_pmt_pool.malloc();
-
-  // fprintf(stderr, "pmt_base::new p = %p\n", p);
-  assert((reinterpret_cast<intptr_t>(p) & (CACHE_LINE_SIZE - 1)) == 0);
-  return p;
+  pmt_pool *pool = pool_for_size(size);
+  return pool ? pool->malloc() : ::operator new(size);
 }
 
 void
 pmt_base::operator delete(void *p, size_t size)
 {
-  global_pmt_pool.free(p);
+  pmt_pool *pool = pool_for_size(size);
+  if (pool)
+    pool->free(p);
+  else
+    ::operator delete(p);
 }
 
 #endif
@@ -135,6 +153,12 @@ _tuple(pmt_t x)
   return dynamic_cast<pmt_tuple*>(x.get());
 }
 
+static pmt_dict *
+_dict(pmt_t x)
+{
+  return dynamic_cast<pmt_dict*>(x.get());
+}
+
 static pmt_uniform_vector *
 _uniform_vector(pmt_t x)
 {
@@ -723,28 +747,30 @@ pmt_uniform_vector_writable_elements(pmt_t vector, size_t &len)
 ////////////////////////////////////////////////////////////////////////////
 
 /*
- * This is an a-list implementation.
- *
- * When we need better performance for large dictionaries, consider implementing
- * persistent Red-Black trees as described in "Purely Functional Data Structures", 
- * Chris Okasaki, 1998, section 3.3.
+ * pmt_make_dict returns a pmt_dict, a persistent hash array mapped trie
+ * (see pmt_dict.cc).  For backward compatibility an a-list of
+ * (key . value) pairs, including the empty list, is still accepted
+ * anywhere a dictionary is, and is updated as an a-list.
  */
 
 bool
 pmt_is_dict(const pmt_t &obj)
 {
-  return pmt_is_null(obj) || pmt_is_pair(obj);
+  return obj->is_dict() || pmt_is_null(obj) || pmt_is_pair(obj);
 }
 
 pmt_t
 pmt_make_dict()
 {
-  return PMT_NIL;
+  return pmt_t(new pmt_dict());
 }
 
 pmt_t
 pmt_dict_add(const pmt_t &dict, const pmt_t &key, const pmt_t &value)
 {
+  if (dict->is_dict())
+    return _dict(dict)->add(key, value);
+
   if (pmt_is_null(dict))
     return pmt_acons(key, value, PMT_NIL);
 
@@ -757,6 +783,9 @@ pmt_dict_add(const pmt_t &dict, const pmt_t &key, const pmt_t &value)
 pmt_t
 pmt_dict_delete(const pmt_t &dict, const pmt_t &key)
 {
+  if (dict->is_dict())
+    return _dict(dict)->remove(key);
+
   if (pmt_is_null(dict))
     return dict;
 
@@ -769,6 +798,11 @@ pmt_dict_delete(const pmt_t &dict, const pmt_t &key)
 pmt_t
 pmt_dict_ref(const pmt_t &dict, const pmt_t &key, const pmt_t &not_found)
 {
+  if (dict->is_dict()){
+    const pmt_t *v = _dict(dict)->find(key);
+    return v ? *v : not_found;
+  }
+
   pmt_t	p = pmt_assv(key, dict);	// look for (key . value) pair
   if (pmt_is_pair(p))
     return pmt_cdr(p);
@@ -779,6 +813,9 @@ pmt_dict_ref(const pmt_t &dict, const pmt_t &key, const pmt_t &not_found)
 bool
 pmt_dict_has_key(const pmt_t &dict, const pmt_t &key)
 {
+  if (dict->is_dict())
+    return _dict(dict)->find(key) != 0;
+
   return pmt_is_pair(pmt_assv(key, dict));
 }
 
@@ -788,6 +825,9 @@ pmt_dict_items(pmt_t dict)
   if (!pmt_is_dict(dict))
     throw pmt_wrong_type("pmt_dict_values", dict);
 
+  if (dict->is_dict())
+    return _dict(dict)->items();
+
   return dict;		// equivalent to dict in the a-list case
 }
 
@@ -797,7 +837,7 @@ pmt_dict_keys(pmt_t dict)
   if (!pmt_is_dict(dict))
     throw pmt_wrong_type("pmt_dict_keys", dict);
 
-  return pmt_map(pmt_car, dict);
+  return pmt_map(pmt_car, pmt_dict_items(dict));
 }
 
 pmt_t
@@ -806,7 +846,7 @@ pmt_dict_values(pmt_t dict)
   if (!pmt_is_dict(dict))
     throw pmt_wrong_type("pmt_dict_keys", dict);
 
-  return pmt_map(pmt_cdr, dict);
+  return pmt_map(pmt_cdr, pmt_dict_items(dict));
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -998,11 +1038,27 @@ pmt_equal(const pmt_t& x, const pmt_t& y)
       return false;
 
     size_t len_x, len_y;
-    if (memcmp(xv->uniform_elements(len_x),
-	       yv->uniform_elements(len_y),
-	       len_x) == 0)
+    const void *px = xv->uniform_elements(len_x);
+    const void *py = yv->uniform_elements(len_y);
+    if (len_x != len_y)
+      return false;
+    if (len_x == 0)		// the elements may both be null
       return true;
 
+    return memcmp(px, py, len_x) == 0;
+  }
+
+  if (x->is_dict() && y->is_dict()){
+    pmt_dict *xd = _dict(x);
+    pmt_dict *yd = _dict(y);
+    if (xd->size() != yd->size())
+      return false;
+
+    for (pmt_t items = xd->items(); pmt_is_pair(items); items = pmt_cdr(items)){
+      const pmt_t *v = yd->find(pmt_caar(items));
+      if (v == 0 || !pmt_equal(pmt_cdar(items), *v))
+	return false;
+    }
     return true;
   }
 
@@ -1040,7 +1096,8 @@ pmt_length(const pmt_t& x)
     throw pmt_wrong_type("pmt_length", x);
   }
 
-  // FIXME dictionary length (number of entries)
+  if (x->is_dict())
+    return _dict(x)->size();
 
   throw pmt_wrong_type("pmt_length", x);
 }
@@ -0,0 +1,318 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <gruel/pmt.h>
+#include "pmt_int.h"
+#include <vector>
+#include <algorithm>
+#include <string.h>
+
+/*
+ * Hash array mapped trie, see Phil Bagwell, "Ideal Hash Trees", 2001.
+ *
+ * Each node consumes BITS bits of the 32-bit key hash.  A node holds a
+ * bitmap of occupied slots and a dense vector with one entry per set
+ * bit; an entry is either a (key, value) leaf or a child node.  Below
+ * MAX_DEPTH the hash is used up, and a node is a plain list of leaves
+ * whose hashes fully collide.
+ */
+
+namespace pmt {
+
+static const unsigned int BITS = 5;
+static const unsigned int MASK = (1 << BITS) - 1;
+static const unsigned int MAX_DEPTH = 32 / BITS;
+
+struct pmt_dict_entry
+{
+  uint32_t		d_hash;
+  unsigned long		d_stamp;	// for ordering pmt_dict_items
+  pmt_t			d_key;
+  pmt_t			d_value;
+  pmt_dict::node_sptr	d_child;	// non-null => this is an interior entry
+
+  pmt_dict_entry() : d_hash(0), d_stamp(0) {}
+  pmt_dict_entry(uint32_t hash, unsigned long stamp, const pmt_t &key, const pmt_t &value)
+    : d_hash(hash), d_stamp(stamp), d_key(key), d_value(value) {}
+};
+
+struct pmt_dict::node
+{
+  uint32_t			d_bitmap;
+  std::vector<pmt_dict_entry>	d_entries;
+
+  node() : d_bitmap(0) {}
+};
+
+typedef pmt_dict::node		node_t;
+typedef pmt_dict::node_sptr	node_sptr;
+
+static inline uint32_t
+mix(uint64_t x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return (uint32_t) x;
+}
+
+static inline uint64_t
+double_bits(double d)
+{
+  if (d == 0.0)			// +0.0 and -0.0 are eqv
+    d = 0.0;
+  uint64_t u;
+  memcpy(&u, &d, sizeof(u));
+  return u;
+}
+
+/*
+ * Must agree with pmt_eqv: numbers hash by value, everything else
+ * (symbols in particular, which are interned) by identity.
+ */
+static uint32_t
+pmt_dict_hash(const pmt_t &key)
+{
+  if (key->is_number()){
+    if (key->is_integer())
+      return mix(pmt_to_long(key));
+    if (key->is_real())
+      return mix(double_bits(pmt_to_double(key)));
+    if (key->is_complex()){
+      std::complex<double> c = pmt_to_complex(key);
+      return mix(double_bits(c.real()) ^ (double_bits(c.imag()) * 31));
+    }
+  }
+  return mix((uintptr_t) key.get());
+}
+
+static inline unsigned int
+slot(uint32_t hash, unsigned int depth)
+{
+  return (hash >> (depth * BITS)) & MASK;
+}
+
+static inline unsigned int
+entry_index(uint32_t bitmap, unsigned int bit)
+{
+  return __builtin_popcount(bitmap & ((1U << bit) - 1));
+}
+
+// Returns a new node with e added; added is set if the key was not present
+static node_sptr
+dict_insert(const node_sptr &n, unsigned int depth, const pmt_dict_entry &e, bool &added)
+{
+  node_sptr r(n ? new node_t(*n) : new node_t());
+
+  if (depth >= MAX_DEPTH){
+    for (size_t i = 0; i < r->d_entries.size(); i++){
+      if (pmt_eqv(r->d_entries[i].d_key, e.d_key)){
+	r->d_entries[i] = e;
+	return r;
+      }
+    }
+    r->d_entries.push_back(e);
+    added = true;
+    return r;
+  }
+
+  unsigned int bit = slot(e.d_hash, depth);
+  unsigned int idx = entry_index(r->d_bitmap, bit);
+
+  if ((r->d_bitmap & (1U << bit)) == 0){
+    r->d_entries.insert(r->d_entries.begin() + idx, e);
+    r->d_bitmap |= 1U << bit;
+    added = true;
+    return r;
+  }
+
+  pmt_dict_entry &x = r->d_entries[idx];
+  if (x.d_child)
+    x.d_child = dict_insert(x.d_child, depth + 1, e, added);
+
+  else if (x.d_hash == e.d_hash && pmt_eqv(x.d_key, e.d_key))
+    x = e;
+
+  else {			// push both leaves down a level
+    bool dummy = false;
+    node_sptr c = dict_insert(node_sptr(), depth + 1, x, dummy);
+    c = dict_insert(c, depth + 1, e, added);
+    x = pmt_dict_entry();
+    x.d_child = c;
+  }
+  return r;
+}
+
+// Returns n itself if key is not present, else a new node (or null if empty)
+static node_sptr
+dict_remove(const node_sptr &n, unsigned int depth, uint32_t hash, const pmt_t &key, bool &removed)
+{
+  if (!n)
+    return n;
+
+  if (depth >= MAX_DEPTH){
+    for (size_t i = 0; i < n->d_entries.size(); i++){
+      if (pmt_eqv(n->d_entries[i].d_key, key)){
+	removed = true;
+	if (n->d_entries.size() == 1)
+	  return node_sptr();
+	node_sptr r(new node_t(*n));
+	r->d_entries.erase(r->d_entries.begin() + i);
+	return r;
+      }
+    }
+    return n;
+  }
+
+  unsigned int bit = slot(hash, depth);
+  if ((n->d_bitmap & (1U << bit)) == 0)
+    return n;
+
+  unsigned int idx = entry_index(n->d_bitmap, bit);
+  const pmt_dict_entry &x = n->d_entries[idx];
+  node_sptr child;
+
+  if (x.d_child){
+    child = dict_remove(x.d_child, depth + 1, hash, key, removed);
+    if (!removed)
+      return n;
+  }
+  else if (x.d_hash == hash && pmt_eqv(x.d_key, key))
+    removed = true;
+  else
+    return n;
+
+  node_sptr r(new node_t(*n));
+  pmt_dict_entry &y = r->d_entries[idx];
+
+  if (child && child->d_entries.size() == 1 && !child->d_entries[0].d_child)
+    y = child->d_entries[0];	// pull a lone leaf back up
+  else if (child)
+    y.d_child = child;
+  else {
+    r->d_entries.erase(r->d_entries.begin() + idx);
+    r->d_bitmap &= ~(1U << bit);
+    if (r->d_entries.empty())
+      return node_sptr();
+  }
+  return r;
+}
+
+static void
+collect(const node_sptr &n, std::vector<const pmt_dict_entry *> &out)
+{
+  if (!n)
+    return;
+  for (size_t i = 0; i < n->d_entries.size(); i++){
+    if (n->d_entries[i].d_child)
+      collect(n->d_entries[i].d_child, out);
+    else
+      out.push_back(&n->d_entries[i]);
+  }
+}
+
+static bool
+stamp_less(const pmt_dict_entry *a, const pmt_dict_entry *b)
+{
+  return a->d_stamp < b->d_stamp;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+pmt_dict::pmt_dict()
+  : d_size(0), d_stamp(0)
+{
+}
+
+pmt_dict::pmt_dict(const node_sptr &root, size_t size, unsigned long stamp)
+  : d_root(root), d_size(size), d_stamp(stamp)
+{
+}
+
+const pmt_t *
+pmt_dict::find(const pmt_t &key) const
+{
+  uint32_t hash = pmt_dict_hash(key);
+  const node_t *n = d_root.get();
+
+  for (unsigned int depth = 0; n != 0; depth++){
+    if (depth >= MAX_DEPTH){
+      for (size_t i = 0; i < n->d_entries.size(); i++)
+	if (pmt_eqv(n->d_entries[i].d_key, key))
+	  return &n->d_entries[i].d_value;
+      return 0;
+    }
+
+    unsigned int bit = slot(hash, depth);
+    if ((n->d_bitmap & (1U << bit)) == 0)
+      return 0;
+
+    const pmt_dict_entry &x = n->d_entries[entry_index(n->d_bitmap, bit)];
+    if (x.d_child)
+      n = x.d_child.get();
+    else if (x.d_hash == hash && pmt_eqv(x.d_key, key))
+      return &x.d_value;
+    else
+      return 0;
+  }
+  return 0;
+}
+
+pmt_t
+pmt_dict::add(const pmt_t &key, const pmt_t &value) const
+{
+  bool added = false;
+  pmt_dict_entry e(pmt_dict_hash(key), d_stamp, key, value);
+  node_sptr root = dict_insert(d_root, 0, e, added);
+  return pmt_t(new pmt_dict(root, d_size + (added ? 1 : 0), d_stamp + 1));
+}
+
+pmt_t
+pmt_dict::remove(const pmt_t &key) const
+{
+  bool removed = false;
+  node_sptr root = dict_remove(d_root, 0, pmt_dict_hash(key), key, removed);
+  if (!removed)
+    return pmt_t(const_cast<pmt_dict *>(this));
+  return pmt_t(new pmt_dict(root, d_size - 1, d_stamp));
+}
+
+pmt_t
+pmt_dict::items() const
+{
+  std::vector<const pmt_dict_entry *> v;
+  v.reserve(d_size);
+  collect(d_root, v);
+  std::sort(v.begin(), v.end(), stamp_less);
+
+  pmt_t r = PMT_NIL;
+  for (size_t i = 0; i < v.size(); i++)
+    r = pmt_acons(v[i]->d_key, v[i]->d_value, r);
+  return r;
+}
+
+} /* namespace pmt */
@@ -25,6 +25,7 @@
 #include <gruel/pmt.h>
 #include <boost/utility.hpp>
 #include <boost/detail/atomic_count.hpp>
+#include <boost/shared_ptr.hpp>
 
 /*
  * EVERYTHING IN THIS FILE IS PRIVATE TO THE IMPLEMENTATION!
@@ -32,7 +33,7 @@
  * See pmt.h for the public interface
  */
 
-#define PMT_LOCAL_ALLOCATOR 0		// define to 0 or 1
+#define PMT_LOCAL_ALLOCATOR 1		// define to 0 or 1
 namespace pmt {
 
 class pmt_base : boost::noncopyable {
@@ -203,6 +204,43 @@ public:
   void _set(size_t k, pmt_t v) { d_v[k] = v; }
 };
 
+/*!
+ * \brief Persistent hash map (hash array mapped trie).
+ *
+ * Updates never modify an existing pmt_dict; add and remove return a
+ * new dict that shares all untouched trie nodes with the original, so
+ * an update copies at most one node per level.
+ */
+class pmt_dict : public pmt_base
+{
+public:
+  struct node;
+  typedef boost::shared_ptr<node> node_sptr;
+
+private:
+  node_sptr	d_root;
+  size_t	d_size;
+  unsigned long	d_stamp;	// insertion stamp for the next add
+
+  pmt_dict(const node_sptr &root, size_t size, unsigned long stamp);
+
+public:
+  pmt_dict();
+  //~pmt_dict();
+
+  bool is_dict() const { return true; }
+  size_t size() const { return d_size; }
+
+  //! Return pointer to value associated with key, or 0
+  const pmt_t *find(const pmt_t &key) const;
+
+  pmt_t add(const pmt_t &key, const pmt_t &value) const;
+  pmt_t remove(const pmt_t &key) const;
+
+  //! Return (key . value) alist, most recently added first
+  pmt_t items() const;
+};
+
 class pmt_any : public pmt_base
 {
   boost::any	d_any;
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,35 +25,260 @@
 #include <gruel/pmt_pool.h>
 #include <algorithm>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <new>
 
 namespace pmt {
 
+static const int    MAX_POOLS = 32;	// pools that get per-thread free lists
+static const size_t BATCH = 64;		// items handed back to the pool at a time
+
+struct thread_cache {
+  void	       *d_head;
+  size_t	d_n;
+  unsigned long	d_gen;		// s_gen[] of the pool the list belongs to
+};
+
+struct thread_caches {
+  thread_cache	d_cache[MAX_POOLS];
+};
+
+// These are all statically initialized, since pools are often static too
+static pthread_key_t	s_key;
+static pthread_once_t	s_key_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t	s_pools_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pmt_pool	       *s_pools[MAX_POOLS];	// slot owners, guarded by s_pools_mutex
+static unsigned long	s_gen[MAX_POOLS];	// bumped each time a slot is taken
+static int		s_use_heap = -1;
+static void	      (*s_release)(void *);	// thread exit handler
+
 static inline size_t
 ROUNDUP(size_t x, size_t stride)
 {
   return ((((x) + (stride) - 1)/(stride)) * (stride));
 }
 
+static void
+make_key()
+{
+  pthread_key_create(&s_key, s_release);
+}
+
+static thread_caches *
+my_thread_caches()
+{
+  thread_caches *tc = (thread_caches *) pthread_getspecific(s_key);
+  if (tc == 0){
+    tc = new thread_caches;
+    memset(tc, 0, sizeof(*tc));
+    pthread_setspecific(s_key, tc);
+  }
+  return tc;
+}
+
+// Our free list for slot id, emptied if it was left by a previous owner
+static thread_cache &
+my_thread_cache(int id, unsigned long gen)
+{
+  thread_cache &c = my_thread_caches()->d_cache[id];
+  if (c.d_gen != gen){		// items belonged to a destroyed pool
+    c.d_head = 0;
+    c.d_n = 0;
+    c.d_gen = gen;
+  }
+  return c;
+}
+
+bool
+pmt_pool::use_heap()
+{
+  if (s_use_heap < 0)
+    s_use_heap = getenv("GR_PMT_POOL_USE_HEAP") != 0;
+  return s_use_heap;
+}
+
 pmt_pool::pmt_pool(size_t itemsize, size_t alignment,
 		   size_t allocation_size, size_t max_items)
-  : d_itemsize(ROUNDUP(itemsize, alignment)),
+  : d_itemsize(ROUNDUP(std::max(itemsize, sizeof(item)), alignment)),
     d_alignment(alignment),
     d_allocation_size(std::max(allocation_size, 16 * itemsize)),
     d_max_items(max_items), d_n_items(0),
-    d_freelist(0)
+    d_freelist(0), d_id(-1), d_gen(0), d_returned(0)
 {
+  if (d_max_items == 0 && !use_heap()){
+    pthread_mutex_lock(&s_pools_mutex);
+    for (int id = 0; id < MAX_POOLS; id++){
+      if (s_pools[id] == 0){
+	s_release = release_thread_caches;
+	pthread_once(&s_key_once, make_key);
+	s_pools[id] = this;
+	d_id = id;
+	d_gen = ++s_gen[id];
+	break;
+      }
+    }
+    pthread_mutex_unlock(&s_pools_mutex);
+  }
 }
 
 pmt_pool::~pmt_pool()
 {
+  // Free the slot.  Threads still holding lists for it drop them the
+  // next time they use the slot, since d_gen won't match.
+  if (d_id >= 0){
+    pthread_mutex_lock(&s_pools_mutex);
+    s_pools[d_id] = 0;
+    pthread_mutex_unlock(&s_pools_mutex);
+  }
+
   for (unsigned int i = 0; i < d_allocations.size(); i++){
     delete [] d_allocations[i];
   }
 }
 
+// Allocate a new chunk and return its items as a list.  Caller holds d_mutex.
+pmt_pool::item *
+pmt_pool::new_chunk()
+{
+  char *alloc = new char[d_allocation_size + d_alignment - 1];
+  d_allocations.push_back(alloc);
+
+  // get the alignment we require
+  char *start = (char *)(((uintptr_t)alloc + d_alignment-1) & -d_alignment);
+  char *end = alloc + d_allocation_size + d_alignment - 1;
+  size_t n = (end - start) / d_itemsize;
+
+  // link the new items together
+  item *list = 0;
+  item *p = (item *) start;
+  for (size_t i = 0; i < n; i++){
+    p->d_next = list;
+    list = p;
+    p = (item *)((char *) p + d_itemsize);
+  }
+  return list;
+}
+
+// Lock-free push of a batch of BATCH items onto d_returned
+void
+pmt_pool::push_returned(item *head, item *tail)
+{
+  tail->d_next = 0;
+  item *old = __sync_val_compare_and_swap(&d_returned, (item *) 0, (item *) 0);
+  while (1){
+    head->d_next_batch = old;
+    item *seen = __sync_val_compare_and_swap(&d_returned, old, head);
+    if (seen == old)
+      break;
+    old = seen;
+  }
+}
+
+/*
+ * Return a list of free items and its length.  Batches are only popped
+ * with d_mutex held, so the head of d_returned can't be popped and
+ * pushed again behind our back (no ABA); pushes just make the CAS retry.
+ */
+pmt_pool::item *
+pmt_pool::take_batch(size_t &n)
+{
+  scoped_lock guard(d_mutex);
+
+  // The CASes are full barriers, so head->d_next_batch is read after
+  // the push that published head
+  item *head = __sync_val_compare_and_swap(&d_returned, (item *) 0, (item *) 0);
+  while (head){
+    item *seen = __sync_val_compare_and_swap(&d_returned, head, head->d_next_batch);
+    if (seen == head)
+      break;
+    head = seen;
+  }
+
+  if (head){
+    n = BATCH;
+    return head;
+  }
+
+  if (d_freelist == 0)
+    d_freelist = new_chunk();
+
+  head = d_freelist;
+  item *tail = head;
+  for (n = 1; n < BATCH && tail->d_next; n++)
+    tail = tail->d_next;
+  d_freelist = tail->d_next;
+  tail->d_next = 0;
+  return head;
+}
+
+void *
+pmt_pool::cached_malloc()
+{
+  thread_cache &c = my_thread_cache(d_id, d_gen);
+
+  if (c.d_head == 0)
+    c.d_head = take_batch(c.d_n);
+
+  item *p = (item *) c.d_head;
+  c.d_head = p->d_next;
+  c.d_n--;
+  return p;
+}
+
+void
+pmt_pool::cached_free(void *foo)
+{
+  thread_cache &c = my_thread_cache(d_id, d_gen);
+
+  item *p = (item *) foo;
+  p->d_next = (item *) c.d_head;
+  c.d_head = p;
+  c.d_n++;
+
+  if (c.d_n >= 2 * BATCH){		// hand a batch back
+    item *head = (item *) c.d_head;
+    item *tail = head;
+    for (size_t i = 1; i < BATCH; i++)
+      tail = tail->d_next;
+    c.d_head = tail->d_next;
+    c.d_n -= BATCH;
+    push_returned(head, tail);
+  }
+}
+
+// Called on thread exit with the thread's free lists
+void
+pmt_pool::release_thread_caches(void *arg)
+{
+  thread_caches *tc = (thread_caches *) arg;
+
+  // Holding s_pools_mutex keeps the pools from going away meanwhile
+  pthread_mutex_lock(&s_pools_mutex);
+  for (int i = 0; i < MAX_POOLS; i++){
+    item *head = (item *) tc->d_cache[i].d_head;
+    pmt_pool *pool = s_pools[i];
+    if (head == 0 || pool == 0 || tc->d_cache[i].d_gen != pool->d_gen)
+      continue;
+
+    scoped_lock guard(pool->d_mutex);
+    item *tail = head;
+    while (tail->d_next)
+      tail = tail->d_next;
+    tail->d_next = pool->d_freelist;
+    pool->d_freelist = head;
+  }
+  pthread_mutex_unlock(&s_pools_mutex);
+  delete tc;
+}
+
 void *
 pmt_pool::malloc()
 {
+  if (d_id >= 0)
+    return cached_malloc();
+
   scoped_lock guard(d_mutex);
   item *p;
 
@@ -62,31 +287,17 @@ pmt_pool::malloc()
       d_cond.wait(guard);
   }
 
-  if (d_freelist){	// got something?
-    p = d_freelist;
-    d_freelist = p->d_next;
+  if (use_heap()){
+    void *q = 0;
+    if (posix_memalign(&q, std::max(d_alignment, sizeof(void *)), d_itemsize) != 0)
+      throw std::bad_alloc();
     d_n_items++;
-    return p;
+    return q;
   }
 
-  // allocate a new chunk
-  char *alloc = new char[d_allocation_size + d_alignment - 1];
-  d_allocations.push_back(alloc);
-
-  // get the alignment we require
-  char *start = (char *)(((uintptr_t)alloc + d_alignment-1) & -d_alignment);
-  char *end = alloc + d_allocation_size + d_alignment - 1;
-  size_t n = (end - start) / d_itemsize;
+  if (d_freelist == 0)	// allocate a new chunk
+    d_freelist = new_chunk();
 
-  // link the new items onto the free list.
-  p = (item *) start;
-  for (size_t i = 0; i < n; i++){
-    p->d_next = d_freelist;
-    d_freelist = p;
-    p = (item *)((char *) p + d_itemsize);
-  }
-
-  // now return the first one
   p = d_freelist;
   d_freelist = p->d_next;
   d_n_items++;
@@ -99,11 +310,20 @@ pmt_pool::free(void *foo)
   if (!foo)
     return;
 
+  if (d_id >= 0){
+    cached_free(foo);
+    return;
+  }
+
   scoped_lock guard(d_mutex);
 
-  item *p = (item *) foo;
-  p->d_next = d_freelist;
-  d_freelist = p;
+  if (use_heap())
+    ::free(foo);
+  else {
+    item *p = (item *) foo;
+    p->d_next = d_freelist;
+    d_freelist = p;
+  }
   d_n_items--;
   if (d_max_items != 0)
     d_cond.notify_one();
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -19,187 +19,465 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
 #include <vector>
+#include <algorithm>
+#include <string.h>
 #include <gruel/pmt.h>
+#include <gruel/inet.h>
 #include "pmt_int.h"
 #include "gruel/pmt_serial_tags.h"
 
 namespace pmt {
 
-static pmt_t parse_pair(std::streambuf &sb);
+// gruel/inet.h is configured with GR_ARCH_BIGENDIAN
+static inline unsigned int
+uvi_host_endian()
+{
+  return htonl(1) == 1 ? UVI_BIG_ENDIAN : UVI_LITTLE_ENDIAN;
+}
+
+// Indexed by UVI_U8 ... UVI_C64
+static const size_t uvi_itemsize[] = { 1, 1, 2, 2, 4, 4, 8, 8, 4, 8,  8, 16 };
+static const size_t uvi_wordsize[] = { 1, 1, 2, 2, 4, 4, 8, 8, 4, 8,  4,  8 };
+
+// ----------------------------------------------------------------
+// sinks and sources
+//
+// The (de)serializer is written once, as a template over where the
+// bytes go to or come from.
+// ----------------------------------------------------------------
+
+class streambuf_sink
+{
+  std::streambuf       &d_sb;
+  size_t		d_pos;
+  bool			d_ok;
+
+public:
+  streambuf_sink(std::streambuf &sb) : d_sb(sb), d_pos(0), d_ok(true) {}
+
+  void write(const void *p, size_t n)
+  {
+    if (d_sb.sputn((const char *) p, n) != (std::streamsize) n)
+      d_ok = false;
+    d_pos += n;
+  }
+
+  size_t pos() const { return d_pos; }
+  bool ok() const { return d_ok; }
+};
+
+class string_sink
+{
+  std::string	       &d_buf;
+
+public:
+  string_sink(std::string &buf) : d_buf(buf) {}
+
+  void write(const void *p, size_t n) { d_buf.append((const char *) p, n); }
+  size_t pos() const { return d_buf.size(); }
+  bool ok() const { return true; }
+};
+
+class streambuf_source
+{
+  std::streambuf       &d_sb;
+  std::string		d_fetched;
+
+public:
+  streambuf_source(std::streambuf &sb) : d_sb(sb) {}
+
+  bool get_u8(uint8_t *ip)
+  {
+    std::streambuf::traits_type::int_type t = d_sb.sbumpc();
+    *ip = t & 0xff;
+    return t != std::streambuf::traits_type::eof();
+  }
+
+  void unget_u8() { d_sb.sungetc(); }
+
+  bool read(void *p, size_t n)
+  {
+    return d_sb.sgetn((char *) p, n) == (std::streamsize) n;
+  }
+
+  // Return a pointer to the next n bytes, valid until the next call,
+  // or 0 if the input ends first.  They are read in chunks, so that a
+  // corrupt length runs out of input instead of allocating n bytes.
+  const void *fetch(size_t n)
+  {
+    static const size_t CHUNK = 64 * 1024;
+    d_fetched.clear();
+    while (d_fetched.size() < n){
+      size_t k = std::min(n - d_fetched.size(), CHUNK);
+      size_t old = d_fetched.size();
+      d_fetched.resize(old + k);
+      if (!read(&d_fetched[old], k))
+	return 0;
+    }
+    return d_fetched.data();
+  }
+
+  const void *alias(size_t n, size_t align) { return 0; }
+  pmt_t owner() const { return PMT_F; }
+};
+
+class buffer_source
+{
+  const uint8_t	       *d_buf;
+  size_t		d_len;
+  size_t		d_pos;
+  pmt_t			d_owner;	// PMT_F => copy, don't alias
+
+public:
+  buffer_source(const void *buf, size_t len, size_t pos, pmt_t owner)
+    : d_buf((const uint8_t *) buf), d_len(len), d_pos(pos), d_owner(owner) {}
+
+  bool get_u8(uint8_t *ip)
+  {
+    if (d_pos >= d_len)
+      return false;
+    *ip = d_buf[d_pos++];
+    return true;
+  }
+
+  void unget_u8() { d_pos--; }
+
+  bool read(void *p, size_t n)
+  {
+    if (n > d_len - d_pos)
+      return false;
+    memcpy(p, d_buf + d_pos, n);
+    d_pos += n;
+    return true;
+  }
+
+  // Return a pointer to the next n bytes and consume them, or 0 if
+  // there aren't that many
+  const void *fetch(size_t n)
+  {
+    const uint8_t *p = d_buf + d_pos;
+    if (n > d_len - d_pos)
+      return 0;
+    d_pos += n;
+    return p;
+  }
+
+  // Like fetch, but 0 unless the result may be kept (aliased) as well
+  const void *alias(size_t n, size_t align)
+  {
+    const uint8_t *p = d_buf + d_pos;
+    if (pmt_is_false(d_owner) || n > d_len - d_pos
+	|| ((uintptr_t) p & (align - 1)) != 0)
+      return 0;
+    d_pos += n;
+    return p;
+  }
+
+  pmt_t owner() const { return d_owner; }
+  size_t pos() const { return d_pos; }
+};
 
 // ----------------------------------------------------------------
 // output primitives
 // ----------------------------------------------------------------
 
-static bool
-serialize_untagged_u8(unsigned int i, std::streambuf &sb)
+template<class Sink>
+static void
+serialize_untagged_u8(unsigned int i, Sink &sink)
 {
-  return sb.sputc((i >> 0) & 0xff) != std::streambuf::traits_type::eof();
+  uint8_t b = i & 0xff;
+  sink.write(&b, 1);
 }
 
 // always writes big-endian
-static bool
-serialize_untagged_u16(unsigned int i, std::streambuf &sb)
+template<class Sink>
+static void
+serialize_untagged_u16(unsigned int i, Sink &sink)
 {
-  sb.sputc((i >> 8) & 0xff);
-  return sb.sputc((i >> 0) & 0xff) != std::streambuf::traits_type::eof();
+  uint8_t b[2];
+  b[0] = (i >> 8) & 0xff;
+  b[1] = (i >> 0) & 0xff;
+  sink.write(b, sizeof(b));
 }
 
 // always writes big-endian
-static bool
-serialize_untagged_u32(unsigned int i, std::streambuf &sb)
+template<class Sink>
+static void
+serialize_untagged_u32(unsigned int i, Sink &sink)
 {
-  sb.sputc((i >> 24) & 0xff);
-  sb.sputc((i >> 16) & 0xff);
-  sb.sputc((i >>  8) & 0xff);
-  return sb.sputc((i >> 0) & 0xff) != std::streambuf::traits_type::eof();
+  uint8_t b[4];
+  b[0] = (i >> 24) & 0xff;
+  b[1] = (i >> 16) & 0xff;
+  b[2] = (i >>  8) & 0xff;
+  b[3] = (i >>  0) & 0xff;
+  sink.write(b, sizeof(b));
 }
 
-#if 0
 // always writes big-endian
-static bool
-serialize_untagged_u64(uint64_t i, std::streambuf &sb)
+template<class Sink>
+static void
+serialize_untagged_u64(uint64_t i, Sink &sink)
 {
-  sb.sputc((i >> 56) & 0xff);
-  sb.sputc((i >> 48) & 0xff);
-  sb.sputc((i >> 40) & 0xff);
-  sb.sputc((i >> 32) & 0xff);
-  sb.sputc((i >> 24) & 0xff);
-  sb.sputc((i >> 16) & 0xff);
-  sb.sputc((i >>  8) & 0xff);
-  return sb.sputc((i >> 0) & 0xff) != std::streambuf::traits_type::eof();
+  serialize_untagged_u32(i >> 32, sink);
+  serialize_untagged_u32(i & 0xffffffff, sink);
+}
+
+template<class Sink>
+static void
+serialize_untagged_f64(double d, Sink &sink)
+{
+  uint64_t i;
+  memcpy(&i, &d, sizeof(i));
+  serialize_untagged_u64(i, sink);
 }
-#endif
 
 // ----------------------------------------------------------------
 // input primitives
 // ----------------------------------------------------------------
 
-
 // always reads big-endian
+template<class Source>
 static bool
-deserialize_untagged_u8(uint8_t *ip, std::streambuf &sb)
+deserialize_untagged_u16(uint16_t *ip, Source &src)
 {
-  std::streambuf::traits_type::int_type  t;
-  int i;
-
-  t = sb.sbumpc();
-  i = t & 0xff;
+  uint8_t b[2];
+  if (!src.read(b, sizeof(b)))
+    return false;
+  *ip = (b[0] << 8) | b[1];
+  return true;
+}
 
-  *ip = i;
-  return t != std::streambuf::traits_type::eof();
+// always reads big-endian
+template<class Source>
+static bool
+deserialize_untagged_u32(uint32_t *ip, Source &src)
+{
+  uint8_t b[4];
+  if (!src.read(b, sizeof(b)))
+    return false;
+  *ip = ((uint32_t) b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+  return true;
 }
 
 // always reads big-endian
+template<class Source>
+static bool
+deserialize_untagged_u64(uint64_t *ip, Source &src)
+{
+  uint32_t hi, lo;
+  if (!deserialize_untagged_u32(&hi, src) || !deserialize_untagged_u32(&lo, src))
+    return false;
+  *ip = ((uint64_t) hi << 32) | lo;
+  return true;
+}
+
+template<class Source>
 static bool
-deserialize_untagged_u16(uint16_t *ip, std::streambuf &sb)
+deserialize_untagged_f64(double *ip, Source &src)
+{
+  uint64_t i;
+  if (!deserialize_untagged_u64(&i, src))
+    return false;
+  memcpy(ip, &i, sizeof(i));
+  return true;
+}
+
+// ----------------------------------------------------------------
+// uniform vectors
+// ----------------------------------------------------------------
+
+static int
+uniform_vector_subtype(pmt_t v)
 {
-  std::streambuf::traits_type::int_type  t;
-  int i;
+  if (pmt_is_u8vector(v))  return UVI_U8;
+  if (pmt_is_s8vector(v))  return UVI_S8;
+  if (pmt_is_u16vector(v)) return UVI_U16;
+  if (pmt_is_s16vector(v)) return UVI_S16;
+  if (pmt_is_u32vector(v)) return UVI_U32;
+  if (pmt_is_s32vector(v)) return UVI_S32;
+  if (pmt_is_u64vector(v)) return UVI_U64;
+  if (pmt_is_s64vector(v)) return UVI_S64;
+  if (pmt_is_f32vector(v)) return UVI_F32;
+  if (pmt_is_f64vector(v)) return UVI_F64;
+  if (pmt_is_c32vector(v)) return UVI_C32;
+  if (pmt_is_c64vector(v)) return UVI_C64;
+  throw pmt_notimplemented("pmt_serialize (uniform-vector)", v);
+}
 
-  t = sb.sbumpc();
-  i = t & 0xff;
+static pmt_t
+make_uniform_vector(int subtype, size_t k)
+{
+  switch (subtype){
+  case UVI_U8:  return pmt_make_u8vector(k, 0);
+  case UVI_S8:  return pmt_make_s8vector(k, 0);
+  case UVI_U16: return pmt_make_u16vector(k, 0);
+  case UVI_S16: return pmt_make_s16vector(k, 0);
+  case UVI_U32: return pmt_make_u32vector(k, 0);
+  case UVI_S32: return pmt_make_s32vector(k, 0);
+  case UVI_U64: return pmt_make_u64vector(k, 0);
+  case UVI_S64: return pmt_make_s64vector(k, 0);
+  case UVI_F32: return pmt_make_f32vector(k, 0);
+  case UVI_F64: return pmt_make_f64vector(k, 0);
+  case UVI_C32: return pmt_make_c32vector(k, 0);
+  case UVI_C64: return pmt_make_c64vector(k, 0);
+  default:
+    throw pmt_exception("pmt_deserialize: malformed input stream, uniform vector subtype = ",
+			pmt_from_long(subtype));
+  }
+}
 
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
+// Returns a uniform vector that shares p, and holds a reference to owner
+static pmt_t
+alias_uniform_vector(int subtype, size_t k, const void *p, pmt_t owner)
+{
+  void *d = const_cast<void *>(p);
+
+  switch (subtype){
+  case UVI_U8:  return pmt_t(new pmt_u8vector(k, (uint8_t *) d, owner));
+  case UVI_S8:  return pmt_t(new pmt_s8vector(k, (int8_t *) d, owner));
+  case UVI_U16: return pmt_t(new pmt_u16vector(k, (uint16_t *) d, owner));
+  case UVI_S16: return pmt_t(new pmt_s16vector(k, (int16_t *) d, owner));
+  case UVI_U32: return pmt_t(new pmt_u32vector(k, (uint32_t *) d, owner));
+  case UVI_S32: return pmt_t(new pmt_s32vector(k, (int32_t *) d, owner));
+  case UVI_U64: return pmt_t(new pmt_u64vector(k, (uint64_t *) d, owner));
+  case UVI_S64: return pmt_t(new pmt_s64vector(k, (int64_t *) d, owner));
+  case UVI_F32: return pmt_t(new pmt_f32vector(k, (float *) d, owner));
+  case UVI_F64: return pmt_t(new pmt_f64vector(k, (double *) d, owner));
+  case UVI_C32: return pmt_t(new pmt_c32vector(k, (std::complex<float> *) d, owner));
+  case UVI_C64: return pmt_t(new pmt_c64vector(k, (std::complex<double> *) d, owner));
+  default:
+    throw pmt_exception("pmt_deserialize: malformed input stream, uniform vector subtype = ",
+			pmt_from_long(subtype));
+  }
+}
 
-  *ip = i;
-  return t != std::streambuf::traits_type::eof();
+static void
+byteswap_words(void *buf, size_t nbytes, size_t wordsize)
+{
+  uint8_t *p = (uint8_t *) buf;
+  for (size_t i = 0; i < nbytes; i += wordsize)
+    std::reverse(p + i, p + i + wordsize);
 }
 
-// always reads big-endian
-static bool
-deserialize_untagged_u32(uint32_t *ip, std::streambuf &sb)
+/*
+ * The numeric data is written in host byte order, as a single block,
+ * preceded by enough padding to align it to its word size relative to
+ * the start of the sink.
+ */
+template<class Sink>
+static void
+serialize_uniform_vector(pmt_t obj, Sink &sink)
 {
-  std::streambuf::traits_type::int_type  t;
-  int i;
+  static const uint8_t zeros[8] = { 0 };
+
+  int subtype = uniform_vector_subtype(obj);
+  size_t nbytes;
+  const void *data = pmt_uniform_vector_elements(obj, nbytes);
+  size_t nitems = nbytes / uvi_itemsize[subtype];
+  size_t align = uvi_wordsize[subtype];
 
-  t = sb.sbumpc();
-  i = t & 0xff;
+  if (nitems > 0xffffffff)
+    throw pmt_notimplemented("pmt_serialize (very long uniform-vector)", obj);
 
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
+  serialize_untagged_u8(PST_UNIFORM_VECTOR, sink);
+  serialize_untagged_u8(subtype | uvi_host_endian(), sink);
+  serialize_untagged_u32(nitems, sink);
 
-  *ip = i;
-  return t != std::streambuf::traits_type::eof();
+  size_t npad = (align - (sink.pos() + 1) % align) % align;
+  serialize_untagged_u8(npad, sink);
+  sink.write(zeros, npad);
+  sink.write(data, nbytes);
 }
 
-#if 0
-// always reads big-endian
-static bool
-deserialize_untagged_u64(uint64_t *ip, std::streambuf &sb)
+// On entry we've already eaten the PST_UNIFORM_VECTOR tag.
+template<class Source>
+static pmt_t
+parse_uniform_vector(Source &src)
 {
-  std::streambuf::traits_type::int_type  t;
-  uint64_t i;
+  uint8_t	uvi, npad;
+  uint32_t	nitems;
+  uint8_t	pad[256];
+
+  if (!src.get_u8(&uvi) || !deserialize_untagged_u32(&nitems, src)
+      || !src.get_u8(&npad) || !src.read(pad, npad))
+    throw pmt_exception("pmt_deserialize: malformed input stream", PMT_F);
+
+  int subtype = uvi & UVI_SUBTYPE_MASK;
+  if (subtype > UVI_C64)
+    throw pmt_exception("pmt_deserialize: malformed input stream, uniform vector subtype = ",
+			pmt_from_long(subtype));
+
+  size_t wordsize = uvi_wordsize[subtype];
+  if (nitems > (size_t) -1 / uvi_itemsize[subtype])
+    throw pmt_exception("pmt_deserialize: malformed input stream", PMT_F);
+  size_t nbytes = nitems * uvi_itemsize[subtype];
+  bool swap = (uvi & UVI_ENDIAN_MASK) != uvi_host_endian() && wordsize > 1;
+
+  if (!swap){
+    const void *p = src.alias(nbytes, wordsize);
+    if (p)
+      return alias_uniform_vector(subtype, nitems, p, src.owner());
+  }
 
-  t = sb.sbumpc();
-  i = t & 0xff;
-
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-  t = sb.sbumpc();
-  i = (i << 8) | (t & 0xff);
-
-  *ip = i;
-  return t != std::streambuf::traits_type::eof();
+  // Have the bytes in hand before allocating nitems
+  const void *p = src.fetch(nbytes);
+  if (!p)
+    throw pmt_exception("pmt_deserialize: malformed input stream", PMT_F);
+
+  pmt_t v = make_uniform_vector(subtype, nitems);
+  size_t len;
+  void *data = pmt_uniform_vector_writable_elements(v, len);
+  memcpy(data, p, nbytes);
+  if (swap)
+    byteswap_words(data, nbytes, wordsize);
+  return v;
 }
-#endif
+
+// ----------------------------------------------------------------
+// serialize
+// ----------------------------------------------------------------
 
 /*
- * Write portable byte-serial representation of \p obj to \p sb
- *
  * N.B., Circular structures cause infinite recursion.
  */
-bool
-pmt_serialize(pmt_t obj, std::streambuf &sb)
+template<class Sink>
+static void
+serialize(pmt_t obj, Sink &sink)
 {
-  bool ok = true;
-
  tail_recursion:
 
   if (pmt_is_bool(obj)){
     if (pmt_eq(obj, PMT_T))
-      return serialize_untagged_u8(PST_TRUE, sb);
+      serialize_untagged_u8(PST_TRUE, sink);
     else
-      return serialize_untagged_u8(PST_FALSE, sb);
+      serialize_untagged_u8(PST_FALSE, sink);
+    return;
   }
   
-  if (pmt_is_null(obj))
-    return serialize_untagged_u8(PST_NULL, sb);
+  if (pmt_is_null(obj)){
+    serialize_untagged_u8(PST_NULL, sink);
+    return;
+  }
 
   if (pmt_is_symbol(obj)){
     const std::string s = pmt_symbol_to_string(obj);
     size_t len = s.size();
-    ok = serialize_untagged_u8(PST_SYMBOL, sb);
-    ok &= serialize_untagged_u16(len, sb);
-    for (size_t i = 0; i < len; i++)
-      ok &= serialize_untagged_u8(s[i], sb);
-    return ok;
+    if (len > 0xffff)
+      throw pmt_notimplemented("pmt_serialize (very long symbol)", obj);
+    serialize_untagged_u8(PST_SYMBOL, sink);
+    serialize_untagged_u16(len, sink);
+    sink.write(s.data(), len);
+    return;
   }
 
   if (pmt_is_pair(obj)){
-    ok = serialize_untagged_u8(PST_PAIR, sb);
-    ok &= pmt_serialize(pmt_car(obj), sb);
-    if (!ok)
-      return false;
+    serialize_untagged_u8(PST_PAIR, sink);
+    serialize(pmt_car(obj), sink);
     obj = pmt_cdr(obj);
     goto tail_recursion;
   }
@@ -208,52 +486,85 @@ pmt_serialize(pmt_t obj, std::streambuf &sb)
 
     if (pmt_is_integer(obj)){
       long i = pmt_to_long(obj);
-      if (sizeof(long) > 4){
-	if (i < -2147483647 || i > 2147483647)
-	  throw pmt_notimplemented("pmt_serialize (64-bit integers)", obj);
+      if (sizeof(long) > 4 && (i < -2147483647L - 1 || i > 2147483647L)){
+	serialize_untagged_u8(PST_INT64, sink);
+	serialize_untagged_u64(i, sink);
+      }
+      else {
+	serialize_untagged_u8(PST_INT32, sink);
+	serialize_untagged_u32(i, sink);
       }
-      ok = serialize_untagged_u8(PST_INT32, sb);
-      ok &= serialize_untagged_u32(i, sb);
-      return ok;
+      return;
     }
 
-    if (pmt_is_real(obj))
-      throw pmt_notimplemented("pmt_serialize (real)", obj);
+    if (pmt_is_real(obj)){
+      serialize_untagged_u8(PST_DOUBLE, sink);
+      serialize_untagged_f64(pmt_to_double(obj), sink);
+      return;
+    }
 
-    if (pmt_is_complex(obj))
-      throw pmt_notimplemented("pmt_serialize (complex)", obj);
+    if (pmt_is_complex(obj)){
+      std::complex<double> c = pmt_to_complex(obj);
+      serialize_untagged_u8(PST_COMPLEX, sink);
+      serialize_untagged_f64(c.real(), sink);
+      serialize_untagged_f64(c.imag(), sink);
+      return;
+    }
   }
 
-  if (pmt_is_vector(obj))
-    throw pmt_notimplemented("pmt_serialize (vector)", obj);
+  if (pmt_is_vector(obj)){
+    size_t len = pmt_length(obj);
+    serialize_untagged_u8(PST_VECTOR, sink);
+    serialize_untagged_u32(len, sink);
+    for (size_t i = 0; i < len; i++)
+      serialize(pmt_vector_ref(obj, i), sink);
+    return;
+  }
 
-  if (pmt_is_uniform_vector(obj))
-    throw pmt_notimplemented("pmt_serialize (uniform-vector)", obj);
-    
-  if (pmt_is_dict(obj))
-    throw pmt_notimplemented("pmt_serialize (dict)", obj);
+  if (pmt_is_uniform_vector(obj)){
+    serialize_uniform_vector(obj, sink);
+    return;
+  }
     
+  if (pmt_is_dict(obj)){	// a-lists were handled as pairs above
+    pmt_t items = pmt_dict_items(obj);
+    serialize_untagged_u8(PST_DICT, sink);
+    serialize_untagged_u32(pmt_length(obj), sink);
+    for (; pmt_is_pair(items); items = pmt_cdr(items)){
+      serialize(pmt_caar(items), sink);
+      serialize(pmt_cdar(items), sink);
+    }
+    return;
+  }
 
   throw pmt_notimplemented("pmt_serialize (?)", obj);
 }
 
+// ----------------------------------------------------------------
+// deserialize
+// ----------------------------------------------------------------
+
+template<class Source>
+static pmt_t parse_pair(Source &src);
+
+template<class Source>
+static pmt_t deserialize_required(Source &src);
+
 /*
- * Create obj from portable byte-serial representation
- *
- * Returns next obj from streambuf, or PMT_EOF at end of file.
+ * Returns next obj from src, or PMT_EOF at end of input.
  * Throws exception on malformed input.
  */
-pmt_t
-pmt_deserialize(std::streambuf &sb)
+template<class Source>
+static pmt_t
+deserialize(Source &src)
 {
   uint8_t	tag;
-  //uint8_t	u8;
   uint16_t	u16;
   uint32_t	u32;
-  //uint32_t	u64;
-  static char   tmpbuf[1024];
+  uint64_t	u64;
+  double	re, im;
 
-  if (!deserialize_untagged_u8(&tag, sb))
+  if (!src.get_u8(&tag))
     return PMT_EOF;
 
   switch (tag){
@@ -266,29 +577,68 @@ pmt_deserialize(std::streambuf &sb)
   case PST_NULL:
     return PMT_NIL;
 
-  case PST_SYMBOL:
-    if (!deserialize_untagged_u16(&u16, sb))
+  case PST_SYMBOL: {
+    if (!deserialize_untagged_u16(&u16, src))
       goto error;
-    if (u16 > sizeof(tmpbuf))
-      throw pmt_notimplemented("pmt_deserialize: very long symbol",
-			       PMT_F);
-    if (sb.sgetn(tmpbuf, u16) != u16)
+    std::string name(u16, '\0');
+    if (u16 != 0 && !src.read(&name[0], u16))
       goto error;
-    return pmt_intern(std::string(tmpbuf, u16));
+    return pmt_intern(name);
+  }
 
   case PST_INT32:
-    if (!deserialize_untagged_u32(&u32, sb))
+    if (!deserialize_untagged_u32(&u32, src))
       goto error;
     return pmt_from_long((int32_t) u32);
 
-  case PST_PAIR:
-    return parse_pair(sb);
+  case PST_INT64:
+    if (!deserialize_untagged_u64(&u64, src))
+      goto error;
+    if (sizeof(long) < 8)
+      throw pmt_notimplemented("pmt_deserialize: 64-bit integer on 32-bit host",
+			       PMT_F);
+    return pmt_from_long((int64_t) u64);
 
   case PST_DOUBLE:
+    if (!deserialize_untagged_f64(&re, src))
+      goto error;
+    return pmt_from_double(re);
+
   case PST_COMPLEX:
-  case PST_VECTOR:
-  case PST_DICT:
+    if (!deserialize_untagged_f64(&re, src) || !deserialize_untagged_f64(&im, src))
+      goto error;
+    return pmt_make_rectangular(re, im);
+
+  case PST_PAIR:
+    return parse_pair(src);
+
+  case PST_VECTOR: {
+    if (!deserialize_untagged_u32(&u32, src))
+      goto error;
+    // grow with the input rather than trust u32 with an allocation
+    std::vector<pmt_t> items;
+    for (size_t i = 0; i < u32; i++)
+      items.push_back(deserialize_required(src));
+    pmt_t v = pmt_make_vector(u32, PMT_NIL);
+    for (size_t i = 0; i < u32; i++)
+      pmt_vector_set(v, i, items[i]);
+    return v;
+  }
+
+  case PST_DICT: {
+    if (!deserialize_untagged_u32(&u32, src))
+      goto error;
+    pmt_t d = pmt_make_dict();
+    for (size_t i = 0; i < u32; i++){
+      pmt_t key = deserialize_required(src);
+      d = pmt_dict_add(d, key, deserialize_required(src));
+    }
+    return d;
+  }
+
   case PST_UNIFORM_VECTOR:
+    return parse_uniform_vector(src);
+
   case PST_COMMENT:
     throw pmt_notimplemented("pmt_deserialize: tag value = ",
 			     pmt_from_long(tag));
@@ -302,14 +652,26 @@ pmt_deserialize(std::streambuf &sb)
   throw pmt_exception("pmt_deserialize: malformed input stream", PMT_F);
 }
 
+// Like deserialize, but running out of input is an error
+template<class Source>
+static pmt_t
+deserialize_required(Source &src)
+{
+  pmt_t obj = deserialize(src);
+  if (pmt_eq(obj, PMT_EOF))
+    throw pmt_exception("pmt_deserialize: malformed input stream", PMT_F);
+  return obj;
+}
+
 /*
  * This is a mostly non-recursive implementation that allows us to
  * deserialize very long lists w/o exhausting the evaluation stack.
  *
  * On entry we've already eaten the PST_PAIR tag.
  */
-pmt_t
-parse_pair(std::streambuf &sb)
+template<class Source>
+static pmt_t
+parse_pair(Source &src)
 {
   uint8_t tag;
   pmt_t	val, expr, lastnptr, nptr;
@@ -319,7 +681,7 @@ parse_pair(std::streambuf &sb)
   //
   lastnptr = PMT_NIL;
   while (1){
-    expr = pmt_deserialize(sb);		// read the car
+    expr = deserialize_required(src);	// read the car
 
     nptr = pmt_cons(expr, PMT_NIL);	// build new cell
     if (pmt_is_null(lastnptr))
@@ -328,7 +690,7 @@ parse_pair(std::streambuf &sb)
       pmt_set_cdr(lastnptr, nptr);
     lastnptr = nptr;
 
-    if (!deserialize_untagged_u8(&tag, sb))  // get tag of cdr
+    if (!src.get_u8(&tag))		// get tag of cdr
       throw pmt_exception("pmt_deserialize: malformed input stream", PMT_F);
 
     if (tag == PST_PAIR)
@@ -340,10 +702,10 @@ parse_pair(std::streambuf &sb)
     }
 
     //
-    // default: push tag back and use pmt_deserialize to get the cdr
+    // default: push tag back and use deserialize to get the cdr
     //
-    sb.sungetc();
-    expr = pmt_deserialize(sb);
+    src.unget_u8();
+    expr = deserialize_required(src);
     break;
   }
 
@@ -354,4 +716,68 @@ parse_pair(std::streambuf &sb)
   return val;
 }
 
+// ----------------------------------------------------------------
+// public interface
+// ----------------------------------------------------------------
+
+bool
+pmt_serialize(pmt_t obj, std::streambuf &sb)
+{
+  streambuf_sink sink(sb);
+  serialize(obj, sink);
+  return sink.ok();
+}
+
+pmt_t
+pmt_deserialize(std::streambuf &sb)
+{
+  streambuf_source src(sb);
+  return deserialize(src);
+}
+
+void
+pmt_serialize(pmt_t obj, std::string &buf)
+{
+  string_sink sink(buf);
+  serialize(obj, sink);
+}
+
+std::string
+pmt_serialize_str(pmt_t obj)
+{
+  std::string buf;
+  pmt_serialize(obj, buf);
+  return buf;
+}
+
+pmt_t
+pmt_deserialize(const void *buf, size_t len, size_t &consumed)
+{
+  buffer_source src(buf, len, 0, PMT_F);
+  pmt_t obj = deserialize(src);
+  consumed = src.pos();
+  return obj;
+}
+
+pmt_t
+pmt_deserialize_str(const std::string &str)
+{
+  size_t consumed;
+  return pmt_deserialize(str.data(), str.size(), consumed);
+}
+
+pmt_t
+pmt_deserialize_nocopy(pmt_t blob, size_t &offset)
+{
+  size_t len;
+  const void *buf = pmt_uniform_vector_elements(blob, len);
+  if (offset > len)
+    throw pmt_out_of_range("pmt_deserialize_nocopy", pmt_from_long(offset));
+
+  buffer_source src(buf, len, offset, blob);
+  pmt_t obj = deserialize(src);
+  offset = src.pos();
+  return obj;
+}
+
 } /* namespace pmt */
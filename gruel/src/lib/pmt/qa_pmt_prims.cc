@@ -23,9 +23,14 @@
 #include <qa_pmt_prims.h>
 #include <cppunit/TestAssert.h>
 #include <gruel/msg_passing.h>
+#include <gruel/pmt_pool.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 #include <cstdio>
 #include <cstring>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 using namespace pmt;
 
@@ -319,6 +324,16 @@ qa_pmt_prims::test_equivalence()
   pmt_vector_set(v1, 0, list1);
   pmt_vector_set(v1, 1, list1);
   CPPUNIT_ASSERT(pmt_equal(v0, v1));
+
+  uint8_t bytes[3] = { 1, 2, 3 };
+  pmt_t u0 = pmt_init_u8vector(3, bytes);
+  pmt_t u1 = pmt_init_u8vector(3, bytes);
+  bytes[2] = 4;
+  pmt_t u2 = pmt_init_u8vector(3, bytes);
+  CPPUNIT_ASSERT(pmt_equal(u0, u1));
+  CPPUNIT_ASSERT(!pmt_equal(u0, u2));
+  CPPUNIT_ASSERT(!pmt_equal(u0, pmt_make_u8vector(2, 1)));
+  CPPUNIT_ASSERT(pmt_equal(pmt_make_u8vector(0, 0), pmt_make_u8vector(0, 0)));
 }
 
 void
@@ -380,6 +395,64 @@ qa_pmt_prims::test_dict()
   CPPUNIT_ASSERT(pmt_equal(vals, pmt_dict_values(dict)));
 }
 
+void
+qa_pmt_prims::test_dict_large()
+{
+  static const int N = 1000;
+  pmt_t not_found = pmt_cons(PMT_NIL, PMT_NIL);
+  pmt_t dict = pmt_make_dict();
+  pmt_t empty = dict;
+
+  for (int i = 0; i < N; i++){
+    char name[32];
+    snprintf(name, sizeof(name), "key-%d", i);
+    dict = pmt_dict_add(dict, mp(name), mp(i));
+    dict = pmt_dict_add(dict, mp(i), mp(name));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t) 2*N, pmt_length(dict));
+  CPPUNIT_ASSERT_EQUAL((size_t) 0, pmt_length(empty));	// persistent
+
+  for (int i = 0; i < N; i++){
+    char name[32];
+    snprintf(name, sizeof(name), "key-%d", i);
+    CPPUNIT_ASSERT_EQUAL((long) i, pmt_to_long(pmt_dict_ref(dict, mp(name), not_found)));
+    CPPUNIT_ASSERT(pmt_eq(mp(name), pmt_dict_ref(dict, mp(i), not_found)));
+  }
+  CPPUNIT_ASSERT(pmt_eq(not_found, pmt_dict_ref(dict, mp(N), not_found)));
+  CPPUNIT_ASSERT(pmt_eq(not_found, pmt_dict_ref(dict, mp("nope"), not_found)));
+
+  // Replacing a value doesn't change the size; deleting does
+  pmt_t d2 = pmt_dict_add(dict, mp(7), mp("seven"));
+  CPPUNIT_ASSERT_EQUAL((size_t) 2*N, pmt_length(d2));
+  CPPUNIT_ASSERT(pmt_eq(mp("seven"), pmt_dict_ref(d2, mp(7), not_found)));
+  CPPUNIT_ASSERT(pmt_eq(mp("key-7"), pmt_dict_ref(dict, mp(7), not_found)));
+
+  pmt_t d3 = dict;
+  for (int i = 0; i < N; i += 2)
+    d3 = pmt_dict_delete(d3, mp(i));
+  CPPUNIT_ASSERT_EQUAL((size_t) 2*N - N/2, pmt_length(d3));
+  CPPUNIT_ASSERT(!pmt_dict_has_key(d3, mp(0)));
+  CPPUNIT_ASSERT(pmt_dict_has_key(d3, mp(1)));
+  CPPUNIT_ASSERT(pmt_dict_has_key(dict, mp(0)));
+  CPPUNIT_ASSERT_EQUAL(d3, pmt_dict_delete(d3, mp(0)));
+
+  // Equality doesn't depend on insertion order
+  pmt_t a = pmt_dict_add(pmt_dict_add(pmt_make_dict(), mp(1), mp(2.0)), mp("x"), mp("y"));
+  pmt_t b = pmt_dict_add(pmt_dict_add(pmt_make_dict(), mp("x"), mp("y")), mp(1), mp(2.0));
+  CPPUNIT_ASSERT(pmt_equal(a, b));
+  CPPUNIT_ASSERT(!pmt_equal(a, pmt_dict_delete(b, mp(1))));
+
+  // Numeric keys are compared by value, as with pmt_eqv
+  CPPUNIT_ASSERT(pmt_dict_has_key(a, pmt_from_long(1)));
+  pmt_t c = pmt_dict_add(pmt_make_dict(), pmt_from_double(-0.0), PMT_T);
+  CPPUNIT_ASSERT(pmt_dict_has_key(c, pmt_from_double(0.0)));
+
+  // a-lists are still dictionaries
+  pmt_t alist = pmt_dict_add(PMT_NIL, mp("k"), mp("v"));
+  CPPUNIT_ASSERT(pmt_is_pair(alist));
+  CPPUNIT_ASSERT(pmt_eq(mp("v"), pmt_dict_ref(alist, mp("k"), not_found)));
+}
+
 void
 qa_pmt_prims::test_io()
 {
@@ -533,10 +606,124 @@ qa_pmt_prims::test_serialize()
 
   CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), PMT_EOF));	// last item
 
+  // the remaining types
+
+  sb.str("");
+  pmt_t v = pmt_make_vector(3, PMT_NIL);
+  pmt_vector_set(v, 0, a);
+  pmt_vector_set(v, 1, pmt_from_double(1.5));
+  pmt_vector_set(v, 2, pmt_list2(b, c));
+  pmt_t d = pmt_dict_add(pmt_dict_add(pmt_make_dict(), a, b), c, pmt_from_long(3));
+  std::complex<float> cf[3] = { 1, std::complex<float>(2, -3), -4 };
+  pmt_t c32 = pmt_init_c32vector(3, cf);
+  int64_t big = 1; big <<= 40;
+
+  pmt_serialize(pmt_from_double(-2.25e-10), sb);
+  pmt_serialize(pmt_make_rectangular(3, -4), sb);
+  pmt_serialize(v, sb);
+  pmt_serialize(d, sb);
+  pmt_serialize(c32, sb);
+  pmt_serialize(pmt_make_u8vector(0, 0), sb);
+  if (sizeof(long) > 4)
+    pmt_serialize(pmt_from_long(big), sb);
+
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), pmt_from_double(-2.25e-10)));
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), pmt_make_rectangular(3, -4)));
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), v));
+  pmt_t d2 = pmt_deserialize(sb);
+  CPPUNIT_ASSERT(pmt_is_dict(d2) && !pmt_is_pair(d2));
+  CPPUNIT_ASSERT(pmt_equal(d2, d));
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), c32));
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), pmt_make_u8vector(0, 0)));
+  if (sizeof(long) > 4)
+    CPPUNIT_ASSERT_EQUAL((long) big, pmt_to_long(pmt_deserialize(sb)));
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(sb), PMT_EOF));
+
+  // malformed input
+
+  sb.str(std::string("\x07\x02\x00\x05" "ab", 6));	// truncated pair
+  CPPUNIT_ASSERT_THROW(pmt_deserialize(sb), pmt_exception);
+  sb.str(std::string("\x0a\x7f\x00\x00\x00\x01\x00", 7));	// bad subtype
+  CPPUNIT_ASSERT_THROW(pmt_deserialize(sb), pmt_exception);
+
+  // lengths far beyond the input fail without allocating them
+  sb.str(std::string("\x0a\x07\x1f\xff\xff\xff\x00" "abcd", 11));	// s64 vector
+  CPPUNIT_ASSERT_THROW(pmt_deserialize(sb), pmt_exception);
+  sb.str(std::string("\x08\xff\xff\xff\xff\x00", 6));	// vector
+  CPPUNIT_ASSERT_THROW(pmt_deserialize(sb), pmt_exception);
+}
 
-  // FIXME add tests for real, complex, vector, uniform-vector, dict
-  // FIXME add tests for malformed input too.
-
+void
+qa_pmt_prims::test_serialize_buffer()
+{
+  static const size_t N = 1000;
+  std::vector<float> f(N);
+  for (size_t i = 0; i < N; i++)
+    f[i] = i * 0.5;
+
+  pmt_t f32 = pmt_init_f32vector(N, &f[0]);
+  pmt_t msg = pmt_list3(mp("samples"), pmt_from_long(42), f32);
+
+  // contiguous buffer, several objects back to back
+
+  std::string buf;
+  pmt_serialize(PMT_T, buf);
+  pmt_serialize(msg, buf);
+  CPPUNIT_ASSERT(buf.size() > N * sizeof(float));
+
+  size_t consumed;
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(buf.data(), buf.size(), consumed), PMT_T));
+  CPPUNIT_ASSERT_EQUAL((size_t) 1, consumed);
+  size_t off = consumed;
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(buf.data() + off, buf.size() - off, consumed), msg));
+  CPPUNIT_ASSERT_EQUAL(buf.size(), off + consumed);
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize(buf.data(), 0, consumed), PMT_EOF));
+  CPPUNIT_ASSERT_THROW(pmt_deserialize(buf.data() + off, buf.size() - off - 1, consumed),
+		       pmt_exception);
+
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize_str(pmt_serialize_str(msg)), msg));
+
+  // INT32_MIN still fits an int32
+  pmt_t imin = pmt_from_long(-2147483647L - 1);
+  CPPUNIT_ASSERT_EQUAL((size_t) 5, pmt_serialize_str(imin).size());
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize_str(pmt_serialize_str(imin)), imin));
+
+  // a length that runs past the end of the buffer
+  const uint8_t huge[] = { 0x0a, 0x07, 0x1f, 0xff, 0xff, 0xff, 0x00, 'a', 'b', 'c', 'd' };
+  CPPUNIT_ASSERT_THROW(pmt_deserialize(huge, sizeof(huge), consumed), pmt_exception);
+
+  // streambuf and buffer forms produce the same bytes
+  std::stringbuf sb;
+  pmt_serialize(msg, sb);
+  CPPUNIT_ASSERT(sb.str() == pmt_serialize_str(msg));
+
+  // zero-copy: the vector data is shared with the blob
+
+  pmt_t blob = pmt_make_blob(buf.data(), buf.size());
+  size_t offset = 0;
+  CPPUNIT_ASSERT(pmt_equal(pmt_deserialize_nocopy(blob, offset), PMT_T));
+  pmt_t r = pmt_deserialize_nocopy(blob, offset);
+  CPPUNIT_ASSERT_EQUAL(buf.size(), offset);
+  CPPUNIT_ASSERT(pmt_equal(r, msg));
+
+  const uint8_t *b = (const uint8_t *) pmt_blob_data(blob);
+  size_t len;
+  const float *p = pmt_f32vector_elements(pmt_nth(2, r), len);
+  CPPUNIT_ASSERT_EQUAL(N, len);
+  CPPUNIT_ASSERT(p > (const float *) b && p < (const float *) (b + buf.size()));
+
+  blob = PMT_NIL;			// r keeps the storage alive
+  CPPUNIT_ASSERT_EQUAL(f[N-1], pmt_f32vector_ref(pmt_nth(2, r), N-1));
+
+  // foreign byte order is swapped on the way in
+
+  const uint16_t one = 1;
+  const bool little = *(const uint8_t *) &one == 1;
+  uint8_t be[] = { 0x0a, 0x82 /* big-endian u16 */, 0, 0, 0, 2, 0, 0x12, 0x34, 0xab, 0xcd };
+  uint8_t le[] = { 0x0a, 0x02 /* little-endian u16 */, 0, 0, 0, 2, 0, 0x34, 0x12, 0xcd, 0xab };
+  pmt_t u16 = pmt_deserialize(little ? be : le, sizeof(be), consumed);
+  CPPUNIT_ASSERT_EQUAL((uint16_t) 0x1234, pmt_u16vector_ref(u16, 0));
+  CPPUNIT_ASSERT_EQUAL((uint16_t) 0xabcd, pmt_u16vector_ref(u16, 1));
 }
 
 void
@@ -576,3 +763,73 @@ qa_pmt_prims::test_sugar()
   CPPUNIT_ASSERT_EQUAL(sizeof(buf), nbytes);
   CPPUNIT_ASSERT(memcmp(buf, data, nbytes) == 0);
 }
+
+static void
+free_all(pmt_pool *pool, std::vector<void *> *items)
+{
+  for (size_t i = 0; i < items->size(); i++)
+    pool->free((*items)[i]);
+}
+
+static void
+build_lists(int n)
+{
+  for (int i = 0; i < n; i++){
+    pmt_t l = PMT_NIL;
+    for (int j = 0; j < 100; j++)
+      l = pmt_cons(pmt_from_long(j), l);
+    CPPUNIT_ASSERT_EQUAL((size_t) 100, pmt_length(l));
+  }
+}
+
+void
+qa_pmt_prims::test_pool()
+{
+  static const size_t N = 10000;
+  pmt_pool pool(48, 16);
+  std::vector<void *> items(N);
+
+  for (size_t i = 0; i < N; i++){
+    items[i] = pool.malloc();
+    CPPUNIT_ASSERT(((uintptr_t) items[i] & 15) == 0);
+    memset(items[i], i & 0xff, 48);
+  }
+  std::vector<void *> sorted(items);
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 1; i < N; i++)
+    CPPUNIT_ASSERT((char *) sorted[i] >= (char *) sorted[i-1] + 48);
+
+  // free everything from another thread, then reuse it here
+  boost::thread t(boost::bind(free_all, &pool, &items));
+  t.join();
+  for (size_t i = 0; i < N; i++)
+    items[i] = pool.malloc();
+  free_all(&pool, &items);
+
+  // pmt objects allocated and freed concurrently
+  boost::thread_group threads;
+  for (int i = 0; i < 4; i++)
+    threads.create_thread(boost::bind(build_lists, 1000));
+  threads.join_all();
+}
+
+void
+qa_pmt_prims::test_pool_slots()
+{
+  // Many more pools than there are per-thread slots, one after another.
+  // Each leaves this thread holding a free list for its slot, which the
+  // next pool to get the slot must not hand out.
+  std::vector<void *> items(300);
+  for (int n = 0; n < 100; n++){
+    pmt_pool pool(48, 16);
+    for (size_t i = 0; i < items.size(); i++){
+      items[i] = pool.malloc();
+      memset(items[i], n, 48);
+    }
+    boost::thread t(boost::bind(free_all, &pool, &items));
+    t.join();
+    for (size_t i = 0; i < items.size(); i++)
+      items[i] = pool.malloc();
+    free_all(&pool, &items);
+  }
+}
@@ -39,13 +39,17 @@ class qa_pmt_prims : public CppUnit::TestCase {
   CPPUNIT_TEST(test_equivalence);
   CPPUNIT_TEST(test_misc);
   CPPUNIT_TEST(test_dict);
+  CPPUNIT_TEST(test_dict_large);
   CPPUNIT_TEST(test_any);
   CPPUNIT_TEST(test_msg_accepter);
   CPPUNIT_TEST(test_io);
   CPPUNIT_TEST(test_lists);
   CPPUNIT_TEST(test_serialize);
+  CPPUNIT_TEST(test_serialize_buffer);
   CPPUNIT_TEST(test_sets);
   CPPUNIT_TEST(test_sugar);
+  CPPUNIT_TEST(test_pool);
+  CPPUNIT_TEST(test_pool_slots);
   CPPUNIT_TEST_SUITE_END();
 
  private:
@@ -60,13 +64,17 @@ class qa_pmt_prims : public CppUnit::TestCase {
   void test_equivalence();
   void test_misc();
   void test_dict();
+  void test_dict_large();
   void test_any();
   void test_msg_accepter();
   void test_io();
   void test_lists();
   void test_serialize();
+  void test_serialize_buffer();
   void test_sets();
   void test_sugar();
+  void test_pool();
+  void test_pool_slots();
 };
 
 #endif /* INCLUDED_QA_PMT_PRIMS_H */
@@ -12,17 +12,18 @@ _@TAG@vector(pmt_t x)
 
 
 pmt_@TAG@vector::pmt_@TAG@vector(size_t k, @TYPE@ fill)
-  : d_v(k)
+  : d_v(k, fill), d_elts(k ? &d_v[0] : 0), d_len(k)
 {
-  for (size_t i = 0; i < k; i++)
-    d_v[i] = fill;
 }
 
 pmt_@TAG@vector::pmt_@TAG@vector(size_t k, const @TYPE@ *data)
-  : d_v(k)
+  : d_v(data, data + k), d_elts(k ? &d_v[0] : 0), d_len(k)
+{
+}
+
+pmt_@TAG@vector::pmt_@TAG@vector(size_t k, @TYPE@ *data, pmt_t owner)
+  : d_elts(data), d_len(k), d_owner(owner)
 {
-  for (size_t i = 0; i < k; i++)
-    d_v[i] = data[i];
 }
 
 @TYPE@
@@ -30,7 +31,7 @@ pmt_@TAG@vector::ref(size_t k) const
 {
   if (k >= length())
     throw pmt_out_of_range("pmt_@TAG@vector_ref", pmt_from_long(k));
-  return d_v[k];
+  return d_elts[k];
 }
 
 void 
@@ -38,35 +39,35 @@ pmt_@TAG@vector::set(size_t k, @TYPE@ x)
 {
   if (k >= length())
     throw pmt_out_of_range("pmt_@TAG@vector_set", pmt_from_long(k));
-  d_v[k] = x;
+  d_elts[k] = x;
 }
 
 const @TYPE@ *
 pmt_@TAG@vector::elements(size_t &len)
 {
   len = length();
-  return &d_v[0];
+  return d_elts;
 }
 
 @TYPE@ *
 pmt_@TAG@vector::writable_elements(size_t &len)
 {
   len = length();
-  return &d_v[0];
+  return d_elts;
 }
 
 const void*
 pmt_@TAG@vector::uniform_elements(size_t &len)
 {
   len = length() * sizeof(@TYPE@);
-  return &d_v[0];
+  return d_elts;
 }
 
 void*
 pmt_@TAG@vector::uniform_writable_elements(size_t &len)
 {
   len = length() * sizeof(@TYPE@);
-  return &d_v[0];
+  return d_elts;
 }
 
 bool
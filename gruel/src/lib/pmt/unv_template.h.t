@@ -6,14 +6,18 @@
 class pmt_@TAG@vector : public pmt_uniform_vector
 {
   std::vector< @TYPE@ >	d_v;
+  @TYPE@		       *d_elts;		// &d_v[0], or aliased storage
+  size_t			d_len;
+  pmt_t				d_owner;	// keeps aliased storage alive
 
 public:
   pmt_@TAG@vector(size_t k, @TYPE@ fill);
   pmt_@TAG@vector(size_t k, const @TYPE@ *data);
+  pmt_@TAG@vector(size_t k, @TYPE@ *data, pmt_t owner);	// aliases data
   // ~pmt_@TAG@vector();
 
   bool is_@TAG@vector() const { return true; }
-  size_t length() const { return d_v.size(); }
+  size_t length() const { return d_len; }
   @TYPE@ ref(size_t k) const;
   void set(size_t k, @TYPE@ x);
   const @TYPE@ *elements(size_t &len);
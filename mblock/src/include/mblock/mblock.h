@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -54,6 +54,7 @@ private:
   friend class mb_runtime;
   friend class mb_mblock_impl;
   friend class mb_worker;
+  friend class mb_runtime_thread_pool;
 
 protected:
   /*!
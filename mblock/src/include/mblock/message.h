@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -45,6 +45,7 @@ mb_make_message(pmt::pmt_t signal,
 
 class mb_message {
   mb_message_sptr d_next;		// link field for msg queue
+  mb_message	 *d_mbox_next;		// link field for mb_mailbox
   pmt::pmt_t	  d_signal;
   pmt::pmt_t	  d_data;
   pmt::pmt_t	  d_metadata;
@@ -52,6 +53,7 @@ class mb_message {
   pmt::pmt_t	  d_port_id;		// name of port msg was rcvd on (symbol)
 
   friend class mb_msg_queue;
+  friend class mb_mailbox;
 
   friend mb_message_sptr
   mb_make_message(pmt::pmt_t signal, pmt::pmt_t data, pmt::pmt_t metadata, mb_pri_t priority);
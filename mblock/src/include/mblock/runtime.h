@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -29,6 +29,17 @@
  */
 mb_runtime_sptr mb_make_runtime();
 
+/*!
+ * \brief Make a runtime that runs the mblocks on a fixed pool of threads.
+ *
+ * Each mblock's handle_message is called by one pool thread at a
+ * time, in message priority order.  mblocks that override main_loop
+ * are not supported by this runtime.
+ *
+ * \param nthreads number of worker threads; 0 -> one per processor.
+ */
+mb_runtime_sptr mb_make_runtime_thread_pool(int nthreads = 0);
+
 /*!
  * \brief Abstract runtime support for m-blocks
  *
@@ -0,0 +1,190 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Contention benchmark for mb_port_simple::send.  Each of n threads
+ * sends through its own port of a common top block to its own sink,
+ * and drains the sink as it goes.  With -u the port's cached peer is
+ * thrown away before every send, so every send resolves it again
+ * under the big runtime lock.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <mblock/mblock.h>
+#include <mblock/runtime.h>
+#include <mb_runtime_nop.h>
+#include <mb_mblock_impl.h>
+#include <mblock/protocol_class.h>
+#include <mblock/class_registry.h>
+#include <mblock/message.h>
+#include <mblock/time.h>
+#include <gnuradio/omnithread.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+#include <algorithm>
+
+using namespace pmt;
+
+static const int MAX_THREADS = 64;
+
+static pmt_t s_data = pmt_intern("data");
+
+class bps_sink : public mb_mblock
+{
+  mb_port_sptr	d_in;
+
+public:
+  bps_sink(mb_runtime *runtime, const std::string &instance_name, pmt_t user_arg)
+    : mb_mblock(runtime, instance_name, user_arg)
+  {
+    d_in = define_port("in", "bps-data", true, mb_port::EXTERNAL);
+  }
+};
+
+REGISTER_MBLOCK_CLASS(bps_sink);
+
+class bps_top : public mb_mblock
+{
+  std::vector<mb_port_sptr> d_out;
+
+public:
+  bps_top(mb_runtime *runtime, const std::string &instance_name, pmt_t user_arg)
+    : mb_mblock(runtime, instance_name, user_arg)
+  {
+    for (int i = 0; i < MAX_THREADS; i++){
+      char port[16], comp[16];
+      snprintf(port, sizeof(port), "out%d", i);
+      snprintf(comp, sizeof(comp), "sink%d", i);
+      d_out.push_back(define_port(port, "bps-data", false, mb_port::INTERNAL));
+      define_component(comp, "bps_sink");
+      connect("self", port, comp, "in");
+    }
+  }
+
+  mb_port_sptr out(int i) { return d_out[i]; }
+};
+
+REGISTER_MBLOCK_CLASS(bps_top);
+
+class sender : public omni_thread
+{
+  mb_port_sptr		d_port;
+  mb_mblock_impl_sptr	d_sink;
+  long			d_nmsgs;
+  bool			d_uncached;
+
+public:
+  sender(mb_port_sptr port, mb_mblock_sptr sink, long nmsgs, bool uncached)
+    : omni_thread(), d_port(port), d_sink(sink->impl()),
+      d_nmsgs(nmsgs), d_uncached(uncached) {}
+
+  void *run_undetached(void *ignored)
+  {
+    for (long i = 0; i < d_nmsgs; i++){
+      if (d_uncached)
+	d_port->invalidate_cache();
+      d_port->send(s_data, PMT_T);
+      if ((i & 0xff) == 0xff)
+	while (d_sink->msgq().get_highest_pri_msg_nowait())
+	  ;
+    }
+    while (d_sink->msgq().get_highest_pri_msg_nowait())
+      ;
+    return 0;
+  }
+};
+
+static void
+run_one(mb_mblock_sptr top, int nthreads, long nmsgs, bool uncached)
+{
+  bps_top *t = dynamic_cast<bps_top *>(top.get());
+  std::vector<sender *> threads;
+
+  mb_time t_start = mb_time::time();
+
+  for (int i = 0; i < nthreads; i++){
+    char comp[16];
+    snprintf(comp, sizeof(comp), "sink%d", i);
+    sender *s = new sender(t->out(i), top->impl()->component(comp),
+			   nmsgs, uncached);
+    s->start_undetached();
+    threads.push_back(s);
+  }
+
+  for (int i = 0; i < nthreads; i++){
+    void *ignore;
+    threads[i]->join(&ignore);
+  }
+
+  double delta = (mb_time::time() - t_start).double_time();
+  printf("%-8s  threads: %2d  msgs/sec: %10.0f\n",
+	 uncached ? "uncached" : "cached", nthreads, nthreads * nmsgs / delta);
+}
+
+int
+main(int argc, char **argv)
+{
+  int  max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  long nmsgs = 200000;
+  bool uncached = false;
+  int  ch;
+
+  while ((ch = getopt(argc, argv, "n:N:u")) != EOF){
+    switch(ch){
+    case 'n':
+      max_threads = strtol(optarg, 0, 0);
+      break;
+
+    case 'N':
+      nmsgs = strtol(optarg, 0, 0);
+      break;
+
+    case 'u':
+      uncached = true;
+      break;
+
+    case '?':
+    default:
+      fprintf(stderr, "usage: benchmark_port_send [-n <max_threads>] [-N <nmsgs>] [-u]\n");
+      return 1;
+    }
+  }
+
+  max_threads = std::max(1, std::min(max_threads, MAX_THREADS));
+
+  mb_make_protocol_class(pmt_intern("bps-data"),	// name
+			 PMT_NIL,			// incoming
+			 pmt_list1(s_data));		// outgoing
+
+  mb_runtime_sptr rt = mb_make_runtime_nop();
+  rt->run("top", "bps_top", PMT_F);
+  mb_mblock_sptr top = dynamic_cast<mb_runtime_nop *>(rt.get())->top();
+
+  for (int n = 1; n <= max_threads; n++)
+    run_one(top, n, nmsgs, uncached);
+
+  return 0;
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -20,28 +20,54 @@
  */
 
 #include <mblock/runtime.h>
+#include <mblock/time.h>
 #include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
 
 using namespace pmt;
 
-int
-main(int argc, char **argv)
+/*
+ * Push nmsgs messages through the qa_bitset pipeline with each of the
+ * runtimes and report the message rate.
+ */
+static bool
+run_one(const char *name, mb_runtime_sptr rt, long nmsgs, long batch_size)
 {
-  mb_runtime_sptr rt = mb_make_runtime();
   pmt_t result = PMT_NIL;
-
-  long nmsgs =      1000000;
-  long batch_size =     100;
-
   pmt_t arg = pmt_list2(pmt_from_long(nmsgs),	// # of messages to send through pipe
 			pmt_from_long(batch_size));
 
+  mb_time t_start = mb_time::time();
   rt->run("top", "qa_bitset_top", arg, &result);
+  double delta = (mb_time::time() - t_start).double_time();
 
   if (!pmt_equal(PMT_T, result)){
-    std::cerr << "benchmark_send: incorrect result";
-    return 1;
+    std::cerr << "benchmark_send: " << name << ": incorrect result\n";
+    return false;
   }
 
+  printf("%-16s  msgs: %8ld  secs: %7.3f  msgs/sec: %10.0f\n",
+	 name, nmsgs, delta, nmsgs / delta);
+  return true;
+}
+
+int
+main(int argc, char **argv)
+{
+  long nmsgs =      1000000;
+  long batch_size =     100;
+  int  nthreads =         0;	// 0 -> one per processor
+
+  if (argc > 1)
+    nthreads = strtol(argv[1], 0, 0);
+
+  if (!run_one("thread-per-block", mb_make_runtime(), nmsgs, batch_size))
+    return 1;
+
+  if (!run_one("thread-pool", mb_make_runtime_thread_pool(nthreads),
+	       nmsgs, batch_size))
+    return 1;
+
   return 0;
 }
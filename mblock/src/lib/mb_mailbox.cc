@@ -0,0 +1,118 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <mb_mailbox.h>
+
+mb_mailbox::mb_mailbox()
+  : d_held(1), d_dead(false)
+{
+  for (int q = 0; q < MB_NPRI; q++){
+    d_inbox[q] = 0;
+    d_fifo[q] = 0;
+  }
+}
+
+mb_mailbox::~mb_mailbox()
+{
+  kill();
+}
+
+bool
+mb_mailbox::insert(mb_message_sptr msg)
+{
+  if (d_dead)
+    return false;
+
+  mb_message *m = msg.get();
+  mb_pri_t q = mb_pri_clamp(m->priority());
+  m->d_next = msg;		// keep it alive while it's in here
+
+  mb_message *old;
+  do {
+    old = d_inbox[q];
+    m->d_mbox_next = old;
+  } while (!__sync_bool_compare_and_swap(&d_inbox[q], old, m));
+
+  return acquire();
+}
+
+bool
+mb_mailbox::release()
+{
+  // The CAS is a full barrier, so either we see a message pushed
+  // before an inserter's call to acquire, or it sees d_held == 0.
+  __sync_bool_compare_and_swap(&d_held, 1, 0);
+
+  for (int q = 0; q < MB_NPRI; q++)
+    if (d_fifo[q] != 0 || d_inbox[q] != 0)
+      return acquire();
+
+  return false;
+}
+
+void
+mb_mailbox::refill(int q)
+{
+  mb_message *m = __sync_lock_test_and_set(&d_inbox[q], (mb_message *) 0);
+
+  // reverse the LIFO onto the front of the (empty) FIFO
+  mb_message *fifo = 0;
+  while (m){
+    mb_message *next = m->d_mbox_next;
+    m->d_mbox_next = fifo;
+    fifo = m;
+    m = next;
+  }
+  d_fifo[q] = fifo;
+}
+
+mb_message_sptr
+mb_mailbox::get_highest_pri_msg()
+{
+  mb_message_sptr msg;
+
+  for (int q = 0; q < MB_NPRI; q++){
+    if (d_fifo[q] == 0){
+      if (d_inbox[q] == 0)
+	continue;
+      refill(q);
+    }
+
+    mb_message *m = d_fifo[q];
+    d_fifo[q] = m->d_mbox_next;
+    m->d_mbox_next = 0;
+    msg.swap(m->d_next);	// take over the message's self reference
+    return msg;
+  }
+
+  return msg;
+}
+
+void
+mb_mailbox::kill()
+{
+  d_dead = true;
+  while (get_highest_pri_msg())
+    ;
+}
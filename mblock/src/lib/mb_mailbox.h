@@ -0,0 +1,88 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef INCLUDED_MB_MAILBOX_H
+#define INCLUDED_MB_MAILBOX_H
+
+#include <mblock/common.h>
+#include <mblock/message.h>
+
+/*!
+ * \brief Lock free priority mailbox for an mblock run by mb_runtime_thread_pool
+ * \internal
+ *
+ * Any number of threads may insert messages.  Only the thread that
+ * holds the mailbox (see acquire and release) may remove them, which
+ * is what serializes the calls to an mblock's handle_message.
+ *
+ * Each priority has an intrusive LIFO pushed with compare and swap.
+ * The consumer takes the whole LIFO at once and reverses it into a
+ * private FIFO, so messages of the same priority are delivered in the
+ * order they were inserted.  While a message is in the mailbox it
+ * holds a reference to itself in its d_next field.
+ */
+class mb_mailbox : boost::noncopyable
+{
+  mb_message *volatile	d_inbox[MB_NPRI];	// pushed by any thread
+  mb_message	       *d_fifo[MB_NPRI];	// consumer only
+  volatile int		d_held;			// 1 -> someone owns the consumer side
+  volatile bool		d_dead;			// discard incoming messages
+
+  void refill(int q);
+
+public:
+  /*!
+   * The mailbox starts out held, so that nothing is dispatched to the
+   * mblock until its constructor and initial_transition have finished.
+   */
+  mb_mailbox();
+  ~mb_mailbox();
+
+  /*!
+   * \brief Insert \p msg.  Can be invoked from any thread.
+   * \returns true if the caller acquired the mailbox and must arrange
+   * for its messages to be handled.
+   */
+  bool insert(mb_message_sptr msg);
+
+  //! Try to take ownership of the consumer side.
+  bool acquire() { return __sync_bool_compare_and_swap(&d_held, 0, 1); }
+
+  /*!
+   * \brief Give up ownership of the consumer side.
+   * \returns true if messages arrived in the meantime and the caller
+   * reacquired the mailbox.
+   */
+  bool release();
+
+  /*!
+   * \brief Delete highest pri message from the mailbox and return it.
+   * Returns equivalent of zero pointer if the mailbox is empty.
+   * Only the owner may call this.
+   */
+  mb_message_sptr get_highest_pri_msg();
+
+  //! Discard all pending and future messages.  Only the owner may call this.
+  void kill();
+
+  bool dead_p() const { return d_dead; }
+};
+
+#endif /* INCLUDED_MB_MAILBOX_H */
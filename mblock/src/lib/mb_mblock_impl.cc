@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -129,6 +129,7 @@ mb_mblock_impl::connect(const std::string &comp_name1,
   // FIXME more checks?
 
   d_conn_table.create_conn(ep0, ep1);
+  invalidate_all_port_caches();
 }
 
 void
@@ -299,30 +300,13 @@ mb_mblock_impl::set_class_name(const std::string &name)
 }
 
 /*
- * This is the "Big Hammer" port cache invalidator.
- * It invalidates _all_ of the port caches in the entire mblock tree.
- * It's overkill, but was simple to code.
+ * This is still the "Big Hammer" port cache invalidator: all of the
+ * port caches in the runtime are invalidated.  But rather than walking
+ * the tree, we bump the connection version, and each port notices the
+ * next time it sends.  Must hold the big runtime lock.
  */
 void
 mb_mblock_impl::invalidate_all_port_caches()
 {
-  class invalidator : public mb_visitor
-  {
-  public:
-    bool operator()(mb_mblock *mblock)
-    {
-      mb_mblock_impl_sptr impl = mblock->impl();
-      mb_port_map_t::iterator it = impl->d_port_map.begin();
-      mb_port_map_t::iterator end = impl->d_port_map.end();
-      for (; it != end; ++it)
-	it->second->invalidate_cache();
-      return true;
-    }
-  };
-
-  invalidator visitor;
-
-  // Always true, except in early QA code
-  if (runtime()->top())
-    runtime()->top()->walk_tree(&visitor);
+  d_runtime->bump_conn_version();
 }
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,7 @@
 #include <mb_runtime_base.h>
 #include <mb_connection.h>
 #include <mblock/msg_queue.h>
+#include <mb_mailbox.h>
 #include <list>
 #include <map>
 
@@ -50,6 +51,7 @@ class mb_mblock_impl : boost::noncopyable
   mb_conn_table			d_conn_table;	// our connections
 
   mb_msg_queue			d_msgq;		// incoming messages for us
+  mb_mailbox			d_mailbox;	// ditto, mb_runtime_thread_pool
 
 public:
   mb_mblock_impl(mb_runtime_base *runtime, mb_mblock *mb,
@@ -153,6 +155,9 @@ public:
   mb_msg_queue &
   msgq() { return d_msgq; }
 
+  mb_mailbox &
+  mailbox() { return d_mailbox; }
+
   //! Return instance name of this block
   std::string instance_name() const { return d_instance_name; }
 
@@ -215,7 +220,7 @@ private:
 			   const mb_endpoint &ep1);
 
   /*!
-   * \brief walk mblock tree and invalidate all port resolution caches.
+   * \brief invalidate all port resolution caches.
    * \internal
    */
   void
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2006,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -62,7 +62,7 @@ mb_make_message(pmt_t signal, pmt_t data, pmt_t metadata, mb_pri_t priority)
 }
 
 mb_message::mb_message(pmt_t signal, pmt_t data, pmt_t metadata, mb_pri_t priority)
-  : d_signal(signal), d_data(data), d_metadata(metadata), d_priority(priority),
+  : d_mbox_next(0), d_signal(signal), d_data(data), d_metadata(metadata), d_priority(priority),
     d_port_id(PMT_NIL)
 {
 }
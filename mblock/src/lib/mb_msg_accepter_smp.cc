@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -46,5 +46,6 @@ mb_msg_accepter_smp::operator()(pmt_t signal, pmt_t data,
 {
   mb_message_sptr msg = mb_make_message(signal, data, metadata, priority);
   msg->set_port_id(d_port_name);
-  d_mb->impl()->msgq().insert(msg);
+  mb_mblock_impl *mbi = d_mb->impl().get();
+  mbi->runtime()->deliver(mbi, msg);
 }
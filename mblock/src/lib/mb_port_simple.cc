@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -39,7 +39,7 @@ mb_port_simple::mb_port_simple(mb_mblock *mblock,
 			       bool conjugated,
 			       mb_port::port_type_t port_type)
   : mb_port(mblock, port_name, protocol_class_name, conjugated, port_type),
-    d_cache_valid(false)
+    d_runtime(mblock->impl()->runtime()), d_cache_version(0)
 {
 }
 
@@ -54,25 +54,36 @@ mb_port_simple::send(pmt_t signal, pmt_t data, pmt_t metadata, mb_pri_t priority
   if (port_type() == mb_port::RELAY)  // Can't send directly to a RELAY port
     throw mbe_invalid_port_type(mblock(), mblock()->instance_name(), port_name());
 
-  mb_msg_accepter_sptr  accepter = find_accepter(this);
+  mb_msg_accepter_sptr  accepter = find_accepter();
   if (accepter)
     (*accepter)(signal, data, metadata, priority);
 }
 
 
 mb_msg_accepter_sptr
-mb_port_simple::find_accepter(mb_port_simple *start)
+mb_port_simple::find_accepter()
+{
+  if (d_cache_version == d_runtime->conn_version())
+    return d_cached_accepter;
+
+  mbi_runtime_lock	l(d_runtime);
+
+  // Any connect or disconnect after this is done under the lock,
+  // so we can't miss it.
+  unsigned long version = d_runtime->conn_version();
+  d_cached_accepter = resolve_accepter(this);
+  d_cache_version = version;
+  return d_cached_accepter;
+}
+
+// Must hold the big runtime lock.
+mb_msg_accepter_sptr
+mb_port_simple::resolve_accepter(mb_port_simple *start)
 {
   mb_port_simple	*p = start;
   mb_port_simple	*pp = 0;
   mb_mblock 		*context = 0;
   mb_endpoint 		peer_ep;
-  mb_msg_accepter_sptr	r;
-
-  if (start->d_cache_valid)
-    return start->d_cached_accepter;
-
-  mbi_runtime_lock	l(p->mblock());
 
   // Set up initial context.
 
@@ -88,7 +99,7 @@ mb_port_simple::find_accepter(mb_port_simple *start)
     break;
 
   default:
-    throw std::logic_error("Can't happen: mb_port_simple::find_accepter [1]");
+    throw std::logic_error("Can't happen: mb_port_simple::resolve_accepter [1]");
   }
 
 
@@ -103,13 +114,7 @@ mb_port_simple::find_accepter(mb_port_simple *start)
   switch (pp->port_type()){	
   case mb_port::INTERNAL:	// Terminate here.
   case mb_port::EXTERNAL:
-    r = pp->make_accepter();
-
-    // cache the result
-
-    start->d_cached_accepter = r;
-    start->d_cache_valid = true;
-    return r;
+    return pp->make_accepter();
 
   case mb_port::RELAY:		// Traverse to other side of relay port.
     if (peer_ep.inside_of_relay_port_p()){
@@ -133,7 +138,7 @@ mb_port_simple::find_accepter(mb_port_simple *start)
     break;
 
   default:
-    throw std::logic_error("Can't happen: mb_port_simple::find_accepter [2]");
+    throw std::logic_error("Can't happen: mb_port_simple::resolve_accepter [2]");
   }
 }
 
@@ -147,6 +152,6 @@ mb_port_simple::make_accepter()
 void
 mb_port_simple::invalidate_cache()
 {
-  d_cache_valid = false;
+  d_cache_version = 0;
   d_cached_accepter.reset();
 }
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -23,17 +23,29 @@
 
 #include <mblock/port.h>
 
+class mb_runtime_base;
+
 /*!
  * \brief Concrete port realization
+ *
+ * The peer of the port is resolved on the first send and cached along
+ * with the runtime's connection version (see
+ * mb_runtime_base::conn_version).  Sends through a port whose cache is
+ * current don't take the big runtime lock.  The cache is only touched
+ * by the thread sending through the port.
  */
 class mb_port_simple : public mb_port
 {
-  bool			d_cache_valid;
-  mb_msg_accepter_sptr	d_cached_accepter;
+  mb_runtime_base      *d_runtime;
+  unsigned long		d_cache_version;	// 0 -> invalid
+  mb_msg_accepter_sptr	d_cached_accepter;	// may be 0 (not bound)
 
 protected:
+  mb_msg_accepter_sptr
+  find_accepter();
+
   static mb_msg_accepter_sptr
-  find_accepter(mb_port_simple *start);
+  resolve_accepter(mb_port_simple *start);
 
   mb_msg_accepter_sptr
   make_accepter();
@@ -64,6 +76,9 @@ public:
   /*
    * \brief Invalidate any cached peer resolutions
    * \internal
+   *
+   * Only the thread that sends through this port may call this.
+   * Others change the connection version instead.
    */
   void invalidate_cache();
 
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2008 Free Software Foundation, Inc.
+ * Copyright 2006,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -25,6 +25,7 @@
 
 #include <mblock/runtime.h>
 #include <mb_runtime_thread_per_block.h>
+#include <mb_runtime_thread_pool.h>
 
 mb_runtime_sptr
 mb_make_runtime()
@@ -32,6 +33,12 @@ mb_make_runtime()
   return mb_runtime_sptr(new mb_runtime_thread_per_block());
 }
 
+mb_runtime_sptr
+mb_make_runtime_thread_pool(int nthreads)
+{
+  return mb_runtime_sptr(new mb_runtime_thread_pool(nthreads));
+}
+
 mb_runtime::~mb_runtime()
 {
   // nop
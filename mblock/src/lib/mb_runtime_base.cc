@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2008,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2008,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -23,6 +23,7 @@
 #include <config.h>
 #endif
 #include <mb_runtime_base.h>
+#include <mb_mblock_impl.h>
 
 using namespace pmt;
 
@@ -57,3 +58,8 @@ mb_runtime_base::cancel_timeout(pmt_t handle)
 {
 }
 
+void
+mb_runtime_base::deliver(mb_mblock_impl *mbi, mb_message_sptr msg)
+{
+  mbi->msgq().insert(msg);
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2007,2009 Free Software Foundation, Inc.
+ * Copyright 2007,2009,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -26,17 +26,21 @@
 #include <gnuradio/omnithread.h>
 #include <mblock/time.h>
 
+class mb_mblock_impl;
+
 /*
  * \brief This is the runtime class used by the implementation.
  */
 class mb_runtime_base : public mb_runtime
 {
   omni_mutex		d_brl;	// big runtime lock (avoid using this if possible...)
+  volatile unsigned long d_conn_version;	// bumped when any connection changes
 
 protected:
   mb_msg_accepter_sptr  d_accepter;
 
 public:
+  mb_runtime_base() : d_conn_version(1) {}
 
   /*!
    * \brief lock the big runtime lock
@@ -50,6 +54,23 @@ public:
    */
   inline void unlock() { d_brl.unlock(); }
 
+  /*!
+   * \brief Return the version of the connection tables.
+   * \internal
+   *
+   * May be read without holding the big runtime lock.  A port's cached
+   * peer is good as long as this hasn't changed since it was resolved.
+   */
+  unsigned long conn_version() const { return d_conn_version; }
+
+  /*!
+   * \brief Note that a connection table changed.
+   * \internal
+   *
+   * Must hold the big runtime lock.
+   */
+  void bump_conn_version() { d_conn_version = d_conn_version + 1; }
+
   virtual void request_shutdown(pmt::pmt_t result);
 
   virtual mb_mblock_sptr
@@ -69,6 +90,13 @@ public:
   virtual void
   cancel_timeout(pmt::pmt_t handle);
 
+  /*!
+   * \brief Queue \p msg for the mblock whose implementation is \p mbi.
+   * Can be invoked from any thread.
+   */
+  virtual void
+  deliver(mb_mblock_impl *mbi, mb_message_sptr msg);
+
   mb_msg_accepter_sptr
   accepter() { return d_accepter; }
   
@@ -0,0 +1,468 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <mb_runtime_thread_pool.h>
+#include <mblock/mblock.h>
+#include <mb_mblock_impl.h>
+#include <mblock/class_registry.h>
+#include <mblock/exception.h>
+#include <gnuradio/omnithread.h>
+#include <iostream>
+#include <unistd.h>
+#include <algorithm>
+#include <mb_msg_accepter_msgq.h>
+
+using namespace pmt;
+
+static const int MAX_BATCH = 16;	// msgs handled per turn on a worker
+
+static pmt_t s_halt = pmt_intern("%halt");
+static pmt_t s_sys_port = pmt_intern("%sys-port");
+static pmt_t s_shutdown = pmt_intern("%shutdown");
+static pmt_t s_request_shutdown = pmt_intern("%request-shutdown");
+static pmt_t s_worker_state_changed = pmt_intern("%worker-state-changed");
+static pmt_t s_timeout = pmt_intern("%timeout");
+static pmt_t s_request_timeout = pmt_intern("%request-timeout");
+static pmt_t s_cancel_timeout = pmt_intern("%cancel-timeout");
+static pmt_t s_send_halt = pmt_intern("send-halt");
+static pmt_t s_exit_now = pmt_intern("exit-now");
+
+
+class mb_pool_worker : public omni_thread
+{
+  mb_runtime_thread_pool	*d_runtime;
+
+public:
+  mb_pool_worker(mb_runtime_thread_pool *runtime)
+    : omni_thread(), d_runtime(runtime) {}
+
+  void *run_undetached(void *ignored)
+  {
+    d_runtime->worker_loop();
+    return 0;
+  }
+};
+
+
+mb_runtime_thread_pool::mb_runtime_thread_pool(int nthreads)
+  : d_nthreads(nthreads), d_ready_cond(&d_ready_mutex), d_stop(false),
+    d_nlive(0), d_shutdown_in_progress(false), d_shutdown_result(PMT_T)
+{
+  if (d_nthreads <= 0)
+    d_nthreads = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+  d_accepter = mb_msg_accepter_sptr(new mb_msg_accepter_msgq(&d_msgq));
+}
+
+mb_runtime_thread_pool::~mb_runtime_thread_pool()
+{
+  stop_workers();
+}
+
+void
+mb_runtime_thread_pool::request_shutdown(pmt_t result)
+{
+  (*accepter())(s_request_shutdown, result, PMT_F, MB_PRI_BEST);
+}
+
+bool
+mb_runtime_thread_pool::run(const std::string &instance_name,
+			    const std::string &class_name,
+			    pmt_t user_arg, pmt_t *result)
+{
+  if (result)		// set it to something now, in case we throw
+    *result = PMT_F;
+  
+  // reset the shutdown state
+  d_shutdown_in_progress = false;
+  d_shutdown_result = PMT_T;
+
+  assert(d_actors.empty());
+  d_nlive = 0;
+
+  while (!d_timer_queue.empty())	// ensure timer queue is empty
+    d_timer_queue.pop();
+
+  start_workers();
+
+  try {
+    /*
+     * Create the top-level component, and recursively all of its
+     * subcomponents.  Each one starts taking messages as soon as
+     * its initial_transition returns.
+     */
+    d_top = create_component(instance_name, class_name, user_arg);
+    run_loop();
+  }
+  catch (...){
+    stop_workers();
+    d_top.reset();
+    d_actors.clear();
+    throw;
+  }
+
+  // The pool must be idle before the mblocks can be destroyed.
+  stop_workers();
+
+  if (result)
+    *result = d_shutdown_result;
+  
+  d_top.reset();
+  d_actors.clear();
+  return true;
+}
+
+void
+mb_runtime_thread_pool::run_loop()
+{
+  if (all_dead_p())
+    return;
+
+  while (1){
+    mb_message_sptr msg;
+
+    if (d_timer_queue.empty())			  // Any timeouts pending?
+      msg = d_msgq.get_highest_pri_msg();	  // Nope.  Block forever.
+
+    else {
+      mb_timeout_sptr to = d_timer_queue.top();	  // Yep.  Get earliest timeout.
+
+      // wait for a msg or the timeout...
+      msg = d_msgq.get_highest_pri_msg_timedwait(to->d_when);
+
+      if (!msg){		// We timed out.
+	d_timer_queue.pop();	// Remove timeout from timer queue.
+
+	// send the %timeout msg
+	(*to->d_accepter)(s_timeout, to->d_user_data, to->handle(), MB_PRI_BEST);
+
+	if (to->d_is_periodic){
+	  to->d_when = to->d_when + to->d_delta; 	// update time of next firing
+	  d_timer_queue.push(to);			// push it back into the queue
+	}
+	continue;
+      }
+    }
+
+    pmt_t signal = msg->signal();
+
+    if (pmt_eq(signal, s_worker_state_changed)){	// %worker-state-changed
+      if (all_dead_p())		// no work left to do...
+	return;
+    }
+    else if (pmt_eq(signal, s_request_shutdown)){	// %request-shutdown
+      if (!d_shutdown_in_progress){
+	d_shutdown_in_progress = true;
+	d_shutdown_result = msg->data();
+
+	// schedule a timeout for ourselves...
+	schedule_one_shot_timeout(mb_time::time(0.100), s_send_halt, d_accepter);
+	send_all_sys_msg(s_shutdown);
+      }
+    }
+    else if (pmt_eq(signal, s_request_timeout)){	// %request-timeout
+      mb_timeout_sptr to =
+	boost::any_cast<mb_timeout_sptr>(pmt_any_ref(msg->data()));
+      d_timer_queue.push(to);
+    }
+    else if (pmt_eq(signal, s_cancel_timeout)){		// %cancel-timeout
+      d_timer_queue.cancel(msg->data());
+    }
+    else if (pmt_eq(signal, s_timeout)
+	     && pmt_eq(msg->data(), s_send_halt)){	// %timeout, send-halt
+
+      // schedule another timeout for ourselves...
+      schedule_one_shot_timeout(mb_time::time(0.100), s_exit_now, d_accepter);
+      send_all_sys_msg(s_halt);
+    }
+    else if (pmt_eq(signal, s_timeout)
+	     && pmt_eq(msg->data(), s_exit_now)){	// %timeout, exit-now
+
+      // We only get here if we've sent all mblocks %shutdown followed
+      // by %halt, and one or more of them is still alive.  Since they
+      // only run inside handle_message, one must be stuck in there,
+      // and stopping the pool will wait for it.
+      return;
+    }
+    else {
+      std::cerr << "mb_runtime_thread_pool: unhandled msg: " << msg << std::endl;
+    }
+  }
+}
+
+void
+mb_runtime_thread_pool::start_workers()
+{
+  d_stop = false;
+  for (int i = 0; i < d_nthreads; i++){
+    mb_pool_worker *w = new mb_pool_worker(this);
+    w->start_undetached();
+    d_workers.push_back(w);
+  }
+}
+
+void
+mb_runtime_thread_pool::stop_workers()
+{
+  {
+    omni_mutex_lock l(d_ready_mutex);
+    d_stop = true;
+    d_ready_cond.broadcast();
+  }
+
+  for (unsigned int i = 0; i < d_workers.size(); i++){
+    void *ignore;
+    d_workers[i]->join(&ignore);
+  }
+  d_workers.clear();
+  d_ready.clear();
+}
+
+void
+mb_runtime_thread_pool::worker_loop()
+{
+  while (1){
+    mb_mblock_impl *mbi;
+    {
+      omni_mutex_lock l(d_ready_mutex);
+      while (d_ready.empty() && !d_stop)
+	d_ready_cond.wait();
+
+      if (d_stop)
+	return;
+
+      mbi = d_ready.front();
+      d_ready.pop_front();
+    }
+    run_actor(mbi);
+  }
+}
+
+void
+mb_runtime_thread_pool::make_ready(mb_mblock_impl *mbi)
+{
+  omni_mutex_lock l(d_ready_mutex);
+  d_ready.push_back(mbi);
+  d_ready_cond.signal();
+}
+
+//
+// We own mbi's mailbox.  Handle up to MAX_BATCH of its messages, then
+// let go of it (or go to the back of the line if there are more).
+//
+void
+mb_runtime_thread_pool::run_actor(mb_mblock_impl *mbi)
+{
+  mb_mailbox &mbox = mbi->mailbox();
+
+  for (int i = 0; i < MAX_BATCH; i++){
+    mb_message_sptr msg = mbox.get_highest_pri_msg();
+    if (!msg)
+      break;
+
+    if (!dispatch(mbi->mblock(), msg)){
+      mbox.kill();		// we keep it held, so it's never run again
+      actor_died();
+      return;
+    }
+  }
+
+  if (mbox.release())
+    make_ready(mbi);
+}
+
+//
+// Handle one message the way mb_mblock::main_loop and mb_worker do.
+// Returns false if the mblock is dead.
+//
+bool
+mb_runtime_thread_pool::dispatch(mb_mblock *mb, mb_message_sptr msg)
+{
+  try {
+    // check for %halt from %sys-port
+    if (pmt_eq(msg->port_id(), s_sys_port) && pmt_eq(msg->signal(), s_halt))
+      mb->exit();
+
+    mb->handle_message(msg);
+    return true;
+  }
+  catch (pmt_exception e){
+    std::cerr << "\nmb_runtime_thread_pool: ignored pmt_exception: "
+	      << e.what()
+	      << "\nin mblock instance \"" << mb->instance_name()
+	      << "\" while handling message:"
+	      << "\n    port_id = " << msg->port_id()
+	      << "\n     signal = " << msg->signal()
+	      << "\n       data = " << msg->data()
+	      << "\n  metatdata = " << msg->metadata() << std::endl;
+    return true;
+  }
+  catch (mbe_terminate){
+  }
+  catch (mbe_exit){
+  }
+  catch (std::logic_error e){
+    std::cerr << "\nmb_runtime_thread_pool: unhandled exception:\n";
+    std::cerr << "  " << e.what() << std::endl;
+  }
+  catch (...){
+  }
+  return false;
+}
+
+void
+mb_runtime_thread_pool::actor_died()
+{
+  {
+    omni_mutex_lock l(d_actors_mutex);
+    d_nlive--;
+  }
+
+  // send msg to runtime, telling it something changed.
+  (*d_accepter)(s_worker_state_changed, PMT_F, PMT_F, MB_PRI_BEST);
+}
+
+bool
+mb_runtime_thread_pool::all_dead_p()
+{
+  omni_mutex_lock l(d_actors_mutex);
+  return d_nlive == 0;
+}
+
+//
+// Create the component and run its initial transition in the calling
+// thread, then let it start taking messages.
+//
+// Can be invoked from any thread
+//
+mb_mblock_sptr
+mb_runtime_thread_pool::create_component(const std::string &instance_name,
+					 const std::string &class_name,
+					 pmt_t user_arg)
+{
+  mb_mblock_maker_t maker;
+  if (!mb_class_registry::lookup_maker(class_name, &maker))
+    throw mbe_no_such_class(0, class_name + " (in " + instance_name + ")");
+
+  mb_mblock_sptr mb;
+  bool is_dead = false;
+
+  try {
+    mb = maker(this, instance_name, user_arg);
+  }
+  catch (...){
+    throw mbe_mblock_failed(0, instance_name);
+  }
+
+  try {
+    mb->initial_transition();
+  }
+  catch (mbe_exit){
+    is_dead = true;		// exited in initial_transition
+  }
+  catch (...){
+    // FIXME with some work we ought to be able to propagate the
+    // exception from the constructor or initial_transition.
+    throw mbe_mblock_failed(0, instance_name);
+  }
+
+  {
+    omni_mutex_lock l(d_actors_mutex);
+    d_actors.push_back(mb);
+    if (!is_dead)
+      d_nlive++;
+  }
+
+  mb_mailbox &mbox = mb->impl()->mailbox();
+  if (is_dead)
+    mbox.kill();
+  else if (mbox.release())	// anything sent to it in the meantime?
+    make_ready(mb->impl().get());
+
+  return mb;
+}
+
+void
+mb_runtime_thread_pool::deliver(mb_mblock_impl *mbi, mb_message_sptr msg)
+{
+  if (mbi->mailbox().insert(msg))
+    make_ready(mbi);
+}
+
+void
+mb_runtime_thread_pool::send_all_sys_msg(pmt_t signal,
+					 pmt_t data,
+					 pmt_t metadata,
+					 mb_pri_t priority)
+{
+  omni_mutex_lock l1(d_actors_mutex);
+
+  for (actor_iter_t ai = d_actors.begin(); ai != d_actors.end(); ++ai){
+    mb_message_sptr msg = mb_make_message(signal, data, metadata, priority);
+    msg->set_port_id(s_sys_port);
+    deliver((*ai)->impl().get(), msg);
+  }
+}
+
+//
+// Can be invoked from any thread.
+// Sends a message to the runtime.
+//
+pmt_t
+mb_runtime_thread_pool::schedule_one_shot_timeout
+  (const mb_time &abs_time,
+   pmt_t user_data,
+   mb_msg_accepter_sptr accepter)
+{
+  mb_timeout_sptr to(new mb_timeout(abs_time, user_data, accepter));
+  (*d_accepter)(s_request_timeout, pmt_make_any(to), PMT_F, MB_PRI_BEST);
+  return to->handle();
+}
+
+//
+// Can be invoked from any thread.
+// Sends a message to the runtime.
+//
+pmt_t
+mb_runtime_thread_pool::schedule_periodic_timeout
+  (const mb_time &first_abs_time,
+   const mb_time &delta_time,
+   pmt_t user_data,
+   mb_msg_accepter_sptr accepter)
+{
+  mb_timeout_sptr to(new mb_timeout(first_abs_time, delta_time,
+				    user_data, accepter));
+  (*d_accepter)(s_request_timeout, pmt_make_any(to), PMT_F, MB_PRI_BEST);
+  return to->handle();
+}
+
+//
+// Can be invoked from any thread.
+// Sends a message to the runtime.
+//
+void
+mb_runtime_thread_pool::cancel_timeout(pmt_t handle)
+{
+  (*d_accepter)(s_cancel_timeout, handle, PMT_F, MB_PRI_BEST);
+}
@@ -0,0 +1,117 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010 Free Software Foundation, Inc.
+ * 
+ * This file is part of GNU Radio
+ * 
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef INCLUDED_MB_RUNTIME_THREAD_POOL_H
+#define INCLUDED_MB_RUNTIME_THREAD_POOL_H
+
+#include <mb_runtime_base.h>
+#include <mblock/msg_queue.h>
+#include <mb_timer_queue.h>
+#include <deque>
+#include <vector>
+
+class mb_pool_worker;
+
+/*!
+ * \brief Concrete runtime that runs all mblocks on a fixed pool of threads
+ * \internal
+ *
+ * Messages for an mblock go into its lock free mb_mailbox.  The thread
+ * whose insert acquires the mailbox puts the mblock on the ready
+ * queue, and a pool thread then calls handle_message for a batch of
+ * its messages.  Since only the owner of the mailbox dispatches, each
+ * mblock sees one message at a time, as it does with a thread of its
+ * own.
+ *
+ * The thread that calls run services the timer queue and the
+ * shutdown sequence, just like mb_runtime_thread_per_block.
+ */
+class mb_runtime_thread_pool : public mb_runtime_base
+{
+  int				d_nthreads;
+  std::vector<mb_pool_worker*>	d_workers;
+
+  // d_ready_mutex guards the ready queue and d_stop
+  omni_mutex			d_ready_mutex;
+  omni_condition		d_ready_cond;
+  std::deque<mb_mblock_impl*>	d_ready;
+  bool				d_stop;
+
+  omni_mutex			d_actors_mutex;	// hold while manipulating d_actors
+  std::vector<mb_mblock_sptr>	d_actors;
+  int				d_nlive;
+
+  bool				d_shutdown_in_progress;
+  pmt::pmt_t			d_shutdown_result;
+  mb_msg_queue			d_msgq;
+  mb_timer_queue		d_timer_queue;
+
+  typedef std::vector<mb_mblock_sptr>::iterator  actor_iter_t;
+
+public:
+  mb_runtime_thread_pool(int nthreads = 0);
+  ~mb_runtime_thread_pool();
+
+  bool run(const std::string &instance_name,
+	   const std::string &class_name,
+	   pmt::pmt_t user_arg,
+	   pmt::pmt_t *result);
+
+  void request_shutdown(pmt::pmt_t result);
+
+  void worker_loop();		// really private
+
+protected:
+  mb_mblock_sptr
+  create_component(const std::string &instance_name,
+		   const std::string &class_name,
+		   pmt::pmt_t user_arg);
+
+  pmt::pmt_t
+  schedule_one_shot_timeout(const mb_time &abs_time, pmt::pmt_t user_data,
+			    mb_msg_accepter_sptr accepter);
+
+  pmt::pmt_t
+  schedule_periodic_timeout(const mb_time &first_abs_time,
+			    const mb_time &delta_time,
+			    pmt::pmt_t user_data,
+			    mb_msg_accepter_sptr accepter);
+  void
+  cancel_timeout(pmt::pmt_t handle);
+
+  void
+  deliver(mb_mblock_impl *mbi, mb_message_sptr msg);
+
+private:
+  void start_workers();
+  void stop_workers();
+  void make_ready(mb_mblock_impl *mbi);
+  void run_actor(mb_mblock_impl *mbi);
+  bool dispatch(mb_mblock *mb, mb_message_sptr msg);
+  void actor_died();
+  bool all_dead_p();
+  void run_loop();
+
+  void send_all_sys_msg(pmt::pmt_t signal, pmt::pmt_t data = pmt::PMT_F,
+			pmt::pmt_t metadata = pmt::PMT_F,
+			mb_pri_t priority = MB_PRI_BEST);
+};
+
+#endif /* INCLUDED_MB_RUNTIME_THREAD_POOL_H */
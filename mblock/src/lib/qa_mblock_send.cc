@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2008 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -475,3 +475,126 @@ qa_mblock_send::test_relay_routing_2()
   CPPUNIT_ASSERT(pmt_equal(pmt_list3(pmt_intern("top/c0/c0"), s_p1, pmt_from_long(1)),
 			   msg->data()));
 }
+
+// ================================================================
+//			  test_reconnect
+// ================================================================
+
+// sub-block for test_reconnect; all it has is a port
+
+class rc1 : public mb_mblock
+{
+  mb_port_sptr	d_p1;
+
+public:
+  rc1(mb_runtime *runtime, const std::string &instance_name, pmt_t user_arg);
+  ~rc1();
+};
+
+rc1::rc1(mb_runtime *runtime, const std::string &instance_name, pmt_t user_arg)
+  : mb_mblock(runtime, instance_name, user_arg)
+{
+  d_p1 = define_port("p1", "qa-send-cs", true, mb_port::EXTERNAL);
+}
+
+rc1::~rc1(){}
+
+REGISTER_MBLOCK_CLASS(rc1);
+
+// ----------------------------------------------------------------
+
+// top-level block for test_reconnect; the test drives it directly
+
+class rc0 : public mb_mblock
+{
+  mb_port_sptr	d_p0;
+
+public:
+  rc0(mb_runtime *runtime, const std::string &instance_name, pmt_t user_arg);
+  ~rc0();
+
+  void send(long n) { d_p0->send(s_control, pmt_from_long(n)); }
+
+  void rewire(const std::string &from, const std::string &to)
+  {
+    if (!from.empty())
+      disconnect("self", "p0", from, "p1");
+    if (!to.empty())
+      connect("self", "p0", to, "p1");
+  }
+};
+
+rc0::rc0(mb_runtime *runtime, const std::string &instance_name, pmt_t user_arg)
+  : mb_mblock(runtime, instance_name, user_arg)
+{
+  d_p0 = define_port("p0", "qa-send-cs", false, mb_port::INTERNAL);
+
+  define_component("mb1", "rc1");
+  define_component("mb2", "rc1");
+}
+
+rc0::~rc0(){}
+
+REGISTER_MBLOCK_CLASS(rc0);
+
+// ----------------------------------------------------------------
+
+static void
+check_received(mb_mblock_sptr mb, long n)
+{
+  mb_message_sptr msg = mb->impl()->msgq().get_highest_pri_msg_nowait();
+  CPPUNIT_ASSERT(msg);
+  CPPUNIT_ASSERT_EQUAL(s_p1, msg->port_id());
+  CPPUNIT_ASSERT(pmt_equal(pmt_from_long(n), msg->data()));
+}
+
+static void
+check_empty(mb_mblock_sptr mb)
+{
+  CPPUNIT_ASSERT(!mb->impl()->msgq().get_highest_pri_msg_nowait());
+}
+
+/*
+ * Ports cache their peer.  Make sure the cache follows the connection
+ * table when it changes underneath a port that's already been used.
+ */
+void
+qa_mblock_send::test_reconnect()
+{
+  define_protocol_classes();
+
+  mb_runtime_sptr rt = mb_make_runtime_nop();
+  rt->run("top", "rc0", PMT_F);
+
+  mb_mblock_sptr mb0 = get_top(rt);
+  rc0 *top = dynamic_cast<rc0 *>(mb0.get());
+  CPPUNIT_ASSERT(top);
+  mb_mblock_sptr mb1 = mb0->impl()->component("mb1");
+  mb_mblock_sptr mb2 = mb0->impl()->component("mb2");
+
+  top->send(0);			// not bound
+  check_empty(mb1);
+  check_empty(mb2);
+
+  top->rewire("", "mb1");
+  top->send(1);
+  top->send(2);
+  check_received(mb1, 1);
+  check_received(mb1, 2);
+  check_empty(mb2);
+
+  top->rewire("mb1", "mb2");
+  top->send(3);
+  check_empty(mb1);
+  check_received(mb2, 3);
+
+  top->rewire("mb2", "");
+  top->send(4);
+  check_empty(mb1);
+  check_empty(mb2);
+
+  top->rewire("", "mb1");
+  top->send(5);
+  check_received(mb1, 5);
+  check_empty(mb2);
+}
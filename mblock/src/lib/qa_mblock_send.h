@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -31,12 +31,14 @@ class qa_mblock_send : public CppUnit::TestCase {
   CPPUNIT_TEST(test_simple_routing);
   CPPUNIT_TEST(test_relay_routing_1);
   CPPUNIT_TEST(test_relay_routing_2);
+  CPPUNIT_TEST(test_reconnect);
   CPPUNIT_TEST_SUITE_END();
 
  private:
   void test_simple_routing();
   void test_relay_routing_1();
   void test_relay_routing_2();
+  void test_reconnect();
 };
 
 #endif /* INCLUDED_QA_MBLOCK_SEND_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007,2008 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -270,3 +270,34 @@ qa_mblock_sys::test_disconnect()
 
   CPPUNIT_ASSERT(pmt_equal(PMT_T, result));
 }
+
+// ================================================================
+//	   the same, but with mb_runtime_thread_pool
+// ================================================================
+
+void
+qa_mblock_sys::test_sys_2_pool()
+{
+  mb_runtime_sptr rt = mb_make_runtime_thread_pool(2);
+  pmt_t result = PMT_NIL;
+
+  rt->run("top-sys-2", "sys_2", PMT_F, &result);
+  CPPUNIT_ASSERT(pmt_equal(PMT_T, result));
+}
+
+void
+qa_mblock_sys::test_bitset_pool()
+{
+  mb_runtime_sptr rt = mb_make_runtime_thread_pool(2);
+  pmt_t result = PMT_NIL;
+
+  long nmsgs =        1000;
+  long batch_size =      8;
+  
+  pmt_t arg = pmt_list2(pmt_from_long(nmsgs),	// # of messages to send through pipe
+			pmt_from_long(batch_size));
+
+  rt->run("top", "qa_bitset_top", arg, &result);
+
+  CPPUNIT_ASSERT(pmt_equal(PMT_T, result));
+}
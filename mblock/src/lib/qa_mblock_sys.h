@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2006,2007 Free Software Foundation, Inc.
+ * Copyright 2006,2007,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -32,6 +32,8 @@ class qa_mblock_sys : public CppUnit::TestCase {
   CPPUNIT_TEST(test_sys_2);
   CPPUNIT_TEST(test_bitset_1);
   CPPUNIT_TEST(test_disconnect);
+  CPPUNIT_TEST(test_sys_2_pool);
+  CPPUNIT_TEST(test_bitset_pool);
   CPPUNIT_TEST_SUITE_END();
 
  private:
@@ -39,6 +41,8 @@ class qa_mblock_sys : public CppUnit::TestCase {
   void test_sys_2();
   void test_bitset_1();
   void test_disconnect();
+  void test_sys_2_pool();
+  void test_bitset_pool();
 };
 
 #endif /* INCLUDED_QA_MBLOCK_SYS_H */
@@ -367,6 +367,8 @@ main(int argc, char **argv)
     printf("Approximate throughput was %5.2f MB/sec.\n", mbs);
     printf("Total instances of overruns was %d.\n", u2->rx_overruns());
     printf("Total missing frames was %d.\n", u2->rx_missing());
+    printf("Host ring high-water mark was %d frames.\n", u2->rx_ring_high_water(0));
+    printf("Host ring dropped %d frames.\n", u2->rx_ring_drops(0));
   }
 
   return 0;
@@ -0,0 +1,271 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2009 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measure control command latency and sustained rx/tx rates through
+ * libusrp2.  Intended to be run against usrp2_emulator (see the
+ * comment at the top of usrp2_emulator.cc), but works on real hardware.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <usrp2/usrp2.h>
+#include <usrp2/rx_nop_handler.h>
+#include <usrp2/strtod_si.h>
+#include <gruel/realtime.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <complex>
+#include <getopt.h>
+#include <stdlib.h>
+
+static double
+now_secs()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// Counts samples, checks the emulator's counting pattern if asked to
+class rx_counter : public usrp2::rx_nop_handler
+{
+  bool		d_check;
+  bool		d_first;
+  uint32_t	d_expected;
+  uint64_t	d_pattern_errors;
+
+public:
+  rx_counter(bool check)
+    : usrp2::rx_nop_handler(0), d_check(check), d_first(true),
+      d_expected(0), d_pattern_errors(0) {}
+
+  ~rx_counter();
+
+  bool
+  operator()(const uint32_t *items, size_t nitems, const usrp2::rx_metadata *metadata)
+  {
+    bool ok = rx_nop_handler::operator()(items, nitems, metadata);
+
+    if (d_check){
+      for (size_t i = 0; i < nitems; i++){
+	uint32_t n = ntohl(items[i]) >> 16;	// items are still in wire order
+	if (!d_first && n != d_expected)
+	  d_pattern_errors++;
+	d_first = false;
+	d_expected = (n + 1) & 0xffff;
+      }
+    }
+    return ok;
+  }
+
+  uint64_t pattern_errors() const { return d_pattern_errors; }
+};
+
+rx_counter::~rx_counter()
+{
+}
+
+static void
+bench_control(usrp2::usrp2::sptr u2, int ncmds)
+{
+  double tmin = 1e9, tmax = 0, tsum = 0;
+  int nfailed = 0;
+
+  for (int i = 0; i < ncmds; i++){
+    double t0 = now_secs();
+    bool ok = u2->set_rx_gain(u2->rx_gain_min());
+    double dt = now_secs() - t0;
+    if (!ok)
+      nfailed++;
+    tmin = std::min(tmin, dt);
+    tmax = std::max(tmax, dt);
+    tsum += dt;
+  }
+
+  printf("control: %d commands, %d failed\n", ncmds, nfailed);
+  printf("control: latency min %.1f us, avg %.1f us, max %.1f us\n",
+	 tmin * 1e6, tsum / ncmds * 1e6, tmax * 1e6);
+}
+
+static void
+bench_rx(usrp2::usrp2::sptr u2, int items_per_frame, double secs, bool check)
+{
+  rx_counter handler(check);
+
+  unsigned int overruns0 = u2->rx_overruns();
+  unsigned int missing0 = u2->rx_missing();
+
+  if (!u2->start_rx_streaming(0, items_per_frame)){
+    std::cerr << "start_rx_streaming failed\n";
+    return;
+  }
+
+  double t0 = now_secs();
+  double elapsed = 0;
+  while (elapsed < secs){
+    if (!u2->rx_samples(0, &handler)){
+      std::cerr << "rx_samples failed\n";
+      break;
+    }
+    elapsed = now_secs() - t0;
+  }
+
+  u2->stop_rx_streaming(0);
+
+  printf("rx: %llu frames, %llu samples in %.3f s\n",
+	 (unsigned long long) handler.nframes(),
+	 (unsigned long long) handler.nsamples(), elapsed);
+  printf("rx: %.3f MS/s, %.0f frames/s\n",
+	 handler.nsamples() / elapsed / 1e6, handler.nframes() / elapsed);
+  printf("rx: overruns %u, missing frames %u\n",
+	 u2->rx_overruns() - overruns0, u2->rx_missing() - missing0);
+  printf("rx: host ring high-water %u frames, drops %u\n",
+	 u2->rx_ring_high_water(0), u2->rx_ring_drops(0));
+  if (check)
+    printf("rx: sample pattern errors %llu\n",
+	   (unsigned long long) handler.pattern_errors());
+}
+
+static void
+bench_tx(usrp2::usrp2::sptr u2, double secs)
+{
+  // Large enough that tx_16sc splits it into many frames per call
+  std::vector<std::complex<int16_t> > samples(16 * 1024);
+
+  usrp2::tx_metadata md;
+  md.timestamp = -1;
+  md.start_of_burst = 1;
+  md.send_now = 1;
+
+  uint64_t nsamples = 0;
+  double t0 = now_secs();
+  double elapsed = 0;
+  while (elapsed < secs){
+    if (!u2->tx_16sc(0, &samples[0], samples.size(), &md)){
+      std::cerr << "tx_16sc failed\n";
+      break;
+    }
+    md.start_of_burst = 0;
+    nsamples += samples.size();
+    elapsed = now_secs() - t0;
+  }
+
+  printf("tx: %llu samples in %.3f s, %.3f MS/s\n",
+	 (unsigned long long) nsamples, elapsed, nsamples / elapsed / 1e6);
+}
+
+static void
+usage(const char *progname)
+{
+  fprintf(stderr, "usage: %s [options]\n\n", progname);
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h                   show this message and exit\n");
+  fprintf(stderr, "  -e ETH_INTERFACE     specify ethernet interface [default=eth0]\n");
+  fprintf(stderr, "  -m MAC_ADDR          mac address of USRP2 HH:HH [default=first one found]\n");
+  fprintf(stderr, "  -d DECIM             rx decimation / tx interpolation [default=16]\n");
+  fprintf(stderr, "  -F ITEMS_PER_FRAME   items per rx frame [default=max]\n");
+  fprintf(stderr, "  -t SECS              duration of each rx/tx test [default=5]\n");
+  fprintf(stderr, "  -n NCMDS             number of control commands to time [default=1000]\n");
+  fprintf(stderr, "  -c                   check the usrp2_emulator sample pattern\n");
+}
+
+int
+main(int argc, char **argv)
+{
+  const char *interface = "eth0";
+  const char *mac_addr_str = "";
+  int decim = 16;
+  int items_per_frame = 0;
+  double secs = 5;
+  int ncmds = 1000;
+  bool check = false;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "he:m:d:F:t:n:c")) != EOF){
+    switch (ch){
+    case 'e':
+      interface = optarg;
+      break;
+
+    case 'm':
+      mac_addr_str = optarg;
+      break;
+
+    case 'd':
+      decim = strtol(optarg, 0, 0);
+      if (decim < 4 || decim > 512){
+	std::cerr << "invalid decimation rate: " << optarg << std::endl;
+	usage(argv[0]);
+	return 1;
+      }
+      break;
+
+    case 'F':
+      items_per_frame = strtol(optarg, 0, 0);
+      break;
+
+    case 't':
+      if (!strtod_si(optarg, &secs)){
+	std::cerr << "invalid number: " << optarg << std::endl;
+	usage(argv[0]);
+	return 1;
+      }
+      break;
+
+    case 'n':
+      ncmds = strtol(optarg, 0, 0);
+      break;
+
+    case 'c':
+      check = true;
+      break;
+
+    case 'h':
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  gruel::rt_status_t rt = gruel::enable_realtime_scheduling();
+  if (rt != gruel::RT_OK)
+    std::cerr << "Failed to enable realtime scheduling" << std::endl;
+
+  usrp2::usrp2::sptr u2 = usrp2::usrp2::make(interface, mac_addr_str);
+
+  if (!u2->set_rx_decim(decim) || !u2->set_tx_interp(decim)){
+    std::cerr << "failed to set decim/interp\n";
+    return 1;
+  }
+
+  if (ncmds > 0)
+    bench_control(u2, ncmds);
+
+  if (secs > 0){
+    bench_rx(u2, items_per_frame, secs, check);
+    bench_tx(u2, secs);
+  }
+
+  return 0;
+}
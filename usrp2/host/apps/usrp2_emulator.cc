@@ -0,0 +1,563 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2009 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Software USRP2.
+ *
+ * Speaks the control and data packet formats of usrp2_eth_packet.h on
+ * a raw ethernet socket, so that libusrp2 and the blocks built on it
+ * can be exercised without hardware.  Run it on one end of a veth pair
+ * and point the host code at the other end:
+ *
+ *   ip link add veth0 type veth peer name veth1
+ *   ip link set veth0 up; ip link set veth1 up
+ *   usrp2_emulator -e veth1 &
+ *   usrp2_benchmark -e veth0
+ *
+ * Receive data frames carry consecutive sequence numbers, timestamps
+ * that advance by items_per_frame * decim ticks of the 100 MHz clock
+ * and a counting sample pattern (I = n, Q = ~n), paced to the sample
+ * rate implied by the configured decimation.  Transmit frames are
+ * accepted and counted.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <usrp2_eth_packet.h>
+#include <usrp2_types.h>
+#include <usrp2/strtod_si.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <netpacket/packet.h>
+#include <net/ethernet.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <getopt.h>
+#include <string.h>
+#include <stdlib.h>
+#include <cstdio>
+#include <algorithm>
+
+static const double MASTER_CLOCK_FREQ = 100e6;
+static const int    MAX_CATCHUP_FRAMES = 64;	// frames sent per poll when behind
+static const int    MIN_PKTLEN = 64;
+static const int    MAX_PKTLEN = 1512;
+
+static volatile bool signaled = false;
+
+static void
+sig_handler(int sig)
+{
+  signaled = true;
+}
+
+static double
+now_secs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool
+parse_mac_addr(const char *s, u2_mac_addr_t *p)
+{
+  return sscanf(s, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+		&p->addr[0], &p->addr[1], &p->addr[2],
+		&p->addr[3], &p->addr[4], &p->addr[5]) == 6;
+}
+
+// ------------------------------------------------------------------------
+
+class usrp2_emulator
+{
+  int		d_fd;
+  u2_mac_addr_t	d_mac;		// the MAC we pretend to have
+  u2_mac_addr_t	d_host;		// where streaming data goes
+  bool		d_verbose;
+
+  // rx (USRP2 -> host) state
+  bool		d_streaming;
+  unsigned int	d_items_per_frame;
+  int		d_decim;
+  double	d_rate;		// samples/sec, 0 => derive from decim
+  double	d_next_frame_time;
+  uint8_t	d_rx_seqno;
+  uint32_t	d_timestamp;
+  uint32_t	d_sample_count;
+
+  // tx (host -> USRP2) state
+  int		d_interp;
+  int		d_expected_tx_seqno;
+
+  // statistics
+  unsigned long long d_ctrl_pkts;
+  unsigned long long d_rx_frames;
+  unsigned long long d_rx_send_errors;
+  unsigned long long d_rx_late_frames;
+  unsigned long long d_tx_frames;
+  unsigned long long d_tx_items;
+  unsigned long long d_tx_missing;
+
+  double rx_sample_rate() const
+  {
+    return d_rate > 0 ? d_rate : MASTER_CLOCK_FREQ / d_decim;
+  }
+
+  void init_hdrs(u2_eth_packet_t *p, int chan, uint8_t seqno)
+  {
+    p->ehdr.dst = d_host;
+    p->ehdr.src = d_mac;
+    p->ehdr.ethertype = htons(U2_ETHERTYPE);
+    p->thdr.flags = 0;
+    p->thdr.fifo_status = 0;
+    p->thdr.seqno = seqno;
+    p->thdr.ack = 0;
+    u2p_set_word0(&p->fixed, 0, chan);
+    u2p_set_timestamp(&p->fixed, d_timestamp);
+  }
+
+  size_t handle_subpkt(const uint8_t *s, uint8_t *r);
+  void handle_control(const uint8_t *pkt, size_t len);
+  void handle_data(const uint8_t *pkt, size_t len);
+  void send_rx_frame();
+
+public:
+  usrp2_emulator(const u2_mac_addr_t &mac, double rate, bool verbose)
+    : d_fd(-1), d_mac(mac), d_verbose(verbose),
+      d_streaming(false), d_items_per_frame(U2_MAX_SAMPLES), d_decim(16),
+      d_rate(rate), d_next_frame_time(0), d_rx_seqno(0), d_timestamp(0),
+      d_sample_count(0), d_interp(16), d_expected_tx_seqno(-1),
+      d_ctrl_pkts(0), d_rx_frames(0), d_rx_send_errors(0), d_rx_late_frames(0),
+      d_tx_frames(0), d_tx_items(0), d_tx_missing(0)
+  {
+    memset(&d_host, 0xff, sizeof(d_host));
+  }
+
+  ~usrp2_emulator()
+  {
+    if (d_fd >= 0)
+      close(d_fd);
+  }
+
+  bool open(const char *ifname);
+  void run();
+  void report() const;
+};
+
+bool
+usrp2_emulator::open(const char *ifname)
+{
+  d_fd = socket(PF_PACKET, SOCK_RAW, htons(U2_ETHERTYPE));
+  if (d_fd < 0){
+    perror("usrp2_emulator: socket");
+    return false;
+  }
+
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, ifname, sizeof(ifr.ifr_name) - 1);
+  if (ioctl(d_fd, SIOCGIFINDEX, &ifr) < 0){
+    perror(ifname);
+    return false;
+  }
+
+  struct sockaddr_ll sll;
+  memset(&sll, 0, sizeof(sll));
+  sll.sll_family = AF_PACKET;
+  sll.sll_protocol = htons(U2_ETHERTYPE);
+  sll.sll_ifindex = ifr.ifr_ifindex;
+  if (bind(d_fd, (struct sockaddr *) &sll, sizeof(sll)) < 0){
+    perror("usrp2_emulator: bind");
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Build the reply to a single control subpacket at s into r.
+ * Returns the length of the reply subpacket, 0 if none.
+ */
+size_t
+usrp2_emulator::handle_subpkt(const uint8_t *s, uint8_t *r)
+{
+  int opcode = s[0];
+  op_generic_t *g = (op_generic_t *) r;
+  g->opcode = opcode | OP_REPLY_BIT;
+  g->len = sizeof(op_generic_t);
+  g->rid = s[2];
+  g->ok = 1;
+
+  if (d_verbose)
+    fprintf(stderr, "usrp2_emulator: opcode %d rid %d\n", opcode, s[2]);
+
+  switch (opcode){
+
+  case OP_ID: {
+    op_id_reply_t *idr = (op_id_reply_t *) r;
+    memset(idr, 0, sizeof(*idr));
+    idr->opcode = OP_ID_REPLY;
+    idr->len = sizeof(*idr);
+    idr->rid = s[2];
+    idr->addr = d_mac;
+    idr->hw_rev = htons(0x0300);
+    return sizeof(*idr);
+  }
+
+  case OP_READ_TIME: {
+    op_read_time_reply_t *tr = (op_read_time_reply_t *) r;
+    tr->mbz = 0;
+    tr->len = sizeof(*tr);
+    tr->time = htonl(d_timestamp);
+    return sizeof(*tr);
+  }
+
+  case OP_CONFIG_RX_V2: {
+    const op_config_rx_v2_t *c = (const op_config_rx_v2_t *) s;
+    op_config_rx_reply_v2_t *cr = (op_config_rx_reply_v2_t *) r;
+    memset(cr, 0, sizeof(*cr));
+    cr->opcode = OP_CONFIG_RX_REPLY_V2;
+    cr->len = sizeof(*cr);
+    cr->rid = s[2];
+    cr->ok = htons(1);
+    if (ntohs(c->valid) & CFGV_INTERP_DECIM){
+      int decim = ntohl(c->decim);
+      if (decim < 4 || decim > 512)
+	cr->ok = htons(0);
+      else
+	d_decim = decim;
+    }
+    if (ntohs(c->valid) & CFGV_FREQ){	// tune exactly, all in the "RF"
+      cr->baseband_freq_hi = c->freq_hi;
+      cr->baseband_freq_lo = c->freq_lo;
+    }
+    return sizeof(*cr);
+  }
+
+  case OP_CONFIG_TX_V2: {
+    const op_config_tx_v2_t *c = (const op_config_tx_v2_t *) s;
+    op_config_tx_reply_v2_t *cr = (op_config_tx_reply_v2_t *) r;
+    memset(cr, 0, sizeof(*cr));
+    cr->opcode = OP_CONFIG_TX_REPLY_V2;
+    cr->len = sizeof(*cr);
+    cr->rid = s[2];
+    cr->ok = htons(1);
+    if (ntohs(c->valid) & CFGV_INTERP_DECIM){
+      int interp = ntohl(c->interp);
+      if (interp < 4 || interp > 512)
+	cr->ok = htons(0);
+      else
+	d_interp = interp;
+    }
+    if (ntohs(c->valid) & CFGV_FREQ){
+      cr->baseband_freq_hi = c->freq_hi;
+      cr->baseband_freq_lo = c->freq_lo;
+    }
+    return sizeof(*cr);
+  }
+
+  case OP_START_RX_STREAMING: {
+    const op_start_rx_streaming_t *c = (const op_start_rx_streaming_t *) s;
+    unsigned int n = ntohl(c->items_per_frame);
+    d_items_per_frame = std::min(std::max(n, (unsigned int) U2_MIN_SAMPLES),
+				 (unsigned int) U2_MAX_SAMPLES);
+    d_streaming = true;
+    d_next_frame_time = now_secs();
+    return sizeof(op_generic_t);
+  }
+
+  case OP_STOP_RX:
+    d_streaming = false;
+    return sizeof(op_generic_t);
+
+  case OP_DBOARD_INFO: {
+    op_dboard_info_reply_t *dr = (op_dboard_info_reply_t *) r;
+    memset(dr, 0, sizeof(*dr));
+    dr->opcode = OP_DBOARD_INFO_REPLY;
+    dr->len = sizeof(*dr);
+    dr->rid = s[2];
+    dr->ok = 1;
+
+    // Pretend to be a Basic Tx / Basic Rx pair
+    u2_db_info_t *dbs[2] = { &dr->tx_db_info, &dr->rx_db_info };
+    for (int i = 0; i < 2; i++){
+      u2_fxpt_freq_t fmin = u2_double_to_fxpt_freq(-50e6);
+      u2_fxpt_freq_t fmax = u2_double_to_fxpt_freq(50e6);
+      dbs[i]->dbid = htonl(i == 0 ? 0x0000 : 0x0001);
+      dbs[i]->freq_min_hi = htonl(u2_fxpt_freq_hi(fmin));
+      dbs[i]->freq_min_lo = htonl(u2_fxpt_freq_lo(fmin));
+      dbs[i]->freq_max_hi = htonl(u2_fxpt_freq_hi(fmax));
+      dbs[i]->freq_max_lo = htonl(u2_fxpt_freq_lo(fmax));
+    }
+    return sizeof(*dr);
+  }
+
+  case OP_PEEK: {			// reads as zeros
+    const op_peek_t *c = (const op_peek_t *) s;
+    size_t bytes = std::min((size_t) ntohl(c->bytes),
+			    (size_t) (MAX_SUBPKT_LEN - sizeof(op_generic_t)));
+    bytes &= ~3;
+    memset(r + sizeof(op_generic_t), 0, bytes);
+    g->len = sizeof(op_generic_t) + bytes;
+    return g->len;
+  }
+
+  case OP_GPIO_READ: {
+    op_gpio_read_reply_t *gr = (op_gpio_read_reply_t *) r;
+    gr->len = sizeof(*gr);
+    gr->mbz = 0;
+    gr->value = 0;
+    return sizeof(*gr);
+  }
+
+  default:				// everything else just succeeds
+    return sizeof(op_generic_t);
+  }
+}
+
+void
+usrp2_emulator::handle_control(const uint8_t *pkt, size_t len)
+{
+  uint8_t reply[MAX_PKTLEN];
+  memset(reply, 0, sizeof(reply));
+
+  const u2_eth_packet_t *h = (const u2_eth_packet_t *) pkt;
+  d_host = h->ehdr.src;
+  init_hdrs((u2_eth_packet_t *) reply, CONTROL_CHAN, 0);
+
+  size_t roff = sizeof(u2_eth_packet_t);
+  size_t off = sizeof(u2_eth_packet_t);
+  while (off + sizeof(op_generic_t) <= len){
+    const uint8_t *s = pkt + off;
+    if (s[0] == OP_EOP || s[1] == 0 || off + s[1] > len)
+      break;
+    if (roff + MAX_SUBPKT_LEN + sizeof(op_generic_t) > sizeof(reply))
+      break;
+
+    roff += (handle_subpkt(s, reply + roff) + 3) & ~3;
+    off += s[1];
+  }
+
+  op_generic_t *eop = (op_generic_t *) (reply + roff);
+  eop->opcode = OP_EOP;
+  eop->len = sizeof(*eop);
+  roff += sizeof(*eop);
+
+  d_ctrl_pkts++;
+  size_t rlen = std::max(roff, (size_t) MIN_PKTLEN);
+  if (send(d_fd, reply, rlen, 0) != (ssize_t) rlen)
+    perror("usrp2_emulator: send reply");
+}
+
+void
+usrp2_emulator::handle_data(const uint8_t *pkt, size_t len)
+{
+  const u2_eth_packet_t *h = (const u2_eth_packet_t *) pkt;
+
+  if (d_expected_tx_seqno >= 0 && h->thdr.seqno != d_expected_tx_seqno){
+    int missing = h->thdr.seqno - d_expected_tx_seqno;
+    if (missing < 0)
+      missing += 256;
+    d_tx_missing += missing;
+  }
+  d_expected_tx_seqno = (h->thdr.seqno + 1) & 0xff;
+
+  d_tx_frames++;
+  d_tx_items += (len - sizeof(u2_eth_packet_t)) / sizeof(uint32_t);
+}
+
+void
+usrp2_emulator::send_rx_frame()
+{
+  u2_eth_samples_t pkt;
+  init_hdrs(&pkt.hdrs, 0, d_rx_seqno);
+
+  for (unsigned int i = 0; i < d_items_per_frame; i++){
+    uint32_t n = (d_sample_count + i) & 0xffff;
+    pkt.samples[i] = htonl((n << 16) | (~n & 0xffff));
+  }
+
+  size_t len = sizeof(u2_eth_packet_t) + d_items_per_frame * sizeof(uint32_t);
+  len = std::max(len, (size_t) MIN_PKTLEN);
+
+  // A failed send is a dropped frame: the host sees the sequence gap
+  if (send(d_fd, &pkt, len, 0) != (ssize_t) len)
+    d_rx_send_errors++;
+
+  d_rx_frames++;
+  d_rx_seqno++;
+  d_sample_count += d_items_per_frame;
+  d_timestamp += d_items_per_frame * d_decim;
+}
+
+void
+usrp2_emulator::run()
+{
+  uint8_t buf[2048];
+
+  while (!signaled){
+    int timeout_ms = 100;
+    if (d_streaming){
+      double dt = d_next_frame_time - now_secs();
+      timeout_ms = dt > 0 ? (int) (dt * 1e3) : 0;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = d_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int r = poll(&pfd, 1, timeout_ms);
+    if (r < 0 && errno != EINTR){
+      perror("usrp2_emulator: poll");
+      return;
+    }
+
+    // Drain everything that's waiting for us
+    while (r > 0){
+      struct sockaddr_ll from;
+      socklen_t fromlen = sizeof(from);
+      ssize_t len = recvfrom(d_fd, buf, sizeof(buf), MSG_DONTWAIT,
+			     (struct sockaddr *) &from, &fromlen);
+      if (len < 0)
+	break;
+      if (from.sll_pkttype == PACKET_OUTGOING)	// our own frames
+	continue;
+      if ((size_t) len < sizeof(u2_eth_packet_t))
+	continue;
+
+      u2_eth_packet_t *h = (u2_eth_packet_t *) buf;
+      bool for_us = memcmp(&h->ehdr.dst, &d_mac, sizeof(d_mac)) == 0;
+      bool broadcast = (h->ehdr.dst.addr[0] & 0x01) != 0;
+      if (!for_us && !broadcast)
+	continue;
+
+      if (u2p_chan(&h->fixed) == CONTROL_CHAN)
+	handle_control(buf, len);
+      else if (for_us)
+	handle_data(buf, len);
+    }
+
+    if (d_streaming){
+      double period = d_items_per_frame / rx_sample_rate();
+      double now = now_secs();
+      int n = 0;
+      while (d_streaming && d_next_frame_time <= now && n < MAX_CATCHUP_FRAMES){
+	send_rx_frame();
+	d_next_frame_time += period;
+	n++;
+      }
+
+      // Too far behind to ever catch up; count it and resync the clock
+      if (d_next_frame_time + MAX_CATCHUP_FRAMES * period < now){
+	d_rx_late_frames += (unsigned long long) ((now - d_next_frame_time) / period);
+	d_next_frame_time = now;
+      }
+    }
+  }
+}
+
+void
+usrp2_emulator::report() const
+{
+  printf("control packets handled:  %llu\n", d_ctrl_pkts);
+  printf("rx frames sent:           %llu\n", d_rx_frames);
+  printf("rx frame send errors:     %llu\n", d_rx_send_errors);
+  printf("rx frames skipped (late): %llu\n", d_rx_late_frames);
+  printf("tx frames received:       %llu\n", d_tx_frames);
+  printf("tx items received:        %llu\n", d_tx_items);
+  printf("tx frames missing:        %llu\n", d_tx_missing);
+}
+
+// ------------------------------------------------------------------------
+
+static void
+usage(const char *progname)
+{
+  fprintf(stderr, "usage: %s [options]\n\n", progname);
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h                   show this message and exit\n");
+  fprintf(stderr, "  -e ETH_INTERFACE     specify ethernet interface [default=eth0]\n");
+  fprintf(stderr, "  -m MAC_ADDR          MAC address to emulate [default=00:50:c2:85:3f:ff]\n");
+  fprintf(stderr, "  -r RATE              override rx sample rate (samples/sec) [default=100M/decim]\n");
+  fprintf(stderr, "  -v                   verbose output\n");
+}
+
+int
+main(int argc, char **argv)
+{
+  const char *interface = "eth0";
+  u2_mac_addr_t mac = {{ 0x00, 0x50, 0xc2, 0x85, 0x3f, 0xff }};
+  double rate = 0;
+  bool verbose = false;
+  int ch;
+
+  while ((ch = getopt(argc, argv, "he:m:r:v")) != EOF){
+    switch (ch){
+    case 'e':
+      interface = optarg;
+      break;
+
+    case 'm':
+      if (!parse_mac_addr(optarg, &mac)){
+	fprintf(stderr, "invalid mac addr: %s\n", optarg);
+	usage(argv[0]);
+	return 1;
+      }
+      break;
+
+    case 'r':
+      if (!strtod_si(optarg, &rate) || rate <= 0){
+	fprintf(stderr, "invalid rate: %s\n", optarg);
+	usage(argv[0]);
+	return 1;
+      }
+      break;
+
+    case 'v':
+      verbose = true;
+      break;
+
+    case 'h':
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = sig_handler;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, 0);
+  sigaction(SIGTERM, &sa, 0);
+
+  usrp2_emulator emu(mac, rate, verbose);
+  if (!emu.open(interface))
+    return 1;
+
+  emu.run();
+  emu.report();
+  return 0;
+}
@@ -225,6 +225,18 @@ namespace usrp2 {
      */
     unsigned int rx_missing();
 
+    /*!
+     * Returns the maximum number of frames that have been queued at once
+     * on the host side receive ring for \p channel.
+     */
+    unsigned int rx_ring_high_water(unsigned int channel);
+
+    /*!
+     * Returns the number of frames discarded because the host side
+     * receive ring for \p channel was full.
+     */
+    unsigned int rx_ring_drops(unsigned int channel);
+
     /*
      * ----------------------------------------------------------------
      * Tx configuration and control
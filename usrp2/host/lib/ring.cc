@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -24,12 +24,27 @@
 #endif
 
 #include "ring.h"
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 namespace usrp2 {
 
+  static inline void
+  futex_wait(volatile int *addr, int val)
+  {
+    syscall(SYS_futex, addr, FUTEX_WAIT, val, 0, 0, 0);
+  }
+
+  static inline void
+  futex_wake(volatile int *addr)
+  {
+    syscall(SYS_futex, addr, FUTEX_WAKE, 1, 0, 0, 0);
+  }
+
   ring::ring(unsigned int entries)
-    : d_max(entries), d_read_ind(0), d_write_ind(0), d_ring(entries),
-      d_mutex(), d_not_empty(&d_mutex)
+    : d_max(entries), d_ring(entries), d_read_ind(0), d_write_ind(0),
+      d_waiting(0), d_interrupted(0), d_high_water(0), d_drops(0)
   {
     for (unsigned int i = 0; i < entries; i++) {
       d_ring[i].d_base = 0;
@@ -37,40 +52,83 @@ namespace usrp2 {
     }
   }
 
-  void 
-  ring::wait_for_not_empty() 
-  { 
-    omni_mutex_lock l(d_mutex);
-    while (empty()) 
-      d_not_empty.wait();
+  bool
+  ring::wait_for_not_empty()
+  {
+    while (empty()) {
+      if (d_interrupted)
+	return false;
+
+      // Announce that we're going to sleep, then re-check so that an
+      // enqueue or interrupt racing with us is not missed.
+      d_waiting = 1;
+      __sync_synchronize();
+      if (!empty() || d_interrupted) {
+	d_waiting = 0;
+	continue;
+      }
+      futex_wait(&d_waiting, 1);
+      d_waiting = 0;
+    }
+    return true;
+  }
+
+  void
+  ring::interrupt()
+  {
+    d_interrupted = 1;
+    __sync_synchronize();		// flag visible before checking waiter
+    if (d_waiting && __sync_bool_compare_and_swap(&d_waiting, 1, 0))
+      futex_wake(&d_waiting);
+  }
+
+  void
+  ring::clear_interrupt()
+  {
+    d_interrupted = 0;
+    __sync_synchronize();
   }
 
   bool
   ring::enqueue(void *p, size_t len)
   {
-    omni_mutex_lock l(d_mutex);
-    if (full())
+    size_t w = d_write_ind;
+    size_t r = d_read_ind;
+    if (next(w) == r) {
+      d_drops = d_drops + 1;
       return false;
-      
-    d_ring[d_write_ind].d_len = len;
-    d_ring[d_write_ind].d_base = p;
+    }
+
+    d_ring[w].d_len = len;
+    d_ring[w].d_base = p;
+
+    __sync_synchronize();		// descriptor visible before index
+    d_write_ind = next(w);
+
+    size_t n = w >= r ? w - r + 1 : w + d_max - r + 1;
+    if (n > d_high_water)
+      d_high_water = n;
+
+    __sync_synchronize();		// index visible before checking waiter
+    if (d_waiting && __sync_bool_compare_and_swap(&d_waiting, 1, 0))
+      futex_wake(&d_waiting);
 
-    inc_write_ind();
-    d_not_empty.signal();
     return true;
   }
 
   bool
   ring::dequeue(void **p, size_t *len)
   {
-    omni_mutex_lock l(d_mutex);
-    if (empty())
+    size_t r = d_read_ind;
+    if (r == d_write_ind)
       return false;
-      
-    *p   = d_ring[d_read_ind].d_base;
-    *len = d_ring[d_read_ind].d_len;
 
-    inc_read_ind();
+    __sync_synchronize();		// read descriptor after seeing index
+    *p   = d_ring[r].d_base;
+    *len = d_ring[r].d_len;
+
+    __sync_synchronize();		// done with descriptor before release
+    d_read_ind = next(r);
     return true;
   }
   
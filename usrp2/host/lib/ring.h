@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2010 Free Software Foundation, Inc.
  * 
  * This file is part of GNU Radio
  * 
@@ -21,7 +21,6 @@
 #ifndef INCLUDED_RING_H
 #define INCLUDED_RING_H
 
-#include <gnuradio/omnithread.h>
 #include <stddef.h>
 #include <vector>
 #include <boost/shared_ptr.hpp>
@@ -31,13 +30,27 @@ namespace usrp2 {
   class ring;
   typedef boost::shared_ptr<ring> ring_sptr;
 
+  /*!
+   * \brief Lock-free single producer, single consumer descriptor ring.
+   *
+   * The producer (the background rx thread) only writes d_write_ind and
+   * the consumer (the rx_samples caller) only writes d_read_ind, so no
+   * lock is needed on either path.  A blocked consumer sleeps on a futex
+   * and is only woken when the producer finds it waiting, i.e., on the
+   * empty -> non-empty transition.
+   *
+   * Only one thread may dequeue at a time; usrp2::impl serializes
+   * rx_samples and flush_rx_samples on a per-channel consumer mutex.
+   * interrupt() releases a consumer blocked in wait_for_not_empty so
+   * that it can give up that mutex when the channel is stopped.
+   *
+   * \internal
+   */
   class ring
   {
   private:
  
     size_t d_max;
-    size_t d_read_ind;
-    size_t d_write_ind;
 
     struct ring_desc
     {
@@ -46,36 +59,47 @@ namespace usrp2 {
     };
     std::vector<ring_desc> d_ring;
 
-    omni_mutex d_mutex;
-    omni_condition d_not_empty;
+    // Keep the producer and consumer indices on separate cache lines
+    volatile size_t d_read_ind;
+    char d_pad0[64 - sizeof(size_t)];
+    volatile size_t d_write_ind;
+    char d_pad1[64 - sizeof(size_t)];
 
-    void inc_read_ind()
-    {
-      if (d_read_ind + 1 >= d_max)
-	d_read_ind = 0;
-      else
-	d_read_ind = d_read_ind + 1;
-    }
+    volatile int d_waiting;		// futex word, 1 while consumer sleeps
+    volatile int d_interrupted;		// wait_for_not_empty returns at once
+
+    // statistics, only written by the producer
+    volatile size_t d_high_water;	// max number of entries ever queued
+    volatile unsigned int d_drops;	// enqueues refused because ring full
+
+    size_t next(size_t ind) const { return ind + 1 >= d_max ? 0 : ind + 1; }
 
-    void inc_write_ind()
-    {
-      if (d_write_ind + 1 >= d_max)
-	d_write_ind = 0;
-      else
-	d_write_ind = d_write_ind + 1;
-    }
-        
     bool empty() const { return d_read_ind == d_write_ind; }
-    bool full() const { return (d_write_ind+1)%d_max == d_read_ind; }
 
   public:
     
     ring(unsigned int entries);
 
-    void wait_for_not_empty();
+    /*!
+     * \brief Block until the ring is not empty or interrupt() is called.
+     * \returns false if interrupted with nothing to dequeue.
+     */
+    bool wait_for_not_empty();
+
+    //! Wake a blocked consumer and keep it from blocking again
+    void interrupt();
+
+    //! Allow the consumer to block again
+    void clear_interrupt();
 
     bool enqueue(void *p, size_t len);
     bool dequeue(void **p, size_t *len);
+
+    //! Maximum number of entries that have been queued at once
+    size_t high_water() const { return d_high_water; }
+
+    //! Number of entries refused because the ring was full
+    unsigned int drops() const { return d_drops; }
   };
 
 }  // namespace usrp2
@@ -282,6 +282,18 @@ namespace usrp2 {
     return d_impl->rx_missing();
   }
 
+  unsigned int
+  usrp2::rx_ring_high_water(unsigned int channel)
+  {
+    return d_impl->rx_ring_high_water(channel);
+  }
+
+  unsigned int
+  usrp2::rx_ring_drops(unsigned int channel)
+  {
+    return d_impl->rx_ring_drops(channel);
+  }
+
   // Transmit
 
   bool
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008,2009 Free Software Foundation, Inc.
+ * Copyright 2008,2009,2010 Free Software Foundation, Inc.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -151,6 +151,7 @@ namespace usrp2 {
       std::cerr << "usrp2 constructor: using USRP2 at " << d_addr << std::endl;
 
     memset(d_pending_replies, 0, sizeof(d_pending_replies));
+    memset((void *)d_channel_active, 0, sizeof(d_channel_active));
 
     d_bg_thread = new usrp2_thread(this);
     d_bg_thread->start();
@@ -462,30 +463,40 @@ namespace usrp2 {
     // FIXME unaligned load!
     unsigned int chan = u2p_chan(&pkt->hdrs.fixed);
 
-    {
-      omni_mutex_lock l(d_channel_rings_mutex);
-
-      if (!d_channel_rings[chan]) {
-	DEBUG_LOG("!");
-	return data_handler::RELEASE; 	// discard packet, no channel handler
-      }
+    // No lock needed: rings are never destroyed while the bg thread runs,
+    // and a ring is only marked active once it is fully constructed.
+    if (chan >= NCHANS || !d_channel_active[chan]) {
+      DEBUG_LOG("!");
+      return data_handler::RELEASE; 	// discard packet, no channel handler
+    }
 
-      // Strip off ethernet header and transport header and enqueue the rest
+    // Strip off ethernet header and transport header and enqueue the rest
 
-      size_t offset = offsetof(u2_eth_samples_t, hdrs.fixed);
-      if (d_channel_rings[chan]->enqueue(&pkt->hdrs.fixed, len-offset)) {
-	inc_enqueued();
-	DEBUG_LOG("+");
-	return data_handler::KEEP;	// channel ring runner will mark frame done
-      }
-      else {
-	DEBUG_LOG("!");
-	return data_handler::RELEASE;	// discard, no room in channel ring
-      }
-      return data_handler::RELEASE;
+    size_t offset = offsetof(u2_eth_samples_t, hdrs.fixed);
+    if (d_channel_rings[chan]->enqueue(&pkt->hdrs.fixed, len-offset)) {
+      inc_enqueued();
+      DEBUG_LOG("+");
+      return data_handler::KEEP;	// channel ring runner will mark frame done
+    }
+    else {
+      DEBUG_LOG("!");
+      return data_handler::RELEASE;	// discard, no room in channel ring
     }
   }
 
+  // Called with d_channel_rings_mutex held
+  void
+  usrp2::impl::activate_rx_ring(unsigned int channel)
+  {
+    if (!d_channel_rings[channel])
+      d_channel_rings[channel] = ring_sptr(new ring(d_eth_buf->max_frames()));
+
+    flush_rx_samples(channel);	// drop anything left over from a previous run
+    d_channel_rings[channel]->clear_interrupt();
+    __sync_synchronize();	// ring visible before data path sees it active
+    d_channel_active[channel] = true;
+  }
+
 
   // ----------------------------------------------------------------
   // 			       Receive
@@ -651,7 +662,7 @@ namespace usrp2 {
 
     {
       omni_mutex_lock l(d_channel_rings_mutex);
-      if (d_channel_rings[channel]) {
+      if (d_channel_active[channel]) {
 	std::cerr << "usrp2: channel " << channel
 		  << " already streaming" << std::endl;
 	return false;
@@ -679,7 +690,7 @@ namespace usrp2 {
       success = success && (ntohx(reply.ok) == 1);
 
       if (success)
-	d_channel_rings[channel] = ring_sptr(new ring(d_eth_buf->max_frames()));
+	activate_rx_ring(channel);
       else
 	d_dont_enqueue = true;
 
@@ -705,7 +716,7 @@ namespace usrp2 {
 
     {
       omni_mutex_lock l(d_channel_rings_mutex);
-      if (d_channel_rings[channel]) {
+      if (d_channel_active[channel]) {
 	std::cerr << "usrp2: channel " << channel
 		  << " already streaming" << std::endl;
 	return false;
@@ -733,7 +744,7 @@ namespace usrp2 {
       success = success && (ntohx(reply.ok) == 1);
 
       if (success)
-	d_channel_rings[channel] = ring_sptr(new ring(d_eth_buf->max_frames()));
+	activate_rx_ring(channel);
       else
 	d_dont_enqueue = true;
 
@@ -759,7 +770,7 @@ namespace usrp2 {
 
     {
       omni_mutex_lock l(d_channel_rings_mutex);
-      if (d_channel_rings[channel]) {
+      if (d_channel_active[channel]) {
 	std::cerr << "usrp2: channel " << channel
 		  << " already streaming" << std::endl;
 	return false;
@@ -790,7 +801,7 @@ namespace usrp2 {
       success = success && (ntohx(reply.ok) == 1);
 
       if (success)
-	d_channel_rings[channel] = ring_sptr(new ring(d_eth_buf->max_frames()));
+	activate_rx_ring(channel);
       else
 	d_dont_enqueue = true;
 
@@ -814,6 +825,8 @@ namespace usrp2 {
     }
 
     d_dont_enqueue = true;	// no new samples
+    if (d_channel_rings[channel])
+      d_channel_rings[channel]->interrupt(); // release a blocked rx_samples
     flush_rx_samples(channel);	// dump any we may already have
 
     op_stop_rx_cmd cmd;
@@ -834,7 +847,8 @@ namespace usrp2 {
       pending_reply p(cmd.op.rid, &reply, sizeof(reply));
       success = transmit_cmd_and_wait(&cmd, sizeof(cmd), &p, DEF_CMD_TIMEOUT);
       success = success && (ntohx(reply.ok) == 1);
-      d_channel_rings[channel].reset();
+      d_channel_active[channel] = false;
+      flush_rx_samples(channel);	// anything enqueued before the reply
       //fprintf(stderr, "usrp2::stop_rx_streaming:  success = %d\n", success);
       return success;
     }
@@ -855,16 +869,20 @@ namespace usrp2 {
       return false;
     }
 
-    ring_sptr rp = d_channel_rings[channel];
-    if (!rp){
+    if (!d_channel_active[channel]){
       std::cerr << "usrp2: channel " << channel
                 << " not receiving" << std::endl;
       return false;
     }
+    ring *rp = d_channel_rings[channel].get();
+
+    // The ring has a single consumer; flush_rx_samples takes this too
+    omni_mutex_lock l(d_channel_consumer_mutex[channel]);
 
     // Wait for frames available in channel ring
     DEBUG_LOG("W");
-    rp->wait_for_not_empty();
+    if (!rp->wait_for_not_empty())
+      return true;		// interrupted by stop_rx_streaming
     DEBUG_LOG("s");
 
     // Iterate through frames and present to user
@@ -903,11 +921,13 @@ namespace usrp2 {
       return false;
     }
 
-    ring_sptr rp = d_channel_rings[channel];
+    ring *rp = d_channel_rings[channel].get();
     if (!rp){
       return false;
     }
 
+    omni_mutex_lock l(d_channel_consumer_mutex[channel]);
+
     // Iterate through frames and drop them
     void *p;
     size_t frame_len_in_bytes;
@@ -918,6 +938,22 @@ namespace usrp2 {
     return true;
   }
 
+  unsigned int
+  usrp2::impl::rx_ring_high_water(unsigned int channel)
+  {
+    if (channel >= NCHANS || !d_channel_rings[channel])
+      return 0;
+    return d_channel_rings[channel]->high_water();
+  }
+
+  unsigned int
+  usrp2::impl::rx_ring_drops(unsigned int channel)
+  {
+    if (channel >= NCHANS || !d_channel_rings[channel])
+      return 0;
+    return d_channel_rings[channel]->drops();
+  }
+
   // ----------------------------------------------------------------
   // 				Transmit
   // ----------------------------------------------------------------
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008,2009 Free Software Foundation, Inc.
+ * Copyright 2008,2009,2010 Free Software Foundation, Inc.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -79,7 +79,9 @@ namespace usrp2 {
     pending_reply *d_pending_replies[NRIDS]; // indexed by 8-bit reply id
 
     std::vector<ring_sptr>   d_channel_rings; // indexed by 5-bit channel number
-    omni_mutex     d_channel_rings_mutex;
+    volatile bool  d_channel_active[NCHANS];   // ring is accepting frames
+    omni_mutex     d_channel_rings_mutex;      // serializes start/stop only
+    omni_mutex     d_channel_consumer_mutex[NCHANS]; // one ring consumer at a time
 
     db_info	   d_tx_db_info;
     db_info	   d_rx_db_info;
@@ -114,6 +116,7 @@ namespace usrp2 {
     data_handler::result handle_data_packet(const void *base, size_t len);
     bool dboard_info();
     bool reset_db();
+    void activate_rx_ring(unsigned int channel);
 
   public:
     impl(const std::string &ifc, props *p, size_t rx_bufsize);
@@ -151,6 +154,8 @@ namespace usrp2 {
     bool stop_rx_streaming(unsigned int channel);
     unsigned int rx_overruns() const { return d_num_rx_overruns; }
     unsigned int rx_missing() const { return d_num_rx_missing; }
+    unsigned int rx_ring_high_water(unsigned int channel);
+    unsigned int rx_ring_drops(unsigned int channel);
 
     // Tx
 